@@ -0,0 +1,458 @@
+// helpers/protopirate_batch_decode.c
+#include "protopirate_batch_decode.h"
+#include "protopirate_storage.h"
+#include "protopirate_raw_reader.h"
+#include "../protocols/protocol_items.h"
+#include "../protocols/protocol_dispatch.h"
+#include <toolbox/dir_walk.h>
+#include <toolbox/stream/buffered_file_stream.h>
+
+#define TAG "ProtoPirateBatchDecode"
+
+#define BATCH_CHUNK_SAMPLES 256
+#define BATCH_CSV_HEADER    "File,Protocol,Frequency,Sample,Capture_us,Decode_ms,Fields\n"
+
+typedef struct {
+    ProtoPirateBatchDecode* batch;
+    const SubGhzProtocol* protocol;
+    void* decoder;
+    bool matched; // Already has its row for the current file
+} BatchDecodeSlot;
+
+struct ProtoPirateBatchDecode {
+    BatchDecodeSlot* slots;
+    size_t slot_count;
+    ProtoPirateDispatch* dispatch;
+
+    Storage* storage;
+    DirWalk* dir_walk;
+    Stream* csv;
+    size_t folder_len;
+    bool write_error;
+    uint32_t start_tick;
+
+    // Current file, ff stays open while its RAW_Data is streamed
+    FlipperFormat* ff;
+    ProtoPirateRawReader raw_reader;
+    FuriString* file_path;
+    FuriString* temp_str;
+    FuriString* line;
+    uint32_t frequency;
+    uint32_t file_tick;
+    uint32_t file_rows;
+    uint32_t sample_index;
+    uint32_t capture_us;
+    int32_t chunk[BATCH_CHUNK_SAMPLES];
+
+    volatile uint8_t progress;
+    ProtoPirateBatchDecodeStats stats;
+};
+
+// Path of the current file below the batch folder
+static const char* protopirate_batch_decode_file_name(ProtoPirateBatchDecode* batch) {
+    const char* path = furi_string_get_cstr(batch->file_path);
+    return furi_string_size(batch->file_path) > batch->folder_len ? path + batch->folder_len :
+                                                                    path;
+}
+
+// Quoted CSV field, the line breaks of get_string output become "; "
+static void protopirate_batch_decode_cat_field(FuriString* line, const char* text) {
+    bool line_break = false;
+    bool started = false;
+
+    furi_string_push_back(line, '"');
+    for(const char* c = text; *c; c++) {
+        if(*c == '\r' || *c == '\n') {
+            line_break = started;
+            continue;
+        }
+        if(line_break) {
+            furi_string_cat_str(line, "; ");
+            line_break = false;
+        }
+        if(*c == '"') furi_string_push_back(line, '"');
+        furi_string_push_back(line, *c);
+        started = true;
+    }
+    furi_string_push_back(line, '"');
+}
+
+// Sample and capture time are left empty for rows that don't come from RAW_Data
+static void protopirate_batch_decode_write_row(
+    ProtoPirateBatchDecode* batch,
+    const char* protocol,
+    bool at_sample,
+    const char* fields) {
+    FuriString* line = batch->line;
+
+    furi_string_reset(line);
+    protopirate_batch_decode_cat_field(line, protopirate_batch_decode_file_name(batch));
+    furi_string_cat_printf(line, ",%s,%lu,", protocol, batch->frequency);
+    if(at_sample) {
+        furi_string_cat_printf(line, "%lu,%lu", batch->sample_index, batch->capture_us);
+    } else {
+        furi_string_push_back(line, ',');
+    }
+    furi_string_cat_printf(line, ",%lu,", furi_get_tick() - batch->file_tick);
+    protopirate_batch_decode_cat_field(line, fields);
+    furi_string_push_back(line, '\n');
+
+    if(stream_write_string(batch->csv, line) != furi_string_size(line)) {
+        batch->write_error = true;
+    }
+    batch->file_rows++;
+}
+
+// First frame of each protocol per file, repeats of the same key add nothing to a triage
+static void
+    protopirate_batch_decode_callback(SubGhzProtocolDecoderBase* decoder_base, void* context) {
+    BatchDecodeSlot* slot = context;
+    ProtoPirateBatchDecode* batch = slot->batch;
+
+    if(slot->matched) return;
+    slot->matched = true;
+
+    furi_string_reset(batch->temp_str);
+    if(slot->protocol->decoder->get_string) {
+        slot->protocol->decoder->get_string(decoder_base, batch->temp_str);
+    }
+    protopirate_batch_decode_write_row(
+        batch, slot->protocol->name, true, furi_string_get_cstr(batch->temp_str));
+    batch->stats.rows++;
+}
+
+static bool
+    protopirate_batch_decode_filter(const char* name, FileInfo* fileinfo, void* context) {
+    UNUSED(context);
+    size_t name_len = strlen(name);
+    size_t extension_len = strlen(PROTOPIRATE_APP_EXTENSION);
+
+    return !file_info_is_dir(fileinfo) && name_len > extension_len &&
+           strcmp(name + name_len - extension_len, PROTOPIRATE_APP_EXTENSION) == 0;
+}
+
+ProtoPirateBatchDecode* protopirate_batch_decode_alloc(SubGhzEnvironment* environment) {
+    ProtoPirateBatchDecode* batch = malloc(sizeof(ProtoPirateBatchDecode));
+    memset(batch, 0, sizeof(ProtoPirateBatchDecode));
+    batch->file_path = furi_string_alloc();
+    batch->temp_str = furi_string_alloc();
+    batch->line = furi_string_alloc();
+    batch->dispatch = protopirate_dispatch_alloc();
+    batch->slots = malloc(sizeof(BatchDecodeSlot) * protopirate_protocol_registry.size);
+
+    // Keyed files need the decoders that can't be fed as well
+    for(size_t i = 0; i < protopirate_protocol_registry.size; i++) {
+        const SubGhzProtocol* protocol = protopirate_protocol_registry.items[i];
+        if(!protocol->decoder || !protocol->decoder->alloc) continue;
+
+        void* decoder = protocol->decoder->alloc(environment);
+        if(!decoder) continue;
+
+        BatchDecodeSlot* slot = &batch->slots[batch->slot_count++];
+        slot->batch = batch;
+        slot->protocol = protocol;
+        slot->decoder = decoder;
+        slot->matched = false;
+
+        SubGhzProtocolDecoderBase* decoder_base = decoder;
+        decoder_base->callback = protopirate_batch_decode_callback;
+        decoder_base->context = slot;
+
+        if(protocol->decoder->feed) {
+            protopirate_dispatch_add(batch->dispatch, protocol, decoder);
+        }
+    }
+
+    FURI_LOG_D(TAG, "Allocated %zu decoders", batch->slot_count);
+    return batch;
+}
+
+void protopirate_batch_decode_free(ProtoPirateBatchDecode* batch) {
+    furi_assert(batch);
+    protopirate_batch_decode_finish(batch);
+
+    for(size_t i = 0; i < batch->slot_count; i++) {
+        batch->slots[i].protocol->decoder->free(batch->slots[i].decoder);
+    }
+    free(batch->slots);
+    protopirate_dispatch_free(batch->dispatch);
+    furi_string_free(batch->file_path);
+    furi_string_free(batch->temp_str);
+    furi_string_free(batch->line);
+    free(batch);
+}
+
+bool protopirate_batch_decode_start(
+    ProtoPirateBatchDecode* batch,
+    Storage* storage,
+    const char* folder,
+    FuriString* out_path) {
+    furi_assert(batch);
+    furi_assert(storage);
+    furi_assert(folder);
+    furi_assert(!batch->csv);
+
+    FuriString* csv_path = furi_string_alloc();
+    bool result = false;
+
+    memset(&batch->stats, 0, sizeof(ProtoPirateBatchDecodeStats));
+    batch->write_error = false;
+    batch->progress = 0;
+    batch->start_tick = furi_get_tick();
+    batch->storage = storage;
+    batch->folder_len = strlen(folder) + 1;
+    batch->dir_walk = dir_walk_alloc(storage);
+    batch->csv = buffered_file_stream_alloc(storage);
+
+    do {
+        if(!storage_simply_mkdir(storage, PROTOPIRATE_APP_FOLDER) ||
+           !storage_simply_mkdir(storage, PROTOPIRATE_BATCH_FOLDER)) {
+            FURI_LOG_E(TAG, "Failed to create batch folder");
+            break;
+        }
+
+        const char* name = strrchr(folder, '/');
+        furi_string_printf(
+            csv_path,
+            "%s/%s%s",
+            PROTOPIRATE_BATCH_FOLDER,
+            name ? name + 1 : folder,
+            PROTOPIRATE_BATCH_EXTENSION);
+
+        if(!buffered_file_stream_open(
+               batch->csv, furi_string_get_cstr(csv_path), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            FURI_LOG_E(TAG, "Failed to create %s", furi_string_get_cstr(csv_path));
+            break;
+        }
+        if(stream_write_cstring(batch->csv, BATCH_CSV_HEADER) != strlen(BATCH_CSV_HEADER)) {
+            break;
+        }
+
+        dir_walk_set_recursive(batch->dir_walk, true);
+        dir_walk_set_filter_cb(batch->dir_walk, protopirate_batch_decode_filter, NULL);
+        if(!dir_walk_open(batch->dir_walk, folder)) {
+            FURI_LOG_E(TAG, "Failed to open %s", folder);
+            break;
+        }
+
+        result = true;
+        if(out_path) furi_string_set(out_path, csv_path);
+        FURI_LOG_I(TAG, "Decoding %s into %s", folder, furi_string_get_cstr(csv_path));
+    } while(false);
+
+    if(!result) {
+        dir_walk_free(batch->dir_walk);
+        batch->dir_walk = NULL;
+        buffered_file_stream_close(batch->csv);
+        stream_free(batch->csv);
+        batch->csv = NULL;
+    }
+
+    furi_string_free(csv_path);
+    return result;
+}
+
+static void protopirate_batch_decode_close_file(ProtoPirateBatchDecode* batch) {
+    if(batch->ff) {
+        flipper_format_free(batch->ff);
+        batch->ff = NULL;
+    }
+}
+
+// A RAW file is done once its stream runs dry, a row says so when nothing decoded
+static void protopirate_batch_decode_end_raw(ProtoPirateBatchDecode* batch) {
+    if(protopirate_raw_reader_has_error(&batch->raw_reader)) {
+        protopirate_batch_decode_write_row(batch, "-", false, "RAW_Data value out of range");
+        batch->stats.skipped++;
+    } else if(batch->file_rows > 0) {
+        batch->stats.decoded++;
+    } else {
+        protopirate_batch_decode_write_row(batch, "-", false, "No match");
+    }
+    protopirate_batch_decode_close_file(batch);
+}
+
+// Keyed files are parsed by the decoder their Protocol names, in one go
+static void protopirate_batch_decode_keyed(ProtoPirateBatchDecode* batch) {
+    const char* protocol_name = furi_string_get_cstr(batch->temp_str);
+    const ProtoPirateProtocolInfo* info = protopirate_protocol_find_info(protocol_name);
+    BatchDecodeSlot* slot = NULL;
+
+    for(size_t i = 0; info && i < batch->slot_count; i++) {
+        if(batch->slots[i].protocol == info->protocol) {
+            slot = &batch->slots[i];
+            break;
+        }
+    }
+
+    SubGhzProtocolStatus status = SubGhzProtocolStatusErrorParserProtocolName;
+    if(slot && slot->protocol->decoder->deserialize) {
+        flipper_format_rewind(batch->ff);
+        status = slot->protocol->decoder->deserialize(slot->decoder, batch->ff);
+    }
+
+    // A bit count mismatch still leaves a readable key, as in the single file decode
+    if(status == SubGhzProtocolStatusOk || status == SubGhzProtocolStatusErrorValueBitCount) {
+        furi_string_reset(batch->temp_str);
+        if(slot->protocol->decoder->get_string) {
+            slot->protocol->decoder->get_string(slot->decoder, batch->temp_str);
+        }
+        protopirate_batch_decode_write_row(
+            batch, slot->protocol->name, false, furi_string_get_cstr(batch->temp_str));
+        batch->stats.rows++;
+        batch->stats.decoded++;
+    } else {
+        furi_string_cat_printf(batch->temp_str, " not parsed (%d)", status);
+        protopirate_batch_decode_write_row(
+            batch, "-", false, furi_string_get_cstr(batch->temp_str));
+        batch->stats.skipped++;
+    }
+
+    protopirate_batch_decode_close_file(batch);
+}
+
+static void protopirate_batch_decode_open_file(ProtoPirateBatchDecode* batch) {
+    const char* path = furi_string_get_cstr(batch->file_path);
+    const char* error = NULL;
+    uint32_t version = 0;
+
+    batch->ff = flipper_format_file_alloc(batch->storage);
+    batch->file_tick = furi_get_tick();
+    batch->file_rows = 0;
+    batch->sample_index = 0;
+    batch->capture_us = 0;
+    batch->frequency = 433920000;
+    batch->progress = 0;
+
+    do {
+        if(!flipper_format_file_open_existing(batch->ff, path)) {
+            error = "Open failed";
+            break;
+        }
+        if(!flipper_format_read_header(batch->ff, batch->temp_str, &version) ||
+           (furi_string_cmp_str(batch->temp_str, "Flipper SubGhz Key File") != 0 &&
+            furi_string_cmp_str(batch->temp_str, "Flipper SubGhz RAW File") != 0)) {
+            error = "Not a SubGhz file";
+            break;
+        }
+        flipper_format_read_uint32(batch->ff, "Frequency", &batch->frequency, 1);
+        if(!flipper_format_read_string(batch->ff, "Protocol", batch->temp_str)) {
+            error = "No protocol field";
+            break;
+        }
+    } while(false);
+
+    if(error) {
+        FURI_LOG_W(TAG, "%s: %s", error, path);
+        protopirate_batch_decode_write_row(batch, "-", false, error);
+        batch->stats.skipped++;
+        protopirate_batch_decode_close_file(batch);
+    } else if(furi_string_cmp_str(batch->temp_str, "RAW") == 0) {
+        for(size_t i = 0; i < batch->slot_count; i++) {
+            batch->slots[i].matched = false;
+        }
+        protopirate_dispatch_reset(batch->dispatch);
+        protopirate_raw_reader_init(&batch->raw_reader, flipper_format_get_raw_stream(batch->ff));
+    } else {
+        protopirate_batch_decode_keyed(batch);
+    }
+}
+
+bool protopirate_batch_decode_step(ProtoPirateBatchDecode* batch) {
+    furi_assert(batch);
+    if(!batch->dir_walk) return false;
+
+    if(batch->ff) {
+        size_t count =
+            protopirate_raw_reader_read(&batch->raw_reader, batch->chunk, BATCH_CHUNK_SAMPLES);
+
+        for(size_t i = 0; i < count; i++) {
+            int32_t duration = batch->chunk[i];
+            bool level = (duration >= 0);
+            if(duration < 0) duration = -duration;
+
+            // Where a frame that decodes on this pulse ends
+            batch->capture_us += (uint32_t)duration;
+            protopirate_dispatch_feed(batch->dispatch, level, (uint32_t)duration);
+            batch->sample_index++;
+        }
+
+        batch->stats.samples += count;
+        batch->progress = protopirate_raw_reader_get_progress(&batch->raw_reader);
+        if(count == 0) {
+            protopirate_batch_decode_end_raw(batch);
+        }
+        return true;
+    }
+
+    DirWalkResult walk = dir_walk_read(batch->dir_walk, batch->file_path, NULL);
+    if(walk != DirWalkOK) {
+        if(walk == DirWalkError) {
+            FURI_LOG_E(TAG, "Folder walk failed: %d", dir_walk_get_error(batch->dir_walk));
+        }
+        return false;
+    }
+
+    batch->stats.files++;
+    protopirate_batch_decode_open_file(batch);
+    return true;
+}
+
+bool protopirate_batch_decode_finish(ProtoPirateBatchDecode* batch) {
+    furi_assert(batch);
+    if(!batch->csv) return false;
+
+    // A file cut short keeps the rows it already has
+    if(batch->ff) {
+        protopirate_batch_decode_end_raw(batch);
+    }
+    batch->stats.time_ms = furi_get_tick() - batch->start_tick;
+
+    furi_string_printf(
+        batch->line,
+        "\nFiles,Decoded,Skipped,Rows,Samples,Time_ms\n%lu,%lu,%lu,%lu,%lu,%lu\n",
+        batch->stats.files,
+        batch->stats.decoded,
+        batch->stats.skipped,
+        batch->stats.rows,
+        batch->stats.samples,
+        batch->stats.time_ms);
+    if(stream_write_string(batch->csv, batch->line) != furi_string_size(batch->line)) {
+        batch->write_error = true;
+    }
+
+    // The summary rows are still buffered, the CSV is cut short if they do not make it
+    if(!buffered_file_stream_close(batch->csv)) {
+        batch->write_error = true;
+    }
+    stream_free(batch->csv);
+    batch->csv = NULL;
+    dir_walk_close(batch->dir_walk);
+    dir_walk_free(batch->dir_walk);
+    batch->dir_walk = NULL;
+
+    FURI_LOG_I(
+        TAG,
+        "Batch done: %lu files, %lu decoded, %lu skipped in %lu ms",
+        batch->stats.files,
+        batch->stats.decoded,
+        batch->stats.skipped,
+        batch->stats.time_ms);
+    return !batch->write_error;
+}
+
+void protopirate_batch_decode_get_stats(
+    const ProtoPirateBatchDecode* batch,
+    ProtoPirateBatchDecodeStats* stats) {
+    furi_assert(batch);
+    furi_assert(stats);
+    *stats = batch->stats;
+    if(batch->csv) {
+        stats->time_ms = furi_get_tick() - batch->start_tick;
+    }
+}
+
+uint8_t protopirate_batch_decode_get_progress(const ProtoPirateBatchDecode* batch) {
+    furi_assert(batch);
+    return batch->progress;
+}
@@ -0,0 +1,51 @@
+// helpers/protopirate_batch_decode.h
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+#include <lib/subghz/environment.h>
+
+#define PROTOPIRATE_BATCH_EXTENSION ".csv"
+
+// Running totals of a batch
+typedef struct {
+    uint32_t files; // .sub files found so far
+    uint32_t decoded; // Files with at least one decoded frame
+    uint32_t skipped; // Files that could not be read or have no registry protocol
+    uint32_t rows; // Decoded frames written, one per protocol and file
+    uint32_t samples; // RAW samples streamed through the decoders
+    uint32_t time_ms; // Since the batch started
+} ProtoPirateBatchDecodeStats;
+
+// Walks a folder tree and decodes every .sub in it, streaming one CSV row per protocol found
+// in each file to PROTOPIRATE_BATCH_FOLDER. RAW recordings go through every registry decoder
+// in one pass, keyed files through the decoder their Protocol names. Every registry decoder
+// is allocated once for the whole batch. Not thread safe, except for the getters, which a
+// second thread may call for display while one thread steps.
+typedef struct ProtoPirateBatchDecode ProtoPirateBatchDecode;
+
+ProtoPirateBatchDecode* protopirate_batch_decode_alloc(SubGhzEnvironment* environment);
+void protopirate_batch_decode_free(ProtoPirateBatchDecode* batch);
+
+// Opens the folder and the CSV named after it, replacing an older CSV of the same folder.
+// False when either can't be opened, nothing is left open then.
+bool protopirate_batch_decode_start(
+    ProtoPirateBatchDecode* batch,
+    Storage* storage,
+    const char* folder,
+    FuriString* out_path);
+
+// Streams one chunk of the current file, or moves on to the next file. False once every
+// file in the tree was decoded.
+bool protopirate_batch_decode_step(ProtoPirateBatchDecode* batch);
+
+// Appends the totals, closes the CSV and the folder. Also ends a batch cut short.
+// False when any row could not be written.
+bool protopirate_batch_decode_finish(ProtoPirateBatchDecode* batch);
+
+void protopirate_batch_decode_get_stats(
+    const ProtoPirateBatchDecode* batch,
+    ProtoPirateBatchDecodeStats* stats);
+
+// Percentage of the current file decoded
+uint8_t protopirate_batch_decode_get_progress(const ProtoPirateBatchDecode* batch);
@@ -0,0 +1,308 @@
+// helpers/protopirate_capture_index.c
+#include "protopirate_capture_index.h"
+#include "protopirate_storage.h"
+#include "../protocols/protocol_items.h"
+#include <toolbox/stream/file_stream.h>
+#include <stdlib.h>
+
+#define TAG "ProtoPirateCaptureIndex"
+
+#define CAPTURE_INDEX_PATH    PROTOPIRATE_APP_FOLDER "/.index"
+#define CAPTURE_INDEX_MAGIC   0x58495050 // "PPIX"
+#define CAPTURE_INDEX_VERSION 2 // 2: protocol by name instead of registry index
+
+// Records moved per read/write while closing the gap left by a removal
+#define CAPTURE_INDEX_SHIFT_RECORDS 16
+
+// Lines read from a capture while rebuilding, the interesting keys come first
+#define CAPTURE_SCAN_MAX_LINES 24
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+} ProtoPirateCaptureIndexHeader;
+
+_Static_assert(sizeof(ProtoPirateCaptureRecord) == 96, "Capture record layout changed");
+
+static uint32_t capture_index_offset(uint32_t position) {
+    return sizeof(ProtoPirateCaptureIndexHeader) + position * sizeof(ProtoPirateCaptureRecord);
+}
+
+// Opens the manifest and checks its header, count receives the number of records
+static bool capture_index_open(File* file, FS_AccessMode access, uint32_t* count) {
+    if(!storage_file_open(file, CAPTURE_INDEX_PATH, access, FSOM_OPEN_EXISTING)) return false;
+
+    ProtoPirateCaptureIndexHeader header;
+    uint64_t size = storage_file_size(file);
+    bool valid = size >= sizeof(header) &&
+                 storage_file_read(file, &header, sizeof(header)) == sizeof(header) &&
+                 header.magic == CAPTURE_INDEX_MAGIC && header.version == CAPTURE_INDEX_VERSION &&
+                 header.record_size == sizeof(ProtoPirateCaptureRecord) &&
+                 (size - sizeof(header)) % sizeof(ProtoPirateCaptureRecord) == 0;
+
+    if(!valid) {
+        FURI_LOG_W(TAG, "Manifest invalid");
+        storage_file_close(file);
+        return false;
+    }
+
+    *count = (size - sizeof(header)) / sizeof(ProtoPirateCaptureRecord);
+    return true;
+}
+
+// Same as capture_index_open, rebuilding the manifest once if it is missing or stale
+static bool capture_index_open_or_rebuild(
+    Storage* storage,
+    File* file,
+    FS_AccessMode access,
+    uint32_t* count) {
+    if(capture_index_open(file, access, count)) return true;
+    if(!protopirate_capture_index_rebuild(storage)) return false;
+    return capture_index_open(file, access, count);
+}
+
+void protopirate_capture_index_scan_line(ProtoPirateCaptureRecord* record, FuriString* line) {
+    const char* text = furi_string_get_cstr(line);
+    const char* value = strchr(text, ':');
+    if(!value) return;
+    value++;
+    while(*value == ' ')
+        value++;
+
+    if(furi_string_start_with_str(line, "Protocol:")) {
+        char name[32];
+        size_t len = 0;
+        while(value[len] && value[len] != '\r' && value[len] != '\n' && len < sizeof(name) - 1) {
+            name[len] = value[len];
+            len++;
+        }
+        name[len] = '\0';
+
+        const ProtoPirateProtocolInfo* info = protopirate_protocol_find_info(name);
+        snprintf(
+            record->protocol,
+            sizeof(record->protocol),
+            "%s",
+            info ? info->protocol->name : name);
+    } else if(furi_string_start_with_str(line, "Serial:")) {
+        record->serial = strtoul(value, NULL, 10);
+        record->flags |= PROTOPIRATE_CAPTURE_HAS_SERIAL;
+    } else if(furi_string_start_with_str(line, "Btn:")) {
+        record->button = (uint8_t)strtoul(value, NULL, 10);
+        record->flags |= PROTOPIRATE_CAPTURE_HAS_BUTTON;
+    }
+}
+
+// Builds a record for a file already in the capture folder
+static bool capture_index_scan_file(
+    Storage* storage,
+    const char* file_name,
+    const FileInfo* file_info,
+    ProtoPirateCaptureRecord* record) {
+    const char* ext = strstr(file_name, PROTOPIRATE_APP_EXTENSION);
+    size_t name_len = ext - file_name;
+    if(name_len >= PROTOPIRATE_CAPTURE_NAME_SIZE) {
+        FURI_LOG_W(TAG, "Name too long, not indexed: %s", file_name);
+        return false;
+    }
+
+    memset(record, 0, sizeof(*record));
+    memcpy(record->name, file_name, name_len);
+    record->size = (uint32_t)file_info->size;
+
+    FuriString* path = furi_string_alloc_printf("%s/%s", PROTOPIRATE_APP_FOLDER, file_name);
+    storage_common_timestamp(storage, furi_string_get_cstr(path), &record->mtime);
+
+    Stream* stream = file_stream_alloc(storage);
+    if(file_stream_open(stream, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+        FuriString* line = furi_string_alloc();
+        for(size_t i = 0; i < CAPTURE_SCAN_MAX_LINES && stream_read_line(stream, line); i++) {
+            if(furi_string_start_with_str(line, "RAW_Data:")) break;
+            protopirate_capture_index_scan_line(record, line);
+        }
+        furi_string_free(line);
+    }
+    file_stream_close(stream);
+    stream_free(stream);
+
+    furi_string_free(path);
+    return true;
+}
+
+bool protopirate_capture_index_rebuild(Storage* storage) {
+    File* index = storage_file_alloc(storage);
+    File* dir = storage_file_alloc(storage);
+    uint32_t count = 0;
+    bool result = false;
+
+    do {
+        if(!storage_file_open(index, CAPTURE_INDEX_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            FURI_LOG_E(TAG, "Failed to create manifest");
+            break;
+        }
+
+        ProtoPirateCaptureIndexHeader header = {
+            .magic = CAPTURE_INDEX_MAGIC,
+            .version = CAPTURE_INDEX_VERSION,
+            .record_size = sizeof(ProtoPirateCaptureRecord),
+        };
+        if(storage_file_write(index, &header, sizeof(header)) != sizeof(header)) break;
+
+        result = true;
+        if(!storage_dir_open(dir, PROTOPIRATE_APP_FOLDER)) break;
+
+        // Directory order is save order on FAT, which is the order the manifest keeps
+        FileInfo file_info;
+        ProtoPirateCaptureRecord record;
+        char name[256];
+        while(storage_dir_read(dir, &file_info, name, sizeof(name))) {
+            if(file_info_is_dir(&file_info) || !strstr(name, PROTOPIRATE_APP_EXTENSION)) continue;
+            if(!capture_index_scan_file(storage, name, &file_info, &record)) continue;
+
+            if(storage_file_write(index, &record, sizeof(record)) != sizeof(record)) {
+                result = false;
+                break;
+            }
+            count++;
+        }
+        storage_dir_close(dir);
+    } while(false);
+
+    storage_file_free(dir);
+    storage_file_close(index);
+    storage_file_free(index);
+
+    if(result) {
+        FURI_LOG_I(TAG, "Rebuilt manifest with %lu captures", count);
+    } else {
+        storage_simply_remove(storage, CAPTURE_INDEX_PATH);
+    }
+    return result;
+}
+
+uint32_t protopirate_capture_index_count(Storage* storage) {
+    File* file = storage_file_alloc(storage);
+    uint32_t count = 0;
+
+    if(capture_index_open_or_rebuild(storage, file, FSAM_READ, &count)) {
+        storage_file_close(file);
+    }
+
+    storage_file_free(file);
+    return count;
+}
+
+size_t protopirate_capture_index_read_page(
+    Storage* storage,
+    uint32_t index,
+    ProtoPirateCaptureRecord* records,
+    size_t max) {
+    File* file = storage_file_alloc(storage);
+    uint32_t count = 0;
+    size_t read = 0;
+
+    if(capture_index_open_or_rebuild(storage, file, FSAM_READ, &count)) {
+        if(index < count) {
+            // Newest first: the page is a contiguous run of records read backwards
+            size_t wanted = MIN(max, (size_t)(count - index));
+            uint32_t first = count - index - wanted;
+            size_t bytes = wanted * sizeof(ProtoPirateCaptureRecord);
+
+            if(storage_file_seek(file, capture_index_offset(first), true) &&
+               storage_file_read(file, records, bytes) == bytes) {
+                for(size_t i = 0; i < wanted / 2; i++) {
+                    ProtoPirateCaptureRecord temp = records[i];
+                    records[i] = records[wanted - 1 - i];
+                    records[wanted - 1 - i] = temp;
+                }
+                read = wanted;
+            }
+        }
+        storage_file_close(file);
+    }
+
+    storage_file_free(file);
+    return read;
+}
+
+bool protopirate_capture_index_append(Storage* storage, const ProtoPirateCaptureRecord* record) {
+    File* file = storage_file_alloc(storage);
+    uint32_t count = 0;
+    bool result = false;
+
+    if(capture_index_open(file, FSAM_READ_WRITE, &count)) {
+        result = storage_file_seek(file, capture_index_offset(count), true) &&
+                 storage_file_write(file, record, sizeof(*record)) == sizeof(*record);
+        storage_file_close(file);
+    } else {
+        // The rebuild scans the folder, which already holds the new capture
+        result = protopirate_capture_index_rebuild(storage);
+    }
+
+    storage_file_free(file);
+    return result;
+}
+
+bool protopirate_capture_index_remove(Storage* storage, const char* name) {
+    File* file = storage_file_alloc(storage);
+    uint32_t count = 0;
+
+    if(!capture_index_open(file, FSAM_READ_WRITE, &count)) {
+        // Nothing to update, the next read builds the manifest from the folder
+        storage_file_free(file);
+        return false;
+    }
+
+    ProtoPirateCaptureRecord* buffer =
+        malloc(sizeof(ProtoPirateCaptureRecord) * CAPTURE_INDEX_SHIFT_RECORDS);
+    bool result = false;
+
+    do {
+
+        // Find the record, a chunk at a time
+        uint32_t found = count;
+        for(uint32_t position = 0; position < count && found == count;) {
+            size_t chunk = MIN(count - position, (uint32_t)CAPTURE_INDEX_SHIFT_RECORDS);
+            size_t bytes = chunk * sizeof(ProtoPirateCaptureRecord);
+            if(storage_file_read(file, buffer, bytes) != bytes) break;
+            for(size_t i = 0; i < chunk; i++) {
+                if(strncmp(buffer[i].name, name, PROTOPIRATE_CAPTURE_NAME_SIZE) == 0) {
+                    found = position + i;
+                    break;
+                }
+            }
+            position += chunk;
+        }
+        if(found == count) break;
+
+        // Move the newer records down one slot to keep the manifest dense and ordered
+        bool moved = true;
+        for(uint32_t position = found + 1; position < count;) {
+            size_t chunk = MIN(count - position, (uint32_t)CAPTURE_INDEX_SHIFT_RECORDS);
+            size_t bytes = chunk * sizeof(ProtoPirateCaptureRecord);
+            if(!storage_file_seek(file, capture_index_offset(position), true) ||
+               storage_file_read(file, buffer, bytes) != bytes ||
+               !storage_file_seek(file, capture_index_offset(position - 1), true) ||
+               storage_file_write(file, buffer, bytes) != bytes) {
+                moved = false;
+                break;
+            }
+            position += chunk;
+        }
+        if(!moved) break;
+
+        result = storage_file_seek(file, capture_index_offset(count - 1), true) &&
+                 storage_file_truncate(file);
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    free(buffer);
+
+    // Missing entry or a half-shifted manifest: drop it, the next read rebuilds it
+    if(!result) {
+        storage_simply_remove(storage, CAPTURE_INDEX_PATH);
+    }
+    return result;
+}
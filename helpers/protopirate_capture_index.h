@@ -0,0 +1,47 @@
+// helpers/protopirate_capture_index.h
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+
+#define PROTOPIRATE_CAPTURE_NAME_SIZE     64
+#define PROTOPIRATE_CAPTURE_PROTOCOL_SIZE 16
+
+#define PROTOPIRATE_CAPTURE_HAS_SERIAL (1 << 0)
+#define PROTOPIRATE_CAPTURE_HAS_BUTTON (1 << 1)
+
+// One saved capture as stored in the on-SD manifest (fixed size, oldest first)
+typedef struct {
+    char name[PROTOPIRATE_CAPTURE_NAME_SIZE]; // File name without extension
+    uint32_t size;
+    uint32_t mtime;
+    uint32_t serial;
+    // Registry name, or the file's own when it is not one. Empty if the file names none.
+    // A name rather than a registry index, so the manifest survives the registry changing.
+    char protocol[PROTOPIRATE_CAPTURE_PROTOCOL_SIZE];
+    uint8_t button;
+    uint8_t flags;
+    uint8_t reserved[2];
+} ProtoPirateCaptureRecord;
+
+// Number of captures in the manifest, building it from the folder if it is missing
+uint32_t protopirate_capture_index_count(Storage* storage);
+
+// Reads up to max records starting at index, newest first. Returns how many were read.
+size_t protopirate_capture_index_read_page(
+    Storage* storage,
+    uint32_t index,
+    ProtoPirateCaptureRecord* records,
+    size_t max);
+
+// Appends a newly saved capture
+bool protopirate_capture_index_append(Storage* storage, const ProtoPirateCaptureRecord* record);
+
+// Removes the capture with this name (no extension)
+bool protopirate_capture_index_remove(Storage* storage, const char* name);
+
+// Drops the manifest and recreates it from the capture folder
+bool protopirate_capture_index_rebuild(Storage* storage);
+
+// Fills protocol, serial and button from one "Key: value" line of a capture
+void protopirate_capture_index_scan_line(ProtoPirateCaptureRecord* record, FuriString* line);
@@ -0,0 +1,68 @@
+// helpers/protopirate_decode_queue.c
+#include "protopirate_decode_queue.h"
+#include <stdatomic.h>
+
+_Static_assert(
+    (PROTOPIRATE_DECODE_QUEUE_SIZE & (PROTOPIRATE_DECODE_QUEUE_SIZE - 1)) == 0,
+    "Queue size must be a power of 2");
+
+// head and tail run freely and are masked on access, so full and empty differ
+struct ProtoPirateDecodeQueue {
+    ProtoPirateDecodeEvent events[PROTOPIRATE_DECODE_QUEUE_SIZE];
+    atomic_uint head; // Written by the consumer
+    atomic_uint tail; // Written by the producer
+    atomic_uint dropped;
+};
+
+ProtoPirateDecodeQueue* protopirate_decode_queue_alloc(void) {
+    ProtoPirateDecodeQueue* queue = malloc(sizeof(ProtoPirateDecodeQueue));
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+    atomic_init(&queue->dropped, 0);
+    return queue;
+}
+
+void protopirate_decode_queue_free(ProtoPirateDecodeQueue* queue) {
+    furi_assert(queue);
+    free(queue);
+}
+
+void protopirate_decode_queue_reset(ProtoPirateDecodeQueue* queue) {
+    furi_assert(queue);
+    unsigned tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    atomic_store_explicit(&queue->head, tail, memory_order_release);
+    atomic_store_explicit(&queue->dropped, 0, memory_order_relaxed);
+}
+
+bool protopirate_decode_queue_push(
+    ProtoPirateDecodeQueue* queue,
+    const ProtoPirateDecodeEvent* event,
+    bool* was_empty) {
+    unsigned tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&queue->head, memory_order_acquire);
+
+    if(was_empty) *was_empty = (tail == head);
+    if(tail - head >= PROTOPIRATE_DECODE_QUEUE_SIZE) {
+        atomic_fetch_add_explicit(&queue->dropped, 1, memory_order_relaxed);
+        return false;
+    }
+
+    queue->events[tail & (PROTOPIRATE_DECODE_QUEUE_SIZE - 1)] = *event;
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+bool protopirate_decode_queue_pop(ProtoPirateDecodeQueue* queue, ProtoPirateDecodeEvent* event) {
+    unsigned head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+
+    if(head == tail) return false;
+
+    *event = queue->events[head & (PROTOPIRATE_DECODE_QUEUE_SIZE - 1)];
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return true;
+}
+
+uint32_t protopirate_decode_queue_take_dropped(ProtoPirateDecodeQueue* queue) {
+    return atomic_exchange_explicit(&queue->dropped, 0, memory_order_relaxed);
+}
@@ -0,0 +1,34 @@
+// helpers/protopirate_decode_queue.h
+#pragma once
+
+#include <furi.h>
+
+#define PROTOPIRATE_DECODE_QUEUE_SIZE 16
+
+// A decode that made it into history, everything else is read back from there
+typedef struct {
+    uint16_t history_id; // protopirate_history_get_last_index() right after the add
+    uint8_t protocol; // Registry index
+} ProtoPirateDecodeEvent;
+
+// Lock-free single producer (decoder callback) / single consumer (GUI thread) queue
+typedef struct ProtoPirateDecodeQueue ProtoPirateDecodeQueue;
+
+ProtoPirateDecodeQueue* protopirate_decode_queue_alloc(void);
+void protopirate_decode_queue_free(ProtoPirateDecodeQueue* queue);
+
+// Consumer side only, drops whatever is pending
+void protopirate_decode_queue_reset(ProtoPirateDecodeQueue* queue);
+
+// Producer side. Returns false when full, the event is counted as dropped.
+// was_empty tells the producer the consumer may be idle and needs waking.
+bool protopirate_decode_queue_push(
+    ProtoPirateDecodeQueue* queue,
+    const ProtoPirateDecodeEvent* event,
+    bool* was_empty);
+
+// Consumer side, false when nothing is pending
+bool protopirate_decode_queue_pop(ProtoPirateDecodeQueue* queue, ProtoPirateDecodeEvent* event);
+
+// Events dropped since the last call, consumer side
+uint32_t protopirate_decode_queue_take_dropped(ProtoPirateDecodeQueue* queue);
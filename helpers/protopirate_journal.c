@@ -0,0 +1,438 @@
+// helpers/protopirate_journal.c
+#include "protopirate_journal.h"
+#include "../protocols/protocol_items.h"
+#include <toolbox/stream/stream.h>
+#include <furi_hal_rtc.h>
+
+#define TAG "ProtoPirateJournal"
+
+#define JOURNAL_MAGIC   0x4A505050 // "PPPJ"
+#define JOURNAL_VERSION 2
+
+// What a journal that fails its header check is renamed to, out of the export's way
+#define JOURNAL_INVALID_EXTENSION ".bad"
+
+// Records per buffer, one buffer fills while the other is written
+#define JOURNAL_BUFFER_RECORDS 16
+// File space reserved at a time, so the card is not asked to grow it per write
+#define JOURNAL_PREALLOC_RECORDS 512
+// A partly filled buffer is written once its oldest record has waited this long
+#define JOURNAL_FLUSH_MS 5000
+
+#define JOURNAL_WRITER_STACK 1024
+
+// Sessions started within the same second get a _1, _2... suffix, up to this many
+#define JOURNAL_NAME_ATTEMPTS 100
+
+#define JOURNAL_FLAG_WRITE (1 << 0)
+#define JOURNAL_FLAG_STOP  (1 << 1)
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t created; // RTC seconds
+    uint32_t exported; // Records an export that stopped early already saved, they are skipped
+} ProtoPirateJournalHeader;
+
+typedef enum {
+    ProtoPirateJournalExportDone,
+    ProtoPirateJournalExportInvalid, // Not a journal, or written before its header was
+    ProtoPirateJournalExportIncomplete, // Stopped early, kept for another try
+} ProtoPirateJournalExport;
+
+// Pre-allocated space holds whatever the card had there, so a record only counts when
+// its sequence number follows the previous one and its check matches
+typedef struct {
+    uint32_t sequence;
+    uint32_t check;
+    ProtoPirateCapture capture;
+} ProtoPirateJournalRecord;
+
+struct ProtoPirateJournal {
+    Storage* storage;
+    File* file;
+    FuriString* path;
+    FuriThread* writer;
+    FuriSemaphore* writer_idle;
+
+    ProtoPirateJournalRecord buffers[2][JOURNAL_BUFFER_RECORDS];
+    uint8_t active; // Buffer being filled
+    size_t fill;
+    uint32_t fill_tick; // When the active buffer got its first record
+    uint32_t sequence;
+
+    // Owned by the writer while it runs
+    uint8_t pending;
+    size_t pending_count;
+    uint32_t written;
+    uint32_t allocated;
+    bool failed;
+};
+
+static uint32_t protopirate_journal_check(const ProtoPirateJournalRecord* record) {
+    // FNV-1a over the sequence number and the capture, padding included: append zeroes it
+    uint32_t hash = 2166136261u;
+    const uint8_t* bytes = (const uint8_t*)&record->capture;
+    for(size_t i = 0; i < sizeof(record->sequence); i++) {
+        hash = (hash ^ ((record->sequence >> (i * 8)) & 0xFF)) * 16777619u;
+    }
+    for(size_t i = 0; i < sizeof(record->capture); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static uint64_t protopirate_journal_offset(uint32_t records) {
+    return sizeof(ProtoPirateJournalHeader) + (uint64_t)records * sizeof(ProtoPirateJournalRecord);
+}
+
+static void protopirate_journal_write_pending(ProtoPirateJournal* journal) {
+    size_t bytes = journal->pending_count * sizeof(ProtoPirateJournalRecord);
+
+    do {
+        if(journal->failed) break;
+
+        uint32_t needed = journal->written + journal->pending_count;
+        if(needed > journal->allocated) {
+            uint32_t allocated = journal->allocated + JOURNAL_PREALLOC_RECORDS;
+            if(storage_file_expand(journal->file, protopirate_journal_offset(allocated))) {
+                journal->allocated = allocated;
+            } else {
+                // Not fatal, the file just grows with each write instead
+                journal->allocated = needed;
+            }
+        }
+
+        if(!storage_file_seek(journal->file, protopirate_journal_offset(journal->written), true) ||
+           storage_file_write(journal->file, journal->buffers[journal->pending], bytes) != bytes) {
+            FURI_LOG_E(TAG, "Write failed, journal stops here");
+            journal->failed = true;
+            break;
+        }
+
+        journal->written += journal->pending_count;
+    } while(false);
+
+    journal->pending_count = 0;
+}
+
+static int32_t protopirate_journal_writer(void* context) {
+    ProtoPirateJournal* journal = context;
+
+    while(true) {
+        uint32_t flags = furi_thread_flags_wait(
+            JOURNAL_FLAG_WRITE | JOURNAL_FLAG_STOP, FuriFlagWaitAny, FuriWaitForever);
+        if(flags & FuriFlagError) continue;
+
+        if(flags & JOURNAL_FLAG_WRITE) {
+            protopirate_journal_write_pending(journal);
+            furi_semaphore_release(journal->writer_idle);
+        }
+        if(flags & JOURNAL_FLAG_STOP) break;
+    }
+
+    return 0;
+}
+
+// Hands the active buffer to the writer. Returns false if the writer was still busy
+// with the other buffer after waiting timeout.
+static bool protopirate_journal_flush(ProtoPirateJournal* journal, uint32_t timeout) {
+    if(journal->fill == 0) return true;
+    if(furi_semaphore_acquire(journal->writer_idle, timeout) != FuriStatusOk) return false;
+
+    journal->pending = journal->active;
+    journal->pending_count = journal->fill;
+    journal->active ^= 1;
+    journal->fill = 0;
+
+    furi_thread_flags_set(furi_thread_get_id(journal->writer), JOURNAL_FLAG_WRITE);
+    return true;
+}
+
+// Creates the journal under a name no other journal has, false if none could be created
+static bool protopirate_journal_create(ProtoPirateJournal* journal) {
+    DateTime datetime;
+    furi_hal_rtc_get_datetime(&datetime);
+
+    for(uint32_t attempt = 0; attempt < JOURNAL_NAME_ATTEMPTS; attempt++) {
+        furi_string_printf(
+            journal->path,
+            "%s/%04u%02u%02u_%02u%02u%02u",
+            PROTOPIRATE_JOURNAL_FOLDER,
+            datetime.year,
+            datetime.month,
+            datetime.day,
+            datetime.hour,
+            datetime.minute,
+            datetime.second);
+        if(attempt > 0) furi_string_cat_printf(journal->path, "_%lu", attempt);
+        furi_string_cat_str(journal->path, PROTOPIRATE_JOURNAL_EXTENSION);
+
+        if(storage_file_open(
+               journal->file, furi_string_get_cstr(journal->path), FSAM_WRITE, FSOM_CREATE_NEW)) {
+            return true;
+        }
+        storage_file_close(journal->file);
+        if(storage_file_get_error(journal->file) != FSE_EXIST) break;
+    }
+
+    return false;
+}
+
+ProtoPirateJournal* protopirate_journal_open(void) {
+    ProtoPirateJournal* journal = malloc(sizeof(ProtoPirateJournal));
+    memset(journal, 0, sizeof(ProtoPirateJournal));
+
+    journal->storage = furi_record_open(RECORD_STORAGE);
+    journal->file = storage_file_alloc(journal->storage);
+    journal->path = furi_string_alloc();
+
+    ProtoPirateJournalHeader header = {
+        .magic = JOURNAL_MAGIC,
+        .version = JOURNAL_VERSION,
+        .record_size = sizeof(ProtoPirateJournalRecord),
+        .created = furi_hal_rtc_get_timestamp(),
+    };
+
+    storage_simply_mkdir(journal->storage, PROTOPIRATE_APP_FOLDER);
+    storage_simply_mkdir(journal->storage, PROTOPIRATE_JOURNAL_FOLDER);
+    if(!protopirate_journal_create(journal) ||
+       storage_file_write(journal->file, &header, sizeof(header)) != sizeof(header)) {
+        FURI_LOG_E(TAG, "Failed to create %s", furi_string_get_cstr(journal->path));
+        journal->failed = true;
+    } else {
+        FURI_LOG_I(TAG, "Journal %s", furi_string_get_cstr(journal->path));
+    }
+
+    journal->writer_idle = furi_semaphore_alloc(1, 1);
+    journal->writer = furi_thread_alloc_ex(
+        "ProtoPirateJournal", JOURNAL_WRITER_STACK, protopirate_journal_writer, journal);
+    furi_thread_start(journal->writer);
+
+    return journal;
+}
+
+void protopirate_journal_close(ProtoPirateJournal* journal) {
+    furi_assert(journal);
+
+    // Last buffer, then wait for the writer to finish it before stopping it
+    protopirate_journal_flush(journal, FuriWaitForever);
+    furi_semaphore_acquire(journal->writer_idle, FuriWaitForever);
+    furi_thread_flags_set(furi_thread_get_id(journal->writer), JOURNAL_FLAG_STOP);
+    furi_thread_join(journal->writer);
+    furi_thread_free(journal->writer);
+    furi_semaphore_free(journal->writer_idle);
+
+    if(storage_file_is_open(journal->file)) {
+        // Drop the unused pre-allocated tail
+        storage_file_seek(journal->file, protopirate_journal_offset(journal->written), true);
+        storage_file_truncate(journal->file);
+        storage_file_close(journal->file);
+    }
+    storage_file_free(journal->file);
+
+    if(journal->written == 0) {
+        storage_simply_remove(journal->storage, furi_string_get_cstr(journal->path));
+    } else {
+        FURI_LOG_I(TAG, "Closed journal with %lu captures", journal->written);
+    }
+
+    furi_string_free(journal->path);
+    furi_record_close(RECORD_STORAGE);
+    free(journal);
+}
+
+void protopirate_journal_append(ProtoPirateJournal* journal, const ProtoPirateCapture* capture) {
+    furi_assert(journal);
+    furi_assert(capture);
+
+    if(journal->fill == JOURNAL_BUFFER_RECORDS) {
+        protopirate_journal_flush(journal, FuriWaitForever);
+    }
+
+    // Field by field into a zeroed record, the check covers the padding between them
+    ProtoPirateJournalRecord* record = &journal->buffers[journal->active][journal->fill];
+    memset(record, 0, sizeof(ProtoPirateJournalRecord));
+    record->sequence = journal->sequence++;
+    record->capture.key = capture->key;
+    record->capture.frequency = capture->frequency;
+    record->capture.timestamp = capture->timestamp;
+    memcpy(record->capture.extra, capture->extra, sizeof(capture->extra));
+    memcpy(record->capture.extra_key, capture->extra_key, sizeof(capture->extra_key));
+    record->capture.extra_count = capture->extra_count;
+    record->capture.protocol = capture->protocol;
+    record->capture.bits = capture->bits;
+    record->capture.key_format = capture->key_format;
+    snprintf(record->capture.preset, sizeof(record->capture.preset), "%s", capture->preset);
+    record->check = protopirate_journal_check(record);
+
+    if(journal->fill++ == 0) {
+        journal->fill_tick = furi_get_tick();
+    }
+
+    // Start writing a full buffer right away if the writer is free
+    if(journal->fill == JOURNAL_BUFFER_RECORDS) {
+        protopirate_journal_flush(journal, 0);
+    }
+}
+
+void protopirate_journal_tick(ProtoPirateJournal* journal) {
+    furi_assert(journal);
+    if(journal->fill > 0 && furi_get_tick() - journal->fill_tick >= JOURNAL_FLUSH_MS) {
+        protopirate_journal_flush(journal, 0);
+    }
+}
+
+uint32_t protopirate_journal_count_files(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* dir = storage_file_alloc(storage);
+    uint32_t count = 0;
+
+    if(storage_dir_open(dir, PROTOPIRATE_JOURNAL_FOLDER)) {
+        FileInfo file_info;
+        char name[64];
+        while(storage_dir_read(dir, &file_info, name, sizeof(name))) {
+            if(!file_info_is_dir(&file_info) && strstr(name, PROTOPIRATE_JOURNAL_EXTENSION)) {
+                count++;
+            }
+        }
+    }
+    storage_dir_close(dir);
+
+    storage_file_free(dir);
+    furi_record_close(RECORD_STORAGE);
+    return count;
+}
+
+// Writes one .sub per valid record not exported before. On a failed save the journal
+// remembers where it stopped, so another try does not save the same captures twice.
+static ProtoPirateJournalExport
+    protopirate_journal_export_file(Storage* storage, const char* path, uint32_t* count) {
+    File* file = storage_file_alloc(storage);
+    FlipperFormat* ff = flipper_format_string_alloc();
+    ProtoPirateJournalExport result = ProtoPirateJournalExportIncomplete;
+
+    do {
+        if(!storage_file_open(file, path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING)) break;
+
+        ProtoPirateJournalHeader header;
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header) ||
+           header.magic != JOURNAL_MAGIC || header.version != JOURNAL_VERSION ||
+           header.record_size != sizeof(ProtoPirateJournalRecord)) {
+            FURI_LOG_W(TAG, "Not a journal: %s", path);
+            result = ProtoPirateJournalExportInvalid;
+            break;
+        }
+
+        result = ProtoPirateJournalExportDone;
+        ProtoPirateJournalRecord record;
+        for(uint32_t sequence = 0;
+            storage_file_read(file, &record, sizeof(record)) == sizeof(record);
+            sequence++) {
+            // A crash leaves the tail untrimmed, the records end at the first mismatch
+            if(record.sequence != sequence || record.check != protopirate_journal_check(&record)) {
+                break;
+            }
+            if(sequence < header.exported) continue;
+
+            const ProtoPirateProtocolInfo* info =
+                protopirate_protocol_get_info(record.capture.protocol);
+            stream_clean(flipper_format_get_raw_stream(ff));
+            if(!info || !protopirate_history_write_capture(&record.capture, ff)) {
+                FURI_LOG_W(TAG, "Skipping unreadable record %lu", sequence);
+                continue;
+            }
+
+            if(!protopirate_storage_save_capture(ff, info->protocol->name, NULL)) {
+                header.exported = sequence;
+                if(!storage_file_seek(file, offsetof(ProtoPirateJournalHeader, exported), true) ||
+                   storage_file_write(file, &header.exported, sizeof(header.exported)) !=
+                       sizeof(header.exported)) {
+                    FURI_LOG_E(TAG, "Could not note progress, a retry saves duplicates");
+                }
+                result = ProtoPirateJournalExportIncomplete;
+                break;
+            }
+            (*count)++;
+        }
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    flipper_format_free(ff);
+    return result;
+}
+
+// Swaps the journal extension for the invalid one, false if the file keeps its name
+static bool protopirate_journal_set_aside(Storage* storage, FuriString* path) {
+    FuriString* bad_path = furi_string_alloc_set(path);
+    size_t ext = furi_string_search_str(bad_path, PROTOPIRATE_JOURNAL_EXTENSION);
+    bool result = false;
+
+    if(ext != FURI_STRING_FAILURE) {
+        furi_string_left(bad_path, ext);
+        furi_string_cat_str(bad_path, JOURNAL_INVALID_EXTENSION);
+        // Only a journal of the same name, set aside before, can be in the way
+        storage_simply_remove(storage, furi_string_get_cstr(bad_path));
+        result = storage_common_rename(
+                     storage, furi_string_get_cstr(path), furi_string_get_cstr(bad_path)) ==
+                 FSE_OK;
+    }
+    if(result) {
+        FURI_LOG_W(TAG, "Set aside as %s", furi_string_get_cstr(bad_path));
+    }
+
+    furi_string_free(bad_path);
+    return result;
+}
+
+uint32_t protopirate_journal_export_all(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* dir = storage_file_alloc(storage);
+    FuriString* path = furi_string_alloc();
+    uint32_t count = 0;
+
+    // Removing entries while reading the directory is not safe, so take one at a time.
+    // Every pass removes or renames the journal it took, or stops.
+    bool found = true;
+    while(found) {
+        found = false;
+        if(storage_dir_open(dir, PROTOPIRATE_JOURNAL_FOLDER)) {
+            FileInfo file_info;
+            char name[64];
+            while(storage_dir_read(dir, &file_info, name, sizeof(name))) {
+                if(!file_info_is_dir(&file_info) && strstr(name, PROTOPIRATE_JOURNAL_EXTENSION)) {
+                    furi_string_printf(path, "%s/%s", PROTOPIRATE_JOURNAL_FOLDER, name);
+                    found = true;
+                    break;
+                }
+            }
+        }
+        storage_dir_close(dir);
+        if(!found) break;
+
+        const char* journal_path = furi_string_get_cstr(path);
+        ProtoPirateJournalExport result =
+            protopirate_journal_export_file(storage, journal_path, &count);
+        if(result == ProtoPirateJournalExportDone) {
+            storage_simply_remove(storage, journal_path);
+        } else if(result == ProtoPirateJournalExportInvalid) {
+            // Kept for a look, but it must not block the journals after it
+            if(!protopirate_journal_set_aside(storage, path)) {
+                FURI_LOG_E(TAG, "Could not set %s aside", journal_path);
+                break;
+            }
+        } else {
+            // Keep it for another try, but stop so it is not picked again forever
+            FURI_LOG_E(TAG, "Export of %s incomplete", journal_path);
+            break;
+        }
+    }
+
+    FURI_LOG_I(TAG, "Exported %lu captures", count);
+    furi_string_free(path);
+    storage_file_free(dir);
+    furi_record_close(RECORD_STORAGE);
+    return count;
+}
@@ -0,0 +1,36 @@
+// helpers/protopirate_journal.h
+#pragma once
+
+#include <furi.h>
+#include "protopirate_storage.h"
+#include "../protopirate_history.h"
+
+#define PROTOPIRATE_JOURNAL_FOLDER    PROTOPIRATE_APP_FOLDER "/journal"
+#define PROTOPIRATE_JOURNAL_EXTENSION ".ppj"
+
+// Auto-save session journal: captures are appended as fixed-size records to one
+// pre-allocated file, written in the background, and expanded into .sub files later
+typedef struct ProtoPirateJournal ProtoPirateJournal;
+
+// Creates a new journal file named after the current time and starts its writer. A name
+// another journal already has gets a numbered suffix, journals are never overwritten.
+ProtoPirateJournal* protopirate_journal_open(void);
+
+// Writes what is buffered, trims the pre-allocated tail and closes the file.
+// A journal that never got a record is removed.
+void protopirate_journal_close(ProtoPirateJournal* journal);
+
+// Buffers a capture. Only waits when both buffers are full and the writer is busy.
+void protopirate_journal_append(ProtoPirateJournal* journal, const ProtoPirateCapture* capture);
+
+// Hands a partly filled buffer to the writer once it has waited long enough, call
+// this periodically so a quiet session still reaches the card
+void protopirate_journal_tick(ProtoPirateJournal* journal);
+
+// Number of journal files waiting to be exported
+uint32_t protopirate_journal_count_files(void);
+
+// Expands every journal into .sub captures and removes the journals that were fully
+// exported. Files that are not journals are renamed to .bad and skipped. Returns the
+// number of captures written.
+uint32_t protopirate_journal_export_all(void);
@@ -0,0 +1,231 @@
+// helpers/protopirate_pulse_ring.c
+#include "protopirate_pulse_ring.h"
+#include <stdatomic.h>
+
+#define TAG "ProtoPiratePulseRing"
+
+#define PULSE_RING_THREAD_STACK 2048
+
+#define PULSE_RING_FLAG_DATA (1 << 0)
+#define PULSE_RING_FLAG_STOP (1 << 1)
+
+// A pulse packs its level into the top bit, the reset marker is a value no pulse can have
+#define PULSE_LEVEL_BIT    (1UL << 31)
+#define PULSE_DURATION_MAX (PULSE_LEVEL_BIT - 2)
+#define PULSE_RESET_MARKER UINT32_MAX
+
+// head and tail run freely and are masked on access, so full and empty differ
+struct ProtoPiratePulseRing {
+    uint32_t* pulses;
+    uint32_t mask;
+    atomic_uint head; // Written by the consumer
+    atomic_uint tail; // Written by the producer
+
+    // Producer only: pulses were dropped, a reset marker goes in before the next one
+    bool gap;
+
+    atomic_uint pushed;
+    atomic_uint dropped;
+    atomic_uint overruns;
+    atomic_uint worker_overruns;
+    atomic_uint high_water;
+
+    FuriThread* thread;
+    FuriMutex* callback_mutex; // Held while a batch is decoded
+    SubGhzWorkerPairCallback pair_callback;
+    SubGhzWorkerOverrunCallback reset_callback;
+    void* context;
+};
+
+static void protopirate_pulse_ring_decode(ProtoPiratePulseRing* ring) {
+    furi_mutex_acquire(ring->callback_mutex, FuriWaitForever);
+
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    while(true) {
+        // Pairs with the producer's wake check, one of the two sees the other's store
+        unsigned tail = atomic_load(&ring->tail);
+        if(head == tail) break;
+
+        while(head != tail) {
+            uint32_t pulse = ring->pulses[head & ring->mask];
+            // Free the slot before decoding, the producer can use it right away
+            atomic_store(&ring->head, ++head);
+
+            if(pulse == PULSE_RESET_MARKER) {
+                if(ring->reset_callback) ring->reset_callback(ring->context);
+            } else if(ring->pair_callback) {
+                ring->pair_callback(
+                    ring->context, (pulse & PULSE_LEVEL_BIT) != 0, pulse & ~PULSE_LEVEL_BIT);
+            }
+        }
+    }
+
+    furi_mutex_release(ring->callback_mutex);
+}
+
+static int32_t protopirate_pulse_ring_thread(void* context) {
+    ProtoPiratePulseRing* ring = context;
+
+    while(true) {
+        uint32_t flags = furi_thread_flags_wait(
+            PULSE_RING_FLAG_DATA | PULSE_RING_FLAG_STOP, FuriFlagWaitAny, FuriWaitForever);
+        if(flags & FuriFlagError) continue;
+        if(flags & PULSE_RING_FLAG_STOP) break;
+
+        protopirate_pulse_ring_decode(ring);
+    }
+
+    return 0;
+}
+
+ProtoPiratePulseRing* protopirate_pulse_ring_alloc(size_t depth) {
+    furi_assert(depth > 1);
+
+    ProtoPiratePulseRing* ring = malloc(sizeof(ProtoPiratePulseRing));
+    memset(ring, 0, sizeof(ProtoPiratePulseRing));
+
+    size_t size = 2;
+    while(size < depth)
+        size <<= 1;
+    ring->pulses = malloc(sizeof(uint32_t) * size);
+    ring->mask = size - 1;
+
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->pushed, 0);
+    atomic_init(&ring->dropped, 0);
+    atomic_init(&ring->overruns, 0);
+    atomic_init(&ring->worker_overruns, 0);
+    atomic_init(&ring->high_water, 0);
+
+    ring->callback_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    ring->thread = furi_thread_alloc_ex(
+        "ProtoPirateDecode", PULSE_RING_THREAD_STACK, protopirate_pulse_ring_thread, ring);
+    furi_thread_start(ring->thread);
+
+    return ring;
+}
+
+void protopirate_pulse_ring_free(ProtoPiratePulseRing* ring) {
+    furi_assert(ring);
+
+    furi_thread_flags_set(furi_thread_get_id(ring->thread), PULSE_RING_FLAG_STOP);
+    furi_thread_join(ring->thread);
+    furi_thread_free(ring->thread);
+    furi_mutex_free(ring->callback_mutex);
+
+    free(ring->pulses);
+    free(ring);
+}
+
+void protopirate_pulse_ring_set_pair_callback(
+    ProtoPiratePulseRing* ring,
+    SubGhzWorkerPairCallback callback) {
+    furi_assert(ring);
+    furi_mutex_acquire(ring->callback_mutex, FuriWaitForever);
+    ring->pair_callback = callback;
+    furi_mutex_release(ring->callback_mutex);
+}
+
+void protopirate_pulse_ring_set_reset_callback(
+    ProtoPiratePulseRing* ring,
+    SubGhzWorkerOverrunCallback callback) {
+    furi_assert(ring);
+    furi_mutex_acquire(ring->callback_mutex, FuriWaitForever);
+    ring->reset_callback = callback;
+    furi_mutex_release(ring->callback_mutex);
+}
+
+void protopirate_pulse_ring_set_context(ProtoPiratePulseRing* ring, void* context) {
+    furi_assert(ring);
+    furi_mutex_acquire(ring->callback_mutex, FuriWaitForever);
+    ring->context = context;
+    furi_mutex_release(ring->callback_mutex);
+}
+
+// Stores one value, returns false when the ring has fewer than reserve free slots
+static bool
+    protopirate_pulse_ring_put(ProtoPiratePulseRing* ring, uint32_t value, unsigned reserve) {
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    unsigned used = tail - head;
+    if(used + reserve > ring->mask + 1) return false;
+
+    ring->pulses[tail & ring->mask] = value;
+    atomic_store(&ring->tail, tail + 1);
+
+    if(used + 1 > atomic_load_explicit(&ring->high_water, memory_order_relaxed)) {
+        atomic_store_explicit(&ring->high_water, used + 1, memory_order_relaxed);
+    }
+
+    // The decode thread may have found the ring empty and gone to sleep
+    if(atomic_load(&ring->head) == tail) {
+        furi_thread_flags_set(furi_thread_get_id(ring->thread), PULSE_RING_FLAG_DATA);
+    }
+    return true;
+}
+
+void protopirate_pulse_ring_push(void* context, bool level, uint32_t duration) {
+    ProtoPiratePulseRing* ring = context;
+
+    if(ring->gap) {
+        // The marker needs room for the pulse after it, or the gap just gets longer
+        if(protopirate_pulse_ring_put(ring, PULSE_RESET_MARKER, 2)) {
+            ring->gap = false;
+        } else {
+            atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+            return;
+        }
+    }
+
+    uint32_t pulse = MIN(duration, PULSE_DURATION_MAX) | (level ? PULSE_LEVEL_BIT : 0);
+    if(protopirate_pulse_ring_put(ring, pulse, 1)) {
+        atomic_fetch_add_explicit(&ring->pushed, 1, memory_order_relaxed);
+    } else {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&ring->overruns, 1, memory_order_relaxed);
+        ring->gap = true;
+    }
+}
+
+void protopirate_pulse_ring_overrun(void* context) {
+    ProtoPiratePulseRing* ring = context;
+    atomic_fetch_add_explicit(&ring->worker_overruns, 1, memory_order_relaxed);
+    if(!protopirate_pulse_ring_put(ring, PULSE_RESET_MARKER, 1)) {
+        ring->gap = true;
+    }
+}
+
+void protopirate_pulse_ring_sync(ProtoPiratePulseRing* ring) {
+    furi_assert(ring);
+
+    while(atomic_load(&ring->head) != atomic_load(&ring->tail)) {
+        furi_delay_tick(1);
+    }
+
+    // The last batch may still be in its callbacks
+    furi_mutex_acquire(ring->callback_mutex, FuriWaitForever);
+    furi_mutex_release(ring->callback_mutex);
+}
+
+void protopirate_pulse_ring_get_stats(
+    ProtoPiratePulseRing* ring,
+    ProtoPiratePulseRingStats* stats) {
+    furi_assert(ring);
+    furi_assert(stats);
+    stats->pulses = atomic_load_explicit(&ring->pushed, memory_order_relaxed);
+    stats->dropped = atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+    stats->overruns = atomic_load_explicit(&ring->overruns, memory_order_relaxed);
+    stats->worker_overruns = atomic_load_explicit(&ring->worker_overruns, memory_order_relaxed);
+    stats->high_water = atomic_load_explicit(&ring->high_water, memory_order_relaxed);
+    stats->depth = ring->mask + 1;
+}
+
+void protopirate_pulse_ring_reset_stats(ProtoPiratePulseRing* ring) {
+    furi_assert(ring);
+    atomic_store_explicit(&ring->pushed, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->dropped, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->overruns, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->worker_overruns, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->high_water, 0, memory_order_relaxed);
+}
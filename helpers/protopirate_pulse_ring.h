@@ -0,0 +1,52 @@
+// helpers/protopirate_pulse_ring.h
+#pragma once
+
+#include <furi.h>
+#include <lib/subghz/subghz_worker.h>
+
+// Pulses buffered between the worker and the decode thread, 4 bytes each
+#define PROTOPIRATE_PULSE_RING_DEPTH 1024
+
+// Moves pulses from the SubGhzWorker thread to a decode thread of its own, so a slow
+// decoder or a busy GUI delays decoding instead of overrunning the worker. The worker
+// is the only producer, the decode thread the only consumer.
+typedef struct ProtoPiratePulseRing ProtoPiratePulseRing;
+
+typedef struct {
+    uint32_t pulses; // Pulses accepted
+    uint32_t dropped; // Pulses lost because the ring was full
+    uint32_t overruns; // Times the ring filled up
+    uint32_t worker_overruns; // Times the worker's own buffer overran
+    uint32_t high_water; // Most pulses waiting at once
+    uint32_t depth;
+} ProtoPiratePulseRingStats;
+
+// Depth is rounded up to a power of 2. The decode thread starts right away.
+ProtoPiratePulseRing* protopirate_pulse_ring_alloc(size_t depth);
+void protopirate_pulse_ring_free(ProtoPiratePulseRing* ring);
+
+// Consumer side callbacks, run on the decode thread. Changing them waits for the batch
+// being decoded, so the old callback is never called after this returns.
+void protopirate_pulse_ring_set_pair_callback(
+    ProtoPiratePulseRing* ring,
+    SubGhzWorkerPairCallback callback);
+void protopirate_pulse_ring_set_reset_callback(
+    ProtoPiratePulseRing* ring,
+    SubGhzWorkerOverrunCallback callback);
+void protopirate_pulse_ring_set_context(ProtoPiratePulseRing* ring, void* context);
+
+// Producer side, signature matches SubGhzWorkerPairCallback
+void protopirate_pulse_ring_push(void* context, bool level, uint32_t duration);
+
+// Producer side, signature matches SubGhzWorkerOverrunCallback. The worker lost pulses,
+// so the decoders are reset once they got everything before the gap.
+void protopirate_pulse_ring_overrun(void* context);
+
+// Waits until every pulse pushed so far was decoded. Call once the worker is stopped,
+// after that no decode callback runs until the worker pushes again.
+void protopirate_pulse_ring_sync(ProtoPiratePulseRing* ring);
+
+void protopirate_pulse_ring_get_stats(
+    ProtoPiratePulseRing* ring,
+    ProtoPiratePulseRingStats* stats);
+void protopirate_pulse_ring_reset_stats(ProtoPiratePulseRing* ring);
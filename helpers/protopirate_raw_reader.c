@@ -0,0 +1,138 @@
+// helpers/protopirate_raw_reader.c
+#include "protopirate_raw_reader.h"
+
+#define TAG "ProtoPirateRawReader"
+
+static const char raw_data_key[] = "RAW_Data:";
+
+typedef enum {
+    RawReaderStateLineStart,
+    RawReaderStateValues,
+    RawReaderStateSkipLine,
+} RawReaderState;
+
+void protopirate_raw_reader_init(ProtoPirateRawReader* reader, Stream* stream) {
+    furi_assert(reader);
+    furi_assert(stream);
+
+    memset(reader, 0, sizeof(ProtoPirateRawReader));
+    reader->stream = stream;
+    reader->state = RawReaderStateLineStart;
+    stream_rewind(stream);
+}
+
+static bool protopirate_raw_reader_emit(
+    ProtoPirateRawReader* reader,
+    int32_t* samples,
+    size_t* count) {
+    bool emitted = false;
+
+    // Zero durations carry no edge, the decoders never see them
+    if(reader->has_digits && reader->value != 0) {
+        int32_t value = (int32_t)reader->value;
+        samples[(*count)++] = reader->negative ? -value : value;
+        emitted = true;
+    }
+
+    reader->value = 0;
+    reader->negative = false;
+    reader->has_digits = false;
+    return emitted;
+}
+
+size_t protopirate_raw_reader_read(
+    ProtoPirateRawReader* reader,
+    int32_t* samples,
+    size_t max_samples) {
+    furi_assert(reader);
+    furi_assert(samples);
+
+    size_t count = 0;
+
+    while(count < max_samples) {
+        if(reader->buffer_pos >= reader->buffer_len) {
+            if(reader->eof) break;
+
+            reader->buffer_len =
+                stream_read(reader->stream, reader->buffer, PROTOPIRATE_RAW_READER_BUFFER_SIZE);
+            reader->buffer_pos = 0;
+
+            if(reader->buffer_len == 0) {
+                reader->eof = true;
+                // A file may end in the middle of the last RAW_Data value
+                if(reader->state == RawReaderStateValues) {
+                    protopirate_raw_reader_emit(reader, samples, &count);
+                }
+                break;
+            }
+        }
+
+        char c = (char)reader->buffer[reader->buffer_pos++];
+
+        switch(reader->state) {
+        case RawReaderStateLineStart:
+            if(c == raw_data_key[reader->key_pos]) {
+                reader->key_pos++;
+                if(raw_data_key[reader->key_pos] == '\0') {
+                    reader->state = RawReaderStateValues;
+                    reader->key_pos = 0;
+                }
+            } else if(c == '\n') {
+                reader->key_pos = 0;
+            } else {
+                reader->state = RawReaderStateSkipLine;
+                reader->key_pos = 0;
+            }
+            break;
+
+        case RawReaderStateValues:
+            if(c >= '0' && c <= '9') {
+                uint32_t digit = (uint32_t)(c - '0');
+                // Past what a signed duration holds, the file is not a recording
+                if(reader->value > (INT32_MAX - digit) / 10) {
+                    FURI_LOG_E(TAG, "RAW_Data value out of range");
+                    reader->error = true;
+                    reader->eof = true;
+                    reader->buffer_pos = reader->buffer_len;
+                    break;
+                }
+                reader->value = reader->value * 10 + digit;
+                reader->has_digits = true;
+            } else if(c == '-') {
+                reader->negative = true;
+            } else {
+                protopirate_raw_reader_emit(reader, samples, &count);
+                if(c == '\n') {
+                    reader->state = RawReaderStateLineStart;
+                }
+            }
+            break;
+
+        case RawReaderStateSkipLine:
+        default:
+            if(c == '\n') {
+                reader->state = RawReaderStateLineStart;
+            }
+            break;
+        }
+    }
+
+    return count;
+}
+
+bool protopirate_raw_reader_has_error(ProtoPirateRawReader* reader) {
+    furi_assert(reader);
+    return reader->error;
+}
+
+uint8_t protopirate_raw_reader_get_progress(ProtoPirateRawReader* reader) {
+    furi_assert(reader);
+
+    size_t size = stream_size(reader->stream);
+    if(size == 0) return 100;
+
+    size_t position = stream_tell(reader->stream);
+    if(position >= size) return 100;
+
+    return (uint8_t)(((uint64_t)position * 100) / size);
+}
@@ -0,0 +1,38 @@
+// helpers/protopirate_raw_reader.h
+#pragma once
+
+#include <furi.h>
+#include <toolbox/stream/stream.h>
+
+#define PROTOPIRATE_RAW_READER_BUFFER_SIZE 256
+
+// Incremental RAW_Data parser working straight on a stream with a fixed buffer,
+// so memory use does not depend on the file length or on the RAW_Data line length.
+typedef struct {
+    Stream* stream;
+    uint8_t buffer[PROTOPIRATE_RAW_READER_BUFFER_SIZE];
+    size_t buffer_len;
+    size_t buffer_pos;
+    uint8_t state;
+    uint8_t key_pos;
+    bool negative;
+    bool has_digits;
+    uint32_t value;
+    bool eof;
+    bool error; // A value did not fit a duration, reading stopped there
+} ProtoPirateRawReader;
+
+/** Start reading RAW_Data from the beginning of the stream */
+void protopirate_raw_reader_init(ProtoPirateRawReader* reader, Stream* stream);
+
+/** Read up to max_samples signed durations, returns 0 once the stream is exhausted */
+size_t protopirate_raw_reader_read(
+    ProtoPirateRawReader* reader,
+    int32_t* samples,
+    size_t max_samples);
+
+/** True once a RAW_Data value was out of range. read returns 0 from then on. */
+bool protopirate_raw_reader_has_error(ProtoPirateRawReader* reader);
+
+/** Percentage of the stream consumed so far */
+uint8_t protopirate_raw_reader_get_progress(ProtoPirateRawReader* reader);
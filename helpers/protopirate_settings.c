@@ -14,6 +14,7 @@ void protopirate_settings_set_defaults(ProtoPirateSettings* settings) {
     settings->preset_index = 0;
     settings->auto_save = false;
     settings->hopping_enabled = false;
+    settings->near_miss = false;
 }
 
 void protopirate_settings_load(ProtoPirateSettings* settings) {
@@ -76,6 +77,14 @@ void protopirate_settings_load(ProtoPirateSettings* settings) {
         }
         settings->hopping_enabled = (hopping_temp == 1);
 
+        // Read near-miss capture, missing from older settings files
+        uint32_t near_miss_temp = 0;
+        if(!flipper_format_read_uint32(ff, "NearMiss", &near_miss_temp, 1)) {
+            FURI_LOG_W(TAG, "Failed to read near-miss, using default");
+            near_miss_temp = 0;
+        }
+        settings->near_miss = (near_miss_temp == 1);
+
         FURI_LOG_I(
             TAG,
             "Settings loaded: freq=%lu, preset=%u, auto_save=%d, hopping=%d",
@@ -132,6 +141,12 @@ void protopirate_settings_save(ProtoPirateSettings* settings) {
             break;
         }
 
+        uint32_t near_miss_temp = settings->near_miss ? 1 : 0;
+        if(!flipper_format_write_uint32(ff, "NearMiss", &near_miss_temp, 1)) {
+            FURI_LOG_E(TAG, "Failed to write near-miss");
+            break;
+        }
+
         FURI_LOG_I(
             TAG,
             "Settings saved: freq=%lu, preset=%u, auto_save=%d, hopping=%d",
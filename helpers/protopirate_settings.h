@@ -12,6 +12,7 @@ typedef struct {
     uint8_t preset_index;
     bool auto_save;
     bool hopping_enabled;
+    bool near_miss;
 } ProtoPirateSettings;
 
 void protopirate_settings_load(ProtoPirateSettings* settings);
@@ -2,15 +2,27 @@
 #include "protopirate_storage.h"
 #include <toolbox/stream/file_stream.h>
 #include <toolbox/dir_walk.h>
+#include <furi_hal_rtc.h>
+#include <lib/subghz/blocks/generic.h>
+#include "../protocols/protocol_items.h"
+#include "protopirate_capture_index.h"
 
-#define TAG                  "ProtoPirateStorage"
-#define MAX_FILES_TO_DISPLAY 50
+#define TAG "ProtoPirateStorage"
 
-// Structure to hold file info for sorting
+#define STORAGE_SEQUENCE_CACHE_MAX 16
+#define STORAGE_SEQUENCE_KEY_MAX   32
+
+// A protocol's next index for this session. Loaded on its first save and only written
+// back on exit or when the probe finds the index taken.
 typedef struct {
-    char name[64];
-    uint32_t timestamp;
-} FileEntry;
+    char key[STORAGE_SEQUENCE_KEY_MAX];
+    uint32_t next;
+    bool dirty;
+} ProtoPirateStorageSequence;
+
+// Saves and deletes all run on the GUI thread
+static ProtoPirateStorageSequence storage_sequence[STORAGE_SEQUENCE_CACHE_MAX];
+static size_t storage_sequence_count = 0;
 
 bool protopirate_storage_init() {
     Storage* storage = furi_record_open(RECORD_STORAGE);
@@ -19,34 +31,212 @@ bool protopirate_storage_init() {
     return result;
 }
 
+// Canonical registry name when known, with anything but alphanumerics replaced by '_'
+static void protopirate_storage_file_safe_name(const char* protocol_name, FuriString* out) {
+    const ProtoPirateProtocolInfo* info = protopirate_protocol_find_info(protocol_name);
+    if(info) protocol_name = info->protocol->name;
+    if(!protocol_name || !protocol_name[0]) protocol_name = "Unknown";
+
+    furi_string_reset(out);
+    for(const char* p = protocol_name; *p; p++) {
+        char c = *p;
+        bool alnum = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+        furi_string_push_back(out, alnum ? c : '_');
+    }
+}
+
+// Next index per protocol, so naming a capture does not probe every existing file
+static bool protopirate_storage_sequence_read(Storage* storage, const char* key, uint32_t* value) {
+    FlipperFormat* ff = flipper_format_file_alloc(storage);
+    bool result = false;
+
+    if(flipper_format_file_open_existing(ff, PROTOPIRATE_SEQUENCE_FILE)) {
+        result = flipper_format_read_uint32(ff, key, value, 1);
+    }
+
+    flipper_format_free(ff);
+    return result;
+}
+
+static void protopirate_storage_sequence_write(Storage* storage, const char* key, uint32_t value) {
+    FlipperFormat* ff = flipper_format_file_alloc(storage);
+
+    do {
+        if(flipper_format_file_open_existing(ff, PROTOPIRATE_SEQUENCE_FILE)) {
+            if(flipper_format_insert_or_update_uint32(ff, key, &value, 1)) break;
+            flipper_format_file_close(ff);
+        }
+
+        // Missing or unreadable: start over, the directory scan rebuilds other keys
+        if(!flipper_format_file_open_always(ff, PROTOPIRATE_SEQUENCE_FILE)) break;
+        if(!flipper_format_write_header_cstr(ff, "ProtoPirate Sequence", 1)) break;
+        flipper_format_write_uint32(ff, key, &value, 1);
+    } while(false);
+
+    flipper_format_free(ff);
+}
+
+// Splits "<name>_<index>.sub" into its parts, false for files not named that way
+static bool protopirate_storage_parse_name(
+    const char* file_name,
+    FuriString* key,
+    uint32_t* index) {
+    const char* ext = strstr(file_name, PROTOPIRATE_APP_EXTENSION);
+    if(!ext) return false;
+
+    const char* sep = NULL;
+    for(const char* p = file_name; p < ext; p++) {
+        if(*p == '_') sep = p;
+    }
+    if(!sep || sep == file_name || sep + 1 == ext) return false;
+
+    uint32_t value = 0;
+    for(const char* p = sep + 1; p < ext; p++) {
+        if(*p < '0' || *p > '9') return false;
+        value = value * 10 + (uint32_t)(*p - '0');
+    }
+
+    furi_string_set_strn(key, file_name, sep - file_name);
+    *index = value;
+    return true;
+}
+
+// One directory pass to seed a protocol's counter when it is not in the sequence file yet
+static uint32_t protopirate_storage_sequence_scan(Storage* storage, const char* key) {
+    File* dir = storage_file_alloc(storage);
+    FuriString* file_key = furi_string_alloc();
+    FileInfo file_info;
+    uint32_t next = 0;
+
+    if(storage_dir_open(dir, PROTOPIRATE_APP_FOLDER)) {
+        char name[256];
+        uint32_t index;
+        while(storage_dir_read(dir, &file_info, name, sizeof(name))) {
+            if(file_info_is_dir(&file_info)) continue;
+            if(!protopirate_storage_parse_name(name, file_key, &index)) continue;
+            if(furi_string_equal_str(file_key, key) && index >= next) {
+                next = index + 1;
+            }
+        }
+        storage_dir_close(dir);
+    }
+
+    furi_string_free(file_key);
+    storage_file_free(dir);
+    return next;
+}
+
+// The session's counter for key, loaded from the sequence file the first time. NULL when
+// the key does not fit or the cache is full, the caller then uses the file directly.
+static ProtoPirateStorageSequence*
+    protopirate_storage_sequence_get(Storage* storage, const char* key) {
+    for(size_t i = 0; i < storage_sequence_count; i++) {
+        if(strcmp(storage_sequence[i].key, key) == 0) return &storage_sequence[i];
+    }
+    if(storage_sequence_count == STORAGE_SEQUENCE_CACHE_MAX ||
+       strlen(key) >= STORAGE_SEQUENCE_KEY_MAX) {
+        return NULL;
+    }
+
+    ProtoPirateStorageSequence* entry = &storage_sequence[storage_sequence_count++];
+    snprintf(entry->key, sizeof(entry->key), "%s", key);
+    if(!protopirate_storage_sequence_read(storage, key, &entry->next)) {
+        entry->next = protopirate_storage_sequence_scan(storage, key);
+    }
+    entry->dirty = false;
+    return entry;
+}
+
+void protopirate_storage_sequence_flush(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    for(size_t i = 0; i < storage_sequence_count; i++) {
+        ProtoPirateStorageSequence* entry = &storage_sequence[i];
+        if(!entry->dirty) continue;
+        protopirate_storage_sequence_write(storage, entry->key, entry->next);
+        entry->dirty = false;
+    }
+    furi_record_close(RECORD_STORAGE);
+}
+
 bool protopirate_storage_get_next_filename(const char* protocol_name, FuriString* out_filename) {
     Storage* storage = furi_record_open(RECORD_STORAGE);
     FuriString* temp_path = furi_string_alloc();
+    FuriString* safe_name = furi_string_alloc();
     uint32_t index = 0;
-    bool found = false;
 
-    // Find next available index
-    while(!found && index < 999) {
+    protopirate_storage_file_safe_name(protocol_name, safe_name);
+    const char* key = furi_string_get_cstr(safe_name);
+
+    ProtoPirateStorageSequence* entry = protopirate_storage_sequence_get(storage, key);
+    if(entry) {
+        index = entry->next;
+    } else if(!protopirate_storage_sequence_read(storage, key, &index)) {
+        index = protopirate_storage_sequence_scan(storage, key);
+    }
+    uint32_t first = index;
+
+    // Normally the first candidate is free; files copied in by hand just push it forward
+    while(true) {
         furi_string_printf(
             temp_path,
             "%s/%s_%03lu%s",
             PROTOPIRATE_APP_FOLDER,
-            protocol_name,
+            key,
             index,
             PROTOPIRATE_APP_EXTENSION);
 
-        if(!storage_file_exists(storage, furi_string_get_cstr(temp_path))) {
-            furi_string_set(out_filename, temp_path);
-            found = true;
-        } else {
-            index++;
-        }
+        if(!storage_file_exists(storage, furi_string_get_cstr(temp_path))) break;
+        index++;
+    }
+
+    furi_string_set(out_filename, temp_path);
+    if(entry) {
+        entry->next = index + 1;
+        entry->dirty = true;
+    }
+    // The file is behind what is on the card, or there is no entry to hold the counter
+    if(!entry || index != first) {
+        protopirate_storage_sequence_write(storage, key, index + 1);
+        if(entry) entry->dirty = false;
     }
 
+    furi_string_free(safe_name);
     furi_string_free(temp_path);
     furi_record_close(RECORD_STORAGE);
 
-    return found;
+    return true;
+}
+
+// Streams "Key: value" lines from src to dst, skipping any file header in src.
+// The manifest fields are picked up from the same lines on the way through.
+static bool protopirate_storage_copy_fields(
+    FlipperFormat* src,
+    FlipperFormat* dst,
+    ProtoPirateCaptureRecord* record) {
+    Stream* src_stream = flipper_format_get_raw_stream(src);
+    Stream* dst_stream = flipper_format_get_raw_stream(dst);
+    FuriString* line = furi_string_alloc();
+    bool result = true;
+
+    stream_rewind(src_stream);
+    while(stream_read_line(src_stream, line)) {
+        if(furi_string_start_with_str(line, "Filetype:") ||
+           furi_string_start_with_str(line, "Version:")) {
+            continue;
+        }
+        if(furi_string_empty(line)) continue;
+        protopirate_capture_index_scan_line(record, line);
+        if(furi_string_get_char(line, furi_string_size(line) - 1) != '\n') {
+            furi_string_push_back(line, '\n');
+        }
+        if(stream_write_string(dst_stream, line) != furi_string_size(line)) {
+            result = false;
+            break;
+        }
+    }
+
+    furi_string_free(line);
+    return result;
 }
 
 bool protopirate_storage_save_capture(
@@ -68,12 +258,14 @@ bool protopirate_storage_save_capture(
 
     Storage* storage = furi_record_open(RECORD_STORAGE);
 
-    // Create a new flipper format file for saving
-    FlipperFormat* save_file = flipper_format_file_alloc(storage);
+    // Buffered so the copied lines reach the SD card in large writes
+    FlipperFormat* save_file = flipper_format_buffered_file_alloc(storage);
+    ProtoPirateCaptureRecord record = {0};
     bool result = false;
 
     do {
-        if(!flipper_format_file_open_new(save_file, furi_string_get_cstr(file_path))) {
+        // get_next_filename picked a path that does not exist yet
+        if(!flipper_format_buffered_file_open_always(save_file, furi_string_get_cstr(file_path))) {
             FURI_LOG_E(TAG, "Failed to create file");
             break;
         }
@@ -84,176 +276,35 @@ bool protopirate_storage_save_capture(
             break;
         }
 
-        // Rewind source format to beginning
-        flipper_format_rewind(flipper_format);
-
-        // Copy ALL data from the source flipper format
-        FuriString* string_value = furi_string_alloc();
-        uint32_t uint32_value;
-        uint32_t* uint32_array = NULL;
-        uint32_t uint32_array_size = 0;
-
-        // Protocol name
-        if(flipper_format_read_string(flipper_format, "Protocol", string_value)) {
-            flipper_format_write_string(save_file, "Protocol", string_value);
-        }
-
-        // Bit count
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_uint32(flipper_format, "Bit", &uint32_value, 1)) {
-            flipper_format_write_uint32(save_file, "Bit", &uint32_value, 1);
-        }
-
-        // Key data
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_string(flipper_format, "Key", string_value)) {
-            flipper_format_write_string(save_file, "Key", string_value);
-        } else {
-            flipper_format_rewind(flipper_format);
-            if(flipper_format_get_value_count(flipper_format, "Key", &uint32_array_size) &&
-               uint32_array_size > 0) {
-                uint32_array = malloc(sizeof(uint32_t) * uint32_array_size);
-                if(flipper_format_read_uint32(
-                       flipper_format, "Key", uint32_array, uint32_array_size)) {
-                    flipper_format_write_uint32(save_file, "Key", uint32_array, uint32_array_size);
-                }
-                free(uint32_array);
-                uint32_array = NULL;
-            }
-        }
-
-        // Frequency
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_uint32(flipper_format, "Frequency", &uint32_value, 1)) {
-            flipper_format_write_uint32(save_file, "Frequency", &uint32_value, 1);
-        }
-
-        // Preset
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_string(flipper_format, "Preset", string_value)) {
-            flipper_format_write_string(save_file, "Preset", string_value);
-        }
-
-        // Custom preset data if exists
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_get_value_count(
-               flipper_format, "Custom_preset_module", &uint32_array_size) &&
-           uint32_array_size > 0) {
-            if(flipper_format_read_string(flipper_format, "Custom_preset_module", string_value)) {
-                flipper_format_write_string(save_file, "Custom_preset_module", string_value);
-            }
-        }
-
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_get_value_count(
-               flipper_format, "Custom_preset_data", &uint32_array_size) &&
-           uint32_array_size > 0) {
-            uint8_t* custom_data = malloc(uint32_array_size);
-            if(flipper_format_read_hex(
-                   flipper_format, "Custom_preset_data", custom_data, uint32_array_size)) {
-                flipper_format_write_hex(
-                    save_file, "Custom_preset_data", custom_data, uint32_array_size);
-            }
-            free(custom_data);
-        }
-
-        // Protocol-specific fields - TE
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_uint32(flipper_format, "TE", &uint32_value, 1)) {
-            flipper_format_write_uint32(save_file, "TE", &uint32_value, 1);
-        }
-
-        // Serial number
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_uint32(flipper_format, "Serial", &uint32_value, 1)) {
-            flipper_format_write_uint32(save_file, "Serial", &uint32_value, 1);
-        }
-
-        // Button
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_uint32(flipper_format, "Btn", &uint32_value, 1)) {
-            flipper_format_write_uint32(save_file, "Btn", &uint32_value, 1);
-        }
-
-        // Counter
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_uint32(flipper_format, "Cnt", &uint32_value, 1)) {
-            flipper_format_write_uint32(save_file, "Cnt", &uint32_value, 1);
-        }
-
-        // CRC
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_uint32(flipper_format, "CRC", &uint32_value, 1)) {
-            flipper_format_write_uint32(save_file, "CRC", &uint32_value, 1);
-        }
-
-        // Type (for VW)
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_uint32(flipper_format, "Type", &uint32_value, 1)) {
-            flipper_format_write_uint32(save_file, "Type", &uint32_value, 1);
-        }
-
-        // Check (for VW)
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_uint32(flipper_format, "Check", &uint32_value, 1)) {
-            flipper_format_write_uint32(save_file, "Check", &uint32_value, 1);
-        }
-
-        // Raw data arrays
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_get_value_count(flipper_format, "RAW_Data", &uint32_array_size) &&
-           uint32_array_size > 0) {
-            uint32_array = malloc(sizeof(uint32_t) * uint32_array_size);
-            if(flipper_format_read_uint32(
-                   flipper_format, "RAW_Data", uint32_array, uint32_array_size)) {
-                flipper_format_write_uint32(
-                    save_file, "RAW_Data", uint32_array, uint32_array_size);
-            }
-            free(uint32_array);
-        }
-
-        // DataHi/DataLo
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_uint32(flipper_format, "DataHi", &uint32_value, 1)) {
-            flipper_format_write_uint32(save_file, "DataHi", &uint32_value, 1);
-        }
-
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_uint32(flipper_format, "DataLo", &uint32_value, 1)) {
-            flipper_format_write_uint32(save_file, "DataLo", &uint32_value, 1);
-        }
-
-        // RawCnt for Kia V2
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_uint32(flipper_format, "RawCnt", &uint32_value, 1)) {
-            flipper_format_write_uint32(save_file, "RawCnt", &uint32_value, 1);
+        // Copy every key of the source in one pass, protocol-specific ones included
+        if(!protopirate_storage_copy_fields(flipper_format, save_file, &record)) {
+            FURI_LOG_E(TAG, "Failed to write capture data");
+            break;
         }
 
-        // Encrypted/Decrypted for Kia V3/V4
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_uint32(flipper_format, "Encrypted", &uint32_value, 1)) {
-            flipper_format_write_uint32(save_file, "Encrypted", &uint32_value, 1);
+        // Buffered writes only reach the card when the buffer fills or here, so a full card
+        // often shows up first as a failed close. Every buffered writer checks it the same way.
+        if(!flipper_format_buffered_file_close(save_file)) {
+            FURI_LOG_E(TAG, "Failed to flush file");
+            break;
         }
 
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_uint32(flipper_format, "Decrypted", &uint32_value, 1)) {
-            flipper_format_write_uint32(save_file, "Decrypted", &uint32_value, 1);
-        }
+        // Manifest entry, keyed by the file name without folder and extension
+        const char* file_name = strrchr(furi_string_get_cstr(file_path), '/') + 1;
+        snprintf(record.name, sizeof(record.name), "%s", file_name);
+        char* ext = strstr(record.name, PROTOPIRATE_APP_EXTENSION);
+        if(ext) *ext = '\0';
 
-        // Version for Kia V3/V4
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_uint32(flipper_format, "Version", &uint32_value, 1)) {
-            flipper_format_write_uint32(save_file, "Version", &uint32_value, 1);
+        FileInfo file_info;
+        if(storage_common_stat(storage, furi_string_get_cstr(file_path), &file_info) == FSE_OK) {
+            record.size = (uint32_t)file_info.size;
         }
+        record.mtime = furi_hal_rtc_get_timestamp();
 
-        // BS byte for Ford
-        flipper_format_rewind(flipper_format);
-        if(flipper_format_read_uint32(flipper_format, "BS", &uint32_value, 1)) {
-            flipper_format_write_uint32(save_file, "BS", &uint32_value, 1);
+        if(!protopirate_capture_index_append(storage, &record)) {
+            FURI_LOG_W(TAG, "Manifest not updated");
         }
 
-        furi_string_free(string_value);
-
         if(out_path) {
             furi_string_set(out_path, file_path);
         }
@@ -270,121 +321,38 @@ bool protopirate_storage_save_capture(
     return result;
 }
 
-// Static array to hold sorted file entries
-static FileEntry* g_file_entries = NULL;
-static uint32_t g_file_count = 0;
-
-// Build the sorted file list
-static void protopirate_storage_build_file_list(void) {
-    // Free previous list
-    if(g_file_entries) {
-        free(g_file_entries);
-        g_file_entries = NULL;
-    }
-    g_file_count = 0;
-
+uint32_t protopirate_storage_get_file_count() {
     Storage* storage = furi_record_open(RECORD_STORAGE);
-    File* dir = storage_file_alloc(storage);
-    FileInfo file_info;
-
-    // First pass: count files
-    uint32_t total_count = 0;
-    if(storage_dir_open(dir, PROTOPIRATE_APP_FOLDER)) {
-        char name[256];
-        while(storage_dir_read(dir, &file_info, name, sizeof(name))) {
-            if(!file_info_is_dir(&file_info) && strstr(name, PROTOPIRATE_APP_EXTENSION)) {
-                total_count++;
-            }
-        }
-        storage_dir_close(dir);
-    }
-
-    if(total_count == 0) {
-        storage_file_free(dir);
-        furi_record_close(RECORD_STORAGE);
-        return;
-    }
-
-    // Allocate array
-    g_file_entries = malloc(sizeof(FileEntry) * total_count);
-    if(!g_file_entries) {
-        storage_file_free(dir);
-        furi_record_close(RECORD_STORAGE);
-        return;
-    }
-
-    // Second pass: collect file info
-    FuriString* full_path = furi_string_alloc();
-    if(storage_dir_open(dir, PROTOPIRATE_APP_FOLDER)) {
-        char name[256];
-        while(storage_dir_read(dir, &file_info, name, sizeof(name)) &&
-              g_file_count < total_count) {
-            if(!file_info_is_dir(&file_info) && strstr(name, PROTOPIRATE_APP_EXTENSION)) {
-                // Copy name (without extension for display)
-                strncpy(
-                    g_file_entries[g_file_count].name,
-                    name,
-                    sizeof(g_file_entries[g_file_count].name) - 1);
-                g_file_entries[g_file_count].name[sizeof(g_file_entries[g_file_count].name) - 1] =
-                    '\0';
-
-                // Remove extension
-                char* dot = strrchr(g_file_entries[g_file_count].name, '.');
-                if(dot) *dot = '\0';
-
-                // Get file timestamp
-                furi_string_printf(full_path, "%s/%s", PROTOPIRATE_APP_FOLDER, name);
-
-                // File Count
-                g_file_entries[g_file_count].timestamp = total_count - g_file_count;
-
-                g_file_count++;
-            }
-        }
-        storage_dir_close(dir);
-    }
-    furi_string_free(full_path);
-
-    // Reverse file count so newest files are first
-    if(g_file_count > 1) {
-        // Reverse the array so newest (last found) is first
-        for(uint32_t i = 0; i < g_file_count / 2; i++) {
-            FileEntry temp = g_file_entries[i];
-            g_file_entries[i] = g_file_entries[g_file_count - 1 - i];
-            g_file_entries[g_file_count - 1 - i] = temp;
-        }
-    }
-
-    storage_file_free(dir);
+    uint32_t count = protopirate_capture_index_count(storage);
     furi_record_close(RECORD_STORAGE);
-
-    FURI_LOG_I(TAG, "Built file list with %lu entries", g_file_count);
+    return count;
 }
 
-uint32_t protopirate_storage_get_file_count() {
-    // Rebuild the file list each time we're asked for count
-    protopirate_storage_build_file_list();
-    return g_file_count;
+size_t protopirate_storage_get_file_page(
+    uint32_t index,
+    ProtoPirateCaptureRecord* records,
+    size_t max) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    size_t count = protopirate_capture_index_read_page(storage, index, records, max);
+    furi_record_close(RECORD_STORAGE);
+    return count;
 }
 
 bool protopirate_storage_get_file_by_index(
     uint32_t index,
     FuriString* out_path,
     FuriString* out_name) {
-    if(!g_file_entries || index >= g_file_count) {
+    ProtoPirateCaptureRecord record;
+    if(protopirate_storage_get_file_page(index, &record, 1) != 1) {
         return false;
     }
 
     if(out_path) {
         furi_string_printf(
-            out_path,
-            "%s/%s%s",
-            PROTOPIRATE_APP_FOLDER,
-            g_file_entries[index].name,
-            PROTOPIRATE_APP_EXTENSION);
+            out_path, "%s/%s%s", PROTOPIRATE_APP_FOLDER, record.name, PROTOPIRATE_APP_EXTENSION);
     }
     if(out_name) {
-        furi_string_set_str(out_name, g_file_entries[index].name);
+        furi_string_set_str(out_name, record.name);
     }
 
     return true;
@@ -394,6 +362,36 @@ bool protopirate_storage_delete_file(const char* file_path) {
     Storage* storage = furi_record_open(RECORD_STORAGE);
     bool result = storage_simply_remove(storage, file_path);
     FURI_LOG_I(TAG, "Delete file %s: %s", file_path, result ? "OK" : "FAILED");
+
+    // Deleting the newest capture of a protocol hands its number back
+    const char* file_name = strrchr(file_path, '/');
+    file_name = file_name ? file_name + 1 : file_path;
+    FuriString* key = furi_string_alloc();
+    uint32_t index, next;
+    if(result && protopirate_storage_parse_name(file_name, key, &index)) {
+        ProtoPirateStorageSequence* entry =
+            protopirate_storage_sequence_get(storage, furi_string_get_cstr(key));
+        if(entry) {
+            if(entry->next == index + 1) {
+                entry->next = index;
+                entry->dirty = true;
+            }
+        } else if(
+            protopirate_storage_sequence_read(storage, furi_string_get_cstr(key), &next) &&
+            next == index + 1) {
+            protopirate_storage_sequence_write(storage, furi_string_get_cstr(key), index);
+        }
+    }
+    furi_string_free(key);
+
+    if(result) {
+        FuriString* name = furi_string_alloc_set_str(file_name);
+        size_t ext = furi_string_search_str(name, PROTOPIRATE_APP_EXTENSION);
+        if(ext != FURI_STRING_FAILURE) furi_string_left(name, ext);
+        protopirate_capture_index_remove(storage, furi_string_get_cstr(name));
+        furi_string_free(name);
+    }
+
     furi_record_close(RECORD_STORAGE);
     return result;
 }
@@ -412,11 +410,91 @@ FlipperFormat* protopirate_storage_load_file(const char* file_path) {
     return flipper_format;
 }
 
-// Call this when exiting the app to free memory
-void protopirate_storage_free_file_list(void) {
-    if(g_file_entries) {
-        free(g_file_entries);
-        g_file_entries = NULL;
-    }
-    g_file_count = 0;
+bool protopirate_storage_save_near_miss(
+    const ProtoPirateNearMissSnippet* snippet,
+    const SubGhzRadioPreset* preset,
+    uint32_t* index) {
+    furi_assert(snippet);
+    furi_assert(preset);
+    furi_assert(index);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FlipperFormat* ff = flipper_format_buffered_file_alloc(storage);
+    FuriString* file_path = furi_string_alloc();
+    FuriString* temp_str = furi_string_alloc();
+    bool result = false;
+
+    do {
+        if(!storage_simply_mkdir(storage, PROTOPIRATE_APP_FOLDER) ||
+           !storage_simply_mkdir(storage, PROTOPIRATE_NEAR_MISS_FOLDER)) {
+            FURI_LOG_E(TAG, "Failed to create near miss folder");
+            break;
+        }
+
+        protopirate_storage_file_safe_name(snippet->protocol, temp_str);
+        while(true) {
+            furi_string_printf(
+                file_path,
+                "%s/%s_%03lu%s",
+                PROTOPIRATE_NEAR_MISS_FOLDER,
+                furi_string_get_cstr(temp_str),
+                *index,
+                PROTOPIRATE_APP_EXTENSION);
+            (*index)++;
+            if(!storage_file_exists(storage, furi_string_get_cstr(file_path))) break;
+        }
+
+        if(!flipper_format_buffered_file_open_always(ff, furi_string_get_cstr(file_path))) {
+            FURI_LOG_E(TAG, "Failed to create file");
+            break;
+        }
+
+        // Same layout as a Sub-GHz app RAW recording, so it can be replayed and decoded
+        if(!flipper_format_write_header_cstr(ff, "Flipper SubGhz RAW File", 1)) break;
+
+        uint32_t frequency = preset->frequency;
+        if(!flipper_format_write_uint32(ff, "Frequency", &frequency, 1)) break;
+
+        subghz_block_generic_get_preset_name(furi_string_get_cstr(preset->name), temp_str);
+        if(!flipper_format_write_string(ff, "Preset", temp_str)) break;
+        if(furi_string_equal_str(temp_str, "FuriHalSubGhzPresetCustom") && preset->data) {
+            if(!flipper_format_write_string_cstr(ff, "Custom_preset_module", "CC1101")) break;
+            if(!flipper_format_write_hex(
+                   ff, "Custom_preset_data", preset->data, preset->data_size)) {
+                break;
+            }
+        }
+
+        if(!flipper_format_write_string_cstr(ff, "Protocol", "RAW")) break;
+
+        // Not read by the Sub-GHz app, they say which decoder gave up on the frame and why
+        if(!flipper_format_write_string_cstr(ff, "NearMiss_Protocol", snippet->protocol)) break;
+        if(!flipper_format_write_string_cstr(ff, "NearMiss_Reason", snippet->reason)) break;
+        if(snippet->step != PROTOPIRATE_NEAR_MISS_NO_STEP) {
+            uint32_t step = snippet->step;
+            if(!flipper_format_write_uint32(ff, "NearMiss_Step", &step, 1)) break;
+        }
+
+        if(!flipper_format_write_int32(ff, "RAW_Data", snippet->pulses, snippet->count)) break;
+
+        if(!flipper_format_buffered_file_close(ff)) {
+            FURI_LOG_E(TAG, "Failed to flush file");
+            break;
+        }
+
+        result = true;
+        FURI_LOG_I(
+            TAG,
+            "Near miss %s (%s) saved to %s",
+            snippet->protocol,
+            snippet->reason,
+            furi_string_get_cstr(file_path));
+    } while(false);
+
+    furi_string_free(temp_str);
+    furi_string_free(file_path);
+    flipper_format_free(ff);
+    furi_record_close(RECORD_STORAGE);
+
+    return result;
 }
@@ -4,10 +4,17 @@
 #include <furi.h>
 #include <storage/storage.h>
 #include <flipper_format/flipper_format.h>
+#include <lib/subghz/types.h>
+#include "protopirate_capture_index.h"
+#include "../protocols/protocol_near_miss.h"
 
-#define PROTOPIRATE_APP_FOLDER       EXT_PATH("subghz/protopirate")
-#define PROTOPIRATE_APP_EXTENSION    ".sub"
-#define PROTOPIRATE_APP_FILE_VERSION 1
+#define PROTOPIRATE_APP_FOLDER           EXT_PATH("subghz/protopirate")
+#define PROTOPIRATE_APP_EXTENSION        ".sub"
+#define PROTOPIRATE_APP_FILE_VERSION     1
+#define PROTOPIRATE_SEQUENCE_FILE        PROTOPIRATE_APP_FOLDER "/.sequence"
+#define PROTOPIRATE_NEAR_MISS_FOLDER     PROTOPIRATE_APP_FOLDER "/near_miss"
+#define PROTOPIRATE_TIMING_REPORT_FOLDER PROTOPIRATE_APP_FOLDER "/timing"
+#define PROTOPIRATE_BATCH_FOLDER         PROTOPIRATE_APP_FOLDER "/batch"
 
 bool protopirate_storage_init();
 bool protopirate_storage_save_capture(
@@ -15,11 +22,23 @@ bool protopirate_storage_save_capture(
     const char* protocol_name,
     FuriString* out_path);
 bool protopirate_storage_get_next_filename(const char* protocol_name, FuriString* out_filename);
+// Writes the counters this session moved on back to the sequence file, call on exit
+void protopirate_storage_sequence_flush(void);
 uint32_t protopirate_storage_get_file_count();
+size_t protopirate_storage_get_file_page(
+    uint32_t index,
+    ProtoPirateCaptureRecord* records,
+    size_t max);
 bool protopirate_storage_get_file_by_index(
     uint32_t index,
     FuriString* out_path,
     FuriString* out_name);
 bool protopirate_storage_delete_file(const char* file_path);
 FlipperFormat* protopirate_storage_load_file(const char* file_path);
-void protopirate_storage_free_file_list(void);
+
+// Writes a near miss as a RAW file named after its protocol, the first free index from
+// *index on is used and *index is left just past it
+bool protopirate_storage_save_near_miss(
+    const ProtoPirateNearMissSnippet* snippet,
+    const SubGhzRadioPreset* preset,
+    uint32_t* index);
@@ -0,0 +1,270 @@
+// helpers/protopirate_timing_cluster.c
+#include "protopirate_timing_cluster.h"
+#include <math.h>
+
+#define TAG "ProtoPirateTimingCluster"
+
+#define TIMING_OCTAVE_LAST                                 \
+    (PROTOPIRATE_TIMING_BUCKET_OCTAVE_FIRST +              \
+     PROTOPIRATE_TIMING_BUCKET_COUNT / PROTOPIRATE_TIMING_BUCKETS_PER_OCTAVE - 1)
+
+// Candidates kept while walking the histogram, the lowest ones are dropped
+#define TIMING_CANDIDATE_MAX 8
+// A cluster ends where its buckets fall under 1/8 of its peak, the rest is a noise tail
+#define TIMING_CLUSTER_EDGE 8
+
+// Octave from the top bit, then the next 3 bits pick one of its 8 buckets
+static size_t protopirate_timing_bucket_index(uint32_t duration) {
+    if(duration < (1UL << PROTOPIRATE_TIMING_BUCKET_OCTAVE_FIRST)) return 0;
+
+    uint32_t octave = 31 - __builtin_clz(duration);
+    if(octave > TIMING_OCTAVE_LAST) return PROTOPIRATE_TIMING_BUCKET_COUNT - 1;
+
+    return (octave - PROTOPIRATE_TIMING_BUCKET_OCTAVE_FIRST) *
+               PROTOPIRATE_TIMING_BUCKETS_PER_OCTAVE +
+           ((duration >> (octave - 3)) & (PROTOPIRATE_TIMING_BUCKETS_PER_OCTAVE - 1));
+}
+
+void protopirate_timing_estimator_reset(ProtoPirateTimingEstimator* estimator) {
+    furi_assert(estimator);
+    memset(estimator, 0, sizeof(ProtoPirateTimingEstimator));
+}
+
+// Halves every bucket, which keeps their means; emptied buckets forget their range
+static void protopirate_timing_estimator_decay(ProtoPirateTimingEstimator* estimator) {
+    estimator->weight = 0;
+    for(size_t i = 0; i < PROTOPIRATE_TIMING_BUCKET_COUNT; i++) {
+        ProtoPirateTimingBucket* bucket = &estimator->buckets[i];
+        bucket->count >>= 1;
+        if(bucket->count == 0) {
+            memset(bucket, 0, sizeof(ProtoPirateTimingBucket));
+            continue;
+        }
+        bucket->sum >>= 1;
+        bucket->sum_squares >>= 1;
+        estimator->weight += bucket->count;
+    }
+}
+
+void protopirate_timing_estimator_add(ProtoPirateTimingEstimator* estimator, uint32_t duration) {
+    estimator->pulses++;
+    if(duration < PROTOPIRATE_TIMING_MIN_DURATION) return;
+
+    ProtoPirateTimingBucket* bucket =
+        &estimator->buckets[protopirate_timing_bucket_index(duration)];
+
+    if(bucket->count == 0 || duration < bucket->min) bucket->min = duration;
+    if(duration > bucket->max) bucket->max = duration;
+    bucket->count++;
+    bucket->sum += duration;
+    bucket->sum_squares += (uint64_t)duration * duration;
+
+    if(++estimator->weight >= PROTOPIRATE_TIMING_DECAY_WEIGHT) {
+        protopirate_timing_estimator_decay(estimator);
+    }
+}
+
+// Folds the buckets around the peak of first..last into a cluster
+static void protopirate_timing_cluster_build(
+    const ProtoPirateTimingEstimator* estimator,
+    size_t first,
+    size_t last,
+    ProtoPirateTimingCluster* cluster) {
+    const ProtoPirateTimingBucket* buckets = estimator->buckets;
+    uint64_t sum = 0;
+    uint64_t sum_squares = 0;
+
+    size_t top = first;
+    for(size_t i = first + 1; i <= last; i++) {
+        if(buckets[i].count > buckets[top].count) top = i;
+    }
+    uint32_t edge = buckets[top].count;
+    while(first < top && buckets[first].count * TIMING_CLUSTER_EDGE < edge)
+        first++;
+    while(last > top && buckets[last].count * TIMING_CLUSTER_EDGE < edge)
+        last--;
+
+    memset(cluster, 0, sizeof(ProtoPirateTimingCluster));
+    cluster->min = UINT32_MAX;
+    for(size_t i = first; i <= last; i++) {
+        const ProtoPirateTimingBucket* bucket = &buckets[i];
+        if(bucket->count == 0) continue;
+        cluster->count += bucket->count;
+        sum += bucket->sum;
+        sum_squares += bucket->sum_squares;
+        if(bucket->min < cluster->min) cluster->min = bucket->min;
+        if(bucket->max > cluster->max) cluster->max = bucket->max;
+        if(bucket->count > cluster->peak) cluster->peak = bucket->count;
+    }
+    if(cluster->count == 0) return;
+
+    double mean = (double)sum / cluster->count;
+    double variance = (double)sum_squares / cluster->count - mean * mean;
+    cluster->mean = (uint32_t)(mean + 0.5);
+    cluster->spread = variance > 0 ? (uint32_t)(sqrt(variance) + 0.5) : 0;
+}
+
+// Keeps the highest candidates, replacing the lowest when full
+static void protopirate_timing_candidate_add(
+    ProtoPirateTimingCluster* candidates,
+    size_t* count,
+    const ProtoPirateTimingCluster* cluster) {
+    if(*count < TIMING_CANDIDATE_MAX) {
+        candidates[(*count)++] = *cluster;
+        return;
+    }
+
+    size_t lowest = 0;
+    for(size_t i = 1; i < *count; i++) {
+        if(candidates[i].peak < candidates[lowest].peak) lowest = i;
+    }
+    if(cluster->peak > candidates[lowest].peak) {
+        candidates[lowest] = *cluster;
+    }
+}
+
+// A keyfob repeats the same two pulse widths, so the two highest peaks are short and
+// long unless the second is far enough out to be the gap
+static void protopirate_timing_clusters_classify(ProtoPirateTimingClusters* clusters) {
+    clusters->short_index = -1;
+    clusters->long_index = -1;
+    clusters->gap_index = -1;
+
+    for(int8_t i = 0; i < clusters->count; i++) {
+        uint32_t peak = clusters->clusters[i].peak;
+        if(clusters->short_index < 0 || peak > clusters->clusters[clusters->short_index].peak) {
+            clusters->long_index = clusters->short_index;
+            clusters->short_index = i;
+        } else if(
+            clusters->long_index < 0 || peak > clusters->clusters[clusters->long_index].peak) {
+            clusters->long_index = i;
+        }
+    }
+    if(clusters->long_index >= 0 && clusters->long_index < clusters->short_index) {
+        int8_t swap = clusters->short_index;
+        clusters->short_index = clusters->long_index;
+        clusters->long_index = swap;
+    }
+    if(clusters->short_index < 0) return;
+
+    uint32_t gap_min = clusters->clusters[clusters->short_index].mean * 4;
+    if(clusters->long_index >= 0 && clusters->clusters[clusters->long_index].mean >= gap_min) {
+        clusters->gap_index = clusters->long_index;
+        clusters->long_index = -1;
+    }
+    for(int8_t i = clusters->count - 1; i > clusters->short_index; i--) {
+        if(i == clusters->long_index || clusters->clusters[i].mean < gap_min) continue;
+        if(clusters->gap_index < 0 ||
+           clusters->clusters[i].peak > clusters->clusters[clusters->gap_index].peak) {
+            clusters->gap_index = i;
+        }
+    }
+}
+
+bool protopirate_timing_estimator_find(
+    const ProtoPirateTimingEstimator* estimator,
+    ProtoPirateTimingClusters* clusters) {
+    furi_assert(estimator);
+    furi_assert(clusters);
+
+    ProtoPirateTimingCluster candidates[TIMING_CANDIDATE_MAX];
+    ProtoPirateTimingCluster cluster;
+    size_t candidate_count = 0;
+
+    // Smoothed over 3 buckets, so a cluster straddling a bucket edge keeps one peak.
+    // A run of buckets is cut at its lowest point once the counts rise to twice that
+    // again, as long as the peak before it was at least twice as high too.
+    const ProtoPirateTimingBucket* buckets = estimator->buckets;
+    size_t first = 0;
+    bool open = false;
+    uint32_t peak = 0;
+    uint32_t valley = UINT32_MAX;
+    size_t valley_index = 0;
+
+    for(size_t i = 0; i <= PROTOPIRATE_TIMING_BUCKET_COUNT; i++) {
+        uint32_t level = 0;
+        if(i < PROTOPIRATE_TIMING_BUCKET_COUNT && buckets[i].count) {
+            level = buckets[i].count * 2;
+            if(i > 0) level += buckets[i - 1].count;
+            if(i + 1 < PROTOPIRATE_TIMING_BUCKET_COUNT) level += buckets[i + 1].count;
+        }
+
+        if(level == 0) {
+            if(open) {
+                protopirate_timing_cluster_build(estimator, first, i - 1, &cluster);
+                protopirate_timing_candidate_add(candidates, &candidate_count, &cluster);
+                open = false;
+            }
+            continue;
+        }
+
+        if(!open) {
+            open = true;
+            first = i;
+            peak = level;
+            valley = UINT32_MAX;
+            continue;
+        }
+
+        if(valley != UINT32_MAX && level > valley * 2 && peak > valley * 2) {
+            protopirate_timing_cluster_build(estimator, first, valley_index, &cluster);
+            protopirate_timing_candidate_add(candidates, &candidate_count, &cluster);
+            first = valley_index + 1;
+            peak = level;
+            valley = UINT32_MAX;
+        } else if(level > peak) {
+            peak = level;
+            valley = UINT32_MAX;
+        } else if(level < valley) {
+            valley = level;
+            valley_index = i;
+        }
+    }
+
+    // The highest candidates that stand out enough, then in order of duration
+    memset(clusters, 0, sizeof(ProtoPirateTimingClusters));
+    uint32_t min_peak = 0;
+    while(clusters->count < PROTOPIRATE_TIMING_CLUSTER_MAX) {
+        size_t highest = candidate_count;
+        for(size_t i = 0; i < candidate_count; i++) {
+            if(candidates[i].peak == 0 || candidates[i].peak < min_peak) continue;
+            if(highest == candidate_count || candidates[i].peak > candidates[highest].peak) {
+                highest = i;
+            }
+        }
+        if(highest == candidate_count) break;
+        if(clusters->count == 0) {
+            min_peak = candidates[highest].peak * PROTOPIRATE_TIMING_CLUSTER_PERCENT / 100;
+        }
+
+        size_t at = clusters->count;
+        while(at > 0 && clusters->clusters[at - 1].mean > candidates[highest].mean) {
+            clusters->clusters[at] = clusters->clusters[at - 1];
+            at--;
+        }
+        clusters->clusters[at] = candidates[highest];
+        clusters->count++;
+        candidates[highest].peak = 0;
+    }
+
+    protopirate_timing_clusters_classify(clusters);
+    return clusters->count > 0;
+}
+
+int8_t protopirate_timing_clusters_nearest(
+    const ProtoPirateTimingClusters* clusters,
+    uint32_t duration) {
+    furi_assert(clusters);
+
+    int8_t nearest = -1;
+    uint32_t nearest_diff = UINT32_MAX;
+    for(uint8_t i = 0; i < clusters->count; i++) {
+        uint32_t mean = clusters->clusters[i].mean;
+        uint32_t diff = mean > duration ? mean - duration : duration - mean;
+        if(diff < nearest_diff) {
+            nearest = i;
+            nearest_diff = diff;
+        }
+    }
+    return nearest;
+}
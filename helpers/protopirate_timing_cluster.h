@@ -0,0 +1,70 @@
+// helpers/protopirate_timing_cluster.h
+#pragma once
+
+#include <furi.h>
+
+// Log-spaced buckets: 8 per octave from 32 us, everything from 2^17 us on shares the last
+#define PROTOPIRATE_TIMING_BUCKET_OCTAVE_FIRST 5
+#define PROTOPIRATE_TIMING_BUCKETS_PER_OCTAVE  8
+#define PROTOPIRATE_TIMING_BUCKET_COUNT        96
+// Shorter pulses are receiver noise, no keyfob timing is that short
+#define PROTOPIRATE_TIMING_MIN_DURATION 100
+// Counts are halved once this many pulses were added, so old pulses fade out
+#define PROTOPIRATE_TIMING_DECAY_WEIGHT 4096
+// Most clusters reported, and how high a cluster's peak has to reach compared to the
+// highest one to be reported at all
+#define PROTOPIRATE_TIMING_CLUSTER_MAX     4
+#define PROTOPIRATE_TIMING_CLUSTER_PERCENT 12
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint64_t sum_squares;
+} ProtoPirateTimingBucket;
+
+// Streaming duration histogram. Adding a pulse is O(1), the clusters are found from the
+// buckets on demand. Keyfob pulses pile up in a few buckets while noise spreads thin,
+// so clusters are ranked by their peak rather than their weight. Not thread safe, a
+// caller adding and reading from two threads locks around both.
+typedef struct {
+    ProtoPirateTimingBucket buckets[PROTOPIRATE_TIMING_BUCKET_COUNT];
+    uint32_t weight; // Sum of the bucket counts
+    uint32_t pulses; // Added since the last reset, noise and decay included
+} ProtoPirateTimingEstimator;
+
+typedef struct {
+    uint32_t mean;
+    uint32_t spread; // Standard deviation
+    uint32_t min;
+    uint32_t max;
+    uint32_t count; // Decayed weight, not a pulse count
+    uint32_t peak; // Count of its fullest bucket, clusters are ranked by this
+} ProtoPirateTimingCluster;
+
+// Significant clusters in order of duration. The roles are indexes into clusters,
+// -1 when the signal has no such cluster: short and long are the two highest peaks, a
+// gap is the highest one of at least 4 times short.
+typedef struct {
+    ProtoPirateTimingCluster clusters[PROTOPIRATE_TIMING_CLUSTER_MAX];
+    uint8_t count;
+    int8_t short_index;
+    int8_t long_index;
+    int8_t gap_index;
+} ProtoPirateTimingClusters;
+
+void protopirate_timing_estimator_reset(ProtoPirateTimingEstimator* estimator);
+
+void protopirate_timing_estimator_add(ProtoPirateTimingEstimator* estimator, uint32_t duration);
+
+// Splits the histogram at its valleys and keeps the highest clusters. Returns false
+// while nothing stands out, clusters->count is 0 then.
+bool protopirate_timing_estimator_find(
+    const ProtoPirateTimingEstimator* estimator,
+    ProtoPirateTimingClusters* clusters);
+
+// Cluster whose mean is closest to duration, -1 when there are none
+int8_t protopirate_timing_clusters_nearest(
+    const ProtoPirateTimingClusters* clusters,
+    uint32_t duration);
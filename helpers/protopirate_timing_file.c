@@ -0,0 +1,195 @@
+// helpers/protopirate_timing_file.c
+#include "protopirate_timing_file.h"
+#include "protopirate_storage.h"
+
+#define TAG "ProtoPirateTimingFile"
+
+#define TIMING_REPORT_FILETYPE "ProtoPirate Timing Report"
+#define TIMING_REPORT_VERSION  1
+
+bool protopirate_timing_file_open(
+    ProtoPirateTimingFile* file,
+    Storage* storage,
+    const char* path) {
+    furi_assert(file);
+    furi_assert(storage);
+    furi_assert(path);
+
+    memset(file, 0, sizeof(ProtoPirateTimingFile));
+    file->ff = flipper_format_file_alloc(storage);
+    FuriString* temp_str = furi_string_alloc();
+    uint32_t version = 0;
+    bool result = false;
+
+    do {
+        if(!flipper_format_file_open_existing(file->ff, path)) {
+            FURI_LOG_E(TAG, "Failed to open %s", path);
+            break;
+        }
+        if(!flipper_format_read_header(file->ff, temp_str, &version)) {
+            FURI_LOG_E(TAG, "Invalid header in %s", path);
+            break;
+        }
+
+        file->frequency = 433920000;
+        flipper_format_read_uint32(file->ff, "Frequency", &file->frequency, 1);
+
+        if(!flipper_format_read_string(file->ff, "Protocol", temp_str) ||
+           furi_string_cmp_str(temp_str, "RAW") != 0) {
+            FURI_LOG_W(TAG, "Not a RAW recording: %s", path);
+            break;
+        }
+
+        protopirate_raw_reader_init(&file->raw_reader, flipper_format_get_raw_stream(file->ff));
+        result = true;
+    } while(false);
+
+    furi_string_free(temp_str);
+    if(!result) {
+        flipper_format_free(file->ff);
+        file->ff = NULL;
+    }
+    return result;
+}
+
+size_t protopirate_timing_file_read(ProtoPirateTimingFile* file, int32_t* samples, size_t max) {
+    furi_assert(file);
+    furi_assert(file->ff);
+
+    size_t count = protopirate_raw_reader_read(&file->raw_reader, samples, max);
+    file->samples += count;
+    return count;
+}
+
+uint8_t protopirate_timing_file_get_progress(ProtoPirateTimingFile* file) {
+    furi_assert(file);
+    return file->ff ? protopirate_raw_reader_get_progress(&file->raw_reader) : 100;
+}
+
+void protopirate_timing_file_close(ProtoPirateTimingFile* file) {
+    furi_assert(file);
+    if(file->ff) {
+        flipper_format_free(file->ff);
+        file->ff = NULL;
+    }
+}
+
+// Role clusters as mean, spread, min and max, skipped when the signal has no such cluster
+static bool protopirate_timing_file_write_cluster(
+    FlipperFormat* ff,
+    const char* key,
+    const ProtoPirateTimingClusters* clusters,
+    int8_t index) {
+    if(index < 0) return true;
+
+    const ProtoPirateTimingCluster* cluster = &clusters->clusters[index];
+    uint32_t values[] = {cluster->mean, cluster->spread, cluster->min, cluster->max};
+    return flipper_format_write_uint32(ff, key, values, COUNT_OF(values));
+}
+
+bool protopirate_timing_file_save_report(
+    Storage* storage,
+    const ProtoPirateTimingFile* file,
+    const char* source_path,
+    const ProtoPirateTimingEstimator* estimator,
+    const ProtoPirateTimingFit* fit,
+    FuriString* out_path) {
+    furi_assert(storage);
+    furi_assert(file);
+    furi_assert(source_path);
+    furi_assert(estimator);
+    furi_assert(fit);
+
+    size_t rank_max = protopirate_protocol_count();
+    ProtoPirateTimingFitResult* rank = malloc(rank_max * sizeof(ProtoPirateTimingFitResult));
+    ProtoPirateTimingClusters clusters;
+    FlipperFormat* ff = flipper_format_buffered_file_alloc(storage);
+    FuriString* file_path = furi_string_alloc();
+    FuriString* temp_str = furi_string_alloc();
+    bool result = false;
+
+    do {
+        if(!storage_simply_mkdir(storage, PROTOPIRATE_APP_FOLDER) ||
+           !storage_simply_mkdir(storage, PROTOPIRATE_TIMING_REPORT_FOLDER)) {
+            FURI_LOG_E(TAG, "Failed to create timing report folder");
+            break;
+        }
+
+        const char* name = strrchr(source_path, '/');
+        name = name ? name + 1 : source_path;
+        const char* extension = strrchr(name, '.');
+        size_t name_len = extension ? (size_t)(extension - name) : strlen(name);
+        furi_string_printf(
+            file_path,
+            "%s/%.*s%s",
+            PROTOPIRATE_TIMING_REPORT_FOLDER,
+            (int)name_len,
+            name,
+            PROTOPIRATE_TIMING_REPORT_EXTENSION);
+
+        if(!flipper_format_buffered_file_open_always(ff, furi_string_get_cstr(file_path))) {
+            FURI_LOG_E(TAG, "Failed to create file");
+            break;
+        }
+
+        if(!flipper_format_write_header_cstr(ff, TIMING_REPORT_FILETYPE, TIMING_REPORT_VERSION)) {
+            break;
+        }
+        if(!flipper_format_write_string_cstr(ff, "Source", source_path)) break;
+        uint32_t frequency = file->frequency;
+        if(!flipper_format_write_uint32(ff, "Frequency", &frequency, 1)) break;
+        uint32_t samples = file->samples;
+        if(!flipper_format_write_uint32(ff, "Samples", &samples, 1)) break;
+
+        // Clusters in order of duration, each as mean, spread, min, max and weight
+        protopirate_timing_estimator_find(estimator, &clusters);
+        uint32_t cluster_count = clusters.count;
+        if(!flipper_format_write_uint32(ff, "Clusters", &cluster_count, 1)) break;
+        bool written = true;
+        for(uint8_t i = 0; i < clusters.count && written; i++) {
+            const ProtoPirateTimingCluster* cluster = &clusters.clusters[i];
+            uint32_t values[] = {
+                cluster->mean, cluster->spread, cluster->min, cluster->max, cluster->count};
+            char key[12];
+            snprintf(key, sizeof(key), "Cluster_%u", i + 1);
+            written = flipper_format_write_uint32(ff, key, values, COUNT_OF(values));
+        }
+        if(!written) break;
+        if(!protopirate_timing_file_write_cluster(ff, "Short", &clusters, clusters.short_index) ||
+           !protopirate_timing_file_write_cluster(ff, "Long", &clusters, clusters.long_index) ||
+           !protopirate_timing_file_write_cluster(ff, "Gap", &clusters, clusters.gap_index)) {
+            break;
+        }
+
+        // Registry protocols by timing fit, as score and mean error in percent
+        size_t ranked = protopirate_timing_fit_rank(fit, rank, rank_max);
+        for(size_t i = 0; i < ranked && written; i++) {
+            char key[12];
+            snprintf(key, sizeof(key), "Fit_%u", (unsigned)(i + 1));
+            furi_string_printf(
+                temp_str,
+                "%s %u%% e%u.%u%%",
+                rank[i].info->protocol->name,
+                rank[i].score,
+                rank[i].error / 10,
+                rank[i].error % 10);
+            written = flipper_format_write_string(ff, key, temp_str);
+        }
+        if(!written) break;
+
+        if(!flipper_format_buffered_file_close(ff)) {
+            FURI_LOG_E(TAG, "Failed to flush file");
+            break;
+        }
+
+        result = true;
+        if(out_path) furi_string_set(out_path, file_path);
+        FURI_LOG_I(TAG, "Timing report saved to %s", furi_string_get_cstr(file_path));
+    } while(false);
+
+    flipper_format_free(ff);
+    furi_string_free(file_path);
+    furi_string_free(temp_str);
+    free(rank);
+    return result;
+}
@@ -0,0 +1,42 @@
+// helpers/protopirate_timing_file.h
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+#include <flipper_format/flipper_format.h>
+#include "protopirate_raw_reader.h"
+#include "protopirate_timing_cluster.h"
+#include "protopirate_timing_fit.h"
+
+#define PROTOPIRATE_TIMING_REPORT_EXTENSION ".txt"
+
+// A .sub RAW recording read back in chunks, for timing a capture without replaying it
+typedef struct {
+    FlipperFormat* ff;
+    ProtoPirateRawReader raw_reader;
+    uint32_t frequency;
+    uint32_t samples; // Read so far
+} ProtoPirateTimingFile;
+
+// False when the file can't be opened or is not a RAW recording, nothing is left open then
+bool protopirate_timing_file_open(
+    ProtoPirateTimingFile* file,
+    Storage* storage,
+    const char* path);
+
+// Up to max signed durations, 0 once RAW_Data is exhausted
+size_t protopirate_timing_file_read(ProtoPirateTimingFile* file, int32_t* samples, size_t max);
+
+uint8_t protopirate_timing_file_get_progress(ProtoPirateTimingFile* file);
+
+void protopirate_timing_file_close(ProtoPirateTimingFile* file);
+
+// Writes what the estimator and fit made of a file to PROTOPIRATE_TIMING_REPORT_FOLDER,
+// named after the source file and replacing an older report of it
+bool protopirate_timing_file_save_report(
+    Storage* storage,
+    const ProtoPirateTimingFile* file,
+    const char* source_path,
+    const ProtoPirateTimingEstimator* estimator,
+    const ProtoPirateTimingFit* fit,
+    FuriString* out_path);
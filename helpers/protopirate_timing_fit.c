@@ -0,0 +1,166 @@
+// helpers/protopirate_timing_fit.c
+#include "protopirate_timing_fit.h"
+#include <lib/subghz/blocks/math.h>
+
+#define TAG "ProtoPirateTimingFit"
+
+// The rarer of short and long needs 1/16 of the other's hits to count fully, preambles
+// of short pulses alone make Manchester streams lopsided
+#define TIMING_FIT_BALANCE 16
+
+typedef struct {
+    uint16_t te_short;
+    uint16_t te_long;
+    uint16_t te_delta;
+    // Hits in the inner and outer half of each tolerance window. Both halves are as wide,
+    // so noise fills them alike and only pulses piling up at te make the inner one fuller.
+    uint32_t short_inner;
+    uint32_t short_outer;
+    uint32_t long_inner;
+    uint32_t long_outer;
+    uint32_t short_error; // Permille of te, summed over the hits
+    uint32_t long_error;
+} ProtoPirateTimingFitEntry;
+
+struct ProtoPirateTimingFit {
+    size_t count;
+    uint32_t weight; // Pulses scored, halved with the hits
+    uint32_t pulses;
+    ProtoPirateTimingFitEntry entries[];
+};
+
+ProtoPirateTimingFit* protopirate_timing_fit_alloc(void) {
+    size_t count = protopirate_protocol_count();
+    ProtoPirateTimingFit* fit =
+        malloc(sizeof(ProtoPirateTimingFit) + count * sizeof(ProtoPirateTimingFitEntry));
+    fit->count = count;
+    protopirate_timing_fit_reset(fit);
+    return fit;
+}
+
+void protopirate_timing_fit_free(ProtoPirateTimingFit* fit) {
+    furi_assert(fit);
+    free(fit);
+}
+
+void protopirate_timing_fit_reset(ProtoPirateTimingFit* fit) {
+    furi_assert(fit);
+    fit->weight = 0;
+    fit->pulses = 0;
+    for(size_t i = 0; i < fit->count; i++) {
+        // Copied so the per pulse loop stays in one array
+        const SubGhzBlockConst* timing = protopirate_protocol_get_info(i)->timing;
+        ProtoPirateTimingFitEntry* entry = &fit->entries[i];
+        memset(entry, 0, sizeof(ProtoPirateTimingFitEntry));
+        entry->te_short = timing->te_short;
+        entry->te_long = timing->te_long;
+        entry->te_delta = timing->te_delta;
+    }
+}
+
+static void protopirate_timing_fit_decay(ProtoPirateTimingFit* fit) {
+    fit->weight >>= 1;
+    for(size_t i = 0; i < fit->count; i++) {
+        ProtoPirateTimingFitEntry* entry = &fit->entries[i];
+        entry->short_inner >>= 1;
+        entry->short_outer >>= 1;
+        entry->long_inner >>= 1;
+        entry->long_outer >>= 1;
+        entry->short_error >>= 1;
+        entry->long_error >>= 1;
+    }
+}
+
+void protopirate_timing_fit_add(ProtoPirateTimingFit* fit, uint32_t duration) {
+    fit->pulses++;
+    if(duration < PROTOPIRATE_TIMING_FIT_MIN_DURATION) return;
+
+    // A pulse hits the closer of the two timings, if it is within the decoder's tolerance
+    for(size_t i = 0; i < fit->count; i++) {
+        ProtoPirateTimingFitEntry* entry = &fit->entries[i];
+        uint32_t short_diff = DURATION_DIFF(duration, entry->te_short);
+        uint32_t long_diff = DURATION_DIFF(duration, entry->te_long);
+        if(short_diff <= long_diff) {
+            if(short_diff < entry->te_delta) {
+                if(short_diff * 2 < entry->te_delta) {
+                    entry->short_inner++;
+                } else {
+                    entry->short_outer++;
+                }
+                entry->short_error += short_diff * 1000 / entry->te_short;
+            }
+        } else if(long_diff < entry->te_delta) {
+            if(long_diff * 2 < entry->te_delta) {
+                entry->long_inner++;
+            } else {
+                entry->long_outer++;
+            }
+            entry->long_error += long_diff * 1000 / entry->te_long;
+        }
+    }
+
+    if(++fit->weight >= PROTOPIRATE_TIMING_FIT_DECAY_PULSES) {
+        protopirate_timing_fit_decay(fit);
+    }
+}
+
+uint32_t protopirate_timing_fit_get_pulses(const ProtoPirateTimingFit* fit) {
+    furi_assert(fit);
+    return fit->pulses;
+}
+
+static void protopirate_timing_fit_score(
+    const ProtoPirateTimingFit* fit,
+    size_t index,
+    ProtoPirateTimingFitResult* result) {
+    const ProtoPirateTimingFitEntry* entry = &fit->entries[index];
+
+    memset(result, 0, sizeof(ProtoPirateTimingFitResult));
+    result->info = protopirate_protocol_get_info(index);
+    result->short_hits = entry->short_inner + entry->short_outer;
+    result->long_hits = entry->long_inner + entry->long_outer;
+    if(result->short_hits == 0 || result->long_hits == 0 || fit->weight == 0) return;
+
+    // Display only: the worse role's mean distance from te
+    result->error = MAX(
+        entry->short_error / result->short_hits, entry->long_error / result->long_hits);
+    result->coverage = MIN((result->short_hits + result->long_hits) * 100 / fit->weight, 100UL);
+
+    // The pulses standing out of the noise at te, both roles have to have some
+    uint32_t short_excess =
+        entry->short_inner > entry->short_outer ? entry->short_inner - entry->short_outer : 0;
+    uint32_t long_excess =
+        entry->long_inner > entry->long_outer ? entry->long_inner - entry->long_outer : 0;
+    uint32_t rarer = MIN(short_excess, long_excess);
+    uint32_t common = MAX(short_excess, long_excess);
+    if(rarer == 0) return;
+
+    uint32_t balance = MIN(rarer * TIMING_FIT_BALANCE * 1000 / common, 1000UL);
+    uint32_t excess = MIN((short_excess + long_excess) * 1000 / fit->weight, 1000UL);
+    result->score = excess * balance / 10000;
+}
+
+size_t protopirate_timing_fit_rank(
+    const ProtoPirateTimingFit* fit,
+    ProtoPirateTimingFitResult* results,
+    size_t max) {
+    furi_assert(fit);
+    furi_assert(results);
+
+    // Insertion sort into the result array, registry order breaks ties
+    size_t filled = 0;
+    for(size_t i = 0; i < fit->count; i++) {
+        ProtoPirateTimingFitResult result;
+        protopirate_timing_fit_score(fit, i, &result);
+
+        size_t at = filled;
+        while(at > 0 && results[at - 1].score < result.score) {
+            if(at < max) results[at] = results[at - 1];
+            at--;
+        }
+        if(at >= max) continue;
+        results[at] = result;
+        if(filled < max) filled++;
+    }
+    return filled;
+}
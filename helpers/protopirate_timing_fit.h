@@ -0,0 +1,41 @@
+// helpers/protopirate_timing_fit.h
+#pragma once
+
+#include <furi.h>
+#include "../protocols/protocol_items.h"
+
+// Shorter pulses are receiver noise and are not scored
+#define PROTOPIRATE_TIMING_FIT_MIN_DURATION 100
+// Hits are halved once this many pulses were scored, so old signals fade out
+#define PROTOPIRATE_TIMING_FIT_DECAY_PULSES 4096
+
+// How well one registry protocol's timing explains the pulse stream
+typedef struct {
+    const ProtoPirateProtocolInfo* info;
+    uint32_t short_hits; // Pulses within te_delta of te_short
+    uint32_t long_hits; // Pulses within te_delta of te_long
+    uint16_t error; // Mean distance of the hits from te, in permille of te
+    uint8_t coverage; // Percent of the scored pulses that hit
+    uint8_t score; // Percent of the scored pulses that stand out of the noise at te
+} ProtoPirateTimingFitResult;
+
+// Scores every pulse against the timing of every registry protocol at once, O(protocols)
+// per pulse. Not thread safe, a caller adding and ranking from two threads locks.
+typedef struct ProtoPirateTimingFit ProtoPirateTimingFit;
+
+ProtoPirateTimingFit* protopirate_timing_fit_alloc(void);
+void protopirate_timing_fit_free(ProtoPirateTimingFit* fit);
+
+void protopirate_timing_fit_reset(ProtoPirateTimingFit* fit);
+
+void protopirate_timing_fit_add(ProtoPirateTimingFit* fit, uint32_t duration);
+
+// Pulses scored since the last reset, before decay
+uint32_t protopirate_timing_fit_get_pulses(const ProtoPirateTimingFit* fit);
+
+// Fills up to max results, best fit first. Returns how many were filled, which is the
+// registry size when max allows.
+size_t protopirate_timing_fit_rank(
+    const ProtoPirateTimingFit* fit,
+    ProtoPirateTimingFitResult* results,
+    size_t max);
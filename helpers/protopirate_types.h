@@ -21,6 +21,7 @@ typedef enum {
     ProtoPirateCustomEventViewReceiverUnlock,
     // Custom events for scenes
     ProtoPirateCustomEventSceneReceiverUpdate,
+    ProtoPirateCustomEventSceneReceiverDecoded,
     ProtoPirateCustomEventSceneSettingLock,
     // File management
     ProtoPirateCustomEventReceiverInfoSave,
@@ -32,8 +33,17 @@ typedef enum {
     ProtoPirateCustomEventEmulateExit,
     // Sub decode
     ProtoPirateCustomEventSubDecodeSave,
+    // Decoder stats
+    ProtoPirateCustomEventStatsReset,
+    ProtoPirateCustomEventStatsSave,
 } ProtoPirateCustomEvent;
 
+// Timing Tuner scene state: where its pulses come from
+typedef enum {
+    ProtoPirateTimingTunerModeRadio,
+    ProtoPirateTimingTunerModeFile,
+} ProtoPirateTimingTunerMode;
+
 typedef enum {
     ProtoPirateLockOff,
     ProtoPirateLockOn,
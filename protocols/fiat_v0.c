@@ -1,9 +1,10 @@
 #include "fiat_v0.h"
-#include <lib/toolbox/manchester_decoder.h>
+#include "protocol_stats.h"
+#include "protocol_manchester.h"
 
 #define TAG "FiatProtocolV0"
 
-static const SubGhzBlockConst subghz_protocol_fiat_v0_const = {
+const SubGhzBlockConst subghz_protocol_fiat_v0_const = {
     .te_short = 200,
     .te_long = 400,
     .te_delta = 100,
@@ -14,7 +15,7 @@ struct SubGhzProtocolDecoderFiatV0 {
     SubGhzProtocolDecoderBase base;
     SubGhzBlockDecoder decoder;
     SubGhzBlockGeneric generic;
-    ManchesterState manchester_state;
+    uint8_t manchester_state;
     uint8_t decoder_state;
     uint16_t preamble_count;
     uint32_t data_low;
@@ -25,6 +26,8 @@ struct SubGhzProtocolDecoderFiatV0 {
     uint8_t endbyte;
     uint8_t final_count;
     uint32_t te_last;
+
+    ProtoPirateProtocolStats* stats;
 };
 
 struct SubGhzProtocolEncoderFiatV0 {
@@ -70,6 +73,7 @@ void* subghz_protocol_decoder_fiat_v0_alloc(SubGhzEnvironment* environment) {
     UNUSED(environment);
     SubGhzProtocolDecoderFiatV0* instance = malloc(sizeof(SubGhzProtocolDecoderFiatV0));
     instance->base.protocol = &fiat_protocol_v0;
+    instance->stats = protopirate_protocol_stats_get(&fiat_protocol_v0);
     instance->generic.protocol_name = instance->base.protocol->name;
     return instance;
 }
@@ -94,14 +98,15 @@ void subghz_protocol_decoder_fiat_v0_reset(void* context) {
     instance->endbyte = 0;
     instance->final_count = 0;
     instance->te_last = 0;
-    instance->manchester_state = ManchesterStateMid1;
+    instance->manchester_state = protopirate_manchester_toolbox.reset;
 }
 
 void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t duration) {
     furi_assert(context);
     SubGhzProtocolDecoderFiatV0* instance = context;
+    ProtoPirateProtocolStatsMark mark =
+        protopirate_protocol_stats_mark(instance->stats, instance->decoder_state);
     uint32_t te_short = (uint32_t)subghz_protocol_fiat_v0_const.te_short;
-    uint32_t te_long = (uint32_t)subghz_protocol_fiat_v0_const.te_long;
     uint32_t te_delta = (uint32_t)subghz_protocol_fiat_v0_const.te_delta;
     uint32_t gap_threshold = 800;
     uint32_t diff;
@@ -122,11 +127,7 @@ void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t du
             instance->te_last = duration;
             instance->preamble_count = 0;
             instance->bit_count = 0;
-            manchester_advance(
-                instance->manchester_state,
-                ManchesterEventReset,
-                &instance->manchester_state,
-                NULL);
+            instance->manchester_state = protopirate_manchester_toolbox.reset;
         }
         break;
     case FiatV0DecoderStepPreamble:
@@ -145,6 +146,7 @@ void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t du
                         diff = duration - gap_threshold;
                     }
                     if(diff < te_delta) {
+                        protopirate_protocol_stats_lock(instance->stats);
                         instance->decoder_state = FiatV0DecoderStepData;
                         instance->preamble_count = 0;
                         instance->data_low = 0;
@@ -163,6 +165,7 @@ void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t du
                         diff = duration - gap_threshold;
                     }
                     if(diff < te_delta) {
+                        protopirate_protocol_stats_lock(instance->stats);
                         instance->decoder_state = FiatV0DecoderStepData;
                         instance->preamble_count = 0;
                         instance->data_low = 0;
@@ -188,6 +191,7 @@ void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t du
                     diff = gap_threshold - duration;
                 }
                 if(diff < te_delta) {
+                    protopirate_protocol_stats_lock(instance->stats);
                     instance->decoder_state = FiatV0DecoderStepData;
                     instance->preamble_count = 0;
                     instance->data_low = 0;
@@ -200,36 +204,14 @@ void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t du
         }
         break;
     case FiatV0DecoderStepData:
-        ManchesterEvent event = ManchesterEventReset;
-        if(duration < te_short) {
-            diff = te_short - duration;
-            if(diff < te_delta) {
-                event = level ? ManchesterEventShortLow : ManchesterEventShortHigh;
-            }
-        } else {
-            diff = duration - te_short;
-            if(diff < te_delta) {
-                event = level ? ManchesterEventShortLow : ManchesterEventShortHigh;
-            } else {
-                if(duration < te_long) {
-                    diff = te_long - duration;
-                } else {
-                    diff = duration - te_long;
-                }
-                if(diff < te_delta) {
-                    event = level ? ManchesterEventLongLow : ManchesterEventLongHigh;
-                }
-            }
-        }
+        ProtoPirateManchesterEvent event =
+            protopirate_manchester_event(&subghz_protocol_fiat_v0_const, level, duration);
 
-        if(event != ManchesterEventReset) {
-            bool data_bit_bool;
-            if(manchester_advance(
-                   instance->manchester_state,
-                   event,
-                   &instance->manchester_state,
-                   &data_bit_bool)) {
-                uint32_t new_bit = data_bit_bool ? 1 : 0;
+        if(event != ProtoPirateManchesterEventInvalid) {
+            uint8_t entry = protopirate_manchester_advance(
+                &protopirate_manchester_toolbox, &instance->manchester_state, event);
+            if(entry & PROTOPIRATE_MANCHESTER_EMIT) {
+                uint32_t new_bit = (entry & PROTOPIRATE_MANCHESTER_ONE) ? 1 : 0;
 
                 uint32_t carry = (instance->data_low >> 31) & 1;
                 instance->data_low = (instance->data_low << 1) | new_bit;
@@ -256,6 +238,7 @@ void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t du
                         instance->endbyte; // still exported as btn for UI compatibility
                     instance->generic.cnt = instance->hop;
 
+                    instance->stats->decodes++;
                     if(instance->base.callback) {
                         instance->base.callback(&instance->base, instance->base.context);
                     }
@@ -270,6 +253,8 @@ void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t du
         instance->te_last = duration;
         break;
     }
+
+    protopirate_protocol_stats_step(instance->stats, mark, instance->decoder_state);
 }
 
 uint8_t subghz_protocol_decoder_fiat_v0_get_hash_data(void* context) {
@@ -287,15 +272,37 @@ SubGhzProtocolStatus subghz_protocol_decoder_fiat_v0_serialize(
     SubGhzRadioPreset* preset) {
     furi_assert(context);
     SubGhzProtocolDecoderFiatV0* instance = context;
-    return subghz_block_generic_serialize(&instance->generic, flipper_format, preset);
+    SubGhzProtocolStatus ret =
+        subghz_block_generic_serialize(&instance->generic, flipper_format, preset);
+
+    if(ret == SubGhzProtocolStatusOk) {
+        // The end byte is not part of the key, keep it so a reload can show it
+        uint32_t temp = instance->endbyte;
+        flipper_format_write_uint32(flipper_format, "Btn", &temp, 1);
+    }
+    return ret;
 }
 
 SubGhzProtocolStatus
     subghz_protocol_decoder_fiat_v0_deserialize(void* context, FlipperFormat* flipper_format) {
     furi_assert(context);
     SubGhzProtocolDecoderFiatV0* instance = context;
-    return subghz_block_generic_deserialize_check_count_bit(
+    SubGhzProtocolStatus ret = subghz_block_generic_deserialize_check_count_bit(
         &instance->generic, flipper_format, subghz_protocol_fiat_v0_const.min_count_bit_for_found);
+
+    if(ret == SubGhzProtocolStatusOk) {
+        instance->hop = (uint32_t)(instance->generic.data >> 32);
+        instance->fix = (uint32_t)(instance->generic.data & 0xFFFFFFFF);
+        instance->generic.serial = instance->fix;
+        instance->generic.cnt = instance->hop;
+
+        uint32_t temp_val;
+        if(flipper_format_read_uint32(flipper_format, "Btn", &temp_val, 1)) {
+            instance->endbyte = (uint8_t)temp_val;
+            instance->generic.btn = instance->endbyte;
+        }
+    }
+    return ret;
 }
 
 void subghz_protocol_decoder_fiat_v0_get_string(void* context, FuriString* output) {
@@ -7,7 +7,6 @@
 #include <lib/subghz/blocks/encoder.h>
 #include <lib/subghz/blocks/generic.h>
 #include <lib/subghz/blocks/math.h>
-#include <lib/toolbox/manchester_decoder.h>
 #include <flipper_format/flipper_format.h>
 
 #define FIAT_PROTOCOL_V0_NAME "Fiat V0"
@@ -15,6 +14,7 @@
 typedef struct SubGhzProtocolDecoderFiatV0 SubGhzProtocolDecoderFiatV0;
 
 extern const SubGhzProtocol fiat_protocol_v0;
+extern const SubGhzBlockConst subghz_protocol_fiat_v0_const;
 
 void* subghz_protocol_decoder_fiat_v0_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_fiat_v0_free(void* context);
@@ -1,4 +1,7 @@
 #include "ford_v0.h"
+#include "protocol_stats.h"
+#include "protocol_manchester.h"
+#include "protocol_checksum.h"
 #include <lib/subghz/blocks/const.h>
 #include <lib/subghz/blocks/decoder.h>
 #include <lib/subghz/blocks/encoder.h>
@@ -7,7 +10,7 @@
 
 #define TAG "FordProtocolV0"
 
-static const SubGhzBlockConst subghz_protocol_ford_v0_const = {
+const SubGhzBlockConst subghz_protocol_ford_v0_const = {
     .te_short = 250,
     .te_long = 500,
     .te_delta = 100,
@@ -19,7 +22,7 @@ typedef struct SubGhzProtocolDecoderFordV0 {
     SubGhzBlockDecoder decoder;
     SubGhzBlockGeneric generic;
 
-    ManchesterState manchester_state;
+    uint8_t manchester_state;
 
     uint64_t data_low;
     uint64_t data_high;
@@ -32,6 +35,8 @@ typedef struct SubGhzProtocolDecoderFordV0 {
     uint32_t serial;
     uint8_t button;
     uint32_t count;
+
+    ProtoPirateProtocolStats* stats;
 } SubGhzProtocolDecoderFordV0;
 
 typedef enum {
@@ -145,14 +150,7 @@ static void encode_ford_v0(SubGhzProtocolEncoderFordV0* instance) {
     buf[8] = instance->bs;
     buf[9] = instance->crc;
 
-    uint8_t tmp = buf[8];
-    uint8_t parity = 0;
-    uint8_t parity_any = (tmp != 0);
-    while(tmp) {
-        parity ^= (tmp & 1);
-        tmp >>= 1;
-    }
-    buf[11] = parity_any ? parity : 0;
+    buf[11] = protopirate_parity8(buf[8]);
 
     // 4. Reverse the XOR operations (apply them again)
     uint8_t xor_byte;
@@ -211,14 +209,7 @@ static void decode_ford_v0(
     buf[8] = (uint8_t)(key2 >> 8);
     buf[9] = (uint8_t)(key2 & 0xFF);
 
-    uint8_t tmp = buf[8];
-    uint8_t parity = 0;
-    uint8_t parity_any = (tmp != 0);
-    while(tmp) {
-        parity ^= (tmp & 1);
-        tmp >>= 1;
-    }
-    buf[11] = parity_any ? parity : 0;
+    buf[11] = protopirate_parity8(buf[8]);
 
     uint8_t xor_byte;
     uint8_t limit;
@@ -282,6 +273,7 @@ void* subghz_protocol_decoder_ford_v0_alloc(SubGhzEnvironment* environment) {
     UNUSED(environment);
     SubGhzProtocolDecoderFordV0* instance = malloc(sizeof(SubGhzProtocolDecoderFordV0));
     instance->base.protocol = &ford_protocol_v0;
+    instance->stats = protopirate_protocol_stats_get(&ford_protocol_v0);
     instance->generic.protocol_name = instance->base.protocol->name;
     return instance;
 }
@@ -297,7 +289,7 @@ void subghz_protocol_decoder_ford_v0_reset(void* context) {
     SubGhzProtocolDecoderFordV0* instance = context;
     instance->decoder.parser_step = FordV0DecoderStepReset;
     instance->decoder.te_last = 0;
-    instance->manchester_state = ManchesterStateMid1;
+    instance->manchester_state = protopirate_manchester_toolbox.reset;
     instance->data_low = 0;
     instance->data_high = 0;
     instance->bit_count = 0;
@@ -312,6 +304,8 @@ void subghz_protocol_decoder_ford_v0_reset(void* context) {
 void subghz_protocol_decoder_ford_v0_feed(void* context, bool level, uint32_t duration) {
     furi_assert(context);
     SubGhzProtocolDecoderFordV0* instance = context;
+    ProtoPirateProtocolStatsMark mark =
+        protopirate_protocol_stats_mark(instance->stats, instance->decoder.parser_step);
 
     uint32_t te_short = subghz_protocol_ford_v0_const.te_short;
     uint32_t te_long = subghz_protocol_ford_v0_const.te_long;
@@ -327,11 +321,7 @@ void subghz_protocol_decoder_ford_v0_feed(void* context, bool level, uint32_t du
             instance->decoder.te_last = duration;
             instance->header_count = 0;
             instance->bit_count = 0;
-            manchester_advance(
-                instance->manchester_state,
-                ManchesterEventReset,
-                &instance->manchester_state,
-                NULL);
+            instance->manchester_state = protopirate_manchester_toolbox.reset;
         }
         break;
 
@@ -362,6 +352,7 @@ void subghz_protocol_decoder_ford_v0_feed(void* context, bool level, uint32_t du
 
     case FordV0DecoderStepGap:
         if(!level && (DURATION_DIFF(duration, gap_threshold) < 250)) {
+            protopirate_protocol_stats_lock(instance->stats);
             instance->data_low = 1;
             instance->data_high = 0;
             instance->bit_count = 1;
@@ -372,21 +363,17 @@ void subghz_protocol_decoder_ford_v0_feed(void* context, bool level, uint32_t du
         break;
 
     case FordV0DecoderStepData: {
-        ManchesterEvent event;
-
-        if(DURATION_DIFF(duration, te_short) < te_delta) {
-            event = level ? ManchesterEventShortLow : ManchesterEventShortHigh;
-        } else if(DURATION_DIFF(duration, te_long) < te_delta) {
-            event = level ? ManchesterEventLongLow : ManchesterEventLongHigh;
-        } else {
+        ProtoPirateManchesterEvent event =
+            protopirate_manchester_event(&subghz_protocol_ford_v0_const, level, duration);
+        if(event == ProtoPirateManchesterEventInvalid) {
             instance->decoder.parser_step = FordV0DecoderStepReset;
             break;
         }
 
-        bool data_bit;
-        if(manchester_advance(
-               instance->manchester_state, event, &instance->manchester_state, &data_bit)) {
-            ford_v0_add_bit(instance, data_bit);
+        uint8_t entry = protopirate_manchester_advance(
+            &protopirate_manchester_toolbox, &instance->manchester_state, event);
+        if(entry & PROTOPIRATE_MANCHESTER_EMIT) {
+            ford_v0_add_bit(instance, entry & PROTOPIRATE_MANCHESTER_ONE);
 
             if(ford_v0_process_data(instance)) {
                 instance->generic.data = instance->key1;
@@ -395,6 +382,7 @@ void subghz_protocol_decoder_ford_v0_feed(void* context, bool level, uint32_t du
                 instance->generic.btn = instance->button;
                 instance->generic.cnt = instance->count;
 
+                instance->stats->decodes++;
                 if(instance->base.callback) {
                     instance->base.callback(&instance->base, instance->base.context);
                 }
@@ -410,6 +398,8 @@ void subghz_protocol_decoder_ford_v0_feed(void* context, bool level, uint32_t du
         break;
     }
     }
+
+    protopirate_protocol_stats_step(instance->stats, mark, instance->decoder.parser_step);
 }
 
 uint8_t subghz_protocol_decoder_ford_v0_get_hash_data(void* context) {
@@ -426,11 +416,8 @@ SubGhzProtocolStatus subghz_protocol_decoder_ford_v0_serialize(
     furi_assert(context);
     SubGhzProtocolDecoderFordV0* instance = context;
 
-    SubGhzProtocolStatus ret = SubGhzProtocolStatusOk;
-
-    if(!subghz_block_generic_serialize(&instance->generic, flipper_format, preset)) {
-        ret = SubGhzProtocolStatusError;
-    }
+    SubGhzProtocolStatus ret =
+        subghz_block_generic_serialize(&instance->generic, flipper_format, preset);
 
     if(ret == SubGhzProtocolStatusOk) {
         // Add Ford-specific data
@@ -466,13 +453,13 @@ SubGhzProtocolStatus
     subghz_protocol_decoder_ford_v0_deserialize(void* context, FlipperFormat* flipper_format) {
     furi_assert(context);
     SubGhzProtocolDecoderFordV0* instance = context;
-    SubGhzProtocolStatus ret = SubGhzProtocolStatusError;
+    SubGhzProtocolStatus ret = subghz_block_generic_deserialize_check_count_bit(
+        &instance->generic, flipper_format, subghz_protocol_ford_v0_const.min_count_bit_for_found);
 
-    if(subghz_block_generic_deserialize_check_count_bit(
-           &instance->generic,
-           flipper_format,
-           subghz_protocol_ford_v0_const.min_count_bit_for_found)) {
+    if(ret == SubGhzProtocolStatusOk) {
         // The decoder doesn't strictly need these to re-decode, but it does to re-serialize or display correctly.
+        instance->key1 = instance->generic.data;
+
         uint32_t temp_bs = 0, temp_crc = 0;
         flipper_format_read_uint32(flipper_format, "BS", &temp_bs, 1);
         flipper_format_read_uint32(flipper_format, "CRC", &temp_crc, 1);
@@ -483,8 +470,6 @@ SubGhzProtocolStatus
         flipper_format_read_uint32(flipper_format, "Btn", &temp_btn, 1);
         instance->button = temp_btn;
         flipper_format_read_uint32(flipper_format, "Cnt", &instance->count, 1);
-
-        ret = SubGhzProtocolStatusOk;
     }
 
     return ret;
@@ -9,11 +9,11 @@
 #include <lib/subghz/blocks/generic.h>
 #include <lib/subghz/blocks/math.h>
 #include <flipper_format/flipper_format.h>
-#include <lib/toolbox/manchester_decoder.h>
 
 #define FORD_PROTOCOL_V0_NAME "Ford V0"
 
 extern const SubGhzProtocol ford_protocol_v0;
+extern const SubGhzBlockConst subghz_protocol_ford_v0_const;
 
 void* subghz_protocol_decoder_ford_v0_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_ford_v0_free(void* context);
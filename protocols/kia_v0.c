@@ -1,11 +1,19 @@
 #include "kia_v0.h"
+#include "protocol_checksum.h"
+#include "protocol_pwm.h"
+#include "protocol_stats.h"
+#include "protocol_trace.h"
 
 #define TAG "KiaProtocolV0"
 
-static const SubGhzBlockConst subghz_protocol_kia_const = {
-    .te_short = 250,
-    .te_long = 500,
-    .te_delta = 100,
+#define KIA_TE_SHORT 250
+#define KIA_TE_LONG  500
+#define KIA_TE_DELTA 100
+
+const SubGhzBlockConst subghz_protocol_kia_const = {
+    .te_short = KIA_TE_SHORT,
+    .te_long = KIA_TE_LONG,
+    .te_delta = KIA_TE_DELTA,
     .min_count_bit_for_found = 61,
 };
 
@@ -17,7 +25,9 @@ struct SubGhzProtocolDecoderKIA {
     SubGhzProtocolDecoderBase base;
     SubGhzBlockDecoder decoder;
     SubGhzBlockGeneric generic;
-    uint16_t header_count;
+    ProtoPiratePwm pwm;
+
+    ProtoPirateProtocolStats* stats;
 };
 
 struct SubGhzProtocolEncoderKIA {
@@ -37,11 +47,76 @@ struct SubGhzProtocolEncoderKIA {
 
 typedef enum {
     KIADecoderStepReset = 0,
-    KIADecoderStepCheckPreambula,
+    KIADecoderStepCheckPreambula, // Last HIGH was short
+    KIADecoderStepCheckPreambulaLong,
     KIADecoderStepSaveDuration,
-    KIADecoderStepCheckDuration,
+    KIADecoderStepCheckDuration, // Last HIGH was short
+    KIADecoderStepCheckDurationLong,
+    KIADecoderStepCheckDurationInvalid, // Any pulse resets
 } KIADecoderStep;
 
+#define KIA_SHORT PROTOPIRATE_PWM_NEAR(KIA_TE_SHORT, KIA_TE_DELTA)
+#define KIA_LONG  PROTOPIRATE_PWM_NEAR(KIA_TE_LONG, KIA_TE_DELTA)
+#define KIA_END   PROTOPIRATE_PWM_ABOVE(KIA_TE_LONG + KIA_TE_DELTA * 2 - 1)
+
+static const ProtoPiratePwmRule kia_pwm_reset_high[] = {
+    {KIA_SHORT, PROTOPIRATE_PWM_START, KIADecoderStepCheckPreambula},
+};
+
+// Short HIGH + short LOW pairs count as header, a long HIGH + long LOW pair after enough of
+// them starts the data as its first 1. The frame counts one more bit than it carries.
+static const ProtoPiratePwmRule kia_pwm_preambula_high[] = {
+    {KIA_SHORT, 0, KIADecoderStepCheckPreambula},
+    {KIA_LONG, 0, KIADecoderStepCheckPreambulaLong},
+};
+
+static const ProtoPiratePwmRule kia_pwm_preambula_low[] = {
+    {KIA_SHORT, PROTOPIRATE_PWM_COUNT, KIADecoderStepCheckPreambula},
+};
+
+static const ProtoPiratePwmRule kia_pwm_preambula_long_low[] = {
+    {KIA_LONG,
+     PROTOPIRATE_PWM_PREAMBLE | PROTOPIRATE_PWM_LOCK | PROTOPIRATE_PWM_BIT | PROTOPIRATE_PWM_ONE,
+     KIADecoderStepSaveDuration},
+};
+
+// A bit is a HIGH + LOW pair of equal length, short for 0 and long for 1
+static const ProtoPiratePwmRule kia_pwm_save_high[] = {
+    {KIA_END, PROTOPIRATE_PWM_END, KIADecoderStepReset},
+    {KIA_SHORT, 0, KIADecoderStepCheckDuration},
+    {KIA_LONG, 0, KIADecoderStepCheckDurationLong},
+    {PROTOPIRATE_PWM_ANY, 0, KIADecoderStepCheckDurationInvalid},
+};
+
+static const ProtoPiratePwmRule kia_pwm_check_low[] = {
+    {KIA_SHORT, PROTOPIRATE_PWM_BIT, KIADecoderStepSaveDuration},
+};
+
+static const ProtoPiratePwmRule kia_pwm_check_long_low[] = {
+    {KIA_LONG, PROTOPIRATE_PWM_BIT | PROTOPIRATE_PWM_ONE, KIADecoderStepSaveDuration},
+};
+
+static const ProtoPiratePwmStep kia_pwm_steps[] = {
+    [KIADecoderStepReset] = PROTOPIRATE_PWM_STEP_HIGH(kia_pwm_reset_high),
+    [KIADecoderStepCheckPreambula] =
+        PROTOPIRATE_PWM_STEP(kia_pwm_preambula_low, kia_pwm_preambula_high),
+    [KIADecoderStepCheckPreambulaLong] =
+        PROTOPIRATE_PWM_STEP(kia_pwm_preambula_long_low, kia_pwm_preambula_high),
+    [KIADecoderStepSaveDuration] = PROTOPIRATE_PWM_STEP_HIGH(kia_pwm_save_high),
+    [KIADecoderStepCheckDuration] = PROTOPIRATE_PWM_STEP_LOW(kia_pwm_check_low),
+    [KIADecoderStepCheckDurationLong] = PROTOPIRATE_PWM_STEP_LOW(kia_pwm_check_long_low),
+    [KIADecoderStepCheckDurationInvalid] = {{PROTOPIRATE_PWM_NONE, PROTOPIRATE_PWM_NONE}},
+};
+
+static const ProtoPiratePwmDescriptor kia_pwm = {
+    .steps = kia_pwm_steps,
+    .step_count = COUNT_OF(kia_pwm_steps),
+    .preamble_min = 16,
+    .seed_bits = 1,
+    .min_bits = 61,
+    .max_bits = 61,
+};
+
 // Forward declarations for encoder
 void* subghz_protocol_encoder_kia_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_encoder_kia_free(void* context);
@@ -78,40 +153,13 @@ const SubGhzProtocol kia_protocol_v0 = {
     .encoder = &subghz_protocol_kia_encoder,
 };
 
-/**
- * CRC8 calculation for Kia protocol
- * Polynomial: 0x7F
- * Initial value: 0x00
- * MSB-first processing
- */
-static uint8_t kia_crc8(uint8_t* data, size_t len) {
-    uint8_t crc = 0;
-    for(size_t i = 0; i < len; i++) {
-        crc ^= data[i];
-        for(size_t j = 0; j < 8; j++) {
-            if((crc & 0x80) != 0)
-                crc = (uint8_t)((crc << 1) ^ 0x7F);
-            else
-                crc <<= 1;
-        }
-    }
-    return crc;
-}
-
 /**
  * Calculate CRC for the Kia data packet
+ * CRC8, polynomial 0x7F, initial value 0x00, MSB first
  * CRC is calculated over bits 8-55 (6 bytes)
  */
 static uint8_t kia_calculate_crc(uint64_t data) {
-    uint8_t crc_data[6];
-    crc_data[0] = (data >> 48) & 0xFF;
-    crc_data[1] = (data >> 40) & 0xFF;
-    crc_data[2] = (data >> 32) & 0xFF;
-    crc_data[3] = (data >> 24) & 0xFF;
-    crc_data[4] = (data >> 16) & 0xFF;
-    crc_data[5] = (data >> 8) & 0xFF;
-
-    return kia_crc8(crc_data, 6);
+    return protopirate_crc8(protopirate_crc8_kia, 0, data >> 8, 6);
 }
 
 /**
@@ -121,12 +169,7 @@ static bool kia_verify_crc(uint64_t data) {
     uint8_t received_crc = data & 0xFF;
     uint8_t calculated_crc = kia_calculate_crc(data);
 
-    FURI_LOG_D(
-        TAG,
-        "CRC Check - Received: 0x%02X, Calculated: 0x%02X, Match: %s",
-        received_crc,
-        calculated_crc,
-        (received_crc == calculated_crc) ? "YES" : "NO");
+    protopirate_trace(ProtoPirateTraceCrc, KIA_PROTOCOL_V0_NAME, received_crc, calculated_crc);
 
     return (received_crc == calculated_crc);
 }
@@ -466,7 +509,9 @@ void* subghz_protocol_decoder_kia_alloc(SubGhzEnvironment* environment) {
     UNUSED(environment);
     SubGhzProtocolDecoderKIA* instance = malloc(sizeof(SubGhzProtocolDecoderKIA));
     instance->base.protocol = &kia_protocol_v0;
+    instance->stats = protopirate_protocol_stats_get(&kia_protocol_v0);
     instance->generic.protocol_name = instance->base.protocol->name;
+    protopirate_pwm_reset(&instance->pwm);
     return instance;
 }
 
@@ -479,134 +524,34 @@ void subghz_protocol_decoder_kia_free(void* context) {
 void subghz_protocol_decoder_kia_reset(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderKIA* instance = context;
-    instance->decoder.parser_step = KIADecoderStepReset;
+    protopirate_pwm_reset(&instance->pwm);
 }
 
 void subghz_protocol_decoder_kia_feed(void* context, bool level, uint32_t duration) {
     furi_assert(context);
     SubGhzProtocolDecoderKIA* instance = context;
+    ProtoPirateProtocolStatsMark mark =
+        protopirate_protocol_stats_mark(instance->stats, instance->pwm.step);
 
-    switch(instance->decoder.parser_step) {
-    case KIADecoderStepReset:
-        if((level) && (DURATION_DIFF(duration, subghz_protocol_kia_const.te_short) <
-                       subghz_protocol_kia_const.te_delta)) {
-            instance->decoder.parser_step = KIADecoderStepCheckPreambula;
-            instance->decoder.te_last = duration;
-            instance->header_count = 0;
-        }
-        break;
-
-    case KIADecoderStepCheckPreambula:
-        if(level) {
-            if((DURATION_DIFF(duration, subghz_protocol_kia_const.te_short) <
-                subghz_protocol_kia_const.te_delta) ||
-               (DURATION_DIFF(duration, subghz_protocol_kia_const.te_long) <
-                subghz_protocol_kia_const.te_delta)) {
-                instance->decoder.te_last = duration;
-            } else {
-                instance->decoder.parser_step = KIADecoderStepReset;
-            }
-        } else if(
-            (DURATION_DIFF(duration, subghz_protocol_kia_const.te_short) <
-             subghz_protocol_kia_const.te_delta) &&
-            (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_kia_const.te_short) <
-             subghz_protocol_kia_const.te_delta)) {
-            instance->header_count++;
-            break;
-        } else if(
-            (DURATION_DIFF(duration, subghz_protocol_kia_const.te_long) <
-             subghz_protocol_kia_const.te_delta) &&
-            (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_kia_const.te_long) <
-             subghz_protocol_kia_const.te_delta)) {
-            if(instance->header_count > 15) {
-                instance->decoder.parser_step = KIADecoderStepSaveDuration;
-                instance->decoder.decode_data = 0;
-                instance->decoder.decode_count_bit = 1;
-                subghz_protocol_blocks_add_bit(&instance->decoder, 1);
-                FURI_LOG_I(
-                    TAG, "Starting data decode after %u header pulses", instance->header_count);
-            } else {
-                instance->decoder.parser_step = KIADecoderStepReset;
-            }
-        } else {
-            instance->decoder.parser_step = KIADecoderStepReset;
-        }
-        break;
-
-    case KIADecoderStepSaveDuration:
-        if(level) {
-            if(duration >=
-               (subghz_protocol_kia_const.te_long + subghz_protocol_kia_const.te_delta * 2UL)) {
-                // End of transmission detected
-                instance->decoder.parser_step = KIADecoderStepReset;
-
-                if(instance->decoder.decode_count_bit ==
-                   subghz_protocol_kia_const.min_count_bit_for_found) {
-                    instance->generic.data = instance->decoder.decode_data;
-                    instance->generic.data_count_bit = instance->decoder.decode_count_bit;
-
-                    if(kia_verify_crc(instance->generic.data)) {
-                        FURI_LOG_I(TAG, "Valid signal received with correct CRC");
-                    } else {
-                        FURI_LOG_W(TAG, "Signal received but CRC mismatch!");
-                    }
-
-                    if(instance->base.callback)
-                        instance->base.callback(&instance->base, instance->base.context);
-                } else {
-                    FURI_LOG_E(
-                        TAG,
-                        "Incomplete signal: only %u bits",
-                        instance->decoder.decode_count_bit);
-                }
-
-                instance->decoder.decode_data = 0;
-                instance->decoder.decode_count_bit = 0;
-                break;
-            } else {
-                instance->decoder.te_last = duration;
-                instance->decoder.parser_step = KIADecoderStepCheckDuration;
-            }
-        } else {
-            instance->decoder.parser_step = KIADecoderStepReset;
-        }
-        break;
-
-    case KIADecoderStepCheckDuration:
-        if(!level) {
-            if((DURATION_DIFF(instance->decoder.te_last, subghz_protocol_kia_const.te_short) <
-                subghz_protocol_kia_const.te_delta) &&
-               (DURATION_DIFF(duration, subghz_protocol_kia_const.te_short) <
-                subghz_protocol_kia_const.te_delta)) {
-                subghz_protocol_blocks_add_bit(&instance->decoder, 0);
-                if(instance->decoder.decode_count_bit % 10 == 0) {
-                    FURI_LOG_D(TAG, "Decoded %u bits so far", instance->decoder.decode_count_bit);
-                }
-                instance->decoder.parser_step = KIADecoderStepSaveDuration;
-            } else if(
-                (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_kia_const.te_long) <
-                 subghz_protocol_kia_const.te_delta) &&
-                (DURATION_DIFF(duration, subghz_protocol_kia_const.te_long) <
-                 subghz_protocol_kia_const.te_delta)) {
-                subghz_protocol_blocks_add_bit(&instance->decoder, 1);
-                if(instance->decoder.decode_count_bit % 10 == 0) {
-                    FURI_LOG_D(TAG, "Decoded %u bits so far", instance->decoder.decode_count_bit);
-                }
-                instance->decoder.parser_step = KIADecoderStepSaveDuration;
-            } else {
-                FURI_LOG_W(
-                    TAG,
-                    "Timing mismatch at bit %u. Last: %lu, Current: %lu",
-                    instance->decoder.decode_count_bit,
-                    instance->decoder.te_last,
-                    duration);
-                instance->decoder.parser_step = KIADecoderStepReset;
-            }
-        } else {
-            instance->decoder.parser_step = KIADecoderStepReset;
+    if(protopirate_pwm_feed(&instance->pwm, &kia_pwm, instance->stats, level, duration)) {
+        instance->decoder.decode_data = instance->pwm.data;
+        instance->decoder.decode_count_bit = instance->pwm.bits;
+        instance->generic.data = instance->decoder.decode_data;
+        instance->generic.data_count_bit = instance->decoder.decode_count_bit;
+
+        if(!kia_verify_crc(instance->generic.data)) {
+            protopirate_protocol_stats_fail(instance->stats, "CRC mismatch", mark.step);
         }
-        break;
+
+        instance->stats->decodes++;
+        if(instance->base.callback)
+            instance->base.callback(&instance->base, instance->base.context);
+
+        instance->decoder.decode_data = 0;
+        instance->decoder.decode_count_bit = 0;
     }
+
+    protopirate_protocol_stats_step(instance->stats, mark, instance->pwm.step);
 }
 
 static void subghz_protocol_kia_check_remote_controller(SubGhzBlockGeneric* instance) {
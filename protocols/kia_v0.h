@@ -10,6 +10,7 @@ typedef struct SubGhzProtocolEncoderKIA SubGhzProtocolEncoderKIA;
 extern const SubGhzProtocolDecoder subghz_protocol_kia_decoder;
 extern const SubGhzProtocolEncoder subghz_protocol_kia_encoder;
 extern const SubGhzProtocol kia_protocol_v0;
+extern const SubGhzBlockConst subghz_protocol_kia_const;
 
 // Decoder functions
 void* subghz_protocol_decoder_kia_alloc(SubGhzEnvironment* environment);
@@ -1,4 +1,8 @@
 #include "kia_v1.h"
+#include "protocol_stats.h"
+#include "protocol_trace.h"
+#include "protocol_manchester.h"
+#include "protocol_checksum.h"
 
 #define TAG "KiaV1"
 
@@ -11,7 +15,7 @@
 // 402087D2395BAA50
 
 // OOK PCM 800µs timing
-static const SubGhzBlockConst kia_protocol_v1_const = {
+const SubGhzBlockConst kia_protocol_v1_const = {
     .te_short = 800,
     .te_long = 1600,
     .te_delta = 200,
@@ -24,8 +28,9 @@ struct SubGhzProtocolDecoderKiaV1 {
     SubGhzBlockGeneric generic;
     uint16_t header_count;
 
-    uint8_t raw_bits[24];
-    uint16_t raw_bit_count;
+    ProtoPirateManchesterFrame frame;
+
+    ProtoPirateProtocolStats* stats;
 };
 
 struct SubGhzProtocolEncoderKiaV1 {
@@ -41,21 +46,9 @@ struct SubGhzProtocolEncoderKiaV1 {
 };
 
 static uint8_t kia_v1_calculate_crc(uint64_t data) {
-    uint8_t crc = 0;
     // Calculate CRC over bits 8-55 (Serial, Btn, Cnt)
     // 6 bytes total: 4 bytes Serial, 1 byte Btn, 1 byte Cnt
-    for(int i = 6; i >= 1; i--) {
-        uint8_t byte = (data >> (i * 8)) & 0xFF;
-        crc ^= byte;
-        for(int j = 0; j < 8; j++) {
-            if(crc & 0x80) {
-                crc = (crc << 1) ^ 0x7F;
-            } else {
-                crc <<= 1;
-            }
-        }
-    }
-    return crc;
+    return protopirate_crc8(protopirate_crc8_kia, 0, data >> 8, 6);
 }
 
 typedef enum {
@@ -65,6 +58,15 @@ typedef enum {
     KiaV1DecoderStepCollectRawBits,
 } KiaV1DecoderStep;
 
+// V1 uses 10=1, 01=0. The first 8 half-bits are tried as start (RTL-433 uses -1 bit offset)
+static const ProtoPirateManchesterFrameConfig kia_v1_manchester = {
+    .table = &protopirate_manchester_pairs_10,
+    .phases = 2,
+    .first_pair = 0,
+    .last_start = 3,
+    .max_bits = 56,
+};
+
 // Forward declarations
 void* kia_protocol_encoder_v1_alloc(SubGhzEnvironment* environment);
 void kia_protocol_encoder_v1_free(void* context);
@@ -100,71 +102,24 @@ const SubGhzProtocol kia_protocol_v1 = {
     .encoder = &kia_protocol_v1_encoder,
 };
 
-static void kia_v1_add_raw_bit(SubGhzProtocolDecoderKiaV1* instance, bool bit) {
-    if(instance->raw_bit_count < 192) {
-        uint16_t byte_idx = instance->raw_bit_count / 8;
-        uint8_t bit_idx = 7 - (instance->raw_bit_count % 8);
-        if(bit) {
-            instance->raw_bits[byte_idx] |= (1 << bit_idx);
-        } else {
-            instance->raw_bits[byte_idx] &= ~(1 << bit_idx);
-        }
-        instance->raw_bit_count++;
-    }
-}
-
-static inline bool kia_v1_get_raw_bit(SubGhzProtocolDecoderKiaV1* instance, uint16_t idx) {
-    uint16_t byte_idx = idx / 8;
-    uint8_t bit_idx = 7 - (idx % 8);
-    return (instance->raw_bits[byte_idx] >> bit_idx) & 1;
-}
-
 static bool kia_v1_manchester_decode(SubGhzProtocolDecoderKiaV1* instance) {
-    if(instance->raw_bit_count < 113) {
-        FURI_LOG_D(TAG, "Not enough raw bits: %u", instance->raw_bit_count);
+    // Too short a frame shows in the trace as a frame end below 113 half bits
+    if(instance->frame.half_bits < 113) {
         return false;
     }
 
-    // Try different offsets to find best alignment (RTL-433 uses -1 bit offset)
-    uint16_t best_bits = 0;
-    uint64_t best_data = 0;
-    uint16_t best_offset = 0;
-
-    for(uint16_t offset = 0; offset < 8; offset++) {
-        uint64_t data = 0;
-        uint16_t decoded_bits = 0;
+    protopirate_manchester_frame_end(&instance->frame);
 
-        for(uint16_t i = offset; i + 1 < instance->raw_bit_count && decoded_bits < 56; i += 2) {
-            bool bit1 = kia_v1_get_raw_bit(instance, i);
-            bool bit2 = kia_v1_get_raw_bit(instance, i + 1);
+    protopirate_trace(
+        ProtoPirateTraceManchester,
+        KIA_PROTOCOL_V1_NAME,
+        instance->frame.best_offset,
+        instance->frame.best_bits);
 
-            uint8_t two_bits = (bit1 << 1) | bit2;
+    instance->decoder.decode_data = instance->frame.best_data;
+    instance->decoder.decode_count_bit = instance->frame.best_bits;
 
-            // V1 uses: 10=1, 01=0
-            if(two_bits == 0x02) { // 10 = decoded 1
-                data = (data << 1) | 1;
-                decoded_bits++;
-            } else if(two_bits == 0x01) { // 01 = decoded 0
-                data = (data << 1);
-                decoded_bits++;
-            } else {
-                break;
-            }
-        }
-
-        if(decoded_bits > best_bits) {
-            best_bits = decoded_bits;
-            best_data = data;
-            best_offset = offset;
-        }
-    }
-
-    FURI_LOG_I(TAG, "Best: offset=%u bits=%u data=%014llX", best_offset, best_bits, best_data);
-
-    instance->decoder.decode_data = best_data;
-    instance->decoder.decode_count_bit = best_bits;
-
-    return best_bits >= kia_protocol_v1_const.min_count_bit_for_found;
+    return instance->frame.best_bits >= kia_protocol_v1_const.min_count_bit_for_found;
 }
 
 // ============================================================================
@@ -176,6 +131,7 @@ void *kia_protocol_decoder_v1_alloc(SubGhzEnvironment *environment)
     UNUSED(environment);
     SubGhzProtocolDecoderKiaV1* instance = malloc(sizeof(SubGhzProtocolDecoderKiaV1));
     instance->base.protocol = &kia_protocol_v1;
+    instance->stats = protopirate_protocol_stats_get(&kia_protocol_v1);
     instance->generic.protocol_name = instance->base.protocol->name;
     return instance;
 }
@@ -191,13 +147,14 @@ void kia_protocol_decoder_v1_reset(void* context) {
     SubGhzProtocolDecoderKiaV1* instance = context;
     instance->decoder.parser_step = KiaV1DecoderStepReset;
     instance->header_count = 0;
-    instance->raw_bit_count = 0;
-    memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
+    protopirate_manchester_frame_start(&instance->frame, &kia_v1_manchester);
 }
 
 void kia_protocol_decoder_v1_feed(void* context, bool level, uint32_t duration) {
     furi_assert(context);
     SubGhzProtocolDecoderKiaV1* instance = context;
+    ProtoPirateProtocolStatsMark mark =
+        protopirate_protocol_stats_mark(instance->stats, instance->decoder.parser_step);
 
     switch(instance->decoder.parser_step) {
     case KiaV1DecoderStepReset:
@@ -245,12 +202,14 @@ void kia_protocol_decoder_v1_feed(void* context, bool level, uint32_t duration)
         // Expecting SHORT HIGH to complete sync
         if(level && (DURATION_DIFF(duration, kia_protocol_v1_const.te_short) <
                      kia_protocol_v1_const.te_delta)) {
-            FURI_LOG_I(TAG, "Sync! hdr=%u", instance->header_count);
+            protopirate_trace(
+                ProtoPirateTraceSync, KIA_PROTOCOL_V1_NAME, instance->header_count, 0);
+            protopirate_protocol_stats_lock(instance->stats);
             instance->decoder.parser_step = KiaV1DecoderStepCollectRawBits;
-            instance->raw_bit_count = 0;
-            memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
+            protopirate_manchester_frame_start(&instance->frame, &kia_v1_manchester);
             // Add the sync short HIGH as first raw bit
-            kia_v1_add_raw_bit(instance, true);
+            protopirate_manchester_frame_feed(
+                &instance->frame, ProtoPirateManchesterEventShortHigh);
         } else {
             instance->decoder.parser_step = KiaV1DecoderStepReset;
         }
@@ -258,7 +217,8 @@ void kia_protocol_decoder_v1_feed(void* context, bool level, uint32_t duration)
 
     case KiaV1DecoderStepCollectRawBits:
         if(duration > 2400) {
-            FURI_LOG_I(TAG, "End! raw_bits=%u", instance->raw_bit_count);
+            protopirate_trace(
+                ProtoPirateTraceFrameEnd, KIA_PROTOCOL_V1_NAME, instance->frame.half_bits, 0);
 
             if(kia_v1_manchester_decode(instance)) {
                 instance->generic.data = instance->decoder.decode_data;
@@ -273,47 +233,35 @@ void kia_protocol_decoder_v1_feed(void* context, bool level, uint32_t duration)
                 instance->generic.btn = (uint8_t)((instance->generic.data >> 16) & 0xFF);
                 instance->generic.cnt = (uint8_t)((instance->generic.data >> 8) & 0xFF);
 
-                FURI_LOG_I(
-                    TAG,
-                    "DECODE! Key=%014llX Sn=%08lX Btn=%02X Cnt=%02X",
-                    instance->generic.data,
-                    instance->generic.serial,
-                    instance->generic.btn,
-                    (uint8_t)instance->generic.cnt);
+                protopirate_trace_u64(
+                    ProtoPirateTraceKey, KIA_PROTOCOL_V1_NAME, instance->generic.data);
 
+                instance->stats->decodes++;
                 if(instance->base.callback)
                     instance->base.callback(&instance->base, instance->base.context);
+            } else {
+                protopirate_protocol_stats_fail(
+                    instance->stats, "Manchester decode failed", instance->decoder.parser_step);
             }
 
             instance->decoder.parser_step = KiaV1DecoderStepReset;
             break;
         }
 
-        int num_bits = 0;
-        if(DURATION_DIFF(duration, kia_protocol_v1_const.te_short) <
-           kia_protocol_v1_const.te_delta) {
-            num_bits = 1;
-        } else if(
-            DURATION_DIFF(duration, kia_protocol_v1_const.te_long) <
-            kia_protocol_v1_const.te_delta) {
-            num_bits = 2;
-        } else {
-            FURI_LOG_D(
-                TAG,
-                "Invalid pulse: %s %lu, raw_bits=%u",
-                level ? "H" : "L",
-                duration,
-                instance->raw_bit_count);
+        ProtoPirateManchesterEvent event =
+            protopirate_manchester_event(&kia_protocol_v1_const, level, duration);
+        if(event == ProtoPirateManchesterEventInvalid) {
+            protopirate_trace(
+                ProtoPirateTraceInvalidPulse, KIA_PROTOCOL_V1_NAME, level, duration);
             instance->decoder.parser_step = KiaV1DecoderStepReset;
             break;
         }
 
-        for(int i = 0; i < num_bits; i++) {
-            kia_v1_add_raw_bit(instance, level);
-        }
-
+        protopirate_manchester_frame_feed(&instance->frame, event);
         break;
     }
+
+    protopirate_protocol_stats_step(instance->stats, mark, instance->decoder.parser_step);
 }
 
 uint8_t kia_protocol_decoder_v1_get_hash_data(void* context) {
@@ -372,8 +320,15 @@ SubGhzProtocolStatus
     kia_protocol_decoder_v1_deserialize(void* context, FlipperFormat* flipper_format) {
     furi_assert(context);
     SubGhzProtocolDecoderKiaV1* instance = context;
-    return subghz_block_generic_deserialize_check_count_bit(
+    SubGhzProtocolStatus ret = subghz_block_generic_deserialize_check_count_bit(
         &instance->generic, flipper_format, kia_protocol_v1_const.min_count_bit_for_found);
+
+    if(ret == SubGhzProtocolStatusOk) {
+        instance->generic.serial = (uint32_t)((instance->generic.data >> 24) & 0xFFFFFFFF);
+        instance->generic.btn = (uint8_t)((instance->generic.data >> 16) & 0xFF);
+        instance->generic.cnt = (uint8_t)((instance->generic.data >> 8) & 0xFF);
+    }
+    return ret;
 }
 
 void kia_protocol_decoder_v1_get_string(void* context, FuriString* output) {
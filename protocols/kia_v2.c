@@ -1,4 +1,6 @@
 #include "kia_v2.h"
+#include "protocol_stats.h"
+#include "protocol_manchester.h"
 #include <lib/subghz/blocks/const.h>
 #include <lib/subghz/blocks/decoder.h>
 #include <lib/subghz/blocks/encoder.h>
@@ -7,7 +9,7 @@
 
 #define TAG "KiaV2"
 
-static const SubGhzBlockConst kia_protocol_v2_const = {
+const SubGhzBlockConst kia_protocol_v2_const = {
     .te_short = 500,
     .te_long = 1000,
     .te_delta = 150,
@@ -20,8 +22,9 @@ struct SubGhzProtocolDecoderKiaV2 {
     SubGhzBlockGeneric generic;
     uint16_t header_count;
 
-    uint8_t raw_bits[20];
-    uint16_t raw_bit_count;
+    ProtoPirateManchesterFrame frame;
+
+    ProtoPirateProtocolStats* stats;
 };
 
 typedef enum {
@@ -49,6 +52,15 @@ typedef enum {
     KiaV2DecoderStepCollectRawBits,
 } KiaV2DecoderStep;
 
+// Pairs are 10 for 1, the first pair falls on any of the first 8 half-bits
+static const ProtoPirateManchesterFrameConfig kia_v2_manchester = {
+    .table = &protopirate_manchester_pairs_10,
+    .phases = 2,
+    .first_pair = 0,
+    .last_start = 3,
+    .max_bits = 53,
+};
+
 const SubGhzProtocolDecoder kia_protocol_v2_decoder = {
     .alloc = kia_protocol_decoder_v2_alloc,
     .free = kia_protocol_decoder_v2_free,
@@ -85,64 +97,16 @@ const SubGhzProtocol kia_protocol_v2 = {
     .encoder = &kia_protocol_v2_encoder,
 };
 
-static void kia_v2_add_raw_bit(SubGhzProtocolDecoderKiaV2* instance, bool bit) {
-    if(instance->raw_bit_count < 160) {
-        uint16_t byte_idx = instance->raw_bit_count / 8;
-        uint8_t bit_idx = 7 - (instance->raw_bit_count % 8);
-        if(bit) {
-            instance->raw_bits[byte_idx] |= (1 << bit_idx);
-        } else {
-            instance->raw_bits[byte_idx] &= ~(1 << bit_idx);
-        }
-        instance->raw_bit_count++;
-    }
-}
-
-static inline bool kia_v2_get_raw_bit(SubGhzProtocolDecoderKiaV2* instance, uint16_t idx) {
-    uint16_t byte_idx = idx / 8;
-    uint8_t bit_idx = 7 - (idx % 8);
-    return (instance->raw_bits[byte_idx] >> bit_idx) & 1;
-}
-
 static bool kia_v2_manchester_decode(SubGhzProtocolDecoderKiaV2* instance) {
-    if(instance->raw_bit_count < 100) {
+    if(instance->frame.half_bits < 100) {
         return false;
     }
 
-    uint16_t best_bits = 0;
-    uint64_t best_data = 0;
-
-    for(uint16_t offset = 0; offset < 8; offset++) {
-        uint64_t data = 0;
-        uint16_t decoded_bits = 0;
-
-        for(uint16_t i = offset; i + 1 < instance->raw_bit_count && decoded_bits < 53; i += 2) {
-            bool bit1 = kia_v2_get_raw_bit(instance, i);
-            bool bit2 = kia_v2_get_raw_bit(instance, i + 1);
-
-            uint8_t two_bits = (bit1 << 1) | bit2;
-
-            if(two_bits == 0x02) {
-                data = (data << 1) | 1;
-                decoded_bits++;
-            } else if(two_bits == 0x01) {
-                data = (data << 1);
-                decoded_bits++;
-            } else {
-                break;
-            }
-        }
-
-        if(decoded_bits > best_bits) {
-            best_bits = decoded_bits;
-            best_data = data;
-        }
-    }
-
-    instance->decoder.decode_data = best_data;
-    instance->decoder.decode_count_bit = best_bits;
+    protopirate_manchester_frame_end(&instance->frame);
+    instance->decoder.decode_data = instance->frame.best_data;
+    instance->decoder.decode_count_bit = instance->frame.best_bits;
 
-    return best_bits >= kia_protocol_v2_const.min_count_bit_for_found;
+    return instance->frame.best_bits >= kia_protocol_v2_const.min_count_bit_for_found;
 }
 
 void* kia_protocol_decoder_v2_alloc(SubGhzEnvironment* environment) {
@@ -150,6 +114,7 @@ void* kia_protocol_decoder_v2_alloc(SubGhzEnvironment* environment) {
     SubGhzProtocolDecoderKiaV2* instance = malloc(sizeof(SubGhzProtocolDecoderKiaV2));
     memset(instance, 0, sizeof(SubGhzProtocolDecoderKiaV2));
     instance->base.protocol = &kia_protocol_v2;
+    instance->stats = protopirate_protocol_stats_get(&kia_protocol_v2);
     instance->generic.protocol_name = instance->base.protocol->name;
     return instance;
 }
@@ -165,13 +130,14 @@ void kia_protocol_decoder_v2_reset(void* context) {
     SubGhzProtocolDecoderKiaV2* instance = context;
     instance->decoder.parser_step = KiaV2DecoderStepReset;
     instance->header_count = 0;
-    instance->raw_bit_count = 0;
-    memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
+    protopirate_manchester_frame_start(&instance->frame, &kia_v2_manchester);
 }
 
 void kia_protocol_decoder_v2_feed(void* context, bool level, uint32_t duration) {
     furi_assert(context);
     SubGhzProtocolDecoderKiaV2* instance = context;
+    ProtoPirateProtocolStatsMark mark =
+        protopirate_protocol_stats_mark(instance->stats, instance->decoder.parser_step);
 
     switch(instance->decoder.parser_step) {
     case KiaV2DecoderStepReset:
@@ -206,9 +172,9 @@ void kia_protocol_decoder_v2_feed(void* context, bool level, uint32_t duration)
                 if(instance->header_count > 10 &&
                    DURATION_DIFF(instance->decoder.te_last, kia_protocol_v2_const.te_short) <
                        kia_protocol_v2_const.te_delta) {
+                    protopirate_protocol_stats_lock(instance->stats);
                     instance->decoder.parser_step = KiaV2DecoderStepCollectRawBits;
-                    instance->raw_bit_count = 0;
-                    memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
+                    protopirate_manchester_frame_start(&instance->frame, &kia_v2_manchester);
                 }
             } else {
                 instance->decoder.parser_step = KiaV2DecoderStepReset;
@@ -228,33 +194,30 @@ void kia_protocol_decoder_v2_feed(void* context, bool level, uint32_t duration)
                 uint16_t raw_count = (uint16_t)((instance->generic.data >> 4) & 0xFFF);
                 instance->generic.cnt = ((raw_count >> 4) | (raw_count << 8)) & 0xFFF;
 
+                instance->stats->decodes++;
                 if(instance->base.callback)
                     instance->base.callback(&instance->base, instance->base.context);
+            } else {
+                protopirate_protocol_stats_fail(
+                    instance->stats, "Manchester decode failed", instance->decoder.parser_step);
             }
 
             instance->decoder.parser_step = KiaV2DecoderStepReset;
             break;
         }
 
-        int num_bits = 0;
-        if(DURATION_DIFF(duration, kia_protocol_v2_const.te_short) <
-           kia_protocol_v2_const.te_delta) {
-            num_bits = 1;
-        } else if(
-            DURATION_DIFF(duration, kia_protocol_v2_const.te_long) <
-            kia_protocol_v2_const.te_delta) {
-            num_bits = 2;
-        } else {
+        ProtoPirateManchesterEvent event =
+            protopirate_manchester_event(&kia_protocol_v2_const, level, duration);
+        if(event == ProtoPirateManchesterEventInvalid) {
             instance->decoder.parser_step = KiaV2DecoderStepReset;
             break;
         }
 
-        for(int i = 0; i < num_bits; i++) {
-            kia_v2_add_raw_bit(instance, level);
-        }
-
+        protopirate_manchester_frame_feed(&instance->frame, event);
         break;
     }
+
+    protopirate_protocol_stats_step(instance->stats, mark, instance->decoder.parser_step);
 }
 
 uint8_t kia_protocol_decoder_v2_get_hash_data(void* context) {
@@ -300,8 +263,14 @@ SubGhzProtocolStatus
     kia_protocol_decoder_v2_deserialize(void* context, FlipperFormat* flipper_format) {
     furi_assert(context);
     SubGhzProtocolDecoderKiaV2* instance = context;
-    SubGhzProtocolStatus ret = subghz_block_generic_deserialize_check_count_bit(
-        &instance->generic, flipper_format, kia_protocol_v2_const.min_count_bit_for_found);
+    SubGhzProtocolStatus ret =
+        subghz_block_generic_deserialize(&instance->generic, flipper_format);
+
+    // The decoder accepts frames of min_count_bit_for_found bits or longer
+    if(ret == SubGhzProtocolStatusOk &&
+       instance->generic.data_count_bit < kia_protocol_v2_const.min_count_bit_for_found) {
+        ret = SubGhzProtocolStatusErrorValueBitCount;
+    }
 
     if(ret == SubGhzProtocolStatusOk) {
         uint32_t temp_val;
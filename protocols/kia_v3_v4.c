@@ -1,4 +1,7 @@
 #include "kia_v3_v4.h"
+#include "protocol_bits.h"
+#include "protocol_pwm.h"
+#include "protocol_stats.h"
 #include <lib/subghz/blocks/const.h>
 #include <lib/subghz/blocks/decoder.h>
 #include <lib/subghz/blocks/encoder.h>
@@ -10,10 +13,14 @@
 static const uint64_t kia_mf_key = 0xA8F5DFFC8DAA5CDB;
 static const char* kia_version_names[] = {"Kia V4", "Kia V3"};
 
-static const SubGhzBlockConst kia_protocol_v3_v4_const = {
-    .te_short = 400,
-    .te_long = 800,
-    .te_delta = 150,
+#define KIA_V3_V4_TE_SHORT 400
+#define KIA_V3_V4_TE_LONG  800
+#define KIA_V3_V4_TE_DELTA 150
+
+const SubGhzBlockConst kia_protocol_v3_v4_const = {
+    .te_short = KIA_V3_V4_TE_SHORT,
+    .te_long = KIA_V3_V4_TE_LONG,
+    .te_delta = KIA_V3_V4_TE_DELTA,
     .min_count_bit_for_found = 64,
 };
 
@@ -21,15 +28,13 @@ typedef struct SubGhzProtocolDecoderKiaV3V4 {
     SubGhzProtocolDecoderBase base;
     SubGhzBlockDecoder decoder;
     SubGhzBlockGeneric generic;
-    uint16_t header_count;
-
-    uint8_t raw_bits[32];
-    uint16_t raw_bit_count;
-    bool is_v3_sync; // true = V3 (long LOW sync), false = V4 (long HIGH sync)
+    ProtoPiratePwm pwm;
 
     uint32_t encrypted;
     uint32_t decrypted;
     uint8_t version; // 0 = V4, 1 = V3
+
+    ProtoPirateProtocolStats* stats;
 } SubGhzProtocolDecoderKiaV3V4;
 
 typedef enum {
@@ -58,9 +63,67 @@ typedef struct SubGhzProtocolEncoderKiaV3V4 {
 typedef enum {
     KiaV3V4DecoderStepReset = 0,
     KiaV3V4DecoderStepCheckPreamble,
-    KiaV3V4DecoderStepCollectRawBits,
+    KiaV3V4DecoderStepCollectBits,
 } KiaV3V4DecoderStep;
 
+#define KIA_V3_V4_SHORT PROTOPIRATE_PWM_NEAR(KIA_V3_V4_TE_SHORT, KIA_V3_V4_TE_DELTA)
+#define KIA_V3_V4_LONG  PROTOPIRATE_PWM_NEAR(KIA_V3_V4_TE_LONG, KIA_V3_V4_TE_DELTA)
+#define KIA_V3_V4_SYNC  PROTOPIRATE_PWM_SPAN(1000, 1500)
+#define KIA_V3_V4_GAP   PROTOPIRATE_PWM_ABOVE(1500)
+
+static const ProtoPiratePwmRule kia_v3_v4_pwm_reset_high[] = {
+    {KIA_V3_V4_SHORT,
+     PROTOPIRATE_PWM_START | PROTOPIRATE_PWM_COUNT,
+     KiaV3V4DecoderStepCheckPreamble},
+};
+
+// The sync level tells the versions apart: long HIGH for V4, long LOW for V3
+static const ProtoPiratePwmRule kia_v3_v4_pwm_preamble_high[] = {
+    {KIA_V3_V4_SHORT, 0, KiaV3V4DecoderStepCheckPreamble},
+    {KIA_V3_V4_SYNC,
+     PROTOPIRATE_PWM_PREAMBLE | PROTOPIRATE_PWM_LOCK,
+     KiaV3V4DecoderStepCollectBits},
+};
+
+static const ProtoPiratePwmRule kia_v3_v4_pwm_preamble_low[] = {
+    {KIA_V3_V4_SYNC,
+     PROTOPIRATE_PWM_PREAMBLE | PROTOPIRATE_PWM_LOCK,
+     KiaV3V4DecoderStepCollectBits},
+    {KIA_V3_V4_SYNC, 0, KiaV3V4DecoderStepReset},
+    {KIA_V3_V4_SHORT, PROTOPIRATE_PWM_COUNT, KiaV3V4DecoderStepCheckPreamble},
+    {KIA_V3_V4_GAP, 0, KiaV3V4DecoderStepReset},
+    {PROTOPIRATE_PWM_ANY, 0, KiaV3V4DecoderStepCheckPreamble},
+};
+
+// HIGH carries the bit, the next sync or a long LOW gap ends the frame
+static const ProtoPiratePwmRule kia_v3_v4_pwm_bits_high[] = {
+    {KIA_V3_V4_SYNC, PROTOPIRATE_PWM_END, KiaV3V4DecoderStepReset},
+    {KIA_V3_V4_SHORT, PROTOPIRATE_PWM_BIT, KiaV3V4DecoderStepCollectBits},
+    {KIA_V3_V4_LONG, PROTOPIRATE_PWM_BIT | PROTOPIRATE_PWM_ONE, KiaV3V4DecoderStepCollectBits},
+};
+
+static const ProtoPiratePwmRule kia_v3_v4_pwm_bits_low[] = {
+    {KIA_V3_V4_SYNC, PROTOPIRATE_PWM_END, KiaV3V4DecoderStepReset},
+    {KIA_V3_V4_GAP, PROTOPIRATE_PWM_END, KiaV3V4DecoderStepReset},
+    {PROTOPIRATE_PWM_ANY, 0, KiaV3V4DecoderStepCollectBits},
+};
+
+static const ProtoPiratePwmStep kia_v3_v4_pwm_steps[] = {
+    [KiaV3V4DecoderStepReset] = PROTOPIRATE_PWM_STEP_HIGH(kia_v3_v4_pwm_reset_high),
+    [KiaV3V4DecoderStepCheckPreamble] =
+        PROTOPIRATE_PWM_STEP(kia_v3_v4_pwm_preamble_low, kia_v3_v4_pwm_preamble_high),
+    [KiaV3V4DecoderStepCollectBits] =
+        PROTOPIRATE_PWM_STEP(kia_v3_v4_pwm_bits_low, kia_v3_v4_pwm_bits_high),
+};
+
+static const ProtoPiratePwmDescriptor kia_v3_v4_pwm = {
+    .steps = kia_v3_v4_pwm_steps,
+    .step_count = COUNT_OF(kia_v3_v4_pwm_steps),
+    .preamble_min = 8,
+    .min_bits = 64,
+    .max_bits = UINT8_MAX,
+};
+
 // KeeLoq decrypt
 static uint32_t keeloq_common_decrypt(uint32_t data, uint64_t key) {
     uint32_t block = data;
@@ -100,42 +163,18 @@ static uint8_t reverse8(uint8_t byte) {
     return byte;
 }
 
-static void kia_v3_v4_add_raw_bit(SubGhzProtocolDecoderKiaV3V4* instance, bool bit) {
-    if(instance->raw_bit_count < 256) {
-        uint16_t byte_idx = instance->raw_bit_count / 8;
-        uint8_t bit_idx = 7 - (instance->raw_bit_count % 8);
-        if(bit) {
-            instance->raw_bits[byte_idx] |= (1 << bit_idx);
-        } else {
-            instance->raw_bits[byte_idx] &= ~(1 << bit_idx);
-        }
-        instance->raw_bit_count++;
-    }
-}
-
 static bool kia_v3_v4_process_buffer(SubGhzProtocolDecoderKiaV3V4* instance) {
-    if(instance->raw_bit_count < 64) {
-        return false;
-    }
-
-    uint8_t* b = instance->raw_bits;
+    // V3 syncs on a long LOW, V4 on a long HIGH
+    bool is_v3_sync = !instance->pwm.lock_level;
 
     // For V3-style (long LOW sync), data is inverted
-    if(instance->is_v3_sync) {
-        uint16_t num_bytes = (instance->raw_bit_count + 7) / 8;
-        for(uint16_t i = 0; i < num_bytes; i++) {
-            b[i] = ~b[i];
-        }
-    }
+    uint64_t key_data = is_v3_sync ? ~instance->pwm.data : instance->pwm.data;
 
-    // Extract fields
-    uint32_t encrypted = ((uint32_t)reverse8(b[3]) << 24) | ((uint32_t)reverse8(b[2]) << 16) |
-                         ((uint32_t)reverse8(b[1]) << 8) | (uint32_t)reverse8(b[0]);
-
-    uint32_t serial = ((uint32_t)reverse8(b[7] & 0xF0) << 24) | ((uint32_t)reverse8(b[6]) << 16) |
-                      ((uint32_t)reverse8(b[5]) << 8) | (uint32_t)reverse8(b[4]);
-
-    uint8_t btn = (reverse8(b[7]) & 0xF0) >> 4;
+    // Fields are sent LSB first: encrypted, then serial, then button
+    uint64_t fields = protopirate_bits_reverse64(key_data);
+    uint32_t encrypted = (uint32_t)fields;
+    uint32_t serial = (uint32_t)(fields >> 32) & 0x0FFFFFFF;
+    uint8_t btn = fields >> 60;
     uint8_t our_serial_lsb = serial & 0xFF;
 
     // Decrypt
@@ -154,11 +193,7 @@ static bool kia_v3_v4_process_buffer(SubGhzProtocolDecoderKiaV3V4* instance) {
     instance->generic.serial = serial;
     instance->generic.btn = btn;
     instance->generic.cnt = decrypted & 0xFFFF;
-    instance->version = instance->is_v3_sync ? 1 : 0;
-
-    uint64_t key_data = ((uint64_t)b[0] << 56) | ((uint64_t)b[1] << 48) | ((uint64_t)b[2] << 40) |
-                        ((uint64_t)b[3] << 32) | ((uint64_t)b[4] << 24) | ((uint64_t)b[5] << 16) |
-                        ((uint64_t)b[6] << 8) | (uint64_t)b[7];
+    instance->version = is_v3_sync ? 1 : 0;
     instance->generic.data = key_data;
     instance->generic.data_count_bit = 64;
 
@@ -206,7 +241,9 @@ void* kia_protocol_decoder_v3_v4_alloc(SubGhzEnvironment* environment) {
     UNUSED(environment);
     SubGhzProtocolDecoderKiaV3V4* instance = malloc(sizeof(SubGhzProtocolDecoderKiaV3V4));
     instance->base.protocol = &kia_protocol_v3_v4;
+    instance->stats = protopirate_protocol_stats_get(&kia_protocol_v3_v4);
     instance->generic.protocol_name = instance->base.protocol->name;
+    protopirate_pwm_reset(&instance->pwm);
     return instance;
 }
 
@@ -219,106 +256,26 @@ void kia_protocol_decoder_v3_v4_free(void* context) {
 void kia_protocol_decoder_v3_v4_reset(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderKiaV3V4* instance = context;
-    instance->decoder.parser_step = KiaV3V4DecoderStepReset;
-    instance->header_count = 0;
-    instance->raw_bit_count = 0;
-    memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
+    protopirate_pwm_reset(&instance->pwm);
 }
 
 void kia_protocol_decoder_v3_v4_feed(void* context, bool level, uint32_t duration) {
     furi_assert(context);
     SubGhzProtocolDecoderKiaV3V4* instance = context;
-
-    switch(instance->decoder.parser_step) {
-    case KiaV3V4DecoderStepReset:
-        if(level && DURATION_DIFF(duration, kia_protocol_v3_v4_const.te_short) <
-                        kia_protocol_v3_v4_const.te_delta) {
-            instance->decoder.parser_step = KiaV3V4DecoderStepCheckPreamble;
-            instance->decoder.te_last = duration;
-            instance->header_count = 1;
-        }
-        break;
-
-    case KiaV3V4DecoderStepCheckPreamble:
-        if(level) {
-            if(DURATION_DIFF(duration, kia_protocol_v3_v4_const.te_short) <
-               kia_protocol_v3_v4_const.te_delta) {
-                instance->decoder.te_last = duration;
-            } else if(duration > 1000 && duration < 1500) {
-                // V4 style: Sync is LONG HIGH
-                if(instance->header_count >= 8) {
-                    instance->decoder.parser_step = KiaV3V4DecoderStepCollectRawBits;
-                    instance->raw_bit_count = 0;
-                    instance->is_v3_sync = false;
-                    memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
-                } else {
-                    instance->decoder.parser_step = KiaV3V4DecoderStepReset;
-                }
-            } else {
-                instance->decoder.parser_step = KiaV3V4DecoderStepReset;
-            }
+    ProtoPirateProtocolStatsMark mark =
+        protopirate_protocol_stats_mark(instance->stats, instance->pwm.step);
+
+    if(protopirate_pwm_feed(&instance->pwm, &kia_v3_v4_pwm, instance->stats, level, duration)) {
+        if(kia_v3_v4_process_buffer(instance)) {
+            instance->stats->decodes++;
+            if(instance->base.callback)
+                instance->base.callback(&instance->base, instance->base.context);
         } else {
-            if(duration > 1000 && duration < 1500) {
-                // V3 style: Sync is LONG LOW
-                if(instance->header_count >= 8) {
-                    instance->decoder.parser_step = KiaV3V4DecoderStepCollectRawBits;
-                    instance->raw_bit_count = 0;
-                    instance->is_v3_sync = true;
-                    memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
-                } else {
-                    instance->decoder.parser_step = KiaV3V4DecoderStepReset;
-                }
-            } else if(
-                DURATION_DIFF(duration, kia_protocol_v3_v4_const.te_short) <
-                    kia_protocol_v3_v4_const.te_delta &&
-                DURATION_DIFF(instance->decoder.te_last, kia_protocol_v3_v4_const.te_short) <
-                    kia_protocol_v3_v4_const.te_delta) {
-                instance->header_count++;
-            } else if(duration > 1500) {
-                instance->decoder.parser_step = KiaV3V4DecoderStepReset;
-            }
-        }
-        break;
-
-    case KiaV3V4DecoderStepCollectRawBits:
-        if(level) {
-            if(duration > 1000 && duration < 1500) {
-                // Next sync pulse (V4 style) - end this packet
-                if(kia_v3_v4_process_buffer(instance)) {
-                    if(instance->base.callback)
-                        instance->base.callback(&instance->base, instance->base.context);
-                }
-                instance->decoder.parser_step = KiaV3V4DecoderStepReset;
-            } else if(
-                DURATION_DIFF(duration, kia_protocol_v3_v4_const.te_short) <
-                kia_protocol_v3_v4_const.te_delta) {
-                kia_v3_v4_add_raw_bit(instance, false);
-            } else if(
-                DURATION_DIFF(duration, kia_protocol_v3_v4_const.te_long) <
-                kia_protocol_v3_v4_const.te_delta) {
-                kia_v3_v4_add_raw_bit(instance, true);
-            } else {
-                instance->decoder.parser_step = KiaV3V4DecoderStepReset;
-            }
-        } else {
-            if(duration > 1000 && duration < 1500) {
-                // Next sync pulse (V3 style) - end this packet
-                if(kia_v3_v4_process_buffer(instance)) {
-                    if(instance->base.callback)
-                        instance->base.callback(&instance->base, instance->base.context);
-                }
-                instance->decoder.parser_step = KiaV3V4DecoderStepReset;
-            } else if(duration > 1500) {
-                // Long gap - end of transmission
-                if(kia_v3_v4_process_buffer(instance)) {
-                    if(instance->base.callback)
-                        instance->base.callback(&instance->base, instance->base.context);
-                }
-                instance->decoder.parser_step = KiaV3V4DecoderStepReset;
-            }
+            protopirate_protocol_stats_fail(instance->stats, "Frame check failed", mark.step);
         }
-        break;
     }
+
+    protopirate_protocol_stats_step(instance->stats, mark, instance->pwm.step);
 }
 
 uint8_t kia_protocol_decoder_v3_v4_get_hash_data(void* context) {
@@ -365,6 +322,12 @@ SubGhzProtocolStatus
         if(flipper_format_read_uint32(flipper_format, "Version", &temp_version, 1)) {
             instance->version = temp_version;
         }
+
+        // Serial, button and counter are not saved, recover them as the decoder found them
+        uint64_t fields = protopirate_bits_reverse64(instance->generic.data);
+        instance->generic.serial = (uint32_t)(fields >> 32) & 0x0FFFFFFF;
+        instance->generic.btn = fields >> 60;
+        instance->generic.cnt = instance->decrypted & 0xFFFF;
     }
     return ret;
 }
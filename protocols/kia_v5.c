@@ -1,4 +1,8 @@
 #include "kia_v5.h"
+#include "protocol_stats.h"
+#include "protocol_trace.h"
+#include "protocol_manchester.h"
+#include "protocol_bits.h"
 #include <lib/subghz/blocks/const.h>
 #include <lib/subghz/blocks/decoder.h>
 #include <lib/subghz/blocks/encoder.h>
@@ -7,7 +11,7 @@
 
 #define TAG "KiaV5"
 
-static const SubGhzBlockConst kia_protocol_v5_const = {
+const SubGhzBlockConst kia_protocol_v5_const = {
     .te_short = 400,
     .te_long = 800,
     .te_delta = 150,
@@ -20,8 +24,9 @@ struct SubGhzProtocolDecoderKiaV5 {
     SubGhzBlockGeneric generic;
     uint16_t header_count;
 
-    uint8_t raw_bits[32];
-    uint16_t raw_bit_count;
+    ProtoPirateManchesterFrame frame;
+
+    ProtoPirateProtocolStats* stats;
 };
 
 typedef enum {
@@ -50,6 +55,15 @@ typedef enum {
     KiaV5DecoderStepCollectRawBits,
 } KiaV5DecoderStep;
 
+// Pairs are 01 for 1 and start at the third half-bit for proper alignment
+static const ProtoPirateManchesterFrameConfig kia_v5_manchester = {
+    .table = &protopirate_manchester_pairs_01,
+    .phases = 1,
+    .first_pair = 1,
+    .last_start = 1,
+    .max_bits = 64,
+};
+
 const SubGhzProtocolDecoder kia_protocol_v5_decoder = {
     .alloc = kia_protocol_decoder_v5_alloc,
     .free = kia_protocol_decoder_v5_free,
@@ -86,61 +100,14 @@ const SubGhzProtocol kia_protocol_v5 = {
     .encoder = &kia_protocol_v5_encoder,
 };
 
-static uint8_t reverse8(uint8_t b) {
-    b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
-    b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
-    b = (b & 0xAA) >> 1 | (b & 0x55) << 1;
-    return b;
-}
-
-static void kia_v5_add_raw_bit(SubGhzProtocolDecoderKiaV5* instance, bool bit) {
-    if(instance->raw_bit_count < 256) {
-        uint16_t byte_idx = instance->raw_bit_count / 8;
-        uint8_t bit_idx = 7 - (instance->raw_bit_count % 8);
-        if(bit) {
-            instance->raw_bits[byte_idx] |= (1 << bit_idx);
-        } else {
-            instance->raw_bits[byte_idx] &= ~(1 << bit_idx);
-        }
-        instance->raw_bit_count++;
-    }
-}
-
-static inline bool kia_v5_get_raw_bit(SubGhzProtocolDecoderKiaV5* instance, uint16_t idx) {
-    uint16_t byte_idx = idx / 8;
-    uint8_t bit_idx = 7 - (idx % 8);
-    return (instance->raw_bits[byte_idx] >> bit_idx) & 1;
-}
-
 static bool kia_v5_manchester_decode(SubGhzProtocolDecoderKiaV5* instance) {
-    if(instance->raw_bit_count < 130) {
+    if(instance->frame.half_bits < 130) {
         return false;
     }
 
-    instance->decoder.decode_data = 0;
-    instance->decoder.decode_count_bit = 0;
-
-    // Start at offset 2 for proper Manchester alignment
-    const uint16_t start_bit = 2;
-
-    for(uint16_t i = start_bit;
-        i + 1 < instance->raw_bit_count && instance->decoder.decode_count_bit < 64;
-        i += 2) {
-        bool bit1 = kia_v5_get_raw_bit(instance, i);
-        bool bit2 = kia_v5_get_raw_bit(instance, i + 1);
-
-        uint8_t two_bits = (bit1 << 1) | bit2;
-
-        if(two_bits == 0x01) { // 01 = decoded 1
-            instance->decoder.decode_data = (instance->decoder.decode_data << 1) | 1;
-            instance->decoder.decode_count_bit++;
-        } else if(two_bits == 0x02) { // 10 = decoded 0
-            instance->decoder.decode_data = (instance->decoder.decode_data << 1);
-            instance->decoder.decode_count_bit++;
-        } else {
-            break;
-        }
-    }
+    protopirate_manchester_frame_end(&instance->frame);
+    instance->decoder.decode_data = instance->frame.best_data;
+    instance->decoder.decode_count_bit = instance->frame.best_bits;
 
     return instance->decoder.decode_count_bit >= kia_protocol_v5_const.min_count_bit_for_found;
 }
@@ -149,6 +116,7 @@ void* kia_protocol_decoder_v5_alloc(SubGhzEnvironment* environment) {
     UNUSED(environment);
     SubGhzProtocolDecoderKiaV5* instance = malloc(sizeof(SubGhzProtocolDecoderKiaV5));
     instance->base.protocol = &kia_protocol_v5;
+    instance->stats = protopirate_protocol_stats_get(&kia_protocol_v5);
     instance->generic.protocol_name = instance->base.protocol->name;
     return instance;
 }
@@ -164,13 +132,14 @@ void kia_protocol_decoder_v5_reset(void* context) {
     SubGhzProtocolDecoderKiaV5* instance = context;
     instance->decoder.parser_step = KiaV5DecoderStepReset;
     instance->header_count = 0;
-    instance->raw_bit_count = 0;
-    memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
+    protopirate_manchester_frame_start(&instance->frame, &kia_v5_manchester);
 }
 
 void kia_protocol_decoder_v5_feed(void* context, bool level, uint32_t duration) {
     furi_assert(context);
     SubGhzProtocolDecoderKiaV5* instance = context;
+    ProtoPirateProtocolStatsMark mark =
+        protopirate_protocol_stats_mark(instance->stats, instance->decoder.parser_step);
 
     switch(instance->decoder.parser_step) {
     case KiaV5DecoderStepReset:
@@ -204,9 +173,9 @@ void kia_protocol_decoder_v5_feed(void* context, bool level, uint32_t duration)
                 (DURATION_DIFF(instance->decoder.te_last, kia_protocol_v5_const.te_short) <
                  kia_protocol_v5_const.te_delta)) {
                 if(instance->header_count > 40) {
+                    protopirate_protocol_stats_lock(instance->stats);
                     instance->decoder.parser_step = KiaV5DecoderStepCollectRawBits;
-                    instance->raw_bit_count = 0;
-                    memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
+                    protopirate_manchester_frame_start(&instance->frame, &kia_v5_manchester);
                 } else {
                     instance->header_count++;
                 }
@@ -226,57 +195,41 @@ void kia_protocol_decoder_v5_feed(void* context, bool level, uint32_t duration)
                 instance->generic.data = instance->decoder.decode_data;
                 instance->generic.data_count_bit = instance->decoder.decode_count_bit;
 
-                // Compute yek (bit-reverse each byte)
-                uint64_t yek = 0;
-                for(int i = 0; i < 8; i++) {
-                    uint8_t byte = (instance->generic.data >> (i * 8)) & 0xFF;
-                    uint8_t reversed = 0;
-                    for(int b = 0; b < 8; b++) {
-                        if(byte & (1 << b)) reversed |= (1 << (7 - b));
-                    }
-                    yek |= ((uint64_t)reversed << ((7 - i) * 8));
-                }
+                // yek is the key bit-reversed
+                uint64_t yek = protopirate_bits_reverse64(instance->generic.data);
 
                 // Shift serial right by 1 to correct alignment
                 instance->generic.serial = (uint32_t)(((yek >> 32) & 0x0FFFFFFF) >> 1);
                 instance->generic.btn = (uint8_t)((yek >> 61) & 0x07); // Shift btn too
                 instance->generic.cnt = (uint16_t)(yek & 0xFFFF);
 
-                FURI_LOG_I(
-                    TAG,
-                    "Key=%08lX%08lX Sn=%07lX Btn=%X",
-                    (uint32_t)(instance->generic.data >> 32),
-                    (uint32_t)(instance->generic.data & 0xFFFFFFFF),
-                    instance->generic.serial,
-                    instance->generic.btn);
+                protopirate_trace_u64(
+                    ProtoPirateTraceKey, KIA_PROTOCOL_V5_NAME, instance->generic.data);
 
+                instance->stats->decodes++;
                 if(instance->base.callback)
                     instance->base.callback(&instance->base, instance->base.context);
+            } else {
+                protopirate_protocol_stats_fail(
+                    instance->stats, "Manchester decode failed", instance->decoder.parser_step);
             }
 
             instance->decoder.parser_step = KiaV5DecoderStepReset;
             break;
         }
 
-        int num_bits = 0;
-        if(DURATION_DIFF(duration, kia_protocol_v5_const.te_short) <
-           kia_protocol_v5_const.te_delta) {
-            num_bits = 1;
-        } else if(
-            DURATION_DIFF(duration, kia_protocol_v5_const.te_long) <
-            kia_protocol_v5_const.te_delta) {
-            num_bits = 2;
-        } else {
+        ProtoPirateManchesterEvent event =
+            protopirate_manchester_event(&kia_protocol_v5_const, level, duration);
+        if(event == ProtoPirateManchesterEventInvalid) {
             instance->decoder.parser_step = KiaV5DecoderStepReset;
             break;
         }
 
-        for(int i = 0; i < num_bits; i++) {
-            kia_v5_add_raw_bit(instance, level);
-        }
-
+        protopirate_manchester_frame_feed(&instance->frame, event);
         break;
     }
+
+    protopirate_protocol_stats_step(instance->stats, mark, instance->decoder.parser_step);
 }
 
 uint8_t kia_protocol_decoder_v5_get_hash_data(void* context) {
@@ -320,8 +273,20 @@ SubGhzProtocolStatus
     kia_protocol_decoder_v5_deserialize(void* context, FlipperFormat* flipper_format) {
     furi_assert(context);
     SubGhzProtocolDecoderKiaV5* instance = context;
-    return subghz_block_generic_deserialize_check_count_bit(
+    SubGhzProtocolStatus ret = subghz_block_generic_deserialize_check_count_bit(
         &instance->generic, flipper_format, kia_protocol_v5_const.min_count_bit_for_found);
+
+    if(ret == SubGhzProtocolStatusOk) {
+        uint32_t temp_val;
+        flipper_format_read_uint32(flipper_format, "Serial", &instance->generic.serial, 1);
+        if(flipper_format_read_uint32(flipper_format, "Btn", &temp_val, 1)) {
+            instance->generic.btn = temp_val;
+        }
+        if(flipper_format_read_uint32(flipper_format, "Cnt", &temp_val, 1)) {
+            instance->generic.cnt = temp_val;
+        }
+    }
+    return ret;
 }
 
 void kia_protocol_decoder_v5_get_string(void* context, FuriString* output) {
@@ -348,12 +313,7 @@ void kia_protocol_decoder_v5_get_string(void* context, FuriString* output) {
 // Encoder implementation
 static void subghz_protocol_kia_v5_update_data(SubGhzProtocolEncoderKiaV5* instance) {
     // 1. Current data to yek (reverse of the decoder logic)
-    uint64_t yek = 0;
-    for(int i = 0; i < 8; i++) {
-        uint8_t byte = (instance->generic.data >> (i * 8)) & 0xFF;
-        uint8_t reversed = reverse8(byte);
-        yek |= ((uint64_t)reversed << ((7 - i) * 8));
-    }
+    uint64_t yek = protopirate_bits_reverse64(instance->generic.data);
 
     // 2. Update fields in yek
     // Cnt: bits 15..0
@@ -371,12 +331,7 @@ static void subghz_protocol_kia_v5_update_data(SubGhzProtocolEncoderKiaV5* insta
     yek |= ((uint64_t)(instance->generic.btn & 0x07) << 61);
 
     // 3. Convert yek back to generic.data
-    instance->generic.data = 0;
-    for(int i = 0; i < 8; i++) {
-        uint8_t reversed = (yek >> ((7 - i) * 8)) & 0xFF;
-        uint8_t original = reverse8(reversed);
-        instance->generic.data |= ((uint64_t)original << (i * 8));
-    }
+    instance->generic.data = protopirate_bits_reverse64(yek);
 }
 
 void* kia_protocol_encoder_v5_alloc(SubGhzEnvironment* environment) {
@@ -0,0 +1,29 @@
+// protocols/protocol_bits.h
+#pragma once
+
+#include <furi.h>
+
+#if defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_7M__)
+#include <cmsis_compiler.h>
+
+// Single RBIT instruction on the Cortex-M4
+static inline uint32_t protopirate_bits_reverse32(uint32_t value) {
+    return __RBIT(value);
+}
+#else
+// Host builds, the bench and tools
+static inline uint32_t protopirate_bits_reverse32(uint32_t value) {
+    value = (value >> 16) | (value << 16);
+    value = ((value & 0xFF00FF00) >> 8) | ((value & 0x00FF00FF) << 8);
+    value = ((value & 0xF0F0F0F0) >> 4) | ((value & 0x0F0F0F0F) << 4);
+    value = ((value & 0xCCCCCCCC) >> 2) | ((value & 0x33333333) << 2);
+    value = ((value & 0xAAAAAAAA) >> 1) | ((value & 0x55555555) << 1);
+    return value;
+}
+#endif
+
+// Bit 0 becomes bit 63: a frame shifted in first bit first reads as if sent LSB first
+static inline uint64_t protopirate_bits_reverse64(uint64_t value) {
+    return ((uint64_t)protopirate_bits_reverse32((uint32_t)value) << 32) |
+           protopirate_bits_reverse32((uint32_t)(value >> 32));
+}
@@ -0,0 +1,49 @@
+// protocols/protocol_checksum.c
+#include "protocol_checksum.h"
+
+// One CRC-8 shift, then eight of them: the CRC of a single byte
+#define CRC8_SHIFT(crc, poly)  ((((crc) << 1) ^ (((crc) & 0x80) ? (poly) : 0)) & 0xFF)
+#define CRC8_SHIFT2(crc, poly) CRC8_SHIFT(CRC8_SHIFT(crc, poly), poly)
+#define CRC8_SHIFT4(crc, poly) CRC8_SHIFT2(CRC8_SHIFT2(crc, poly), poly)
+#define CRC8_SHIFT8(crc, poly) CRC8_SHIFT4(CRC8_SHIFT4(crc, poly), poly)
+
+// A CRC is linear, so every entry is the XOR of the entries of its set bits. Only those
+// eight are shifted out, as enum constants, which keeps the expansion small.
+#define CRC8_BASIS(name, poly)                 \
+    enum {                                     \
+        name##_bit0 = CRC8_SHIFT8(0x01, poly), \
+        name##_bit1 = CRC8_SHIFT8(0x02, poly), \
+        name##_bit2 = CRC8_SHIFT8(0x04, poly), \
+        name##_bit3 = CRC8_SHIFT8(0x08, poly), \
+        name##_bit4 = CRC8_SHIFT8(0x10, poly), \
+        name##_bit5 = CRC8_SHIFT8(0x20, poly), \
+        name##_bit6 = CRC8_SHIFT8(0x40, poly), \
+        name##_bit7 = CRC8_SHIFT8(0x80, poly), \
+    }
+
+#define CRC8_ENTRY(name, byte)                                                   \
+    ((((byte) & 0x01) ? name##_bit0 : 0) ^ (((byte) & 0x02) ? name##_bit1 : 0) ^ \
+     (((byte) & 0x04) ? name##_bit2 : 0) ^ (((byte) & 0x08) ? name##_bit3 : 0) ^ \
+     (((byte) & 0x10) ? name##_bit4 : 0) ^ (((byte) & 0x20) ? name##_bit5 : 0) ^ \
+     (((byte) & 0x40) ? name##_bit6 : 0) ^ (((byte) & 0x80) ? name##_bit7 : 0))
+
+#define CRC8_ROW4(name, byte)                               \
+    CRC8_ENTRY(name, (byte)), CRC8_ENTRY(name, (byte) + 1), \
+        CRC8_ENTRY(name, (byte) + 2), CRC8_ENTRY(name, (byte) + 3)
+#define CRC8_ROW16(name, byte)                            \
+    CRC8_ROW4(name, (byte)), CRC8_ROW4(name, (byte) + 4), \
+        CRC8_ROW4(name, (byte) + 8), CRC8_ROW4(name, (byte) + 12)
+#define CRC8_ROW64(name, byte)                               \
+    CRC8_ROW16(name, (byte)), CRC8_ROW16(name, (byte) + 16), \
+        CRC8_ROW16(name, (byte) + 32), CRC8_ROW16(name, (byte) + 48)
+
+#define CRC8_TABLE(name, poly)  \
+    CRC8_BASIS(name, poly);     \
+    const uint8_t name[256] = { \
+        CRC8_ROW64(name, 0x00), \
+        CRC8_ROW64(name, 0x40), \
+        CRC8_ROW64(name, 0x80), \
+        CRC8_ROW64(name, 0xC0), \
+    }
+
+CRC8_TABLE(protopirate_crc8_kia, 0x7F);
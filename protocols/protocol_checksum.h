@@ -0,0 +1,27 @@
+// protocols/protocol_checksum.h
+#pragma once
+
+#include <furi.h>
+
+// CRC-8 lookup tables, MSB first, no reflection. Generated by the preprocessor from the
+// polynomial, see protocol_checksum.c.
+extern const uint8_t protopirate_crc8_kia[256]; // Polynomial 0x7F, Kia V0 and V1
+
+// CRC-8 over the low bytes of a packed frame, most significant byte first. Shift the
+// frame so the last byte to check is its lowest.
+static inline uint8_t protopirate_crc8(
+    const uint8_t* table,
+    uint8_t crc,
+    uint64_t frame,
+    uint8_t bytes) {
+    for(int8_t shift = (int8_t)((bytes - 1) * 8); shift >= 0; shift -= 8) {
+        crc = table[crc ^ (uint8_t)(frame >> shift)];
+    }
+    return crc;
+}
+
+// Even parity of a byte: 1 when an odd number of bits is set. 0x6996 is the parity of
+// every nibble, so one fold and a shift do it.
+static inline uint8_t protopirate_parity8(uint8_t value) {
+    return (0x6996 >> ((value ^ (value >> 4)) & 0x0F)) & 1;
+}
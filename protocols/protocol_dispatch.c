@@ -0,0 +1,215 @@
+// protocols/protocol_dispatch.c
+#include "protocol_dispatch.h"
+#include "protocol_items.h"
+
+#define TAG "ProtoPirateDispatch"
+
+ProtoPirateDispatch* protopirate_dispatch_alloc(void) {
+    ProtoPirateDispatch* dispatch = malloc(sizeof(ProtoPirateDispatch));
+    memset(dispatch, 0, sizeof(ProtoPirateDispatch));
+    return dispatch;
+}
+
+void protopirate_dispatch_free(ProtoPirateDispatch* dispatch) {
+    furi_assert(dispatch);
+    free(dispatch);
+}
+
+// A bucket holds a slot if any duration inside it may reach the slot's window
+static void protopirate_dispatch_build_table(ProtoPirateDispatch* dispatch) {
+    uint32_t table_end = PROTOPIRATE_PULSE_CLASS_COUNT << PROTOPIRATE_PULSE_CLASS_SHIFT;
+    dispatch->far_mask = 0;
+    for(size_t i = 0; i < dispatch->count; i++) {
+        if(dispatch->slots[i].start_max >= table_end) dispatch->far_mask |= 1UL << i;
+    }
+
+    for(uint32_t bucket = 0; bucket < PROTOPIRATE_PULSE_CLASS_COUNT; bucket++) {
+        uint32_t bucket_min = bucket << PROTOPIRATE_PULSE_CLASS_SHIFT;
+        uint32_t bucket_max = ((bucket + 1) << PROTOPIRATE_PULSE_CLASS_SHIFT) - 1;
+        uint32_t start[2] = {0, 0};
+        uint32_t range = 0;
+        for(size_t i = 0; i < dispatch->count; i++) {
+            const ProtoPirateDispatchSlot* slot = &dispatch->slots[i];
+            if(bucket_max >= slot->min_duration) {
+                range |= 1UL << i;
+            }
+            if(bucket_max >= slot->start_min && bucket_min <= slot->start_max) {
+                for(uint8_t level = 0; level < 2; level++) {
+                    if(slot->start_levels & (1 << level)) start[level] |= 1UL << i;
+                }
+            }
+        }
+        dispatch->start_table[0][bucket] = start[0];
+        dispatch->start_table[1][bucket] = start[1];
+        dispatch->range_table[bucket] = range;
+    }
+}
+
+bool protopirate_dispatch_add(
+    ProtoPirateDispatch* dispatch,
+    const SubGhzProtocol* protocol,
+    void* decoder) {
+    furi_assert(dispatch);
+    furi_assert(protocol);
+
+    if(!decoder || dispatch->count >= PROTOPIRATE_DISPATCH_MAX) return false;
+
+    ProtoPirateDispatchSlot* slot = &dispatch->slots[dispatch->count];
+    slot->protocol = protocol;
+    slot->decoder = decoder;
+    slot->stats = protopirate_protocol_stats_get(protocol);
+
+    // A protocol without timings is fed every pulse
+    slot->min_duration = 0;
+    slot->start_min = 0;
+    slot->start_max = UINT32_MAX;
+    slot->start_levels = 0x03;
+
+    // Nothing shorter than te_short - te_delta can start or continue a frame. Only some
+    // decoders reset on such a pulse mid-frame, the others have to be fed it there.
+    const ProtoPirateProtocolInfo* info = protopirate_protocol_find_info(protocol->name);
+    if(info) {
+        const SubGhzBlockConst* timing = info->timing;
+        if(timing->te_short > timing->te_delta) {
+            slot->min_duration = timing->te_short - timing->te_delta;
+        }
+        if(info->short_resets) {
+            dispatch->resets_mask |= 1UL << dispatch->count;
+        }
+
+        uint32_t te = (info->start == ProtoPirateProtocolStartLongHigh) ? timing->te_long :
+                                                                           timing->te_short;
+        slot->start_min = (te > timing->te_delta) ? te - timing->te_delta : 0;
+        slot->start_max = te + timing->te_delta;
+        slot->start_levels = (info->start == ProtoPirateProtocolStartShortAny) ? 0x03 : 0x02;
+    }
+
+    dispatch->all_mask |= 1UL << dispatch->count;
+    dispatch->active_mask |= 1UL << dispatch->count;
+    dispatch->count++;
+
+    protopirate_dispatch_build_table(dispatch);
+    return true;
+}
+
+void protopirate_dispatch_clear(ProtoPirateDispatch* dispatch) {
+    furi_assert(dispatch);
+    memset(dispatch, 0, sizeof(ProtoPirateDispatch));
+}
+
+// Hands a dropped frame to the near-miss capture, if there is one
+static void protopirate_dispatch_miss(
+    ProtoPirateDispatch* dispatch,
+    ProtoPirateDispatchSlot* slot,
+    const char* reason,
+    uint8_t step) {
+    if(dispatch->near_miss) {
+        protopirate_near_miss_capture(
+            dispatch->near_miss, slot->protocol->name, reason, step, slot->lock_position);
+    }
+}
+
+void protopirate_dispatch_feed(void* context, bool level, uint32_t duration) {
+    ProtoPirateDispatch* dispatch = context;
+
+    uint32_t position = 0;
+    if(dispatch->near_miss) {
+        position = protopirate_near_miss_pulse(dispatch->near_miss, level, duration);
+    }
+
+    uint32_t bucket = duration >> PROTOPIRATE_PULSE_CLASS_SHIFT;
+    uint32_t start = dispatch->far_mask;
+    uint32_t range = dispatch->all_mask;
+    if(bucket < PROTOPIRATE_PULSE_CLASS_COUNT) {
+        start = dispatch->start_table[level][bucket];
+        range = dispatch->range_table[bucket];
+    }
+
+    // Decoders in their reset step only need a pulse that can start a frame. Mid-frame
+    // ones get the reset their feed would have done on a pulse below their range.
+    uint32_t active = dispatch->active_mask;
+    uint32_t reject = active & ~range & dispatch->resets_mask;
+    active &= ~reject;
+    while(reject) {
+        uint32_t i = __builtin_ctz(reject);
+        reject &= reject - 1;
+        ProtoPirateDispatchSlot* slot = &dispatch->slots[i];
+        slot->protocol->decoder->reset(slot->decoder);
+
+        // The frame was cut short by a pulse no step of the decoder accepts
+        if(slot->stats->locked) {
+            slot->stats->locked = false;
+            protopirate_dispatch_miss(
+                dispatch, slot, "Pulse out of range", PROTOPIRATE_NEAR_MISS_NO_STEP);
+        }
+    }
+
+    uint32_t feed = active | start;
+#ifdef PROTOPIRATE_DISPATCH_PROFILE
+    // One cycle counter read per decoder, each feed is charged up to the next read
+    uint32_t cycles = protopirate_protocol_stats_cycles();
+#endif
+    while(feed) {
+        uint32_t i = __builtin_ctz(feed);
+        feed &= feed - 1;
+        ProtoPirateDispatchSlot* slot = &dispatch->slots[i];
+        slot->protocol->decoder->feed(slot->decoder, level, duration);
+
+        ProtoPirateProtocolStats* stats = slot->stats;
+        if(stats->step) {
+            active |= 1UL << i;
+        } else {
+            active &= ~(1UL << i);
+        }
+
+        // A miss ends the previous lock, so it is taken before looking for a new one
+        if(dispatch->near_miss) {
+            if(stats->miss_reason) {
+                protopirate_dispatch_miss(dispatch, slot, stats->miss_reason, stats->miss_step);
+                stats->miss_reason = NULL;
+            }
+            if(stats->preamble_locks != slot->preamble_locks) {
+                slot->preamble_locks = stats->preamble_locks;
+                slot->lock_position = position;
+            }
+        }
+
+#ifdef PROTOPIRATE_DISPATCH_PROFILE
+        uint32_t end = protopirate_protocol_stats_cycles();
+        stats->cycles += end - cycles;
+        stats->pulses++;
+        cycles = end;
+#endif
+    }
+
+    dispatch->active_mask = active;
+}
+
+void protopirate_dispatch_reset(void* context) {
+    ProtoPirateDispatch* dispatch = context;
+
+    // Pulses went missing, so a frame in progress is not a near miss worth keeping
+    for(size_t i = 0; i < dispatch->count; i++) {
+        dispatch->slots[i].protocol->decoder->reset(dispatch->slots[i].decoder);
+        dispatch->slots[i].stats->locked = false;
+    }
+    dispatch->active_mask = 0;
+}
+
+void protopirate_dispatch_set_near_miss(
+    ProtoPirateDispatch* dispatch,
+    ProtoPirateNearMiss* near_miss) {
+    furi_assert(dispatch);
+
+    // Misses and locks are only tracked while there is a capture, drop what is left over
+    for(size_t i = 0; i < dispatch->count; i++) {
+        dispatch->slots[i].stats->miss_reason = NULL;
+        dispatch->slots[i].preamble_locks = dispatch->slots[i].stats->preamble_locks;
+    }
+    dispatch->near_miss = near_miss;
+}
+
+void protopirate_dispatch_mark_active(ProtoPirateDispatch* dispatch) {
+    furi_assert(dispatch);
+    dispatch->active_mask = dispatch->all_mask;
+}
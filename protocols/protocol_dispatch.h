@@ -0,0 +1,65 @@
+// protocols/protocol_dispatch.h
+#pragma once
+
+#include <lib/subghz/types.h>
+#include "protocol_stats.h"
+#include "protocol_near_miss.h"
+
+// Pulse classes are 32 us buckets, durations past the table go to every mid-frame decoder
+#define PROTOPIRATE_PULSE_CLASS_SHIFT 5
+#define PROTOPIRATE_PULSE_CLASS_COUNT 64
+#define PROTOPIRATE_DISPATCH_MAX      32
+
+typedef struct {
+    const SubGhzProtocol* protocol;
+    void* decoder;
+    uint32_t min_duration; // Shorter pulses are out of range for every step
+    uint32_t start_min; // Pulses that can start a frame, both ends inclusive
+    uint32_t start_max;
+    uint8_t start_levels; // Bit 0 for LOW, bit 1 for HIGH
+    ProtoPirateProtocolStats* stats;
+    uint32_t preamble_locks; // Last seen in stats, a change is a new lock
+    uint32_t lock_position; // Stream position of the last lock
+} ProtoPirateDispatchSlot;
+
+// Feeds a set of decoders from one pulse stream. Each pulse is classified once through
+// duration tables built from the protocol timings. A decoder in its reset step is only fed
+// pulses that can start a frame. One mid-frame is reset instead of fed a pulse below its
+// min_duration if its feed would have reset on it, and fed everything else.
+typedef struct {
+    ProtoPirateDispatchSlot slots[PROTOPIRATE_DISPATCH_MAX];
+    size_t count;
+    uint32_t all_mask;
+    uint32_t resets_mask; // Decoders whose feed resets on any pulse below min_duration
+    uint32_t far_mask; // Decoders a pulse past the tables can start
+    uint32_t active_mask; // Decoders that may be out of their reset step
+    uint32_t start_table[2][PROTOPIRATE_PULSE_CLASS_COUNT]; // By level, then bucket
+    uint32_t range_table[PROTOPIRATE_PULSE_CLASS_COUNT]; // At or past min_duration
+    ProtoPirateNearMiss* near_miss;
+} ProtoPirateDispatch;
+
+ProtoPirateDispatch* protopirate_dispatch_alloc(void);
+void protopirate_dispatch_free(ProtoPirateDispatch* dispatch);
+
+/** Add a decoder instance, returns false when the dispatch is full */
+bool protopirate_dispatch_add(
+    ProtoPirateDispatch* dispatch,
+    const SubGhzProtocol* protocol,
+    void* decoder);
+
+/** Drop all decoders, the instances themselves are owned by the caller */
+void protopirate_dispatch_clear(ProtoPirateDispatch* dispatch);
+
+/** Feed one pulse, signature matches SubGhzWorkerPairCallback */
+void protopirate_dispatch_feed(void* context, bool level, uint32_t duration);
+
+/** Reset every decoder, signature matches SubGhzWorkerOverrunCallback */
+void protopirate_dispatch_reset(void* context);
+
+/** Mark all decoders as possibly mid-frame, for when they were reset or fed elsewhere */
+void protopirate_dispatch_mark_active(ProtoPirateDispatch* dispatch);
+
+/** Capture frames the decoders drop into near_miss, NULL stops. Call while nothing feeds. */
+void protopirate_dispatch_set_near_miss(
+    ProtoPirateDispatch* dispatch,
+    ProtoPirateNearMiss* near_miss);
@@ -1,187 +1,170 @@
 #include "protocol_items.h"
 #include <string.h>
 
+#define TAG "ProtoPirateProtocols"
+
+// Names other firmwares and older captures use for the same protocols
+static const char* const kia_v0_aliases[] = {"KIA/HYU V0", "HYU V0", NULL};
+static const char* const kia_v1_aliases[] = {"KIA/HYU V1", "HYU V1", NULL};
+static const char* const kia_v2_aliases[] = {"KIA/HYU V2", "HYU V2", NULL};
+static const char* const kia_v3_v4_aliases[] =
+    {"Kia V3", "Kia V4", "KIA/HYU V3", "KIA/HYU V4", "HYU V3", "HYU V4", NULL};
+static const char* const kia_v5_aliases[] = {"KIA/HYU V5", "HYU V5", NULL};
+static const char* const ford_v0_aliases[] = {"Ford", NULL};
+static const char* const fiat_v0_aliases[] = {"Fiat type 0", "Fiat", NULL};
+static const char* const subaru_aliases[] = {NULL};
+static const char* const suzuki_aliases[] = {NULL};
+static const char* const vw_aliases[] = {"Volkswagen", NULL};
+
+// The one list of protocols: registry order, decoder timing constants, aliases, whether
+// the decoder's feed resets on every pulse shorter than te_short - te_delta and the pulse
+// that starts its frames. Decoders that skip such a short pulse mid-frame and keep their
+// frame are false, dispatch then feeds them every pulse until they are back in reset.
+#define PROTOPIRATE_PROTOCOLS(X)                                                          \
+    X(kia_protocol_v0, subghz_protocol_kia_const, kia_v0_aliases, false, ShortHigh)       \
+    X(kia_protocol_v1, kia_protocol_v1_const, kia_v1_aliases, true, LongHigh)             \
+    X(kia_protocol_v2, kia_protocol_v2_const, kia_v2_aliases, true, LongHigh)             \
+    X(kia_protocol_v3_v4, kia_protocol_v3_v4_const, kia_v3_v4_aliases, false, ShortHigh)  \
+    X(kia_protocol_v5, kia_protocol_v5_const, kia_v5_aliases, false, ShortHigh)           \
+    X(ford_protocol_v0, subghz_protocol_ford_v0_const, ford_v0_aliases, false, ShortHigh) \
+    X(fiat_protocol_v0, subghz_protocol_fiat_v0_const, fiat_v0_aliases, false, ShortHigh) \
+    X(subaru_protocol, subghz_protocol_subaru_const, subaru_aliases, true, LongHigh)      \
+    X(suzuki_protocol, subghz_protocol_suzuki_const, suzuki_aliases, false, ShortHigh)    \
+    X(vw_protocol, subghz_protocol_vw_const, vw_aliases, true, ShortAny)
+
+#define PROTOPIRATE_REGISTRY_ITEM(proto, block_const, alias_list, resets, start_pulse) &proto,
+#define PROTOPIRATE_INFO_ITEM(proto, block_const, alias_list, resets, start_pulse) \
+    {.protocol = &proto,                                                           \
+     .timing = &block_const,                                                       \
+     .aliases = alias_list,                                                        \
+     .short_resets = resets,                                                       \
+     .start = ProtoPirateProtocolStart##start_pulse},
+
 const SubGhzProtocol* protopirate_protocol_registry_items[] = {
-    &kia_protocol_v0,
-    &kia_protocol_v1,
-    &kia_protocol_v2,
-    &kia_protocol_v3_v4,
-    &kia_protocol_v5,
-    &ford_protocol_v0,
-    &fiat_protocol_v0,
-    &subaru_protocol,
-    &suzuki_protocol,
-    &vw_protocol,
-};
+    PROTOPIRATE_PROTOCOLS(PROTOPIRATE_REGISTRY_ITEM)};
 
 const SubGhzProtocolRegistry protopirate_protocol_registry = {
     .items = protopirate_protocol_registry_items,
     .size = COUNT_OF(protopirate_protocol_registry_items),
 };
 
-// Protocol timing definitions - mirrors the SubGhzBlockConst in each protocol
-static const ProtoPirateProtocolTiming protocol_timings[] = {
-    // Kia V0: PWM encoding, 250/500µs
-    {
-        .name = "Kia V0",
-        .te_short = 250,
-        .te_long = 500,
-        .te_delta = 100,
-        .min_count_bit = 61,
-    },
-    // Kia V1: OOK PCM 800µs timing
-    {
-        .name = "Kia V1",
-        .te_short = 800,
-        .te_long = 1600,
-        .te_delta = 200,
-        .min_count_bit = 56,
-    },
-    // Kia V2: Manchester 500/1000µs
-    {
-        .name = "Kia V2",
-        .te_short = 500,
-        .te_long = 1000,
-        .te_delta = 150,
-        .min_count_bit = 51,
-    },
-    // Kia V3/V4: PWM 400/800µs
-    {
-        .name = "Kia V3/V4",
-        .te_short = 400,
-        .te_long = 800,
-        .te_delta = 150,
-        .min_count_bit = 64,
-    },
-    // Kia V5: PWM 400/800µs (same as V3/V4)
-    {
-        .name = "Kia V5",
-        .te_short = 400,
-        .te_long = 800,
-        .te_delta = 150,
-        .min_count_bit = 64,
-    },
-    // Ford V0: Manchester 250/500µs
-    {
-        .name = "Ford V0",
-        .te_short = 250,
-        .te_long = 500,
-        .te_delta = 100,
-        .min_count_bit = 64,
-    },
-    // Fiat V0: Manchester 200/400µs
-    {
-        .name = "Fiat V0",
-        .te_short = 200,
-        .te_long = 400,
-        .te_delta = 100,
-        .min_count_bit = 64,
-    },
-    // Subaru: PWM 800/1600µs
-    {
-        .name = "Subaru",
-        .te_short = 800,
-        .te_long = 1600,
-        .te_delta = 250,
-        .min_count_bit = 64,
-    },
-    // Suzuki: PWM 250/500µs
-    {
-        .name = "Suzuki",
-        .te_short = 250,
-        .te_long = 500,
-        .te_delta = 100,
-        .min_count_bit = 64,
-    },
-    // VW: Manchester 500/1000µs
-    {
-        .name = "VW",
-        .te_short = 500,
-        .te_long = 1000,
-        .te_delta = 120,
-        .min_count_bit = 80,
-    },
-};
+static const ProtoPirateProtocolInfo protopirate_protocol_info[] = {
+    PROTOPIRATE_PROTOCOLS(PROTOPIRATE_INFO_ITEM)};
+
+#define PROTOPIRATE_PROTOCOL_COUNT COUNT_OF(protopirate_protocol_info)
+
+// Open addressing hash over normalized names and aliases, built once by
+// protopirate_protocol_init and only read after that
+#define NAME_HASH_SIZE 64
+#define NAME_KEY_MAX   32
 
-static const size_t protocol_timings_count = COUNT_OF(protocol_timings);
+typedef struct {
+    const char* name;
+    uint8_t index;
+} ProtoPirateNameSlot;
 
-const ProtoPirateProtocolTiming* protopirate_get_protocol_timing(const char* protocol_name) {
-    if(!protocol_name) return NULL;
+static ProtoPirateNameSlot name_hash[NAME_HASH_SIZE];
+static bool name_hash_ready = false;
 
-    for(size_t i = 0; i < protocol_timings_count; i++) {
-        // Check for exact match or if the protocol name contains our timing name
-        if(strcmp(protocol_name, protocol_timings[i].name) == 0 ||
-           strstr(protocol_name, protocol_timings[i].name) != NULL) {
-            return &protocol_timings[i];
+// Lowercase alphanumerics only, so "KIA/HYU V4" and "kia hyu v4" share a key
+static size_t protopirate_name_key(const char* name, char* key) {
+    size_t len = 0;
+    for(const char* p = name; *p && len < NAME_KEY_MAX - 1; p++) {
+        char c = *p;
+        if(c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        if((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) {
+            key[len++] = c;
         }
     }
+    key[len] = '\0';
+    return len;
+}
 
-    // Try partial matching for version variants
-    for(size_t i = 0; i < protocol_timings_count; i++) {
-        // Match "Kia" protocols
-        if(strstr(protocol_name, "Kia") != NULL || strstr(protocol_name, "KIA") != NULL ||
-           strstr(protocol_name, "HYU") != NULL) {
-            // Try to match version number
-            if(strstr(protocol_name, "V0") != NULL &&
-               strstr(protocol_timings[i].name, "V0") != NULL) {
-                return &protocol_timings[i];
-            }
-            if(strstr(protocol_name, "V1") != NULL &&
-               strstr(protocol_timings[i].name, "V1") != NULL) {
-                return &protocol_timings[i];
-            }
-            if(strstr(protocol_name, "V2") != NULL &&
-               strstr(protocol_timings[i].name, "V2") != NULL) {
-                return &protocol_timings[i];
-            }
-            if((strstr(protocol_name, "V3") != NULL || strstr(protocol_name, "V4") != NULL) &&
-               strstr(protocol_timings[i].name, "V3/V4") != NULL) {
-                return &protocol_timings[i];
-            }
-            if(strstr(protocol_name, "V5") != NULL &&
-               strstr(protocol_timings[i].name, "V5") != NULL) {
-                return &protocol_timings[i];
-            }
-        }
+static uint32_t protopirate_name_hash(const char* key) {
+    // FNV-1a
+    uint32_t hash = 2166136261UL;
+    for(const char* p = key; *p; p++) {
+        hash ^= (uint8_t)*p;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
 
-        // Match Ford
-        if(strstr(protocol_name, "Ford") != NULL &&
-           strstr(protocol_timings[i].name, "Ford") != NULL) {
-            return &protocol_timings[i];
-        }
+static void protopirate_name_hash_insert(const char* name, uint8_t index) {
+    char key[NAME_KEY_MAX];
+    if(protopirate_name_key(name, key) == 0) return;
 
-        // Match Fiat
-        if(strstr(protocol_name, "Fiat") != NULL &&
-           strstr(protocol_timings[i].name, "Fiat") != NULL) {
-            return &protocol_timings[i];
+    uint32_t slot = protopirate_name_hash(key) & (NAME_HASH_SIZE - 1);
+    for(size_t probe = 0; probe < NAME_HASH_SIZE; probe++) {
+        ProtoPirateNameSlot* entry = &name_hash[slot];
+        if(!entry->name) {
+            entry->name = name;
+            entry->index = index;
+            return;
         }
 
-        // Match Subaru
-        if(strstr(protocol_name, "Subaru") != NULL &&
-           strstr(protocol_timings[i].name, "Subaru") != NULL) {
-            return &protocol_timings[i];
-        }
+        char existing[NAME_KEY_MAX];
+        protopirate_name_key(entry->name, existing);
+        if(strcmp(existing, key) == 0) return;
 
-        // Match Suzuki
-        if(strstr(protocol_name, "Suzuki") != NULL &&
-           strstr(protocol_timings[i].name, "Suzuki") != NULL) {
-            return &protocol_timings[i];
-        }
+        slot = (slot + 1) & (NAME_HASH_SIZE - 1);
+    }
 
-        // Match VW
-        if(strstr(protocol_name, "VW") != NULL && strstr(protocol_timings[i].name, "VW") != NULL) {
-            return &protocol_timings[i];
+    FURI_LOG_E(TAG, "Name hash full, %s not indexed", name);
+}
+
+void protopirate_protocol_init(void) {
+    if(name_hash_ready) return;
+
+    for(size_t i = 0; i < PROTOPIRATE_PROTOCOL_COUNT; i++) {
+        const ProtoPirateProtocolInfo* info = &protopirate_protocol_info[i];
+        protopirate_name_hash_insert(info->protocol->name, i);
+        for(const char* const* alias = info->aliases; *alias; alias++) {
+            protopirate_name_hash_insert(*alias, i);
         }
     }
+    name_hash_ready = true;
+}
 
-    return NULL;
+size_t protopirate_protocol_count(void) {
+    return PROTOPIRATE_PROTOCOL_COUNT;
 }
 
-const ProtoPirateProtocolTiming* protopirate_get_protocol_timing_by_index(size_t index) {
-    if(index >= protocol_timings_count) return NULL;
-    return &protocol_timings[index];
+const ProtoPirateProtocolInfo* protopirate_protocol_get_info(size_t index) {
+    if(index >= PROTOPIRATE_PROTOCOL_COUNT) return NULL;
+    return &protopirate_protocol_info[index];
+}
+
+int32_t protopirate_protocol_index(const SubGhzProtocol* protocol) {
+    for(size_t i = 0; i < PROTOPIRATE_PROTOCOL_COUNT; i++) {
+        if(protopirate_protocol_info[i].protocol == protocol) return i;
+    }
+    return -1;
+}
+
+int32_t protopirate_protocol_find(const char* protocol_name) {
+    furi_assert(name_hash_ready);
+    if(!protocol_name) return -1;
+
+    char key[NAME_KEY_MAX];
+    if(protopirate_name_key(protocol_name, key) == 0) return -1;
+
+    uint32_t slot = protopirate_name_hash(key) & (NAME_HASH_SIZE - 1);
+    for(size_t probe = 0; probe < NAME_HASH_SIZE; probe++) {
+        const ProtoPirateNameSlot* entry = &name_hash[slot];
+        if(!entry->name) break;
+
+        char existing[NAME_KEY_MAX];
+        protopirate_name_key(entry->name, existing);
+        if(strcmp(existing, key) == 0) return entry->index;
+
+        slot = (slot + 1) & (NAME_HASH_SIZE - 1);
+    }
+
+    return -1;
 }
 
-size_t protopirate_get_protocol_timing_count(void) {
-    return protocol_timings_count;
+const ProtoPirateProtocolInfo* protopirate_protocol_find_info(const char* protocol_name) {
+    int32_t index = protopirate_protocol_find(protocol_name);
+    return (index < 0) ? NULL : &protopirate_protocol_info[index];
 }
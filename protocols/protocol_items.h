@@ -17,20 +17,40 @@
 
 extern const SubGhzProtocolRegistry protopirate_protocol_registry;
 
-// Timing information for protocol analysis
+// The pulse that takes a decoder out of its reset step, within te_delta of te_short or
+// te_long. The reset step leaves every other pulse alone.
+typedef enum {
+    ProtoPirateProtocolStartShortHigh,
+    ProtoPirateProtocolStartLongHigh,
+    ProtoPirateProtocolStartShortAny, // Of either level
+} ProtoPirateProtocolStart;
+
+// Metadata for a registry protocol. The protocol and timing pointers refer to the
+// decoder's own definitions, so nothing here can drift from what the decoder uses.
 typedef struct {
-    const char* name;
-    uint32_t te_short;
-    uint32_t te_long;
-    uint32_t te_delta;
-    uint32_t min_count_bit;
-} ProtoPirateProtocolTiming;
+    const SubGhzProtocol* protocol;
+    const SubGhzBlockConst* timing;
+    const char* const* aliases;
+    bool short_resets; // Any pulse below te_short - te_delta resets the decoder
+    ProtoPirateProtocolStart start;
+} ProtoPirateProtocolInfo;
+
+// Builds the name index protopirate_protocol_find reads. Call once at app start, before
+// any thread that looks names up is started.
+void protopirate_protocol_init(void);
+
+// Number of registry protocols, info indices match protopirate_protocol_registry
+size_t protopirate_protocol_count(void);
+
+// Info by registry index (NULL if out of range)
+const ProtoPirateProtocolInfo* protopirate_protocol_get_info(size_t index);
 
-// Get timing info for a protocol by name (returns NULL if not found)
-const ProtoPirateProtocolTiming* protopirate_get_protocol_timing(const char* protocol_name);
+// Registry index of a protocol definition, -1 if it is not registered
+int32_t protopirate_protocol_index(const SubGhzProtocol* protocol);
 
-// Get timing info by index (for iteration)
-const ProtoPirateProtocolTiming* protopirate_get_protocol_timing_by_index(size_t index);
+// Registry index for a protocol name or alias, ignoring case, spaces and punctuation.
+// Returns -1 if the name is unknown.
+int32_t protopirate_protocol_find(const char* protocol_name);
 
-// Get number of protocols with timing info
-size_t protopirate_get_protocol_timing_count(void);
+// Info for a protocol name or alias (NULL if not found)
+const ProtoPirateProtocolInfo* protopirate_protocol_find_info(const char* protocol_name);
@@ -0,0 +1,126 @@
+// protocols/protocol_manchester.c
+#include "protocol_manchester.h"
+
+#define EMIT  PROTOPIRATE_MANCHESTER_EMIT
+#define ONE   PROTOPIRATE_MANCHESTER_ONE
+#define BREAK PROTOPIRATE_MANCHESTER_BREAK
+
+// Toolbox states. Pulses that do not fit go back to Mid1, as the toolbox reset does.
+#define START1 0
+#define MID1   1
+#define MID0   2
+#define START0 3
+
+const ProtoPirateManchesterTable protopirate_manchester_toolbox = {
+    .next =
+        {
+            // ShortLow, ShortHigh, LongLow, LongHigh
+            [START1] = {MID1 | BREAK, MID1 | EMIT | ONE, MID1 | BREAK, MID1 | BREAK},
+            [MID1] = {START1, MID1 | BREAK, MID0 | EMIT, MID1 | BREAK},
+            [MID0] = {MID1 | BREAK, START0, MID1 | BREAK, MID1 | EMIT | ONE},
+            [START0] = {MID0 | EMIT, MID1 | BREAK, MID1 | BREAK, MID1 | BREAK},
+        },
+    .reset = MID1,
+};
+
+// Pair states. SKIP drops one half-bit to shift the pairs by one.
+#define BOUNDARY 0
+#define HAVE1    1
+#define HAVE0    2
+#define SKIP     3
+
+const ProtoPirateManchesterTable protopirate_manchester_pairs_10 = {
+    .next =
+        {
+            // ShortLow, ShortHigh, LongLow, LongHigh
+            [BOUNDARY] = {HAVE0, HAVE1, BOUNDARY | BREAK, BOUNDARY | BREAK},
+            [HAVE1] = {BOUNDARY | EMIT | ONE, BOUNDARY | BREAK, HAVE0 | EMIT | ONE, HAVE1 | BREAK},
+            [HAVE0] = {BOUNDARY | BREAK, BOUNDARY | EMIT, HAVE0 | BREAK, HAVE1 | EMIT},
+            [SKIP] = {BOUNDARY, BOUNDARY, HAVE0, HAVE1},
+        },
+    .reset = BOUNDARY,
+};
+
+const ProtoPirateManchesterTable protopirate_manchester_pairs_01 = {
+    .next =
+        {
+            // ShortLow, ShortHigh, LongLow, LongHigh
+            [BOUNDARY] = {HAVE0, HAVE1, BOUNDARY | BREAK, BOUNDARY | BREAK},
+            [HAVE1] = {BOUNDARY | EMIT, BOUNDARY | BREAK, HAVE0 | EMIT, HAVE1 | BREAK},
+            [HAVE0] = {BOUNDARY | BREAK, BOUNDARY | EMIT | ONE, HAVE0 | BREAK, HAVE1 | EMIT | ONE},
+            [SKIP] = {BOUNDARY, BOUNDARY, HAVE0, HAVE1},
+        },
+    .reset = BOUNDARY,
+};
+
+static void protopirate_manchester_frame_close(
+    ProtoPirateManchesterFrame* frame,
+    ProtoPirateManchesterPhase* phase,
+    uint8_t phase_index) {
+    uint8_t offset = phase->start * 2 + phase_index;
+    if(phase->bits > frame->best_bits ||
+       (phase->bits == frame->best_bits && offset < frame->best_offset)) {
+        frame->best_data = phase->data;
+        frame->best_bits = phase->bits;
+        frame->best_offset = offset;
+    }
+}
+
+void protopirate_manchester_frame_start(
+    ProtoPirateManchesterFrame* frame,
+    const ProtoPirateManchesterFrameConfig* config) {
+    memset(frame, 0, sizeof(ProtoPirateManchesterFrame));
+    frame->config = config;
+    frame->best_offset = UINT8_MAX;
+    for(uint8_t i = 0; i < config->phases; i++) {
+        frame->phase[i].state = i ? SKIP : config->table->reset;
+        frame->phase[i].start = config->first_pair;
+    }
+}
+
+void protopirate_manchester_frame_feed(
+    ProtoPirateManchesterFrame* frame,
+    ProtoPirateManchesterEvent event) {
+    const ProtoPirateManchesterFrameConfig* config = frame->config;
+    if(frame->half_bits < UINT16_MAX - 1) {
+        frame->half_bits += (event & ProtoPirateManchesterEventLongLow) ? 2 : 1;
+    }
+
+    for(uint8_t i = 0; i < config->phases; i++) {
+        ProtoPirateManchesterPhase* phase = &frame->phase[i];
+        uint8_t entry = protopirate_manchester_advance(config->table, &phase->state, event);
+        if(!(entry & (EMIT | BREAK)) || phase->done) continue;
+
+        // Each pulse completes at most one pair
+        uint8_t pair = phase->pair++;
+        if(pair < config->first_pair) continue;
+
+        if(entry & EMIT) {
+            phase->data = (phase->data << 1) | ((entry & ONE) ? 1 : 0);
+            if(++phase->bits == config->max_bits) {
+                protopirate_manchester_frame_close(frame, phase, i);
+                phase->done = true;
+            }
+        } else {
+            // A run starting inside the one just broken is shorter, the next start is after it
+            protopirate_manchester_frame_close(frame, phase, i);
+            if(pair >= config->last_start) {
+                phase->done = true;
+            } else {
+                phase->start = pair + 1;
+                phase->bits = 0;
+                phase->data = 0;
+            }
+        }
+    }
+}
+
+void protopirate_manchester_frame_end(ProtoPirateManchesterFrame* frame) {
+    for(uint8_t i = 0; i < frame->config->phases; i++) {
+        ProtoPirateManchesterPhase* phase = &frame->phase[i];
+        if(!phase->done) {
+            protopirate_manchester_frame_close(frame, phase, i);
+            phase->done = true;
+        }
+    }
+}
@@ -0,0 +1,100 @@
+// protocols/protocol_manchester.h
+#pragma once
+
+#include <furi.h>
+#include <lib/subghz/blocks/const.h>
+#include <lib/subghz/blocks/math.h>
+
+// Pulse events as table columns, (long << 1) | level
+typedef enum {
+    ProtoPirateManchesterEventShortLow = 0,
+    ProtoPirateManchesterEventShortHigh = 1,
+    ProtoPirateManchesterEventLongLow = 2,
+    ProtoPirateManchesterEventLongHigh = 3,
+    ProtoPirateManchesterEventInvalid = 4, // Neither short nor long, never fed to a table
+} ProtoPirateManchesterEvent;
+
+// A table entry is the next state in the low bits plus what the pulse completed
+#define PROTOPIRATE_MANCHESTER_STATE 0x03
+#define PROTOPIRATE_MANCHESTER_EMIT  0x04 // A data bit is complete
+#define PROTOPIRATE_MANCHESTER_ONE   0x08 // It is a 1
+#define PROTOPIRATE_MANCHESTER_BREAK 0x10 // The pulse broke the code, the bit run ended
+
+// State x event transitions of one Manchester flavour. A protocol with its own quirks
+// brings its own table; the engine only looks entries up.
+typedef struct {
+    uint8_t next[4][4];
+    uint8_t reset; // State to start a frame in
+} ProtoPirateManchesterTable;
+
+// Manchester as lib/toolbox/manchester_decoder decodes it, with a high then low half as 1
+extern const ProtoPirateManchesterTable protopirate_manchester_toolbox;
+
+// Half-bit pairs: a high then low pair is a 1, a low then high pair is a 0
+extern const ProtoPirateManchesterTable protopirate_manchester_pairs_10;
+
+// Half-bit pairs: a low then high pair is a 1, a high then low pair is a 0
+extern const ProtoPirateManchesterTable protopirate_manchester_pairs_01;
+
+static inline ProtoPirateManchesterEvent protopirate_manchester_event(
+    const SubGhzBlockConst* timing,
+    bool level,
+    uint32_t duration) {
+    if(DURATION_DIFF(duration, timing->te_short) < timing->te_delta) {
+        return level ? ProtoPirateManchesterEventShortHigh : ProtoPirateManchesterEventShortLow;
+    } else if(DURATION_DIFF(duration, timing->te_long) < timing->te_delta) {
+        return level ? ProtoPirateManchesterEventLongHigh : ProtoPirateManchesterEventLongLow;
+    }
+    return ProtoPirateManchesterEventInvalid;
+}
+
+// Moves state along one valid event and returns the entry, test it for EMIT and ONE
+static inline uint8_t protopirate_manchester_advance(
+    const ProtoPirateManchesterTable* table,
+    uint8_t* state,
+    ProtoPirateManchesterEvent event) {
+    uint8_t entry = table->next[*state][event];
+    *state = entry & PROTOPIRATE_MANCHESTER_STATE;
+    return entry;
+}
+
+// Frames whose half-bit alignment is unknown. Runs of valid pairs are decoded while the
+// pulses arrive, from every allowed start, and the longest run is kept.
+typedef struct {
+    const ProtoPirateManchesterTable* table; // A pairs table
+    uint8_t phases; // 2 also tries starts one half-bit in
+    uint8_t first_pair; // Pairs before it are never decoded
+    uint8_t last_start; // Last pair a run may start at
+    uint8_t max_bits; // Up to 64, a run stops growing there
+} ProtoPirateManchesterFrameConfig;
+
+typedef struct {
+    uint8_t state;
+    uint8_t pair; // Pairs completed
+    uint8_t start; // Pair the current run started at
+    uint8_t bits;
+    uint64_t data;
+    bool done; // No later run can win
+} ProtoPirateManchesterPhase;
+
+typedef struct {
+    const ProtoPirateManchesterFrameConfig* config;
+    ProtoPirateManchesterPhase phase[2];
+    uint16_t half_bits; // Fed so far
+    uint64_t best_data;
+    uint8_t best_bits;
+    uint8_t best_offset; // Half-bit the best run starts at
+} ProtoPirateManchesterFrame;
+
+void protopirate_manchester_frame_start(
+    ProtoPirateManchesterFrame* frame,
+    const ProtoPirateManchesterFrameConfig* config);
+
+// Feed one valid event
+void protopirate_manchester_frame_feed(
+    ProtoPirateManchesterFrame* frame,
+    ProtoPirateManchesterEvent event);
+
+// Closes the open runs, best_data and best_bits then hold the longest run. Of equally long
+// runs the one starting first wins.
+void protopirate_manchester_frame_end(ProtoPirateManchesterFrame* frame);
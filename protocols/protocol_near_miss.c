@@ -0,0 +1,138 @@
+// protocols/protocol_near_miss.c
+#include "protocol_near_miss.h"
+
+#define TAG "ProtoPirateNearMiss"
+
+#define NEAR_MISS_MASK      (PROTOPIRATE_NEAR_MISS_HISTORY - 1)
+#define NEAR_MISS_LEVEL_BIT (1UL << 31)
+
+typedef enum {
+    NearMissSlotFree,
+    NearMissSlotReady,
+    NearMissSlotTaken,
+} NearMissSlotState;
+
+struct ProtoPirateNearMiss {
+    uint32_t history[PROTOPIRATE_NEAR_MISS_HISTORY]; // Level in the top bit
+    uint32_t position; // Pulses recorded, the next one goes at position & mask
+
+    FuriMutex* mutex; // Guards the slot states and counters
+    ProtoPirateNearMissSnippet snippets[PROTOPIRATE_NEAR_MISS_SLOTS];
+    uint8_t state[PROTOPIRATE_NEAR_MISS_SLOTS];
+    uint32_t sequence[PROTOPIRATE_NEAR_MISS_SLOTS];
+    uint32_t next_sequence;
+    uint32_t captured;
+    uint32_t dropped;
+};
+
+ProtoPirateNearMiss* protopirate_near_miss_alloc(void) {
+    ProtoPirateNearMiss* near_miss = malloc(sizeof(ProtoPirateNearMiss));
+    memset(near_miss, 0, sizeof(ProtoPirateNearMiss));
+    near_miss->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    return near_miss;
+}
+
+void protopirate_near_miss_free(ProtoPirateNearMiss* near_miss) {
+    furi_assert(near_miss);
+    furi_mutex_free(near_miss->mutex);
+    free(near_miss);
+}
+
+uint32_t
+    protopirate_near_miss_pulse(ProtoPirateNearMiss* near_miss, bool level, uint32_t duration) {
+    uint32_t position = near_miss->position++;
+    near_miss->history[position & NEAR_MISS_MASK] = MIN(duration, NEAR_MISS_LEVEL_BIT - 1) |
+                                                    (level ? NEAR_MISS_LEVEL_BIT : 0);
+    return position;
+}
+
+void protopirate_near_miss_capture(
+    ProtoPirateNearMiss* near_miss,
+    const char* protocol,
+    const char* reason,
+    uint8_t step,
+    uint32_t lock_position) {
+    furi_assert(near_miss);
+
+    // Wrapping differences: the frame length, capped by what the history still has
+    uint32_t end = near_miss->position;
+    uint32_t count = end - lock_position + PROTOPIRATE_NEAR_MISS_LEAD;
+    count = MIN(count, MIN(end, (uint32_t)PROTOPIRATE_NEAR_MISS_HISTORY));
+
+    furi_mutex_acquire(near_miss->mutex, FuriWaitForever);
+
+    size_t slot = 0;
+    while(slot < PROTOPIRATE_NEAR_MISS_SLOTS && near_miss->state[slot] != NearMissSlotFree) {
+        slot++;
+    }
+
+    if(slot == PROTOPIRATE_NEAR_MISS_SLOTS) {
+        near_miss->dropped++;
+    } else {
+        ProtoPirateNearMissSnippet* snippet = &near_miss->snippets[slot];
+        snippet->protocol = protocol;
+        snippet->reason = reason;
+        snippet->step = step;
+        snippet->count = count;
+        for(uint32_t i = 0; i < count; i++) {
+            uint32_t pulse = near_miss->history[(end - count + i) & NEAR_MISS_MASK];
+            int32_t duration = (int32_t)(pulse & ~NEAR_MISS_LEVEL_BIT);
+            snippet->pulses[i] = (pulse & NEAR_MISS_LEVEL_BIT) ? duration : -duration;
+        }
+
+        near_miss->state[slot] = NearMissSlotReady;
+        near_miss->sequence[slot] = near_miss->next_sequence++;
+        near_miss->captured++;
+    }
+
+    furi_mutex_release(near_miss->mutex);
+}
+
+const ProtoPirateNearMissSnippet* protopirate_near_miss_take(ProtoPirateNearMiss* near_miss) {
+    furi_assert(near_miss);
+    const ProtoPirateNearMissSnippet* snippet = NULL;
+
+    furi_mutex_acquire(near_miss->mutex, FuriWaitForever);
+
+    size_t oldest = PROTOPIRATE_NEAR_MISS_SLOTS;
+    for(size_t i = 0; i < PROTOPIRATE_NEAR_MISS_SLOTS; i++) {
+        if(near_miss->state[i] != NearMissSlotReady) continue;
+        if(oldest == PROTOPIRATE_NEAR_MISS_SLOTS ||
+           (int32_t)(near_miss->sequence[i] - near_miss->sequence[oldest]) < 0) {
+            oldest = i;
+        }
+    }
+    if(oldest < PROTOPIRATE_NEAR_MISS_SLOTS) {
+        near_miss->state[oldest] = NearMissSlotTaken;
+        snippet = &near_miss->snippets[oldest];
+    }
+
+    furi_mutex_release(near_miss->mutex);
+    return snippet;
+}
+
+void protopirate_near_miss_release(
+    ProtoPirateNearMiss* near_miss,
+    const ProtoPirateNearMissSnippet* snippet) {
+    furi_assert(near_miss);
+    furi_assert(snippet);
+
+    size_t slot = snippet - near_miss->snippets;
+    furi_assert(slot < PROTOPIRATE_NEAR_MISS_SLOTS);
+
+    furi_mutex_acquire(near_miss->mutex, FuriWaitForever);
+    near_miss->state[slot] = NearMissSlotFree;
+    furi_mutex_release(near_miss->mutex);
+}
+
+void protopirate_near_miss_get_counts(
+    ProtoPirateNearMiss* near_miss,
+    uint32_t* captured,
+    uint32_t* dropped) {
+    furi_assert(near_miss);
+
+    furi_mutex_acquire(near_miss->mutex, FuriWaitForever);
+    if(captured) *captured = near_miss->captured;
+    if(dropped) *dropped = near_miss->dropped;
+    furi_mutex_release(near_miss->mutex);
+}
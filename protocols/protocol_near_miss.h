@@ -0,0 +1,53 @@
+// protocols/protocol_near_miss.h
+#pragma once
+
+#include <furi.h>
+
+// Pulses kept from the stream, also the most a snippet holds. Power of 2.
+#define PROTOPIRATE_NEAR_MISS_HISTORY 256
+// Pulses from before the preamble lock that go into a snippet
+#define PROTOPIRATE_NEAR_MISS_LEAD 32
+// Snippets waiting to be written, captures past that are counted as dropped
+#define PROTOPIRATE_NEAR_MISS_SLOTS 3
+// Step value for a frame the decoder did not drop itself
+#define PROTOPIRATE_NEAR_MISS_NO_STEP 0xFF
+
+// The pulses of a frame a decoder locked onto and then gave up on
+typedef struct {
+    const char* protocol;
+    const char* reason;
+    uint8_t step;
+    uint16_t count;
+    int32_t pulses[PROTOPIRATE_NEAR_MISS_HISTORY]; // RAW_Data convention, low is negative
+} ProtoPirateNearMissSnippet;
+
+// Keeps the last pulses of the stream so a failed frame can be cut out of it. Pulses and
+// captures come from the decode thread, snippets are taken from any other thread.
+typedef struct ProtoPirateNearMiss ProtoPirateNearMiss;
+
+ProtoPirateNearMiss* protopirate_near_miss_alloc(void);
+void protopirate_near_miss_free(ProtoPirateNearMiss* near_miss);
+
+// Decode thread: record a pulse, returns its position in the stream
+uint32_t
+    protopirate_near_miss_pulse(ProtoPirateNearMiss* near_miss, bool level, uint32_t duration);
+
+// Decode thread: keep everything from a little before lock_position up to the last pulse
+void protopirate_near_miss_capture(
+    ProtoPirateNearMiss* near_miss,
+    const char* protocol,
+    const char* reason,
+    uint8_t step,
+    uint32_t lock_position);
+
+// Oldest waiting snippet or NULL, hand it back with release once written
+const ProtoPirateNearMissSnippet* protopirate_near_miss_take(ProtoPirateNearMiss* near_miss);
+void protopirate_near_miss_release(
+    ProtoPirateNearMiss* near_miss,
+    const ProtoPirateNearMissSnippet* snippet);
+
+// Snippets captured and dropped for lack of a free slot
+void protopirate_near_miss_get_counts(
+    ProtoPirateNearMiss* near_miss,
+    uint32_t* captured,
+    uint32_t* dropped);
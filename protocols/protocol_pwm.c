@@ -0,0 +1,6 @@
+// protocols/protocol_pwm.c
+#include "protocol_pwm.h"
+
+void protopirate_pwm_reset(ProtoPiratePwm* pwm) {
+    memset(pwm, 0, sizeof(ProtoPiratePwm));
+}
@@ -0,0 +1,151 @@
+// protocols/protocol_pwm.h
+#pragma once
+
+#include <furi.h>
+#include "protocol_stats.h"
+
+// Pulse windows for a rule, the ends are exclusive as with DURATION_DIFF(duration, te) < delta
+#define PROTOPIRATE_PWM_SPAN(lo, hi)    (lo) + 1, (hi) - (lo) - 1
+#define PROTOPIRATE_PWM_NEAR(te, delta) PROTOPIRATE_PWM_SPAN((te) - (delta), (te) + (delta))
+#define PROTOPIRATE_PWM_ABOVE(lo)       (lo) + 1, UINT32_MAX - (lo) - 1
+#define PROTOPIRATE_PWM_ANY             0, UINT32_MAX
+
+// What a matching rule does, in this order
+#define PROTOPIRATE_PWM_START    0x01 // The preamble count starts over
+#define PROTOPIRATE_PWM_COUNT    0x02 // One more preamble pulse
+#define PROTOPIRATE_PWM_PREAMBLE 0x04 // The rule only matches after preamble_min pulses
+#define PROTOPIRATE_PWM_LOCK     0x08 // Data starts, counted as a preamble lock
+#define PROTOPIRATE_PWM_BIT      0x10 // Shifts in a data bit, a 0 unless ONE
+#define PROTOPIRATE_PWM_ONE      0x20
+#define PROTOPIRATE_PWM_END      0x40 // The frame ended, feed returns true if its bit count fits
+
+typedef struct {
+    uint32_t min; // Inclusive
+    uint32_t span; // Durations from min up to, not including, min + span match
+    uint8_t action;
+    uint8_t next; // Step taken when the rule matches
+} ProtoPiratePwmRule;
+
+typedef struct {
+    const ProtoPiratePwmRule* rules;
+    uint8_t count;
+} ProtoPiratePwmRules;
+
+// A step's rules are split by pulse level ahead of time, so a pulse only walks the rules of
+// its own level. Within a level the first matching rule fires, a pulse no rule matches goes
+// back to step 0. A rule for both levels is listed in both.
+typedef struct {
+    ProtoPiratePwmRules level[2]; // LOW, HIGH
+} ProtoPiratePwmStep;
+
+#define PROTOPIRATE_PWM_MAX_STEPS 8
+
+#define PROTOPIRATE_PWM_RULES(rules)    {(rules), COUNT_OF(rules)}
+#define PROTOPIRATE_PWM_NONE            {NULL, 0}
+#define PROTOPIRATE_PWM_STEP(low, high) {{PROTOPIRATE_PWM_RULES(low), PROTOPIRATE_PWM_RULES(high)}}
+#define PROTOPIRATE_PWM_STEP_LOW(low)   {{PROTOPIRATE_PWM_RULES(low), PROTOPIRATE_PWM_NONE}}
+#define PROTOPIRATE_PWM_STEP_HIGH(high) {{PROTOPIRATE_PWM_NONE, PROTOPIRATE_PWM_RULES(high)}}
+
+// One PWM fob: its steps as rules on pulse level and duration, step 0 waits for the
+// preamble. Everything a protocol does after the frame ended stays in the protocol.
+typedef struct {
+    const ProtoPiratePwmStep* steps;
+    uint8_t step_count; // Up to PROTOPIRATE_PWM_MAX_STEPS
+    uint16_t preamble_min; // Counted pulses PREAMBLE rules need
+    uint8_t seed_bits; // Zero bits in front of the first data bit
+    uint8_t min_bits; // A frame ending outside these fails as short
+    uint8_t max_bits;
+} ProtoPiratePwmDescriptor;
+
+typedef struct {
+    uint8_t step;
+    uint8_t bits; // Counted up to 255
+    uint16_t preamble;
+    uint64_t data; // Up to the first 64 bits, the first one highest
+    bool lock_level; // Level of the pulse data started on
+} ProtoPiratePwm;
+
+void protopirate_pwm_reset(ProtoPiratePwm* pwm);
+
+// Walks the rules of one step and level, both constants in every call below so the
+// compiler unrolls the walk with each window as an immediate
+static FURI_ALWAYS_INLINE bool protopirate_pwm_walk(
+    ProtoPiratePwm* pwm,
+    const ProtoPiratePwmDescriptor* pwm_desc,
+    ProtoPirateProtocolStats* stats,
+    uint8_t step,
+    bool level,
+    uint32_t duration) {
+    const ProtoPiratePwmRules* rules = &pwm_desc->steps[step].level[level];
+
+    for(uint8_t i = 0; i < rules->count; i++) {
+        const ProtoPiratePwmRule* rule = &rules->rules[i];
+        // Below min wraps around, so one compare checks both ends
+        if(duration - rule->min >= rule->span) continue;
+        uint8_t action = rule->action;
+        if((action & PROTOPIRATE_PWM_PREAMBLE) && pwm->preamble < pwm_desc->preamble_min) {
+            continue;
+        }
+
+        pwm->step = rule->next;
+        if(action & PROTOPIRATE_PWM_START) {
+            pwm->preamble = 0;
+        }
+        if((action & PROTOPIRATE_PWM_COUNT) && pwm->preamble < UINT16_MAX) {
+            pwm->preamble++;
+        }
+        if(action & PROTOPIRATE_PWM_LOCK) {
+            protopirate_protocol_stats_lock(stats);
+            pwm->data = 0;
+            pwm->bits = pwm_desc->seed_bits;
+            pwm->lock_level = level;
+        }
+        if(action & PROTOPIRATE_PWM_BIT) {
+            if(pwm->bits < 64) {
+                pwm->data = (pwm->data << 1) | ((action & PROTOPIRATE_PWM_ONE) ? 1 : 0);
+            }
+            if(pwm->bits < UINT8_MAX) pwm->bits++;
+        }
+        if(action & PROTOPIRATE_PWM_END) {
+            if(pwm->bits >= pwm_desc->min_bits && pwm->bits <= pwm_desc->max_bits) return true;
+            protopirate_protocol_stats_fail(stats, "Short frame", step);
+        }
+        return false;
+    }
+
+    pwm->step = 0;
+    return false;
+}
+
+// One case per step up to PROTOPIRATE_PWM_MAX_STEPS
+#define PROTOPIRATE_PWM_CASE(step)                                                           \
+    case step:                                                                              \
+        if(step >= pwm_desc->step_count) break;                                             \
+        return level ? protopirate_pwm_walk(pwm, pwm_desc, stats, step, true, duration) :   \
+                       protopirate_pwm_walk(pwm, pwm_desc, stats, step, false, duration);
+
+// Runs one pulse through the descriptor's current step. True when an END rule fired with the
+// bit count in range, the frame is then in data and bits. Inline with the descriptor a
+// constant, so each decoder gets its own walk specialised on step and level.
+static inline bool protopirate_pwm_feed(
+    ProtoPiratePwm* pwm,
+    const ProtoPiratePwmDescriptor* pwm_desc,
+    ProtoPirateProtocolStats* stats,
+    bool level,
+    uint32_t duration) {
+    switch(pwm->step) {
+        PROTOPIRATE_PWM_CASE(0)
+        PROTOPIRATE_PWM_CASE(1)
+        PROTOPIRATE_PWM_CASE(2)
+        PROTOPIRATE_PWM_CASE(3)
+        PROTOPIRATE_PWM_CASE(4)
+        PROTOPIRATE_PWM_CASE(5)
+        PROTOPIRATE_PWM_CASE(6)
+        PROTOPIRATE_PWM_CASE(7)
+    }
+
+    pwm->step = 0;
+    return false;
+}
+
+#undef PROTOPIRATE_PWM_CASE
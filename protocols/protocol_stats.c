@@ -0,0 +1,60 @@
+// protocols/protocol_stats.c
+#include "protocol_stats.h"
+#include "protocol_items.h"
+#include "protocol_dispatch.h"
+
+#define TAG "ProtoPirateStats"
+
+// One entry per registry protocol plus the scratch entry at the end
+static ProtoPirateProtocolStats protopirate_protocol_stats[PROTOPIRATE_DISPATCH_MAX + 1];
+
+#define PROTOPIRATE_STATS_SCRATCH PROTOPIRATE_DISPATCH_MAX
+
+ProtoPirateProtocolStats* protopirate_protocol_stats_get(const SubGhzProtocol* protocol) {
+    int32_t index = protopirate_protocol_index(protocol);
+    if(index < 0 || index >= PROTOPIRATE_STATS_SCRATCH) {
+        return &protopirate_protocol_stats[PROTOPIRATE_STATS_SCRATCH];
+    }
+    return &protopirate_protocol_stats[index];
+}
+
+void protopirate_protocol_stats_reset(void) {
+    memset(protopirate_protocol_stats, 0, sizeof(protopirate_protocol_stats));
+}
+
+void protopirate_protocol_stats_format(FuriString* output) {
+    ProtoPirateProtocolStats total = {0};
+    uint32_t per_us = furi_hal_cortex_instructions_per_microsecond();
+
+    furi_string_cat_printf(output, "Protocol, Pulses, Locks, Resets, Check fail, Decodes, us\n");
+    for(size_t i = 0; i < protopirate_protocol_count() && i < PROTOPIRATE_STATS_SCRATCH; i++) {
+        const ProtoPirateProtocolStats* stats = &protopirate_protocol_stats[i];
+        furi_string_cat_printf(
+            output,
+            "%s, %lu, %lu, %lu, %lu, %lu, %lu\n",
+            protopirate_protocol_get_info(i)->protocol->name,
+            stats->pulses,
+            stats->preamble_locks,
+            stats->resets,
+            stats->check_failures,
+            stats->decodes,
+            (uint32_t)(stats->cycles / per_us));
+
+        total.pulses += stats->pulses;
+        total.preamble_locks += stats->preamble_locks;
+        total.resets += stats->resets;
+        total.check_failures += stats->check_failures;
+        total.decodes += stats->decodes;
+        total.cycles += stats->cycles;
+    }
+
+    furi_string_cat_printf(
+        output,
+        "Total, %lu, %lu, %lu, %lu, %lu, %lu\n",
+        total.pulses,
+        total.preamble_locks,
+        total.resets,
+        total.check_failures,
+        total.decodes,
+        (uint32_t)(total.cycles / per_us));
+}
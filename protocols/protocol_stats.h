@@ -0,0 +1,98 @@
+// protocols/protocol_stats.h
+#pragma once
+
+#include <lib/subghz/types.h>
+#include <furi_hal_cortex.h>
+
+// Build with this defined to charge each decoder's pulses and feed time in the dispatch.
+// Off by default, it reads the cycle counter after every decoder on the receive path.
+// #define PROTOPIRATE_DISPATCH_PROFILE
+
+// Counters for one registry protocol, shared by all of its decoder instances. They are
+// plain increments: a count may be off by one when two threads decode the same protocol.
+typedef struct {
+    uint32_t pulses; // Fed through the dispatch, PROTOPIRATE_DISPATCH_PROFILE builds only
+    uint32_t preamble_locks; // Preamble accepted, data decoding started
+    uint32_t resets; // Fell back to the reset step without decoding
+    uint32_t check_failures; // Frame ended but failed its CRC, check or bit count
+    uint32_t decodes; // Frames handed to the decoder callback
+    uint64_t cycles; // Spent in feed, from the DWT cycle counter, likewise
+    // Step the last feed left a decoder in, 0 for its reset step. The dispatch reads it
+    // straight after its own feed; only one thread feeds a protocol at a time, the receiver
+    // stops before Sub Decode and the batch decoder start.
+    uint8_t step;
+
+    // Near-miss tracking: the dispatch takes a miss after the feed that set it
+    bool locked; // A frame is being decoded
+    uint8_t miss_step; // Step the frame was dropped from
+    const char* miss_reason; // Why a locked frame was dropped, a string literal
+} ProtoPirateProtocolStats;
+
+// Where a decoder's state was when feed started, see protopirate_protocol_stats_step
+typedef struct {
+    uint8_t step;
+    uint32_t decodes;
+} ProtoPirateProtocolStatsMark;
+
+// Stats for a protocol. Protocols outside the registry share a scratch entry that is
+// never reported, so a decoder can always count into what it gets.
+ProtoPirateProtocolStats* protopirate_protocol_stats_get(const SubGhzProtocol* protocol);
+
+// Zeroes every protocol's counters
+void protopirate_protocol_stats_reset(void);
+
+// Appends one line per registry protocol, then a totals line. Pulses and us stay 0 unless
+// built with PROTOPIRATE_DISPATCH_PROFILE.
+void protopirate_protocol_stats_format(FuriString* output);
+
+// Cycle counter reading, wraps every ~67 s at 64 MHz which differences survive
+static inline uint32_t protopirate_protocol_stats_cycles(void) {
+    return furi_hal_cortex_timer_get(0).start;
+}
+
+static inline ProtoPirateProtocolStatsMark
+    protopirate_protocol_stats_mark(const ProtoPirateProtocolStats* stats, uint8_t step) {
+    return (ProtoPirateProtocolStatsMark){.step = step, .decodes = stats->decodes};
+}
+
+// Drops the frame being decoded as a near miss, reason must be a string literal
+static inline void protopirate_protocol_stats_miss(
+    ProtoPirateProtocolStats* stats,
+    const char* reason,
+    uint8_t step) {
+    if(stats->locked) {
+        stats->locked = false;
+        stats->miss_reason = reason;
+        stats->miss_step = step;
+    }
+}
+
+// Preamble accepted, data decoding starts
+static inline void protopirate_protocol_stats_lock(ProtoPirateProtocolStats* stats) {
+    stats->preamble_locks++;
+    stats->locked = true;
+}
+
+// Frame ended but failed its CRC, check or bit count
+static inline void protopirate_protocol_stats_fail(
+    ProtoPirateProtocolStats* stats,
+    const char* reason,
+    uint8_t step) {
+    stats->check_failures++;
+    protopirate_protocol_stats_miss(stats, reason, step);
+}
+
+// Call at the end of feed with the mark taken at its start. A decoder that went back
+// to its reset step (0) from anywhere else without a decode on the way dropped a frame.
+static inline void protopirate_protocol_stats_step(
+    ProtoPirateProtocolStats* stats,
+    ProtoPirateProtocolStatsMark mark,
+    uint8_t step) {
+    stats->step = step;
+    if(stats->decodes != mark.decodes) {
+        stats->locked = false;
+    } else if(mark.step != 0 && step == 0) {
+        stats->resets++;
+        protopirate_protocol_stats_miss(stats, "Reset", mark.step);
+    }
+}
@@ -0,0 +1,78 @@
+// protocols/protocol_trace.c
+#include "protocol_trace.h"
+#include <stdatomic.h>
+
+#define TAG "ProtoPirateTrace"
+
+#define PROTOPIRATE_TRACE_MASK (PROTOPIRATE_TRACE_DEPTH - 1)
+
+typedef struct {
+    const char* name;
+    const char* detail; // Takes both arguments as unsigned long
+} ProtoPirateTraceFormat;
+
+static const ProtoPirateTraceFormat protopirate_trace_formats[ProtoPirateTraceEventCount] = {
+    [ProtoPirateTraceCrc] = {"CRC", "rx 0x%02lX calc 0x%02lX"},
+    [ProtoPirateTraceSync] = {"Sync", "%lu preamble pulses"},
+    [ProtoPirateTraceFrameEnd] = {"Frame end", "%lu half bits"},
+    [ProtoPirateTraceManchester] = {"Manchester", "offset %lu, %lu bits"},
+    [ProtoPirateTraceInvalidPulse] = {"Invalid pulse", "level %lu, %lu us"},
+    [ProtoPirateTraceKey] = {"Key", "%08lX%08lX"},
+    [ProtoPirateTraceHistoryAdd] = {"History add", "item %lu, size %lu"},
+    [ProtoPirateTraceDecoded] = {"Decoded", "history id %lu, kept %lu"},
+    [ProtoPirateTraceMatch] = {"Match", "%lu frames"},
+    [ProtoPirateTraceSerialized] = {"Serialized", ""},
+};
+
+static ProtoPirateTraceRecord protopirate_trace_ring[PROTOPIRATE_TRACE_DEPTH];
+
+// Records written since the last reset, runs freely and is masked on access
+static atomic_uint protopirate_trace_head;
+
+void protopirate_trace(
+    ProtoPirateTraceEvent event,
+    const char* label,
+    uint32_t arg0,
+    uint32_t arg1) {
+    // Claiming the slot is the only shared step, concurrent writers get different slots
+    unsigned slot = atomic_fetch_add_explicit(&protopirate_trace_head, 1, memory_order_relaxed);
+    ProtoPirateTraceRecord* record = &protopirate_trace_ring[slot & PROTOPIRATE_TRACE_MASK];
+
+    record->tick = furi_get_tick();
+    record->event = event;
+    record->label = label;
+    record->arg[0] = arg0;
+    record->arg[1] = arg1;
+}
+
+void protopirate_trace_reset(void) {
+    atomic_store(&protopirate_trace_head, 0);
+    memset(protopirate_trace_ring, 0, sizeof(protopirate_trace_ring));
+}
+
+void protopirate_trace_format(FuriString* output) {
+    unsigned head = atomic_load(&protopirate_trace_head);
+    unsigned count = head < PROTOPIRATE_TRACE_DEPTH ? head : PROTOPIRATE_TRACE_DEPTH;
+
+    furi_string_cat_printf(output, "Tick ms, Event, Label, Detail\n");
+    for(unsigned slot = head - count; slot != head; slot++) {
+        // Copied first, a writer may reuse the slot meanwhile
+        ProtoPirateTraceRecord record = protopirate_trace_ring[slot & PROTOPIRATE_TRACE_MASK];
+        if(record.event >= ProtoPirateTraceEventCount) continue;
+
+        const ProtoPirateTraceFormat* format = &protopirate_trace_formats[record.event];
+        furi_string_cat_printf(
+            output,
+            "%lu, %s, %s, ",
+            (unsigned long)record.tick,
+            format->name,
+            record.label ? record.label : "");
+        furi_string_cat_printf(
+            output, format->detail, (unsigned long)record.arg[0], (unsigned long)record.arg[1]);
+        furi_string_cat_printf(output, "\n");
+    }
+
+    if(head > PROTOPIRATE_TRACE_DEPTH) {
+        furi_string_cat_printf(output, "%u older records overwritten\n", head - count);
+    }
+}
@@ -0,0 +1,51 @@
+// protocols/protocol_trace.h
+#pragma once
+
+#include <furi.h>
+
+// Binary event trace for per-frame paths. A record is an event id, the tick and two raw
+// arguments, copied into a RAM ring without formatting. Text is only made when the ring
+// is dumped, so tracing stays on in every build. Errors and one-off events stay on FURI_LOG.
+typedef enum {
+    ProtoPirateTraceCrc, // Received, calculated
+    ProtoPirateTraceSync, // Preamble pulses counted
+    ProtoPirateTraceFrameEnd, // Raw half bits collected
+    ProtoPirateTraceManchester, // Offset, bits of the best alignment
+    ProtoPirateTraceInvalidPulse, // Level, duration
+    ProtoPirateTraceKey, // Key high and low words
+    ProtoPirateTraceHistoryAdd, // Item number, history size
+    ProtoPirateTraceDecoded, // History item, -1 if it was evicted
+    ProtoPirateTraceMatch, // Sub Decode: first frame of a protocol
+    ProtoPirateTraceSerialized, // Sub Decode: frame saved for the result screen
+    ProtoPirateTraceEventCount,
+} ProtoPirateTraceEvent;
+
+typedef struct {
+    uint32_t tick; // furi_get_tick() when recorded
+    uint32_t event; // ProtoPirateTraceEvent
+    const char* label; // Usually the protocol name, a string that outlives the trace
+    uint32_t arg[2];
+} ProtoPirateTraceRecord;
+
+// Power of two, 2.5 KB on the device. Older records are overwritten.
+#define PROTOPIRATE_TRACE_DEPTH 128
+
+// Safe from any thread. Writers never wait; one landing while the ring is dumped may come
+// out half written in the dump, the ring itself is never corrupted.
+void protopirate_trace(
+    ProtoPirateTraceEvent event,
+    const char* label,
+    uint32_t arg0,
+    uint32_t arg1);
+
+// A 64-bit value split over both arguments, high word first
+static inline void
+    protopirate_trace_u64(ProtoPirateTraceEvent event, const char* label, uint64_t value) {
+    protopirate_trace(event, label, (uint32_t)(value >> 32), (uint32_t)value);
+}
+
+// Drops every record
+void protopirate_trace_reset(void);
+
+// Appends a header and one line per record, oldest first
+void protopirate_trace_format(FuriString* output);
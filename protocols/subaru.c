@@ -1,4 +1,6 @@
 #include "subaru.h"
+#include "protocol_pwm.h"
+#include "protocol_stats.h"
 #include <lib/subghz/blocks/const.h>
 #include <lib/subghz/blocks/decoder.h>
 #include <lib/subghz/blocks/encoder.h>
@@ -7,10 +9,14 @@
 
 #define TAG "SubaruProtocol"
 
-static const SubGhzBlockConst subghz_protocol_subaru_const = {
-    .te_short = 800,
-    .te_long = 1600,
-    .te_delta = 250,
+#define SUBARU_TE_SHORT 800
+#define SUBARU_TE_LONG  1600
+#define SUBARU_TE_DELTA 250
+
+const SubGhzBlockConst subghz_protocol_subaru_const = {
+    .te_short = SUBARU_TE_SHORT,
+    .te_long = SUBARU_TE_LONG,
+    .te_delta = SUBARU_TE_DELTA,
     .min_count_bit_for_found = 64,
 };
 
@@ -18,15 +24,14 @@ typedef struct SubGhzProtocolDecoderSubaru {
     SubGhzProtocolDecoderBase base;
     SubGhzBlockDecoder decoder;
     SubGhzBlockGeneric generic;
-
-    uint16_t header_count;
-    uint16_t bit_count;
-    uint8_t data[8];
+    ProtoPiratePwm pwm;
 
     uint64_t key;
     uint32_t serial;
     uint8_t button;
     uint16_t count;
+
+    ProtoPirateProtocolStats* stats;
 } SubGhzProtocolDecoderSubaru;
 
 typedef enum {
@@ -57,6 +62,64 @@ typedef enum {
     SubaruDecoderStepCheckDuration,
 } SubaruDecoderStep;
 
+#define SUBARU_SHORT PROTOPIRATE_PWM_NEAR(SUBARU_TE_SHORT, SUBARU_TE_DELTA)
+#define SUBARU_LONG  PROTOPIRATE_PWM_NEAR(SUBARU_TE_LONG, SUBARU_TE_DELTA)
+#define SUBARU_GAP   PROTOPIRATE_PWM_SPAN(2000, 3500)
+#define SUBARU_END   PROTOPIRATE_PWM_ABOVE(3000)
+
+static const ProtoPiratePwmRule subaru_pwm_reset_high[] = {
+    {SUBARU_LONG, PROTOPIRATE_PWM_START | PROTOPIRATE_PWM_COUNT, SubaruDecoderStepCheckPreamble},
+};
+
+static const ProtoPiratePwmRule subaru_pwm_preamble_high[] = {
+    {SUBARU_LONG, PROTOPIRATE_PWM_COUNT, SubaruDecoderStepCheckPreamble},
+};
+
+static const ProtoPiratePwmRule subaru_pwm_preamble_low[] = {
+    {SUBARU_LONG, PROTOPIRATE_PWM_COUNT, SubaruDecoderStepCheckPreamble},
+    {SUBARU_GAP, PROTOPIRATE_PWM_PREAMBLE, SubaruDecoderStepFoundGap},
+};
+
+static const ProtoPiratePwmRule subaru_pwm_gap_high[] = {
+    {SUBARU_GAP, 0, SubaruDecoderStepFoundSync},
+};
+
+static const ProtoPiratePwmRule subaru_pwm_sync_low[] = {
+    {SUBARU_LONG, PROTOPIRATE_PWM_LOCK, SubaruDecoderStepSaveDuration},
+};
+
+// HIGH pulse duration encodes the bit: short HIGH (~800us) = 1, long HIGH (~1600us) = 0
+static const ProtoPiratePwmRule subaru_pwm_save_high[] = {
+    {SUBARU_SHORT, PROTOPIRATE_PWM_BIT | PROTOPIRATE_PWM_ONE, SubaruDecoderStepCheckDuration},
+    {SUBARU_LONG, PROTOPIRATE_PWM_BIT, SubaruDecoderStepCheckDuration},
+    {SUBARU_END, PROTOPIRATE_PWM_END, SubaruDecoderStepReset},
+};
+
+// LOW pulse just validates timing, doesn't encode a bit
+static const ProtoPiratePwmRule subaru_pwm_check_low[] = {
+    {SUBARU_SHORT, 0, SubaruDecoderStepSaveDuration},
+    {SUBARU_LONG, 0, SubaruDecoderStepSaveDuration},
+    {SUBARU_END, PROTOPIRATE_PWM_END, SubaruDecoderStepReset},
+};
+
+static const ProtoPiratePwmStep subaru_pwm_steps[] = {
+    [SubaruDecoderStepReset] = PROTOPIRATE_PWM_STEP_HIGH(subaru_pwm_reset_high),
+    [SubaruDecoderStepCheckPreamble] =
+        PROTOPIRATE_PWM_STEP(subaru_pwm_preamble_low, subaru_pwm_preamble_high),
+    [SubaruDecoderStepFoundGap] = PROTOPIRATE_PWM_STEP_HIGH(subaru_pwm_gap_high),
+    [SubaruDecoderStepFoundSync] = PROTOPIRATE_PWM_STEP_LOW(subaru_pwm_sync_low),
+    [SubaruDecoderStepSaveDuration] = PROTOPIRATE_PWM_STEP_HIGH(subaru_pwm_save_high),
+    [SubaruDecoderStepCheckDuration] = PROTOPIRATE_PWM_STEP_LOW(subaru_pwm_check_low),
+};
+
+static const ProtoPiratePwmDescriptor subaru_pwm = {
+    .steps = subaru_pwm_steps,
+    .step_count = COUNT_OF(subaru_pwm_steps),
+    .preamble_min = 21,
+    .min_bits = 64,
+    .max_bits = UINT8_MAX,
+};
+
 const SubGhzProtocolDecoder subghz_protocol_subaru_decoder = {
     .alloc = subghz_protocol_decoder_subaru_alloc,
     .free = subghz_protocol_decoder_subaru_free,
@@ -194,42 +257,25 @@ static void subaru_encode_count(const uint32_t serial, const uint16_t count, uin
     out_bytes[7] |= (REG_SH2_enc & 0x0F) << 4;
 }
 
-static void subaru_add_bit(SubGhzProtocolDecoderSubaru* instance, bool bit) {
-    if(instance->bit_count < 64) {
-        uint8_t byte_idx = instance->bit_count / 8;
-        uint8_t bit_idx = 7 - (instance->bit_count % 8);
-        if(bit) {
-            instance->data[byte_idx] |= (1 << bit_idx);
-        } else {
-            instance->data[byte_idx] &= ~(1 << bit_idx);
-        }
-        instance->bit_count++;
+static void subaru_process_data(SubGhzProtocolDecoderSubaru* instance) {
+    uint8_t b[8];
+    for(uint8_t i = 0; i < 8; i++) {
+        b[i] = (uint8_t)(instance->pwm.data >> (56 - i * 8));
     }
-}
-
-static bool subaru_process_data(SubGhzProtocolDecoderSubaru* instance) {
-    if(instance->bit_count < 64) {
-        return false;
-    }
-
-    uint8_t* b = instance->data;
-
-    instance->key = ((uint64_t)b[0] << 56) | ((uint64_t)b[1] << 48) | ((uint64_t)b[2] << 40) |
-                    ((uint64_t)b[3] << 32) | ((uint64_t)b[4] << 24) | ((uint64_t)b[5] << 16) |
-                    ((uint64_t)b[6] << 8) | ((uint64_t)b[7]);
 
+    instance->key = instance->pwm.data;
     instance->serial = ((uint32_t)b[1] << 16) | ((uint32_t)b[2] << 8) | b[3];
     instance->button = b[0] & 0x0F;
     subaru_decode_count(b, &instance->count);
-
-    return true;
 }
 
 void* subghz_protocol_decoder_subaru_alloc(SubGhzEnvironment* environment) {
     UNUSED(environment);
     SubGhzProtocolDecoderSubaru* instance = malloc(sizeof(SubGhzProtocolDecoderSubaru));
     instance->base.protocol = &subaru_protocol;
+    instance->stats = protopirate_protocol_stats_get(&subaru_protocol);
     instance->generic.protocol_name = instance->base.protocol->name;
+    protopirate_pwm_reset(&instance->pwm);
     return instance;
 }
 
@@ -242,145 +288,30 @@ void subghz_protocol_decoder_subaru_free(void* context) {
 void subghz_protocol_decoder_subaru_reset(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderSubaru* instance = context;
-    instance->decoder.parser_step = SubaruDecoderStepReset;
-    instance->decoder.te_last = 0;
-    instance->header_count = 0;
-    instance->bit_count = 0;
-    memset(instance->data, 0, sizeof(instance->data));
+    protopirate_pwm_reset(&instance->pwm);
 }
 
 void subghz_protocol_decoder_subaru_feed(void* context, bool level, uint32_t duration) {
     furi_assert(context);
     SubGhzProtocolDecoderSubaru* instance = context;
-
-    switch(instance->decoder.parser_step) {
-    case SubaruDecoderStepReset:
-        if(level && DURATION_DIFF(duration, subghz_protocol_subaru_const.te_long) <
-                        subghz_protocol_subaru_const.te_delta) {
-            instance->decoder.parser_step = SubaruDecoderStepCheckPreamble;
-            instance->decoder.te_last = duration;
-            instance->header_count = 1;
-        }
-        break;
-
-    case SubaruDecoderStepCheckPreamble:
-        if(!level) {
-            if(DURATION_DIFF(duration, subghz_protocol_subaru_const.te_long) <
-               subghz_protocol_subaru_const.te_delta) {
-                instance->header_count++;
-            } else if(duration > 2000 && duration < 3500) {
-                if(instance->header_count > 20) {
-                    instance->decoder.parser_step = SubaruDecoderStepFoundGap;
-                } else {
-                    instance->decoder.parser_step = SubaruDecoderStepReset;
-                }
-            } else {
-                instance->decoder.parser_step = SubaruDecoderStepReset;
-            }
-        } else {
-            if(DURATION_DIFF(duration, subghz_protocol_subaru_const.te_long) <
-               subghz_protocol_subaru_const.te_delta) {
-                instance->decoder.te_last = duration;
-                instance->header_count++;
-            } else {
-                instance->decoder.parser_step = SubaruDecoderStepReset;
-            }
-        }
-        break;
-
-    case SubaruDecoderStepFoundGap:
-        if(level && duration > 2000 && duration < 3500) {
-            instance->decoder.parser_step = SubaruDecoderStepFoundSync;
-        } else {
-            instance->decoder.parser_step = SubaruDecoderStepReset;
-        }
-        break;
-
-    case SubaruDecoderStepFoundSync:
-        if(!level && DURATION_DIFF(duration, subghz_protocol_subaru_const.te_long) <
-                         subghz_protocol_subaru_const.te_delta) {
-            instance->decoder.parser_step = SubaruDecoderStepSaveDuration;
-            instance->bit_count = 0;
-            memset(instance->data, 0, sizeof(instance->data));
-        } else {
-            instance->decoder.parser_step = SubaruDecoderStepReset;
+    ProtoPirateProtocolStatsMark mark =
+        protopirate_protocol_stats_mark(instance->stats, instance->pwm.step);
+
+    if(protopirate_pwm_feed(&instance->pwm, &subaru_pwm, instance->stats, level, duration)) {
+        subaru_process_data(instance);
+        instance->generic.data = instance->key;
+        instance->generic.data_count_bit = 64;
+        instance->generic.serial = instance->serial;
+        instance->generic.btn = instance->button;
+        instance->generic.cnt = instance->count;
+
+        instance->stats->decodes++;
+        if(instance->base.callback) {
+            instance->base.callback(&instance->base, instance->base.context);
         }
-        break;
-
-    case SubaruDecoderStepSaveDuration:
-        if(level) {
-            // HIGH pulse duration encodes the bit:
-            // Short HIGH (~800µs) = 1
-            // Long HIGH (~1600µs) = 0
-            if(DURATION_DIFF(duration, subghz_protocol_subaru_const.te_short) <
-               subghz_protocol_subaru_const.te_delta) {
-                // Short HIGH = bit 1
-                subaru_add_bit(instance, true);
-                instance->decoder.te_last = duration;
-                instance->decoder.parser_step = SubaruDecoderStepCheckDuration;
-            } else if(
-                DURATION_DIFF(duration, subghz_protocol_subaru_const.te_long) <
-                subghz_protocol_subaru_const.te_delta) {
-                // Long HIGH = bit 0
-                subaru_add_bit(instance, false);
-                instance->decoder.te_last = duration;
-                instance->decoder.parser_step = SubaruDecoderStepCheckDuration;
-            } else if(duration > 3000) {
-                // End of transmission
-                if(instance->bit_count >= 64) {
-                    if(subaru_process_data(instance)) {
-                        instance->generic.data = instance->key;
-                        instance->generic.data_count_bit = 64;
-                        instance->generic.serial = instance->serial;
-                        instance->generic.btn = instance->button;
-                        instance->generic.cnt = instance->count;
-
-                        if(instance->base.callback) {
-                            instance->base.callback(&instance->base, instance->base.context);
-                        }
-                    }
-                }
-                instance->decoder.parser_step = SubaruDecoderStepReset;
-            } else {
-                instance->decoder.parser_step = SubaruDecoderStepReset;
-            }
-        } else {
-            instance->decoder.parser_step = SubaruDecoderStepReset;
-        }
-        break;
-
-    case SubaruDecoderStepCheckDuration:
-        if(!level) {
-            // LOW pulse - just validates timing, doesn't encode bit
-            if(DURATION_DIFF(duration, subghz_protocol_subaru_const.te_short) <
-                   subghz_protocol_subaru_const.te_delta ||
-               DURATION_DIFF(duration, subghz_protocol_subaru_const.te_long) <
-                   subghz_protocol_subaru_const.te_delta) {
-                instance->decoder.parser_step = SubaruDecoderStepSaveDuration;
-            } else if(duration > 3000) {
-                // Gap - end of packet
-                if(instance->bit_count >= 64) {
-                    if(subaru_process_data(instance)) {
-                        instance->generic.data = instance->key;
-                        instance->generic.data_count_bit = 64;
-                        instance->generic.serial = instance->serial;
-                        instance->generic.btn = instance->button;
-                        instance->generic.cnt = instance->count;
-
-                        if(instance->base.callback) {
-                            instance->base.callback(&instance->base, instance->base.context);
-                        }
-                    }
-                }
-                instance->decoder.parser_step = SubaruDecoderStepReset;
-            } else {
-                instance->decoder.parser_step = SubaruDecoderStepReset;
-            }
-        } else {
-            instance->decoder.parser_step = SubaruDecoderStepReset;
-        }
-        break;
     }
+
+    protopirate_protocol_stats_step(instance->stats, mark, instance->pwm.step);
 }
 
 uint8_t subghz_protocol_decoder_subaru_get_hash_data(void* context) {
@@ -430,6 +361,17 @@ SubGhzProtocolStatus
 
     if(ret == SubGhzProtocolStatusOk) {
         uint32_t temp_val;
+        if(flipper_format_read_uint32(flipper_format, "Serial", &instance->serial, 1)) {
+            instance->generic.serial = instance->serial;
+        }
+        if(flipper_format_read_uint32(flipper_format, "Btn", &temp_val, 1)) {
+            instance->button = temp_val;
+            instance->generic.btn = temp_val;
+        }
+        if(flipper_format_read_uint32(flipper_format, "Cnt", &temp_val, 1)) {
+            instance->count = temp_val;
+            instance->generic.cnt = temp_val;
+        }
         if(flipper_format_read_uint32(flipper_format, "DataHi", &temp_val, 1)) {
             instance->key = ((uint64_t)temp_val << 32);
         }
@@ -13,6 +13,7 @@
 #define SUBARU_PROTOCOL_NAME "Subaru"
 
 extern const SubGhzProtocol subaru_protocol;
+extern const SubGhzBlockConst subghz_protocol_subaru_const;
 
 void* subghz_protocol_decoder_subaru_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_subaru_free(void* context);
@@ -1,4 +1,6 @@
 #include "suzuki.h"
+#include "protocol_pwm.h"
+#include "protocol_stats.h"
 #include <lib/subghz/blocks/const.h>
 #include <lib/subghz/blocks/decoder.h>
 #include <lib/subghz/blocks/encoder.h>
@@ -7,10 +9,14 @@
 
 #define TAG "SuzukiProtocol"
 
-static const SubGhzBlockConst subghz_protocol_suzuki_const = {
-    .te_short = 250,
-    .te_long = 500,
-    .te_delta = 100,
+#define SUZUKI_TE_SHORT 250
+#define SUZUKI_TE_LONG  500
+#define SUZUKI_TE_DELTA 100
+
+const SubGhzBlockConst subghz_protocol_suzuki_const = {
+    .te_short = SUZUKI_TE_SHORT,
+    .te_long = SUZUKI_TE_LONG,
+    .te_delta = SUZUKI_TE_DELTA,
     .min_count_bit_for_found = 64,
 };
 
@@ -21,12 +27,9 @@ typedef struct SubGhzProtocolDecoderSuzuki {
     SubGhzProtocolDecoderBase base;
     SubGhzBlockDecoder decoder;
     SubGhzBlockGeneric generic;
+    ProtoPiratePwm pwm;
 
-    uint32_t te_last;
-    uint32_t data_low;
-    uint32_t data_high;
-    uint8_t data_count_bit;
-    uint16_t header_count;
+    ProtoPirateProtocolStats* stats;
 } SubGhzProtocolDecoderSuzuki;
 
 typedef enum {
@@ -53,6 +56,59 @@ typedef enum {
     SuzukiDecoderStepSaveDuration,
 } SuzukiDecoderStep;
 
+#define SUZUKI_SHORT PROTOPIRATE_PWM_NEAR(SUZUKI_TE_SHORT, SUZUKI_TE_DELTA)
+#define SUZUKI_LONG  PROTOPIRATE_PWM_NEAR(SUZUKI_TE_LONG, SUZUKI_TE_DELTA)
+#define SUZUKI_GAP   PROTOPIRATE_PWM_NEAR(SUZUKI_GAP_TIME, SUZUKI_GAP_DELTA)
+
+// Wait for short HIGH pulse (~250us) to start preamble, a pulse right at the edge counts too
+static const ProtoPiratePwmRule suzuki_pwm_reset_high[] = {
+    {PROTOPIRATE_PWM_SPAN(
+         SUZUKI_TE_SHORT - SUZUKI_TE_DELTA - 1, SUZUKI_TE_SHORT + SUZUKI_TE_DELTA + 1),
+     PROTOPIRATE_PWM_START,
+     SuzukiDecoderStepFoundStartPulse},
+};
+
+// Short LOWs count as header. Once it is long enough the first long HIGH starts the data,
+// any other HIGH is ignored.
+static const ProtoPiratePwmRule suzuki_pwm_preamble_low[] = {
+    {SUZUKI_SHORT, PROTOPIRATE_PWM_COUNT, SuzukiDecoderStepFoundStartPulse},
+};
+
+static const ProtoPiratePwmRule suzuki_pwm_preamble_high[] = {
+    {SUZUKI_LONG,
+     PROTOPIRATE_PWM_PREAMBLE | PROTOPIRATE_PWM_LOCK | PROTOPIRATE_PWM_BIT | PROTOPIRATE_PWM_ONE,
+     SuzukiDecoderStepSaveDuration},
+    {PROTOPIRATE_PWM_ANY, 0, SuzukiDecoderStepFoundStartPulse},
+};
+
+// Long HIGH (~500us) = 1, Short HIGH (~250us) = 0. Short LOWs are ignored, the gap ends
+// the transmission.
+static const ProtoPiratePwmRule suzuki_pwm_data_high[] = {
+    {SUZUKI_LONG, PROTOPIRATE_PWM_BIT | PROTOPIRATE_PWM_ONE, SuzukiDecoderStepSaveDuration},
+    {SUZUKI_SHORT, PROTOPIRATE_PWM_BIT, SuzukiDecoderStepSaveDuration},
+};
+
+static const ProtoPiratePwmRule suzuki_pwm_data_low[] = {
+    {SUZUKI_GAP, PROTOPIRATE_PWM_END, SuzukiDecoderStepReset},
+    {PROTOPIRATE_PWM_ANY, 0, SuzukiDecoderStepSaveDuration},
+};
+
+static const ProtoPiratePwmStep suzuki_pwm_steps[] = {
+    [SuzukiDecoderStepReset] = PROTOPIRATE_PWM_STEP_HIGH(suzuki_pwm_reset_high),
+    [SuzukiDecoderStepFoundStartPulse] =
+        PROTOPIRATE_PWM_STEP(suzuki_pwm_preamble_low, suzuki_pwm_preamble_high),
+    [SuzukiDecoderStepSaveDuration] =
+        PROTOPIRATE_PWM_STEP(suzuki_pwm_data_low, suzuki_pwm_data_high),
+};
+
+static const ProtoPiratePwmDescriptor suzuki_pwm = {
+    .steps = suzuki_pwm_steps,
+    .step_count = COUNT_OF(suzuki_pwm_steps),
+    .preamble_min = 257,
+    .min_bits = 64,
+    .max_bits = 64,
+};
+
 const SubGhzProtocolDecoder subghz_protocol_suzuki_decoder = {
     .alloc = subghz_protocol_decoder_suzuki_alloc,
     .free = subghz_protocol_decoder_suzuki_free,
@@ -89,18 +145,13 @@ const SubGhzProtocol suzuki_protocol = {
     .encoder = &subghz_protocol_suzuki_encoder,
 };
 
-static void suzuki_add_bit(SubGhzProtocolDecoderSuzuki* instance, uint32_t bit) {
-    uint32_t carry = instance->data_low >> 31;
-    instance->data_low = (instance->data_low << 1) | bit;
-    instance->data_high = (instance->data_high << 1) | carry;
-    instance->data_count_bit++;
-}
-
 void* subghz_protocol_decoder_suzuki_alloc(SubGhzEnvironment* environment) {
     UNUSED(environment);
     SubGhzProtocolDecoderSuzuki* instance = malloc(sizeof(SubGhzProtocolDecoderSuzuki));
     instance->base.protocol = &suzuki_protocol;
+    instance->stats = protopirate_protocol_stats_get(&suzuki_protocol);
     instance->generic.protocol_name = instance->base.protocol->name;
+    protopirate_pwm_reset(&instance->pwm);
     return instance;
 }
 
@@ -113,107 +164,39 @@ void subghz_protocol_decoder_suzuki_free(void* context) {
 void subghz_protocol_decoder_suzuki_reset(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderSuzuki* instance = context;
-    instance->decoder.parser_step = SuzukiDecoderStepReset;
-    instance->header_count = 0;
-    instance->data_count_bit = 0;
-    instance->data_low = 0;
-    instance->data_high = 0;
+    protopirate_pwm_reset(&instance->pwm);
 }
 
 void subghz_protocol_decoder_suzuki_feed(void* context, bool level, uint32_t duration) {
     furi_assert(context);
     SubGhzProtocolDecoderSuzuki* instance = context;
-
-    switch(instance->decoder.parser_step) {
-    case SuzukiDecoderStepReset:
-        // Wait for short HIGH pulse (~250µs) to start preamble
-        if(!level) return;
-
-        if(DURATION_DIFF(duration, subghz_protocol_suzuki_const.te_short) >
-           subghz_protocol_suzuki_const.te_delta) {
-            return;
-        }
-
-        instance->data_low = 0;
-        instance->data_high = 0;
-        instance->decoder.parser_step = SuzukiDecoderStepFoundStartPulse;
-        instance->header_count = 0;
-        instance->data_count_bit = 0;
-        break;
-
-    case SuzukiDecoderStepFoundStartPulse:
-        if(level) {
-            // HIGH pulse
-            if(instance->header_count < 257) {
-                // Still in preamble - just count
-                return;
-            }
-
-            // After preamble, look for long HIGH to start data
-            if(DURATION_DIFF(duration, subghz_protocol_suzuki_const.te_long) <
-               subghz_protocol_suzuki_const.te_delta) {
-                instance->decoder.parser_step = SuzukiDecoderStepSaveDuration;
-                suzuki_add_bit(instance, 1);
-            }
-            // Ignore short HIGHs after preamble until we see a long one
-        } else {
-            // LOW pulse - count as header if short
-            if(DURATION_DIFF(duration, subghz_protocol_suzuki_const.te_short) <
-               subghz_protocol_suzuki_const.te_delta) {
-                instance->te_last = duration;
-                instance->header_count++;
-            } else {
-                instance->decoder.parser_step = SuzukiDecoderStepReset;
-            }
-        }
-        break;
-
-    case SuzukiDecoderStepSaveDuration:
-        if(level) {
-            // HIGH pulse - determines bit value
-            // Long HIGH (~500µs) = 1, Short HIGH (~250µs) = 0
-            if(DURATION_DIFF(duration, subghz_protocol_suzuki_const.te_long) <
-               subghz_protocol_suzuki_const.te_delta) {
-                suzuki_add_bit(instance, 1);
-            } else if(
-                DURATION_DIFF(duration, subghz_protocol_suzuki_const.te_short) <
-                subghz_protocol_suzuki_const.te_delta) {
-                suzuki_add_bit(instance, 0);
-            } else {
-                instance->decoder.parser_step = SuzukiDecoderStepReset;
+    ProtoPirateProtocolStatsMark mark =
+        protopirate_protocol_stats_mark(instance->stats, instance->pwm.step);
+
+    if(protopirate_pwm_feed(&instance->pwm, &suzuki_pwm, instance->stats, level, duration)) {
+        uint64_t data = instance->pwm.data;
+        instance->generic.data_count_bit = 64;
+        instance->generic.data = data;
+
+        // Check manufacturer nibble (should be 0xF)
+        uint8_t manufacturer = (data >> 60) & 0xF;
+        if(manufacturer == 0xF) {
+            // Extract fields
+            uint32_t serial_button = (uint32_t)(data >> 12);
+            instance->generic.serial = serial_button >> 4;
+            instance->generic.btn = serial_button & 0xF;
+            instance->generic.cnt = (data >> 44) & 0xFFFF;
+
+            instance->stats->decodes++;
+            if(instance->base.callback) {
+                instance->base.callback(&instance->base, instance->base.context);
             }
-            // Stay in this state for next bit
         } else {
-            // LOW pulse - check for gap (end of transmission)
-            if(DURATION_DIFF(duration, SUZUKI_GAP_TIME) < SUZUKI_GAP_DELTA) {
-                // Gap found - end of transmission
-                if(instance->data_count_bit == 64) {
-                    instance->generic.data_count_bit = 64;
-                    instance->generic.data = ((uint64_t)instance->data_high << 32) |
-                                             (uint64_t)instance->data_low;
-
-                    // Check manufacturer nibble (should be 0xF)
-                    uint8_t manufacturer = (instance->data_high >> 28) & 0xF;
-                    if(manufacturer == 0xF) {
-                        // Extract fields
-                        uint64_t data = instance->generic.data;
-                        uint32_t serial_button = ((instance->data_high & 0xFFF) << 20) |
-                                                 (instance->data_low >> 12);
-                        instance->generic.serial = serial_button >> 4;
-                        instance->generic.btn = serial_button & 0xF;
-                        instance->generic.cnt = (data >> 44) & 0xFFFF;
-
-                        if(instance->base.callback) {
-                            instance->base.callback(&instance->base, instance->base.context);
-                        }
-                    }
-                }
-                instance->decoder.parser_step = SuzukiDecoderStepReset;
-            }
-            // Short LOW pulses are ignored - stay in this state
+            protopirate_protocol_stats_fail(instance->stats, "Manufacturer mismatch", mark.step);
         }
-        break;
     }
+
+    protopirate_protocol_stats_step(instance->stats, mark, instance->pwm.step);
 }
 
 uint8_t subghz_protocol_decoder_suzuki_get_hash_data(void* context) {
@@ -1,4 +1,6 @@
 #include "vw.h"
+#include "protocol_stats.h"
+#include "protocol_manchester.h"
 #include <lib/subghz/blocks/const.h>
 #include <lib/subghz/blocks/decoder.h>
 #include <lib/subghz/blocks/encoder.h>
@@ -7,7 +9,7 @@
 
 #define TAG "VWProtocol"
 
-static const SubGhzBlockConst subghz_protocol_vw_const = {
+const SubGhzBlockConst subghz_protocol_vw_const = {
     .te_short = 500,
     .te_long = 1000,
     .te_delta = 120,
@@ -19,8 +21,10 @@ typedef struct SubGhzProtocolDecoderVw {
     SubGhzBlockDecoder decoder;
     SubGhzBlockGeneric generic;
 
-    ManchesterState manchester_state;
+    uint8_t manchester_state;
     uint64_t data_2; // Additional 16 bits (type byte + check byte)
+
+    ProtoPirateProtocolStats* stats;
 } SubGhzProtocolDecoderVw;
 
 typedef enum {
@@ -88,54 +92,29 @@ const SubGhzProtocol vw_protocol = {
     .encoder = &subghz_protocol_vw_encoder,
 };
 
-// Fixed manchester_advance for VW protocol
-static bool vw_manchester_advance(
-    ManchesterState state,
-    ManchesterEvent event,
-    ManchesterState* next_state,
-    bool* data) {
-    bool result = false;
-    ManchesterState new_state = ManchesterStateMid1;
-
-    if(event == ManchesterEventReset) {
-        new_state = ManchesterStateMid1;
-    } else if(state == ManchesterStateMid0 || state == ManchesterStateMid1) {
-        if(event == ManchesterEventShortHigh) {
-            new_state = ManchesterStateStart1;
-        } else if(event == ManchesterEventShortLow) {
-            new_state = ManchesterStateStart0;
-        } else {
-            new_state = ManchesterStateMid1;
-        }
-    } else if(state == ManchesterStateStart1) {
-        if(event == ManchesterEventShortLow) {
-            new_state = ManchesterStateMid1;
-            result = true;
-            if(data) *data = true;
-        } else if(event == ManchesterEventLongLow) {
-            new_state = ManchesterStateStart0;
-            result = true;
-            if(data) *data = true;
-        } else {
-            new_state = ManchesterStateMid1;
-        }
-    } else if(state == ManchesterStateStart0) {
-        if(event == ManchesterEventShortHigh) {
-            new_state = ManchesterStateMid0;
-            result = true;
-            if(data) *data = false;
-        } else if(event == ManchesterEventLongHigh) {
-            new_state = ManchesterStateStart1;
-            result = true;
-            if(data) *data = false;
-        } else {
-            new_state = ManchesterStateMid1;
-        }
-    }
-
-    *next_state = new_state;
-    return result;
-}
+// VW drops back to a bit boundary on any pulse that does not fit, instead of resetting
+#define VW_MID    0
+#define VW_START1 1
+#define VW_START0 2
+
+static const ProtoPirateManchesterTable vw_manchester = {
+    .next =
+        {
+            // ShortLow, ShortHigh, LongLow, LongHigh
+            [VW_MID] = {VW_START0, VW_START1, VW_MID, VW_MID},
+            [VW_START1] =
+                {VW_MID | PROTOPIRATE_MANCHESTER_EMIT | PROTOPIRATE_MANCHESTER_ONE,
+                 VW_MID,
+                 VW_START0 | PROTOPIRATE_MANCHESTER_EMIT | PROTOPIRATE_MANCHESTER_ONE,
+                 VW_MID},
+            [VW_START0] =
+                {VW_MID,
+                 VW_MID | PROTOPIRATE_MANCHESTER_EMIT,
+                 VW_MID,
+                 VW_START1 | PROTOPIRATE_MANCHESTER_EMIT},
+        },
+    .reset = VW_MID,
+};
 
 static uint8_t vw_get_bit_index(uint8_t bit) {
     uint8_t bit_index = 0;
@@ -186,6 +165,7 @@ static void vw_add_bit(SubGhzProtocolDecoderVw* instance, bool level) {
     instance->generic.data_count_bit++;
 
     if(instance->generic.data_count_bit >= subghz_protocol_vw_const.min_count_bit_for_found) {
+        instance->stats->decodes++;
         if(instance->base.callback) {
             instance->base.callback(&instance->base, instance->base.context);
         }
@@ -196,6 +176,7 @@ void* subghz_protocol_decoder_vw_alloc(SubGhzEnvironment* environment) {
     UNUSED(environment);
     SubGhzProtocolDecoderVw* instance = malloc(sizeof(SubGhzProtocolDecoderVw));
     instance->base.protocol = &vw_protocol;
+    instance->stats = protopirate_protocol_stats_get(&vw_protocol);
     instance->generic.protocol_name = instance->base.protocol->name;
     return instance;
 }
@@ -213,12 +194,14 @@ void subghz_protocol_decoder_vw_reset(void* context) {
     instance->generic.data_count_bit = 0;
     instance->generic.data = 0;
     instance->data_2 = 0;
-    instance->manchester_state = ManchesterStateMid1;
+    instance->manchester_state = vw_manchester.reset;
 }
 
 void subghz_protocol_decoder_vw_feed(void* context, bool level, uint32_t duration) {
     furi_assert(context);
     SubGhzProtocolDecoderVw* instance = context;
+    ProtoPirateProtocolStatsMark mark =
+        protopirate_protocol_stats_mark(instance->stats, instance->decoder.parser_step);
 
     uint32_t te_short = subghz_protocol_vw_const.te_short;
     uint32_t te_long = subghz_protocol_vw_const.te_long;
@@ -226,8 +209,6 @@ void subghz_protocol_decoder_vw_feed(void* context, bool level, uint32_t duratio
     uint32_t te_med = (te_long + te_short) / 2;
     uint32_t te_end = te_long * 5;
 
-    ManchesterEvent event = ManchesterEventReset;
-
     switch(instance->decoder.parser_step) {
     case VwDecoderStepReset:
         if(DURATION_DIFF(duration, te_short) < te_delta) {
@@ -273,21 +254,18 @@ void subghz_protocol_decoder_vw_feed(void* context, bool level, uint32_t duratio
             break;
         }
 
+        // The short HIGH is the first half of the type's top bit. Types with the top bit
+        // clear (0x00, 0x2B) start with a short LOW instead, which runs into the last
+        // medium LOW, so those frames are not decoded.
         if(level && DURATION_DIFF(duration, te_short) < te_delta) {
             // Start data collection
-            vw_manchester_advance(
-                instance->manchester_state,
-                ManchesterEventReset,
-                &instance->manchester_state,
-                NULL);
-            vw_manchester_advance(
-                instance->manchester_state,
-                ManchesterEventShortHigh,
-                &instance->manchester_state,
-                NULL);
+            instance->manchester_state = vw_manchester.reset;
+            protopirate_manchester_advance(
+                &vw_manchester, &instance->manchester_state, ProtoPirateManchesterEventShortHigh);
             instance->generic.data_count_bit = 0;
             instance->generic.data = 0;
             instance->data_2 = 0;
+            protopirate_protocol_stats_lock(instance->stats);
             instance->decoder.parser_step = VwDecoderStepFoundData;
             break;
         }
@@ -295,33 +273,31 @@ void subghz_protocol_decoder_vw_feed(void* context, bool level, uint32_t duratio
         instance->decoder.parser_step = VwDecoderStepReset;
         break;
 
-    case VwDecoderStepFoundData:
-        if(DURATION_DIFF(duration, te_short) < te_delta) {
-            event = level ? ManchesterEventShortHigh : ManchesterEventShortLow;
-        }
-
-        if(DURATION_DIFF(duration, te_long) < te_delta) {
-            event = level ? ManchesterEventLongHigh : ManchesterEventLongLow;
-        }
+    case VwDecoderStepFoundData: {
+        ProtoPirateManchesterEvent event =
+            protopirate_manchester_event(&subghz_protocol_vw_const, level, duration);
 
         // Last bit can be arbitrarily long
         if(instance->generic.data_count_bit ==
                subghz_protocol_vw_const.min_count_bit_for_found - 1 &&
            !level && duration > te_end) {
-            event = ManchesterEventShortLow;
+            event = ProtoPirateManchesterEventShortLow;
         }
 
-        if(event == ManchesterEventReset) {
+        if(event == ProtoPirateManchesterEventInvalid) {
             subghz_protocol_decoder_vw_reset(instance);
         } else {
-            bool new_level;
-            if(vw_manchester_advance(
-                   instance->manchester_state, event, &instance->manchester_state, &new_level)) {
-                vw_add_bit(instance, new_level);
+            uint8_t entry =
+                protopirate_manchester_advance(&vw_manchester, &instance->manchester_state, event);
+            if(entry & PROTOPIRATE_MANCHESTER_EMIT) {
+                vw_add_bit(instance, entry & PROTOPIRATE_MANCHESTER_ONE);
             }
         }
         break;
     }
+    }
+
+    protopirate_protocol_stats_step(instance->stats, mark, instance->decoder.parser_step);
 }
 
 uint8_t subghz_protocol_decoder_vw_get_hash_data(void* context) {
@@ -509,10 +485,11 @@ LevelDuration subghz_protocol_encoder_vw_yield(void* context) {
                 return level_duration_make(false, te_med);
             }
         } else {
+            // The decoder takes the first half of the type's top bit as the start of data,
+            // so there is no separate start pulse
             instance->step = VwEncoderStepData;
-            return level_duration_make(true, te_short); // Start of data
         }
-
+        // fallthrough
     case VwEncoderStepData:
         if(instance->manchester_pulse.duration > 0) {
             LevelDuration pulse = instance->manchester_pulse;
@@ -8,12 +8,12 @@
 #include <lib/subghz/blocks/encoder.h>
 #include <lib/subghz/blocks/generic.h>
 #include <lib/subghz/blocks/math.h>
-#include <lib/toolbox/manchester_decoder.h>
 #include <flipper_format/flipper_format.h>
 
 #define VW_PROTOCOL_NAME "VW"
 
 extern const SubGhzProtocol vw_protocol;
+extern const SubGhzBlockConst subghz_protocol_vw_const;
 
 void* subghz_protocol_decoder_vw_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_vw_free(void* context);
@@ -32,6 +32,9 @@ ProtoPirateApp* protopirate_app_alloc() {
 
     FURI_LOG_I(TAG, "Allocating ProtoPirate Decoder App");
 
+    // Name lookups run on the receiver, decode worker and GUI threads, index them first
+    protopirate_protocol_init();
+
     // GUI
     app->gui = furi_record_open(RECORD_GUI);
 
@@ -90,6 +93,9 @@ ProtoPirateApp* protopirate_app_alloc() {
     // Init setting
     app->setting = subghz_setting_alloc();
     app->loaded_file_path = NULL;
+    app->journal = NULL;
+    app->near_miss = NULL;
+    app->near_miss_index = 0;
     // Fix: Try to load user settings first, fallback to default if failed
     subghz_setting_load(app->setting, EXT_PATH("subghz/assets/setting_user"));
     if(subghz_setting_get_preset_count(app->setting) == 0) {
@@ -103,6 +109,7 @@ ProtoPirateApp* protopirate_app_alloc() {
 
     // Apply auto-save setting
     app->auto_save = settings.auto_save;
+    app->near_miss_capture = settings.near_miss;
 
     // Init Worker & Protocol & History
     app->lock = ProtoPirateLockOff;
@@ -157,7 +164,6 @@ ProtoPirateApp* protopirate_app_alloc() {
     app->txrx->hopper_timeout = 0;
     app->txrx->idx_menu_chosen = 0;
 
-    app->txrx->history = protopirate_history_alloc();
     app->txrx->worker = subghz_worker_alloc();
 
     // Create environment with our custom protocols
@@ -167,9 +173,25 @@ ProtoPirateApp* protopirate_app_alloc() {
     subghz_environment_set_protocol_registry(
         app->txrx->environment, (void*)&protopirate_protocol_registry);
 
+    // History rebuilds item text and saved form with decoders from this environment
+    app->txrx->history = protopirate_history_alloc(app->txrx->environment);
+    app->txrx->decode_queue = protopirate_decode_queue_alloc();
+
     // Create receiver
     app->txrx->receiver = subghz_receiver_alloc_init(app->txrx->environment);
 
+    // Feed the receiver's decoders through the classified dispatch instead of
+    // subghz_receiver_decode, so each pulse is classified once for all of them
+    app->txrx->dispatch = protopirate_dispatch_alloc();
+    for(size_t i = 0; i < protopirate_protocol_registry.size; i++) {
+        const SubGhzProtocol* protocol = protopirate_protocol_registry.items[i];
+        if(!(protocol->flag & SubGhzProtocolFlag_Decodable)) continue;
+        protopirate_dispatch_add(
+            app->txrx->dispatch,
+            protocol,
+            subghz_receiver_search_decoder_base_by_name(app->txrx->receiver, protocol->name));
+    }
+
     // Initialize SubGhz devices
     subghz_devices_init();
 
@@ -194,12 +216,18 @@ ProtoPirateApp* protopirate_app_alloc() {
     // Set filter to accept decodable protocols
     subghz_receiver_set_filter(app->txrx->receiver, SubGhzProtocolFlag_Decodable);
 
+    // The worker only queues pulses, the decoders run on the ring's decode thread
+    app->txrx->pulse_ring = protopirate_pulse_ring_alloc(PROTOPIRATE_PULSE_RING_DEPTH);
+    protopirate_pulse_ring_set_pair_callback(
+        app->txrx->pulse_ring, (SubGhzWorkerPairCallback)protopirate_dispatch_feed);
+    protopirate_pulse_ring_set_reset_callback(
+        app->txrx->pulse_ring, (SubGhzWorkerOverrunCallback)protopirate_dispatch_reset);
+    protopirate_pulse_ring_set_context(app->txrx->pulse_ring, app->txrx->dispatch);
+
     // Set up worker callbacks
-    subghz_worker_set_overrun_callback(
-        app->txrx->worker, (SubGhzWorkerOverrunCallback)subghz_receiver_reset);
-    subghz_worker_set_pair_callback(
-        app->txrx->worker, (SubGhzWorkerPairCallback)subghz_receiver_decode);
-    subghz_worker_set_context(app->txrx->worker, app->txrx->receiver);
+    subghz_worker_set_overrun_callback(app->txrx->worker, protopirate_pulse_ring_overrun);
+    subghz_worker_set_pair_callback(app->txrx->worker, protopirate_pulse_ring_push);
+    subghz_worker_set_context(app->txrx->worker, app->txrx->pulse_ring);
 
     furi_hal_power_suppress_charge_enter();
 
@@ -213,14 +241,12 @@ void protopirate_app_free(ProtoPirateApp* app) {
 
     FURI_LOG_I(TAG, "Freeing ProtoPirate Decoder App");
 
-    // Free the storage file list cache
-    protopirate_storage_free_file_list();
-
     // Save settings before exiting
     ProtoPirateSettings settings;
     settings.frequency = app->txrx->preset->frequency;
     settings.auto_save = app->auto_save;
     settings.hopping_enabled = (app->txrx->hopper_state != ProtoPirateHopperStateOFF);
+    settings.near_miss = app->near_miss_capture;
 
     // Find current preset index
     settings.preset_index = 0;
@@ -248,6 +274,23 @@ void protopirate_app_free(ProtoPirateApp* app) {
         subghz_devices_stop_async_rx(app->txrx->radio_device);
     }
 
+    if(app->journal) {
+        protopirate_journal_close(app->journal);
+    }
+    protopirate_storage_sequence_flush();
+
+    ProtoPiratePulseRingStats ring_stats;
+    protopirate_pulse_ring_get_stats(app->txrx->pulse_ring, &ring_stats);
+    FURI_LOG_I(
+        TAG,
+        "Pulses: %lu, dropped %lu in %lu overruns, worker overruns %lu, peak %lu/%lu",
+        ring_stats.pulses,
+        ring_stats.dropped,
+        ring_stats.overruns,
+        ring_stats.worker_overruns,
+        ring_stats.high_water,
+        ring_stats.depth);
+
     if(app->loaded_file_path) {
         furi_string_free(app->loaded_file_path);
     }
@@ -285,9 +328,15 @@ void protopirate_app_free(ProtoPirateApp* app) {
     subghz_setting_free(app->setting);
 
     // Worker & Protocol & History
+    protopirate_pulse_ring_free(app->txrx->pulse_ring);
+    protopirate_dispatch_free(app->txrx->dispatch);
+    if(app->near_miss) {
+        protopirate_near_miss_free(app->near_miss);
+    }
     subghz_receiver_free(app->txrx->receiver);
     subghz_environment_free(app->txrx->environment);
     protopirate_history_free(app->txrx->history);
+    protopirate_decode_queue_free(app->txrx->decode_queue);
     subghz_worker_free(app->txrx->worker);
     furi_string_free(app->txrx->preset->name);
     free(app->txrx->preset);
@@ -96,6 +96,8 @@ void protopirate_rx_end(ProtoPirateApp* app) {
         subghz_worker_stop(app->txrx->worker);
         subghz_devices_stop_async_rx(app->txrx->radio_device);
     }
+    // Decode what was queued before the stop, nothing decodes behind the caller after this
+    protopirate_pulse_ring_sync(app->txrx->pulse_ring);
     subghz_devices_idle(app->txrx->radio_device);
     app->txrx->txrx_state = ProtoPirateTxRxStateIDLE;
 }
@@ -146,7 +148,7 @@ void protopirate_hopper_update(ProtoPirateApp* app) {
         protopirate_rx_end(app);
     }
     if(app->txrx->txrx_state == ProtoPirateTxRxStateIDLE) {
-        subghz_receiver_reset(app->txrx->receiver);
+        protopirate_dispatch_reset(app->txrx->dispatch);
         app->txrx->preset->frequency =
             subghz_setting_get_hopper_frequency(app->setting, app->txrx->hopper_idx_frequency);
         protopirate_rx(app, app->txrx->preset->frequency);
@@ -8,6 +8,10 @@
 #include "views/protopirate_receiver_info.h"
 #include "protopirate_history.h"
 #include "helpers/radio_device_loader.h"
+#include "helpers/protopirate_decode_queue.h"
+#include "helpers/protopirate_journal.h"
+#include "helpers/protopirate_pulse_ring.h"
+#include "protocols/protocol_dispatch.h"
 
 #include <gui/gui.h>
 #include <gui/view_dispatcher.h>
@@ -29,8 +33,11 @@ typedef struct {
     SubGhzWorker* worker;
     SubGhzEnvironment* environment;
     SubGhzReceiver* receiver;
+    ProtoPirateDispatch* dispatch;
+    ProtoPiratePulseRing* pulse_ring;
     SubGhzRadioPreset* preset;
     ProtoPirateHistory* history;
+    ProtoPirateDecodeQueue* decode_queue;
     const SubGhzDevice* radio_device;
     ProtoPirateTxRxState txrx_state;
     ProtoPirateHopperState hopper_state;
@@ -56,6 +63,10 @@ struct ProtoPirateApp {
     ProtoPirateLock lock;
     FuriString* loaded_file_path;
     bool auto_save;
+    ProtoPirateJournal* journal; // Open while a receive session auto-saves
+    bool near_miss_capture;
+    ProtoPirateNearMiss* near_miss; // Allocated by the first session that captures
+    uint32_t near_miss_index; // Where the next near-miss file name search starts
     ProtoPirateSettings settings;
 };
 
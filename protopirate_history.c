@@ -1,70 +1,162 @@
 // protopirate_history.c
 #include "protopirate_history.h"
-#include <lib/subghz/receiver.h>
-#include <flipper_format/flipper_format_i.h>
+#include "protocols/protocol_items.h"
+#include "protocols/protocol_trace.h"
+#include <lib/subghz/blocks/decoder.h>
+#include <lib/subghz/blocks/generic.h>
+#include <toolbox/stream/stream.h>
+#include <furi_hal_rtc.h>
 
 #define TAG "ProtoPirateHistory"
 
+#define HISTORY_EXTRA_MAX     PROTOPIRATE_CAPTURE_EXTRA_MAX
+#define HISTORY_PRESET_MAX    8
+#define HISTORY_PRESET_INLINE 0xFF // Record's name is in preset_inline[slot]
+
+// key_format: length in the low bits, top bit set for a plain hex string
+// ("Key: 0123ABCD...") instead of the generic space separated bytes
+#define HISTORY_KEY_COMPACT  0x80
+#define HISTORY_KEY_LEN_MASK 0x7F
+
+// Open addressing over ring slots, kept at most half full
+#define HISTORY_HASH_SIZE  1024
+#define HISTORY_HASH_MASK  (HISTORY_HASH_SIZE - 1)
+#define HISTORY_HASH_EMPTY 0
+
+_Static_assert((HISTORY_HASH_SIZE & HISTORY_HASH_MASK) == 0, "Hash size must be a power of 2");
+_Static_assert(HISTORY_HASH_SIZE >= KIA_HISTORY_MAX * 2, "Hash must stay at most half full");
+
+// Extra "Name: <uint32>" fields the decoders write after Key, stored by index.
+// Journals on SD keep these indices: only ever append.
+static const char* const history_extra_keys[] = {
+    "Serial",
+    "Btn",
+    "Cnt",
+    "CRC",
+    "BS",
+    "Type",
+    "Check",
+    "DataHi",
+    "DataLo",
+    "RawCnt",
+    "Encrypted",
+    "Decrypted",
+    "Version",
+    "TE",
+};
+
+// Every decoder in the registry starts with these, so a repeat can be matched
+// on the decoded data without serializing it
+typedef struct {
+    SubGhzProtocolDecoderBase base;
+    SubGhzBlockDecoder decoder;
+    SubGhzBlockGeneric generic;
+} ProtoPirateHistoryDecoderHead;
+
+// What makes two decodes the same capture
 typedef struct {
-    FuriString* item_str;
-    FlipperFormat* flipper_format;
-    uint8_t type;
-    SubGhzRadioPreset* preset;
-} ProtoPirateHistoryItem;
+    uint64_t data;
+    uint8_t protocol;
+    uint8_t bits;
+    uint8_t hash; // Decoder's own hash, covers state outside generic.data
+} ProtoPirateHistoryIdentity;
 
-ARRAY_DEF(ProtoPirateHistoryItemArray, ProtoPirateHistoryItem, M_POD_OPLIST)
+// One capture. Everything the decoder serialized, without the text around it.
+typedef struct {
+    uint64_t key;
+    uint64_t ident_data;
+    uint32_t frequency;
+    uint32_t timestamp;
+    uint32_t first_seen; // Ticks
+    uint32_t last_seen;
+    uint32_t extra[HISTORY_EXTRA_MAX];
+    uint16_t repeats;
+    uint8_t extra_key[HISTORY_EXTRA_MAX];
+    uint8_t extra_count;
+    uint8_t protocol;
+    uint8_t bits;
+    uint8_t ident_bits;
+    uint8_t ident_hash;
+    uint8_t preset;
+    uint8_t key_format;
+    int8_t rssi;
+} ProtoPirateHistoryRecord;
 
 struct ProtoPirateHistory {
-    ProtoPirateHistoryItemArray_t data;
+    ProtoPirateHistoryRecord* records;
+    uint16_t head; // Oldest record
+    uint16_t count;
     uint16_t last_index;
-    uint32_t last_update_timestamp;
-    uint8_t code_last_hash_data;
+
+    // Ring slot + 1 of every record, indexed by its identity
+    uint16_t* table;
+
+    // Preset names are shared by most captures, so records only keep an index. A name
+    // keeps its slot until reset and is only read under the lock.
+    FuriString* presets[HISTORY_PRESET_MAX];
+    uint8_t preset_count;
+    // Per ring slot, allocated once a capture brings a name when every shared slot is taken
+    FuriString** preset_inline;
+
+    SubGhzEnvironment* environment;
+    FlipperFormat* scratch; // Serialize target while packing a new record
+    FuriString* line;
+    FuriMutex* mutex;
 };
 
-ProtoPirateHistory* protopirate_history_alloc(void) {
+ProtoPirateHistory* protopirate_history_alloc(SubGhzEnvironment* environment) {
     ProtoPirateHistory* instance = malloc(sizeof(ProtoPirateHistory));
-    ProtoPirateHistoryItemArray_init(instance->data);
-    instance->last_index = 0;
+    memset(instance, 0, sizeof(ProtoPirateHistory));
+    instance->records = malloc(sizeof(ProtoPirateHistoryRecord) * KIA_HISTORY_MAX);
+    instance->table = malloc(sizeof(uint16_t) * HISTORY_HASH_SIZE);
+    memset(instance->table, 0, sizeof(uint16_t) * HISTORY_HASH_SIZE);
+    instance->environment = environment;
+    instance->scratch = flipper_format_string_alloc();
+    instance->line = furi_string_alloc();
+    instance->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     return instance;
 }
 
-void protopirate_history_free(ProtoPirateHistory* instance) {
-    furi_assert(instance);
-    for(size_t i = 0; i < ProtoPirateHistoryItemArray_size(instance->data); i++) {
-        ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, i);
-        furi_string_free(item->item_str);
-        flipper_format_free(item->flipper_format);
-        if(item->preset) {
-            if(item->preset->name) {
-                furi_string_free(item->preset->name);
-            }
-            free(item->preset);
+static void protopirate_history_clear_presets(ProtoPirateHistory* instance) {
+    for(uint8_t i = 0; i < instance->preset_count; i++) {
+        furi_string_free(instance->presets[i]);
+    }
+    instance->preset_count = 0;
+
+    if(instance->preset_inline) {
+        for(uint16_t i = 0; i < KIA_HISTORY_MAX; i++) {
+            if(instance->preset_inline[i]) furi_string_free(instance->preset_inline[i]);
         }
+        free(instance->preset_inline);
+        instance->preset_inline = NULL;
     }
-    ProtoPirateHistoryItemArray_clear(instance->data);
+}
+
+void protopirate_history_free(ProtoPirateHistory* instance) {
+    furi_assert(instance);
+    protopirate_history_clear_presets(instance);
+    flipper_format_free(instance->scratch);
+    furi_string_free(instance->line);
+    furi_mutex_free(instance->mutex);
+    free(instance->records);
+    free(instance->table);
     free(instance);
 }
 
 void protopirate_history_reset(ProtoPirateHistory* instance) {
     furi_assert(instance);
-    for(size_t i = 0; i < ProtoPirateHistoryItemArray_size(instance->data); i++) {
-        ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, i);
-        furi_string_free(item->item_str);
-        flipper_format_free(item->flipper_format);
-        if(item->preset) {
-            if(item->preset->name) {
-                furi_string_free(item->preset->name);
-            }
-            free(item->preset);
-        }
-    }
-    ProtoPirateHistoryItemArray_reset(instance->data);
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    instance->head = 0;
+    instance->count = 0;
     instance->last_index = 0;
+    memset(instance->table, 0, sizeof(uint16_t) * HISTORY_HASH_SIZE);
+    protopirate_history_clear_presets(instance);
+    furi_mutex_release(instance->mutex);
 }
 
 uint16_t protopirate_history_get_item(ProtoPirateHistory* instance) {
     furi_assert(instance);
-    return ProtoPirateHistoryItemArray_size(instance->data);
+    return instance->count;
 }
 
 uint16_t protopirate_history_get_last_index(ProtoPirateHistory* instance) {
@@ -72,110 +164,406 @@ uint16_t protopirate_history_get_last_index(ProtoPirateHistory* instance) {
     return instance->last_index;
 }
 
-// Helper function to free a single history item's resources
-static void protopirate_history_item_free(ProtoPirateHistoryItem* item) {
-    if(item->item_str) {
-        furi_string_free(item->item_str);
-        item->item_str = NULL;
+int32_t protopirate_history_find_id(ProtoPirateHistory* instance, uint16_t id) {
+    furi_assert(instance);
+    int32_t idx = -1;
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    uint16_t age = instance->last_index - id;
+    if(age < instance->count) {
+        idx = instance->count - 1 - age;
     }
-    if(item->flipper_format) {
-        flipper_format_free(item->flipper_format);
-        item->flipper_format = NULL;
+    furi_mutex_release(instance->mutex);
+    return idx;
+}
+
+// False once every slot holds another name: renaming one would relabel older records.
+// The record then keeps the name inline instead.
+static bool protopirate_history_intern_preset(
+    ProtoPirateHistory* instance,
+    const char* name,
+    uint8_t* index) {
+    for(uint8_t i = 0; i < instance->preset_count; i++) {
+        if(furi_string_equal(instance->presets[i], name)) {
+            *index = i;
+            return true;
+        }
     }
-    if(item->preset) {
-        if(item->preset->name) {
-            furi_string_free(item->preset->name);
+
+    if(instance->preset_count == HISTORY_PRESET_MAX) return false;
+
+    instance->presets[instance->preset_count] = furi_string_alloc_set_str(name);
+    *index = instance->preset_count++;
+    return true;
+}
+
+static bool protopirate_history_parse_key(const char* value, ProtoPirateHistoryRecord* record) {
+    uint64_t key = 0;
+    uint8_t digits = 0;
+    bool spaced = false;
+
+    for(const char* p = value; *p && *p != '\r' && *p != '\n'; p++) {
+        char c = *p;
+        uint8_t nibble;
+        if(c >= '0' && c <= '9') {
+            nibble = c - '0';
+        } else if(c >= 'A' && c <= 'F') {
+            nibble = c - 'A' + 10;
+        } else if(c >= 'a' && c <= 'f') {
+            nibble = c - 'a' + 10;
+        } else if(c == ' ') {
+            spaced = true;
+            continue;
+        } else {
+            return false;
         }
-        free(item->preset);
-        item->preset = NULL;
+        if(digits == 16) return false;
+        key = (key << 4) | nibble;
+        digits++;
+    }
+
+    if(digits == 0) return false;
+    record->key = key;
+    if(spaced) {
+        record->key_format = digits / 2;
+    } else {
+        record->key_format = HISTORY_KEY_COMPACT | digits;
     }
+    return true;
 }
 
-bool protopirate_history_add_to_history(
+// Value up to the line end, the line buffer is reused so it cannot be kept
+static void protopirate_history_copy_value(const char* value, char* out, size_t out_size) {
+    size_t len = strcspn(value, "\r\n");
+    if(len >= out_size) len = out_size - 1;
+    memcpy(out, value, len);
+    out[len] = '\0';
+}
+
+// Turns the decoder's serialized lines into a record, false if something would be lost.
+// A preset that could not be shared is left in preset for the record's slot.
+static bool protopirate_history_pack(
     ProtoPirateHistory* instance,
-    void* context,
-    SubGhzRadioPreset* preset,
-    FuriString* history_item_str) {
-    furi_assert(instance);
-    furi_assert(context);
+    ProtoPirateHistoryRecord* record,
+    char* preset,
+    size_t preset_size) {
+    Stream* stream = flipper_format_get_raw_stream(instance->scratch);
+    FuriString* line = instance->line;
+    bool has_protocol = false;
+    bool has_key = false;
+    char name[32];
+
+    stream_rewind(stream);
+    while(stream_read_line(stream, line)) {
+        const char* text = furi_string_get_cstr(line);
+        const char* colon = strchr(text, ':');
+        if(!colon) continue;
+
+        size_t key_len = colon - text;
+        const char* value = colon + 1;
+        while(*value == ' ')
+            value++;
+
+        if(key_len == 9 && strncmp(text, "Frequency", key_len) == 0) {
+            record->frequency = strtoul(value, NULL, 10);
+        } else if(key_len == 6 && strncmp(text, "Preset", key_len) == 0) {
+            protopirate_history_copy_value(value, name, sizeof(name));
+            if(!protopirate_history_intern_preset(instance, name, &record->preset)) {
+                record->preset = HISTORY_PRESET_INLINE;
+                snprintf(preset, preset_size, "%s", name);
+            }
+        } else if(key_len == 8 && strncmp(text, "Protocol", key_len) == 0) {
+            protopirate_history_copy_value(value, name, sizeof(name));
+            int32_t index = protopirate_protocol_find(name);
+            if(index < 0) return false;
+            record->protocol = index;
+            has_protocol = true;
+        } else if(key_len == 3 && strncmp(text, "Bit", key_len) == 0) {
+            record->bits = strtoul(value, NULL, 10);
+        } else if(key_len == 3 && strncmp(text, "Key", key_len) == 0) {
+            has_key = protopirate_history_parse_key(value, record);
+        } else {
+            size_t extra = 0;
+            while(extra < COUNT_OF(history_extra_keys) &&
+                  !(strlen(history_extra_keys[extra]) == key_len &&
+                    strncmp(text, history_extra_keys[extra], key_len) == 0)) {
+                extra++;
+            }
+            if(extra == COUNT_OF(history_extra_keys) ||
+               record->extra_count == HISTORY_EXTRA_MAX) {
+                FURI_LOG_W(TAG, "Field %.*s not kept", (int)key_len, text);
+                return false;
+            }
+            record->extra_key[record->extra_count] = extra;
+            record->extra[record->extra_count] = strtoul(value, NULL, 10);
+            record->extra_count++;
+        }
+    }
 
-    SubGhzProtocolDecoderBase* decoder_base = context;
+    return has_protocol && has_key;
+}
+
+// Call with the lock held, reset frees the preset names
+static void protopirate_history_record_to_capture(
+    ProtoPirateHistory* instance,
+    uint16_t slot,
+    const ProtoPirateHistoryRecord* record,
+    ProtoPirateCapture* capture) {
+    memset(capture, 0, sizeof(ProtoPirateCapture));
+    capture->key = record->key;
+    capture->frequency = record->frequency;
+    capture->timestamp = record->timestamp;
+    memcpy(capture->extra, record->extra, sizeof(capture->extra));
+    memcpy(capture->extra_key, record->extra_key, sizeof(capture->extra_key));
+    capture->extra_count = record->extra_count;
+    capture->protocol = record->protocol;
+    capture->bits = record->bits;
+    capture->key_format = record->key_format;
+    FuriString* preset = (record->preset == HISTORY_PRESET_INLINE) ?
+                             instance->preset_inline[slot] :
+                             instance->presets[record->preset];
+    snprintf(capture->preset, sizeof(capture->preset), "%s", furi_string_get_cstr(preset));
+}
+
+// Gives the record in slot its own preset name, or drops the one it had when name is NULL
+static void protopirate_history_set_inline_preset(
+    ProtoPirateHistory* instance,
+    uint16_t slot,
+    const char* name) {
+    if(!instance->preset_inline) {
+        if(!name) return;
+        instance->preset_inline = malloc(sizeof(FuriString*) * KIA_HISTORY_MAX);
+        memset(instance->preset_inline, 0, sizeof(FuriString*) * KIA_HISTORY_MAX);
+    }
+
+    FuriString** inline_name = &instance->preset_inline[slot];
+    if(!name) {
+        if(*inline_name) furi_string_free(*inline_name);
+        *inline_name = NULL;
+    } else if(*inline_name) {
+        furi_string_set_str(*inline_name, name);
+    } else {
+        *inline_name = furi_string_alloc_set_str(name);
+    }
+}
 
-    // Check for duplicate (same hash within 500ms)
-    if((instance->code_last_hash_data ==
-        subghz_protocol_decoder_base_get_hash_data(decoder_base)) &&
-       ((furi_get_tick() - instance->last_update_timestamp) < 500)) {
-        instance->last_update_timestamp = furi_get_tick();
+// Writes the capture back in the order and format the decoder serialized it
+bool protopirate_history_write_capture(const ProtoPirateCapture* capture, FlipperFormat* output) {
+    furi_assert(capture);
+    furi_assert(output);
+
+    const ProtoPirateProtocolInfo* info = protopirate_protocol_get_info(capture->protocol);
+    uint8_t key_len = capture->key_format & HISTORY_KEY_LEN_MASK;
+    if(!info || key_len == 0 || key_len > 16 || capture->extra_count > HISTORY_EXTRA_MAX) {
         return false;
     }
+    for(uint8_t i = 0; i < capture->extra_count; i++) {
+        if(capture->extra_key[i] >= COUNT_OF(history_extra_keys)) return false;
+    }
+
+    uint32_t value;
+    flipper_format_write_uint32(output, "Frequency", &capture->frequency, 1);
+    flipper_format_write_string_cstr(output, "Preset", capture->preset);
+    flipper_format_write_string_cstr(output, "Protocol", info->protocol->name);
+    value = capture->bits;
+    flipper_format_write_uint32(output, "Bit", &value, 1);
+
+    if(capture->key_format & HISTORY_KEY_COMPACT) {
+        char key_str[20];
+        snprintf(key_str, sizeof(key_str), "%0*llX", key_len, capture->key);
+        flipper_format_write_string_cstr(output, "Key", key_str);
+    } else {
+        uint8_t key_data[sizeof(uint64_t)];
+        key_len = MIN(key_len, sizeof(key_data));
+        for(uint8_t i = 0; i < key_len; i++) {
+            key_data[key_len - i - 1] = (capture->key >> (i * 8)) & 0xFF;
+        }
+        flipper_format_write_hex(output, "Key", key_data, key_len);
+    }
+
+    for(uint8_t i = 0; i < capture->extra_count; i++) {
+        flipper_format_write_uint32(
+            output, history_extra_keys[capture->extra_key[i]], &capture->extra[i], 1);
+    }
+    return true;
+}
+
+static uint32_t protopirate_history_hash(const ProtoPirateHistoryIdentity* ident) {
+    uint64_t h = ident->data ^ ((uint64_t)ident->protocol << 56) ^ ((uint64_t)ident->bits << 48) ^
+                 ((uint64_t)ident->hash << 40);
+    // 64-bit finalizer from MurmurHash3, so neighbouring keys spread over the table
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return (uint32_t)h;
+}
+
+static void protopirate_history_record_identity(
+    const ProtoPirateHistoryRecord* record,
+    ProtoPirateHistoryIdentity* ident) {
+    ident->data = record->ident_data;
+    ident->protocol = record->protocol;
+    ident->bits = record->ident_bits;
+    ident->hash = record->ident_hash;
+}
 
-    FuriString* reuse_item_str = NULL;
-    SubGhzRadioPreset* reuse_preset = NULL;
+static bool protopirate_history_identity_match(
+    const ProtoPirateHistoryRecord* record,
+    const ProtoPirateHistoryIdentity* ident) {
+    return record->ident_data == ident->data && record->protocol == ident->protocol &&
+           record->ident_bits == ident->bits && record->ident_hash == ident->hash;
+}
+
+// Returns the ring slot holding this identity, or -1
+static int32_t protopirate_history_table_find(
+    ProtoPirateHistory* instance,
+    const ProtoPirateHistoryIdentity* ident) {
+    uint32_t pos = protopirate_history_hash(ident) & HISTORY_HASH_MASK;
+    while(instance->table[pos] != HISTORY_HASH_EMPTY) {
+        uint16_t slot = instance->table[pos] - 1;
+        if(protopirate_history_identity_match(&instance->records[slot], ident)) return slot;
+        pos = (pos + 1) & HISTORY_HASH_MASK;
+    }
+    return -1;
+}
 
-    // If history is full, remove the oldest entry
-    if(ProtoPirateHistoryItemArray_size(instance->data) >= KIA_HISTORY_MAX) {
-        ProtoPirateHistoryItem* oldest = ProtoPirateHistoryItemArray_get(instance->data, 0);
-        if(oldest) {
-            // Reuse resources to reduce heap churn
-            reuse_item_str = oldest->item_str;
-            oldest->item_str = NULL;
+static void protopirate_history_table_insert(ProtoPirateHistory* instance, uint16_t slot) {
+    ProtoPirateHistoryIdentity ident;
+    protopirate_history_record_identity(&instance->records[slot], &ident);
+    uint32_t pos = protopirate_history_hash(&ident) & HISTORY_HASH_MASK;
+    while(instance->table[pos] != HISTORY_HASH_EMPTY) {
+        pos = (pos + 1) & HISTORY_HASH_MASK;
+    }
+    instance->table[pos] = slot + 1;
+}
 
-            reuse_preset = oldest->preset;
-            oldest->preset = NULL;
+// Drops a slot before it is overwritten. Later entries of the probe run move back
+// into the gap, so lookups never need tombstones.
+static void protopirate_history_table_remove(ProtoPirateHistory* instance, uint16_t slot) {
+    ProtoPirateHistoryIdentity ident;
+    protopirate_history_record_identity(&instance->records[slot], &ident);
+    uint32_t gap = protopirate_history_hash(&ident) & HISTORY_HASH_MASK;
+    while(instance->table[gap] != slot + 1) {
+        if(instance->table[gap] == HISTORY_HASH_EMPTY) return;
+        gap = (gap + 1) & HISTORY_HASH_MASK;
+    }
 
-            protopirate_history_item_free(oldest);
+    for(uint32_t pos = (gap + 1) & HISTORY_HASH_MASK; instance->table[pos] != HISTORY_HASH_EMPTY;
+        pos = (pos + 1) & HISTORY_HASH_MASK) {
+        protopirate_history_record_identity(&instance->records[instance->table[pos] - 1], &ident);
+        uint32_t home = protopirate_history_hash(&ident) & HISTORY_HASH_MASK;
+        // Move it only if its home is not between the gap and where it sits now
+        if(((pos - home) & HISTORY_HASH_MASK) >= ((pos - gap) & HISTORY_HASH_MASK)) {
+            instance->table[gap] = instance->table[pos];
+            gap = pos;
         }
-        ProtoPirateHistoryItemArray_pop_at(NULL, instance->data, 0);
     }
+    instance->table[gap] = HISTORY_HASH_EMPTY;
+}
 
-    instance->code_last_hash_data = subghz_protocol_decoder_base_get_hash_data(decoder_base);
-    instance->last_update_timestamp = furi_get_tick();
+// Copies record idx (0 = oldest) out under the lock, the ring may move on meanwhile.
+// capture, if not NULL, gets the record as a capture with its preset name.
+static bool protopirate_history_get_record(
+    ProtoPirateHistory* instance,
+    uint16_t idx,
+    ProtoPirateHistoryRecord* record,
+    ProtoPirateCapture* capture) {
+    bool result = false;
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    if(idx < instance->count) {
+        uint16_t slot = (instance->head + idx) % KIA_HISTORY_MAX;
+        *record = instance->records[slot];
+        if(capture) protopirate_history_record_to_capture(instance, slot, record, capture);
+        result = true;
+    }
+    furi_mutex_release(instance->mutex);
+    return result;
+}
 
-    // Create a new history item
-    ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_push_raw(instance->data);
+bool protopirate_history_add_to_history(
+    ProtoPirateHistory* instance,
+    void* context,
+    SubGhzRadioPreset* preset,
+    float rssi) {
+    furi_assert(instance);
+    furi_assert(context);
 
-    if(reuse_item_str) {
-        item->item_str = reuse_item_str;
-        furi_string_reset(item->item_str);
-    } else {
-        item->item_str = furi_string_alloc();
+    SubGhzProtocolDecoderBase* decoder_base = context;
+    const ProtoPirateHistoryDecoderHead* head = context;
+    int32_t protocol = protopirate_protocol_index(decoder_base->protocol);
+    if(protocol < 0) return false;
+
+    ProtoPirateHistoryIdentity ident = {
+        .data = head->generic.data,
+        .protocol = protocol,
+        .bits = head->generic.data_count_bit,
+        .hash = subghz_protocol_decoder_base_get_hash_data(decoder_base),
+    };
+    uint32_t now = furi_get_tick();
+
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+
+    // A repeat of anything still in history only bumps its counter
+    int32_t existing = protopirate_history_table_find(instance, &ident);
+    if(existing >= 0) {
+        ProtoPirateHistoryRecord* record = &instance->records[existing];
+        if(record->repeats < UINT16_MAX) record->repeats++;
+        record->last_seen = now;
+        furi_mutex_release(instance->mutex);
+        return false;
     }
 
-    item->flipper_format = flipper_format_string_alloc();
-    item->type = 0;
+    ProtoPirateHistoryRecord record = {0};
+    char preset_name[PROTOPIRATE_CAPTURE_PRESET_SIZE];
+    bool packed = false;
 
-    // Copy preset
-    if(reuse_preset) {
-        item->preset = reuse_preset;
-    } else {
-        item->preset = malloc(sizeof(SubGhzRadioPreset));
-        item->preset->name = furi_string_alloc();
+    stream_clean(flipper_format_get_raw_stream(instance->scratch));
+    if(subghz_protocol_decoder_base_serialize(decoder_base, instance->scratch, preset) ==
+       SubGhzProtocolStatusOk) {
+        packed = protopirate_history_pack(instance, &record, preset_name, sizeof(preset_name));
     }
 
-    item->preset->frequency = preset->frequency;
-    furi_string_set(item->preset->name, preset->name);
-    item->preset->data = preset->data;
-    item->preset->data_size = preset->data_size;
+    if(packed) {
+        record.ident_data = ident.data;
+        record.ident_bits = ident.bits;
+        record.ident_hash = ident.hash;
+        record.timestamp = furi_hal_rtc_get_timestamp();
+        record.first_seen = now;
+        record.last_seen = now;
+        record.repeats = 1;
+        record.rssi = (int8_t)CLAMP(rssi, 0.0f, -128.0f);
+
+        // Full ring: the new record takes the oldest slot, nothing moves
+        uint16_t slot;
+        if(instance->count < KIA_HISTORY_MAX) {
+            slot = (instance->head + instance->count) % KIA_HISTORY_MAX;
+            instance->count++;
+        } else {
+            slot = instance->head;
+            instance->head = (instance->head + 1) % KIA_HISTORY_MAX;
+            protopirate_history_table_remove(instance, slot);
+        }
+        instance->records[slot] = record;
+        protopirate_history_set_inline_preset(
+            instance, slot, (record.preset == HISTORY_PRESET_INLINE) ? preset_name : NULL);
+        protopirate_history_table_insert(instance, slot);
 
-    // Get string representation
-    // Optimization: Write directly to item->item_str to avoid temporary allocation and copy
-    furi_string_reset(item->item_str);
-    if(history_item_str) {
-        furi_string_set(item->item_str, history_item_str);
-    } else {
-        subghz_protocol_decoder_base_get_string(decoder_base, item->item_str);
+        instance->last_index++;
     }
 
-    // Serialize to flipper format
-    subghz_protocol_decoder_base_serialize(decoder_base, item->flipper_format, preset);
+    furi_mutex_release(instance->mutex);
 
-    instance->last_index++;
+    if(!packed) {
+        FURI_LOG_E(TAG, "Could not store %s capture", decoder_base->protocol->name);
+        return false;
+    }
 
-    FURI_LOG_I(
-        TAG,
-        "Added item %u to history (size: %zu)",
+    protopirate_trace(
+        ProtoPirateTraceHistoryAdd,
+        decoder_base->protocol->name,
         instance->last_index,
-        ProtoPirateHistoryItemArray_size(instance->data));
+        instance->count);
 
     return true;
 }
@@ -187,27 +575,17 @@ void protopirate_history_get_text_item_menu(
     furi_assert(instance);
     furi_assert(output);
 
-    if(idx >= ProtoPirateHistoryItemArray_size(instance->data)) {
+    ProtoPirateHistoryRecord record;
+    if(!protopirate_history_get_record(instance, idx, &record, NULL)) {
         furi_string_set(output, "---");
         return;
     }
 
-    ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, idx);
-
-    // Get just the first line for the menu
-    const char* str = furi_string_get_cstr(item->item_str);
-    const char* newline = strchr(str, '\r');
-    if(newline) {
-        size_t len = newline - str;
-        furi_string_set_strn(output, str, len);
-    } else {
-        newline = strchr(str, '\n');
-        if(newline) {
-            size_t len = newline - str;
-            furi_string_set_strn(output, str, len);
-        } else {
-            furi_string_set(output, item->item_str);
-        }
+    // Same as the first line of every decoder's get_string, without building it
+    const ProtoPirateProtocolInfo* info = protopirate_protocol_get_info(record.protocol);
+    furi_string_printf(output, "%s %dbit", info->protocol->name, record.bits);
+    if(record.repeats > 1) {
+        furi_string_cat_printf(output, " x%u", record.repeats);
     }
 }
 
@@ -218,13 +596,30 @@ void protopirate_history_get_text_item(
     furi_assert(instance);
     furi_assert(output);
 
-    if(idx >= ProtoPirateHistoryItemArray_size(instance->data)) {
+    ProtoPirateHistoryRecord record;
+    ProtoPirateCapture capture;
+    if(!protopirate_history_get_record(instance, idx, &record, &capture)) {
         furi_string_set(output, "---");
         return;
     }
 
-    ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, idx);
-    furi_string_set(output, item->item_str);
+    // Rebuild through the decoder so the text is exactly what it printed on receive
+    const SubGhzProtocol* protocol = protopirate_protocol_get_info(record.protocol)->protocol;
+    FlipperFormat* flipper_format = flipper_format_string_alloc();
+    void* decoder = protocol->decoder->alloc(instance->environment);
+
+    protopirate_history_write_capture(&capture, flipper_format);
+    flipper_format_rewind(flipper_format);
+
+    furi_string_reset(output);
+    if(protocol->decoder->deserialize(decoder, flipper_format) == SubGhzProtocolStatusOk) {
+        protocol->decoder->get_string(decoder, output);
+    } else {
+        furi_string_set(output, "Decode failed");
+    }
+
+    (protocol->decoder->free)(decoder);
+    flipper_format_free(flipper_format);
 }
 
 SubGhzProtocolDecoderBase*
@@ -234,13 +629,31 @@ SubGhzProtocolDecoderBase*
     return NULL;
 }
 
-FlipperFormat* protopirate_history_get_raw_data(ProtoPirateHistory* instance, uint16_t idx) {
+bool protopirate_history_get_capture(
+    ProtoPirateHistory* instance,
+    uint16_t idx,
+    ProtoPirateCapture* capture) {
     furi_assert(instance);
+    furi_assert(capture);
 
-    if(idx >= ProtoPirateHistoryItemArray_size(instance->data)) {
-        return NULL;
+    ProtoPirateHistoryRecord record;
+    return protopirate_history_get_record(instance, idx, &record, capture);
+}
+
+bool protopirate_history_get_raw_data(
+    ProtoPirateHistory* instance,
+    uint16_t idx,
+    FlipperFormat* output) {
+    furi_assert(instance);
+    furi_assert(output);
+
+    ProtoPirateHistoryRecord record;
+    ProtoPirateCapture capture;
+    if(!protopirate_history_get_record(instance, idx, &record, &capture)) {
+        return false;
     }
 
-    ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, idx);
-    return item->flipper_format;
+    protopirate_history_write_capture(&capture, output);
+    flipper_format_rewind(output);
+    return true;
 }
@@ -1,23 +1,49 @@
 // protopirate_history.h
 #pragma once
 
-#include <lib/subghz/receiver.h>
+#include <lib/subghz/types.h>
 #include <lib/subghz/protocols/base.h>
 
-#define KIA_HISTORY_MAX 50
+// Captures are fixed-size records in a ring, 72 bytes each plus a 2 KB repeat index. 320 of
+// them take ~25 KB, what the old list of 50 string-backed items used.
+#define KIA_HISTORY_MAX 320
+
+#define PROTOPIRATE_CAPTURE_EXTRA_MAX   6
+#define PROTOPIRATE_CAPTURE_PRESET_SIZE 24
 
 typedef struct ProtoPirateHistory ProtoPirateHistory;
 
-ProtoPirateHistory* protopirate_history_alloc(void);
+// A capture as the decoder serialized it, without the text around the values. This is
+// also the auto-save journal's on-SD layout, so fields and extra_key meanings only grow.
+typedef struct {
+    uint64_t key;
+    uint32_t frequency;
+    uint32_t timestamp; // RTC seconds
+    uint32_t extra[PROTOPIRATE_CAPTURE_EXTRA_MAX];
+    uint8_t extra_key[PROTOPIRATE_CAPTURE_EXTRA_MAX];
+    uint8_t extra_count;
+    uint8_t protocol; // Registry index
+    uint8_t bits;
+    uint8_t key_format;
+    char preset[PROTOPIRATE_CAPTURE_PRESET_SIZE];
+} ProtoPirateCapture;
+
+// The environment is used to allocate a decoder when an item's text is rebuilt
+ProtoPirateHistory* protopirate_history_alloc(SubGhzEnvironment* environment);
 void protopirate_history_free(ProtoPirateHistory* instance);
 void protopirate_history_reset(ProtoPirateHistory* instance);
 uint16_t protopirate_history_get_item(ProtoPirateHistory* instance);
 uint16_t protopirate_history_get_last_index(ProtoPirateHistory* instance);
+
+// Current index of the item that was added when get_last_index returned id,
+// -1 once the ring has dropped it
+int32_t protopirate_history_find_id(ProtoPirateHistory* instance, uint16_t id);
+// False for a capture already in history (its repeat count goes up instead) or on error
 bool protopirate_history_add_to_history(
     ProtoPirateHistory* instance,
     void* context,
     SubGhzRadioPreset* preset,
-    FuriString* history_item_str);
+    float rssi);
 void protopirate_history_get_text_item_menu(
     ProtoPirateHistory* instance,
     FuriString* output,
@@ -28,4 +54,19 @@ void protopirate_history_get_text_item(
     uint16_t idx);
 SubGhzProtocolDecoderBase*
     protopirate_history_get_decoder_base(ProtoPirateHistory* instance, uint16_t idx);
-FlipperFormat* protopirate_history_get_raw_data(ProtoPirateHistory* instance, uint16_t idx);
+
+// Rebuilds the item's saved form into output (appended, caller owns it)
+bool protopirate_history_get_raw_data(
+    ProtoPirateHistory* instance,
+    uint16_t idx,
+    FlipperFormat* output);
+
+// Copies item idx out as a capture
+bool protopirate_history_get_capture(
+    ProtoPirateHistory* instance,
+    uint16_t idx,
+    ProtoPirateCapture* capture);
+
+// Writes a capture's fields (everything a Key File has after its header) to output.
+// Returns false if the capture refers to an unknown protocol or field.
+bool protopirate_history_write_capture(const ProtoPirateCapture* capture, FlipperFormat* output);
@@ -1,6 +1,7 @@
 // scenes/protopirate_scene_config.h
 ADD_SCENE(protopirate, start, Start)
 ADD_SCENE(protopirate, sub_decode, SubDecode)
+ADD_SCENE(protopirate, sub_decode_batch, SubDecodeBatch)
 ADD_SCENE(protopirate, about, About)
 ADD_SCENE(protopirate, receiver, Receiver)
 ADD_SCENE(protopirate, receiver_config, ReceiverConfig)
@@ -9,3 +10,4 @@ ADD_SCENE(protopirate, saved, Saved)
 ADD_SCENE(protopirate, saved_info, SavedInfo)
 ADD_SCENE(protopirate, emulate, Emulate)
 ADD_SCENE(protopirate, timing_tuner, TimingTuner)
+ADD_SCENE(protopirate, stats, Stats)
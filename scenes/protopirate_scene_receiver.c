@@ -1,10 +1,11 @@
 // scenes/protopirate_scene_receiver.c
 #include "../protopirate_app_i.h"
 #include "../helpers/protopirate_storage.h"
+#include "../protocols/protocol_items.h"
+#include "../protocols/protocol_trace.h"
 #include <notification/notification_messages.h>
 
-#define TAG                     "ProtoPirateSceneRx"
-#define KIA_DISPLAY_HISTORY_MAX 50
+#define TAG "ProtoPirateSceneRx"
 
 // Forward declaration
 void protopirate_scene_receiver_view_callback(ProtoPirateCustomEvent event, void* context);
@@ -26,13 +27,13 @@ static void protopirate_scene_receiver_update_statusbar(void* context) {
             history_stat_str,
             "A%u/%u",
             protopirate_history_get_item(app->txrx->history),
-            KIA_DISPLAY_HISTORY_MAX);
+            KIA_HISTORY_MAX);
     } else {
         furi_string_printf(
             history_stat_str,
             "%u/%u",
             protopirate_history_get_item(app->txrx->history),
-            KIA_DISPLAY_HISTORY_MAX);
+            KIA_HISTORY_MAX);
     }
 
     // Pass actual external radio status
@@ -48,6 +49,14 @@ static void protopirate_scene_receiver_update_statusbar(void* context) {
     furi_string_free(history_stat_str);
 }
 
+static void
+    protopirate_scene_receiver_item_callback(void* context, uint16_t idx, FuriString* out) {
+    ProtoPirateApp* app = context;
+    protopirate_history_get_text_item_menu(app->txrx->history, out, idx);
+}
+
+// Runs on the decode thread between pulses: keep a snapshot of the capture in history
+// and leave everything slow (notifications, SD, logging, redraws) to the GUI thread
 static void protopirate_scene_receiver_callback(
     SubGhzReceiver* receiver,
     SubGhzProtocolDecoderBase* decoder_base,
@@ -56,73 +65,89 @@ static void protopirate_scene_receiver_callback(
     furi_assert(context);
     ProtoPirateApp* app = context;
 
-    FURI_LOG_I(TAG, "=== SIGNAL DECODED ===");
-
-    FuriString* str_buff = furi_string_alloc();
-    subghz_protocol_decoder_base_get_string(decoder_base, str_buff);
-    FURI_LOG_I(TAG, "%s", furi_string_get_cstr(str_buff));
-
-    // Add to history
     if(protopirate_history_add_to_history(
-           app->txrx->history, decoder_base, app->txrx->preset, str_buff)) {
-        notification_message(app->notifications, &sequence_semi_success);
+           app->txrx->history,
+           decoder_base,
+           app->txrx->preset,
+           subghz_devices_get_rssi(app->txrx->radio_device))) {
+        ProtoPirateDecodeEvent event = {
+            .history_id = protopirate_history_get_last_index(app->txrx->history),
+            .protocol = protopirate_protocol_index(decoder_base->protocol),
+        };
+        bool was_empty = false;
+        if(protopirate_decode_queue_push(app->txrx->decode_queue, &event, &was_empty) &&
+           was_empty) {
+            view_dispatcher_send_custom_event(
+                app->view_dispatcher, ProtoPirateCustomEventSceneReceiverDecoded);
+        }
+    }
+
+    // Pause hopper when we receive something
+    if(app->txrx->hopper_state == ProtoPirateHopperStateRunning) {
+        app->txrx->hopper_state = ProtoPirateHopperStatePause;
+        app->txrx->hopper_timeout = 10;
+    }
+}
 
-        FURI_LOG_I(
-            TAG,
-            "Added to history, total items: %u",
-            protopirate_history_get_item(app->txrx->history));
+// Appends to the session journal, which is opened on the first capture it gets
+static void protopirate_scene_receiver_auto_save(ProtoPirateApp* app, uint16_t idx) {
+    ProtoPirateCapture capture;
+    if(!protopirate_history_get_capture(app->txrx->history, idx, &capture)) return;
 
-        FuriString* item_name = furi_string_alloc();
-        protopirate_history_get_text_item_menu(
-            app->txrx->history, item_name, protopirate_history_get_item(app->txrx->history) - 1);
+    if(!app->journal) {
+        app->journal = protopirate_journal_open();
+    }
+    protopirate_journal_append(app->journal, &capture);
+}
 
-        protopirate_view_receiver_add_item_to_menu(
-            app->protopirate_receiver, furi_string_get_cstr(item_name), 0);
+// Writes the near misses captured since the last call, each one to its own RAW file
+static void protopirate_scene_receiver_save_near_misses(ProtoPirateApp* app) {
+    if(!app->near_miss) return;
 
-        furi_string_free(item_name);
+    const ProtoPirateNearMissSnippet* snippet;
+    while((snippet = protopirate_near_miss_take(app->near_miss)) != NULL) {
+        protopirate_storage_save_near_miss(snippet, app->txrx->preset, &app->near_miss_index);
+        protopirate_near_miss_release(app->near_miss, snippet);
+    }
+}
 
-        // Auto-save if enabled
+// Handles whatever the decode callback queued since the last call
+static void protopirate_scene_receiver_process_decodes(ProtoPirateApp* app) {
+    ProtoPirateDecodeEvent event;
+    bool added = false;
+
+    while(protopirate_decode_queue_pop(app->txrx->decode_queue, &event)) {
+        int32_t idx = protopirate_history_find_id(app->txrx->history, event.history_id);
+        const ProtoPirateProtocolInfo* info = protopirate_protocol_get_info(event.protocol);
+        protopirate_trace(
+            ProtoPirateTraceDecoded,
+            info ? info->protocol->name : NULL,
+            event.history_id,
+            idx >= 0);
+        if(idx < 0) continue;
+
+        if(!added) {
+            notification_message(app->notifications, &sequence_semi_success);
+            added = true;
+        }
         if(app->auto_save) {
-            FlipperFormat* ff = protopirate_history_get_raw_data(
-                app->txrx->history, protopirate_history_get_item(app->txrx->history) - 1);
-
-            if(ff) {
-                FuriString* protocol = furi_string_alloc();
-                flipper_format_rewind(ff);
-                if(!flipper_format_read_string(ff, "Protocol", protocol)) {
-                    furi_string_set_str(protocol, "Unknown");
-                }
-
-                // Clean protocol name for filename
-                furi_string_replace_all(protocol, "/", "_");
-                furi_string_replace_all(protocol, " ", "_");
-
-                FuriString* saved_path = furi_string_alloc();
-                if(protopirate_storage_save_capture(
-                       ff, furi_string_get_cstr(protocol), saved_path)) {
-                    FURI_LOG_I(TAG, "Auto-saved: %s", furi_string_get_cstr(saved_path));
-                    notification_message(app->notifications, &sequence_double_vibro);
-                } else {
-                    FURI_LOG_E(TAG, "Auto-save failed");
-                }
-
-                furi_string_free(protocol);
-                furi_string_free(saved_path);
-            }
+            protopirate_scene_receiver_auto_save(app, idx);
         }
+    }
 
-        view_dispatcher_send_custom_event(
-            app->view_dispatcher, ProtoPirateCustomEventSceneReceiverUpdate);
-    } else {
-        FURI_LOG_W(TAG, "Failed to add to history (duplicate or full)");
+    if(added && app->auto_save) {
+        notification_message(app->notifications, &sequence_double_vibro);
     }
 
-    furi_string_free(str_buff);
+    uint32_t dropped = protopirate_decode_queue_take_dropped(app->txrx->decode_queue);
+    if(dropped) {
+        FURI_LOG_W(TAG, "%lu decodes not processed, queue full", dropped);
+    }
 
-    // Pause hopper when we receive something
-    if(app->txrx->hopper_state == ProtoPirateHopperStateRunning) {
-        app->txrx->hopper_state = ProtoPirateHopperStatePause;
-        app->txrx->hopper_timeout = 10;
+    if(added) {
+        protopirate_view_receiver_set_item_count(
+            app->protopirate_receiver, protopirate_history_get_item(app->txrx->history));
+        protopirate_scene_receiver_update_statusbar(app);
     }
 }
 
@@ -147,6 +172,12 @@ void protopirate_scene_receiver_on_enter(void* context) {
     protopirate_view_receiver_set_callback(
         app->protopirate_receiver, protopirate_scene_receiver_view_callback, app);
 
+    // Menu rows are built from history on demand
+    protopirate_view_receiver_set_item_callback(
+        app->protopirate_receiver, protopirate_scene_receiver_item_callback, app);
+    protopirate_view_receiver_set_item_count(
+        app->protopirate_receiver, protopirate_history_get_item(app->txrx->history));
+
     // Update status bar
     protopirate_scene_receiver_update_statusbar(app);
 
@@ -164,6 +195,14 @@ void protopirate_scene_receiver_on_enter(void* context) {
         preset_data = subghz_setting_get_preset_data_by_name(app->setting, "AM650");
     }
 
+    // Capture frames the decoders drop while this session receives
+    if(app->near_miss_capture) {
+        if(!app->near_miss) {
+            app->near_miss = protopirate_near_miss_alloc();
+        }
+        protopirate_dispatch_set_near_miss(app->txrx->dispatch, app->near_miss);
+    }
+
     // Begin receiving
     protopirate_begin(app, preset_data);
 
@@ -192,6 +231,11 @@ bool protopirate_scene_receiver_on_event(void* context, SceneManagerEvent event)
             consumed = true;
             break;
 
+        case ProtoPirateCustomEventSceneReceiverDecoded:
+            protopirate_scene_receiver_process_decodes(app);
+            consumed = true;
+            break;
+
         case ProtoPirateCustomEventViewReceiverOK: {
             uint16_t idx = protopirate_view_receiver_get_idx_menu(app->protopirate_receiver);
             FURI_LOG_I(TAG, "Selected item %d", idx);
@@ -213,7 +257,23 @@ bool protopirate_scene_receiver_on_event(void* context, SceneManagerEvent event)
                 protopirate_rx_end(app);
             }
             protopirate_sleep(app);
+            protopirate_scene_receiver_process_decodes(app);
+            if(app->journal) {
+                protopirate_journal_close(app->journal);
+                app->journal = NULL;
+            }
+            if(app->near_miss) {
+                protopirate_dispatch_set_near_miss(app->txrx->dispatch, NULL);
+                protopirate_scene_receiver_save_near_misses(app);
+
+                uint32_t captured, dropped;
+                protopirate_near_miss_get_counts(app->near_miss, &captured, &dropped);
+                FURI_LOG_I(TAG, "Near misses: %lu captured, %lu dropped", captured, dropped);
+                protopirate_near_miss_free(app->near_miss);
+                app->near_miss = NULL;
+            }
             protopirate_history_reset(app->txrx->history);
+            protopirate_decode_queue_reset(app->txrx->decode_queue);
             scene_manager_search_and_switch_to_previous_scene(
                 app->scene_manager, ProtoPirateSceneStart);
             consumed = true;
@@ -224,6 +284,13 @@ bool protopirate_scene_receiver_on_event(void* context, SceneManagerEvent event)
             break;
         }
     } else if(event.type == SceneManagerEventTypeTick) {
+        // Catches anything queued while the previous batch was being drained
+        protopirate_scene_receiver_process_decodes(app);
+        if(app->journal) {
+            protopirate_journal_tick(app->journal);
+        }
+        protopirate_scene_receiver_save_near_misses(app);
+
         // Update hopper
         if(app->txrx->hopper_state != ProtoPirateHopperStateOFF) {
             protopirate_hopper_update(app);
@@ -258,6 +325,11 @@ void protopirate_scene_receiver_on_exit(void* context) {
     if(app->txrx->txrx_state == ProtoPirateTxRxStateRx) {
         protopirate_rx_end(app);
     }
+
+    // Decoding has stopped, finish what it queued (auto-save) before leaving
+    protopirate_dispatch_set_near_miss(app->txrx->dispatch, NULL);
+    protopirate_scene_receiver_process_decodes(app);
+    protopirate_scene_receiver_save_near_misses(app);
 }
 
 void protopirate_scene_receiver_view_callback(ProtoPirateCustomEvent event, void* context) {
@@ -6,6 +6,7 @@ enum ProtoPirateSettingIndex {
     ProtoPirateSettingIndexHopping,
     ProtoPirateSettingIndexModulation,
     ProtoPirateSettingIndexAutoSave,
+    ProtoPirateSettingIndexNearMiss,
     ProtoPirateSettingIndexLock,
 };
 
@@ -25,6 +26,12 @@ const char* const auto_save_text[AUTO_SAVE_COUNT] = {
     "ON",
 };
 
+#define NEAR_MISS_COUNT 2
+const char* const near_miss_text[NEAR_MISS_COUNT] = {
+    "OFF",
+    "ON",
+};
+
 uint8_t protopirate_scene_receiver_config_next_frequency(const uint32_t value, void* context) {
     furi_assert(context);
     ProtoPirateApp* app = context;
@@ -150,6 +157,14 @@ static void protopirate_scene_receiver_config_set_auto_save(VariableItem* item)
     variable_item_set_current_value_text(item, auto_save_text[index]);
 }
 
+static void protopirate_scene_receiver_config_set_near_miss(VariableItem* item) {
+    ProtoPirateApp* app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    app->near_miss_capture = (index == 1);
+    variable_item_set_current_value_text(item, near_miss_text[index]);
+}
+
 static void
     protopirate_scene_receiver_config_var_list_enter_callback(void* context, uint32_t index) {
     furi_assert(context);
@@ -218,6 +233,16 @@ void protopirate_scene_receiver_config_on_enter(void* context) {
     variable_item_set_current_value_index(item, app->auto_save ? 1 : 0);
     variable_item_set_current_value_text(item, auto_save_text[app->auto_save ? 1 : 0]);
 
+    // Near-miss capture, writes frames the decoders gave up on as RAW files
+    item = variable_item_list_add(
+        app->variable_item_list,
+        "Near-Miss:",
+        NEAR_MISS_COUNT,
+        protopirate_scene_receiver_config_set_near_miss,
+        app);
+    variable_item_set_current_value_index(item, app->near_miss_capture ? 1 : 0);
+    variable_item_set_current_value_text(item, near_miss_text[app->near_miss_capture ? 1 : 0]);
+
     variable_item_list_add(app->variable_item_list, "Lock Keyboard", 1, NULL, NULL);
     variable_item_list_set_enter_callback(
         app->variable_item_list, protopirate_scene_receiver_config_var_list_enter_callback, app);
@@ -4,9 +4,14 @@
 
 #define TAG "ProtoPirateSceneSaved"
 
-typedef enum {
-    SubmenuIndexBack = 0xFF,
-} SavedMenuIndex;
+// Captures shown per submenu page, the manifest is read one page at a time
+#define SAVED_PAGE_SIZE 50
+
+// Menu events above any capture index
+#define SAVED_EVENT_BACK   UINT32_MAX
+#define SAVED_EVENT_NEWER  (UINT32_MAX - 1)
+#define SAVED_EVENT_OLDER  (UINT32_MAX - 2)
+#define SAVED_EVENT_EXPORT (UINT32_MAX - 3)
 
 static void protopirate_scene_saved_submenu_callback(void* context, uint32_t index) {
     ProtoPirateApp* app = context;
@@ -24,31 +29,68 @@ void protopirate_scene_saved_on_enter(void* context) {
     uint32_t file_count = protopirate_storage_get_file_count();
     FURI_LOG_I(TAG, "File count: %lu", file_count);
 
-    if(file_count == 0) {
+    // Scene state holds the first index of the page, clamped in case files were deleted
+    uint32_t page_start = scene_manager_get_scene_state(app->scene_manager, ProtoPirateSceneSaved);
+    if(page_start >= file_count) {
+        page_start = file_count ? ((file_count - 1) / SAVED_PAGE_SIZE) * SAVED_PAGE_SIZE : 0;
+        scene_manager_set_scene_state(app->scene_manager, ProtoPirateSceneSaved, page_start);
+    }
+
+    // Auto-saved sessions become captures only once exported
+    uint32_t journal_count = protopirate_journal_count_files();
+    if(journal_count > 0) {
+        char label[32];
+        snprintf(label, sizeof(label), "Export journals (%lu)", journal_count);
+        submenu_add_item(
+            app->submenu,
+            label,
+            SAVED_EVENT_EXPORT,
+            protopirate_scene_saved_submenu_callback,
+            app);
+    }
+
+    if(file_count == 0 && journal_count == 0) {
         submenu_add_item(
             app->submenu,
             "No saved captures",
-            SubmenuIndexBack,
+            SAVED_EVENT_BACK,
             protopirate_scene_saved_submenu_callback,
             app);
-    } else {
-        FuriString* name = furi_string_alloc();
-        FuriString* path = furi_string_alloc();
-
-        for(uint32_t i = 0; i < file_count && i < 50; i++) {
-            if(protopirate_storage_get_file_by_index(i, path, name)) {
-                FURI_LOG_D(TAG, "Adding menu item: %s", furi_string_get_cstr(name));
-                submenu_add_item(
-                    app->submenu,
-                    furi_string_get_cstr(name),
-                    i,
-                    protopirate_scene_saved_submenu_callback,
-                    app);
-            }
+    } else if(file_count > 0) {
+        ProtoPirateCaptureRecord* records =
+            malloc(sizeof(ProtoPirateCaptureRecord) * SAVED_PAGE_SIZE);
+        size_t page_count =
+            protopirate_storage_get_file_page(page_start, records, SAVED_PAGE_SIZE);
+
+        if(page_start > 0) {
+            submenu_add_item(
+                app->submenu,
+                "<< Newer",
+                SAVED_EVENT_NEWER,
+                protopirate_scene_saved_submenu_callback,
+                app);
+        }
+
+        for(size_t i = 0; i < page_count; i++) {
+            FURI_LOG_D(TAG, "Adding menu item: %s", records[i].name);
+            submenu_add_item(
+                app->submenu,
+                records[i].name,
+                page_start + i,
+                protopirate_scene_saved_submenu_callback,
+                app);
+        }
+
+        if(page_start + page_count < file_count) {
+            submenu_add_item(
+                app->submenu,
+                "Older >>",
+                SAVED_EVENT_OLDER,
+                protopirate_scene_saved_submenu_callback,
+                app);
         }
 
-        furi_string_free(name);
-        furi_string_free(path);
+        free(records);
     }
 
     view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewSubmenu);
@@ -59,9 +101,31 @@ bool protopirate_scene_saved_on_event(void* context, SceneManagerEvent event) {
     bool consumed = false;
 
     if(event.type == SceneManagerEventTypeCustom) {
-        if(event.event == SubmenuIndexBack) {
+        uint32_t page_start =
+            scene_manager_get_scene_state(app->scene_manager, ProtoPirateSceneSaved);
+
+        if(event.event == SAVED_EVENT_BACK) {
             // Just go back
             consumed = true;
+        } else if(event.event == SAVED_EVENT_EXPORT) {
+            uint32_t exported = protopirate_journal_export_all();
+            FURI_LOG_I(TAG, "Exported %lu captures from journals", exported);
+            notification_message(
+                app->notifications, exported ? &sequence_success : &sequence_error);
+
+            // New captures are the newest, show them
+            scene_manager_set_scene_state(app->scene_manager, ProtoPirateSceneSaved, 0);
+            protopirate_scene_saved_on_enter(app);
+            consumed = true;
+        } else if(event.event == SAVED_EVENT_NEWER || event.event == SAVED_EVENT_OLDER) {
+            if(event.event == SAVED_EVENT_NEWER) {
+                page_start = (page_start > SAVED_PAGE_SIZE) ? page_start - SAVED_PAGE_SIZE : 0;
+            } else {
+                page_start += SAVED_PAGE_SIZE;
+            }
+            scene_manager_set_scene_state(app->scene_manager, ProtoPirateSceneSaved, page_start);
+            protopirate_scene_saved_on_enter(app);
+            consumed = true;
         } else {
             // Load and display the selected file
             FuriString* path = furi_string_alloc();
@@ -6,7 +6,10 @@ typedef enum {
     SubmenuIndexProtoPirateSaved,
     SubmenuIndexProtoPirateReceiverConfig,
     SubmenuIndexProtoPirateSubDecode,
+    SubmenuIndexProtoPirateSubDecodeBatch,
     SubmenuIndexProtoPirateTimingTuner,
+    SubmenuIndexProtoPirateTimingFile,
+    SubmenuIndexProtoPirateStats,
     SubmenuIndexProtoPirateAbout,
 } SubmenuIndex;
 
@@ -48,6 +51,13 @@ void protopirate_scene_start_on_enter(void* context) {
         protopirate_scene_start_submenu_callback,
         app);
 
+    submenu_add_item(
+        app->submenu,
+        "Sub Decode Folder",
+        SubmenuIndexProtoPirateSubDecodeBatch,
+        protopirate_scene_start_submenu_callback,
+        app);
+
     submenu_add_item(
         app->submenu,
         "Timing Tuner",
@@ -55,6 +65,20 @@ void protopirate_scene_start_on_enter(void* context) {
         protopirate_scene_start_submenu_callback,
         app);
 
+    submenu_add_item(
+        app->submenu,
+        "Timing From File",
+        SubmenuIndexProtoPirateTimingFile,
+        protopirate_scene_start_submenu_callback,
+        app);
+
+    submenu_add_item(
+        app->submenu,
+        "Decoder Stats",
+        SubmenuIndexProtoPirateStats,
+        protopirate_scene_start_submenu_callback,
+        app);
+
     submenu_add_item(
         app->submenu,
         "About",
@@ -81,6 +105,8 @@ bool protopirate_scene_start_on_event(void* context, SceneManagerEvent event) {
             scene_manager_next_scene(app->scene_manager, ProtoPirateSceneReceiver);
             consumed = true;
         } else if(event.event == SubmenuIndexProtoPirateSaved) {
+            // Open on the newest page
+            scene_manager_set_scene_state(app->scene_manager, ProtoPirateSceneSaved, 0);
             scene_manager_next_scene(app->scene_manager, ProtoPirateSceneSaved);
             consumed = true;
         } else if(event.event == SubmenuIndexProtoPirateReceiverConfig) {
@@ -89,9 +115,22 @@ bool protopirate_scene_start_on_event(void* context, SceneManagerEvent event) {
         } else if(event.event == SubmenuIndexProtoPirateSubDecode) {
             scene_manager_next_scene(app->scene_manager, ProtoPirateSceneSubDecode);
             consumed = true;
+        } else if(event.event == SubmenuIndexProtoPirateSubDecodeBatch) {
+            scene_manager_next_scene(app->scene_manager, ProtoPirateSceneSubDecodeBatch);
+            consumed = true;
         } else if(event.event == SubmenuIndexProtoPirateTimingTuner) {
+            scene_manager_set_scene_state(
+                app->scene_manager, ProtoPirateSceneTimingTuner, ProtoPirateTimingTunerModeRadio);
+            scene_manager_next_scene(app->scene_manager, ProtoPirateSceneTimingTuner);
+            consumed = true;
+        } else if(event.event == SubmenuIndexProtoPirateTimingFile) {
+            scene_manager_set_scene_state(
+                app->scene_manager, ProtoPirateSceneTimingTuner, ProtoPirateTimingTunerModeFile);
             scene_manager_next_scene(app->scene_manager, ProtoPirateSceneTimingTuner);
             consumed = true;
+        } else if(event.event == SubmenuIndexProtoPirateStats) {
+            scene_manager_next_scene(app->scene_manager, ProtoPirateSceneStats);
+            consumed = true;
         }
         scene_manager_set_scene_state(app->scene_manager, ProtoPirateSceneStart, event.event);
     }
@@ -0,0 +1,156 @@
+// scenes/protopirate_scene_stats.c
+#include "../protopirate_app_i.h"
+#include "../helpers/protopirate_storage.h"
+#include "../protocols/protocol_items.h"
+#include "../protocols/protocol_trace.h"
+
+#define TAG "ProtoPirateSceneStats"
+
+#define STATS_FILE PROTOPIRATE_APP_FOLDER "/decoder_stats.csv"
+#define TRACE_FILE PROTOPIRATE_APP_FOLDER "/trace.csv"
+
+static void protopirate_scene_stats_widget_callback(
+    GuiButtonType result,
+    InputType type,
+    void* context) {
+    ProtoPirateApp* app = context;
+    if(type == InputTypeShort) {
+        if(result == GuiButtonTypeLeft) {
+            view_dispatcher_send_custom_event(
+                app->view_dispatcher, ProtoPirateCustomEventStatsReset);
+        } else if(result == GuiButtonTypeRight) {
+            view_dispatcher_send_custom_event(
+                app->view_dispatcher, ProtoPirateCustomEventStatsSave);
+        }
+    }
+}
+
+// Decoders that never left their reset step are left out, everything else gets two lines
+static void protopirate_scene_stats_text(ProtoPirateApp* app, FuriString* text) {
+#ifdef PROTOPIRATE_DISPATCH_PROFILE
+    uint32_t per_us = furi_hal_cortex_instructions_per_microsecond();
+#endif
+
+    ProtoPiratePulseRingStats ring;
+    protopirate_pulse_ring_get_stats(app->txrx->pulse_ring, &ring);
+    furi_string_printf(
+        text,
+        "Pulses %lu, lost %lu\nPeak queue %lu/%lu\n",
+        ring.pulses,
+        ring.dropped,
+        ring.high_water,
+        ring.depth);
+
+    for(size_t i = 0; i < protopirate_protocol_count(); i++) {
+        const SubGhzProtocol* protocol = protopirate_protocol_get_info(i)->protocol;
+        const ProtoPirateProtocolStats* stats = protopirate_protocol_stats_get(protocol);
+        if(stats->resets == 0 && stats->preamble_locks == 0 && stats->decodes == 0) continue;
+
+        furi_string_cat_printf(text, "%s: %lu ok", protocol->name, stats->decodes);
+#ifdef PROTOPIRATE_DISPATCH_PROFILE
+        furi_string_cat_printf(text, ", %lu ms", (uint32_t)(stats->cycles / per_us / 1000));
+#endif
+        furi_string_cat_printf(
+            text,
+            "\n Lck %lu Rst %lu Bad %lu\n",
+            stats->preamble_locks,
+            stats->resets,
+            stats->check_failures);
+    }
+}
+
+static bool protopirate_scene_stats_write(Storage* storage, const char* path, FuriString* text) {
+    File* file = storage_file_alloc(storage);
+    size_t size = furi_string_size(text);
+    bool result = false;
+
+    if(storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        result = storage_file_write(file, furi_string_get_cstr(text), size) == size;
+        storage_file_close(file);
+    }
+    if(!result) {
+        FURI_LOG_E(TAG, "Failed to write %s", path);
+    }
+
+    storage_file_free(file);
+    return result;
+}
+
+// The counters, then the trace ring in its own file
+static bool protopirate_scene_stats_save(ProtoPirateApp* app) {
+    FuriString* text = furi_string_alloc();
+    protopirate_protocol_stats_format(text);
+
+    ProtoPiratePulseRingStats ring;
+    protopirate_pulse_ring_get_stats(app->txrx->pulse_ring, &ring);
+    furi_string_cat_printf(
+        text,
+        "\nRing, Pulses, Dropped, Overruns, Worker overruns, Peak, Depth\n"
+        "Ring, %lu, %lu, %lu, %lu, %lu, %lu\n",
+        ring.pulses,
+        ring.dropped,
+        ring.overruns,
+        ring.worker_overruns,
+        ring.high_water,
+        ring.depth);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, PROTOPIRATE_APP_FOLDER);
+    bool result = protopirate_scene_stats_write(storage, STATS_FILE, text);
+
+    furi_string_reset(text);
+    protopirate_trace_format(text);
+    result &= protopirate_scene_stats_write(storage, TRACE_FILE, text);
+
+    furi_record_close(RECORD_STORAGE);
+    furi_string_free(text);
+    return result;
+}
+
+void protopirate_scene_stats_on_enter(void* context) {
+    ProtoPirateApp* app = context;
+
+    widget_reset(app->widget);
+
+    FuriString* text = furi_string_alloc();
+    protopirate_scene_stats_text(app, text);
+    widget_add_text_scroll_element(app->widget, 0, 0, 128, 50, furi_string_get_cstr(text));
+    furi_string_free(text);
+
+    widget_add_button_element(
+        app->widget, GuiButtonTypeLeft, "Reset", protopirate_scene_stats_widget_callback, app);
+    widget_add_button_element(
+        app->widget, GuiButtonTypeRight, "Save", protopirate_scene_stats_widget_callback, app);
+
+    view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewWidget);
+}
+
+bool protopirate_scene_stats_on_event(void* context, SceneManagerEvent event) {
+    ProtoPirateApp* app = context;
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeCustom) {
+        if(event.event == ProtoPirateCustomEventStatsReset) {
+            protopirate_protocol_stats_reset();
+            protopirate_pulse_ring_reset_stats(app->txrx->pulse_ring);
+            protopirate_trace_reset();
+            protopirate_scene_stats_on_enter(app);
+            consumed = true;
+        } else if(event.event == ProtoPirateCustomEventStatsSave) {
+            if(protopirate_scene_stats_save(app)) {
+                FURI_LOG_I(TAG, "Saved %s and %s", STATS_FILE, TRACE_FILE);
+                notification_message(app->notifications, &sequence_success);
+            } else {
+                notification_message(app->notifications, &sequence_error);
+            }
+            consumed = true;
+        }
+    }
+
+    return consumed;
+}
+
+void protopirate_scene_stats_on_exit(void* context) {
+    ProtoPirateApp* app = context;
+    widget_reset(app->widget);
+}
@@ -1,16 +1,18 @@
 // scenes/protopirate_scene_sub_decode.c
 #include "../protopirate_app_i.h"
 #include "../protocols/protocol_items.h"
+#include "../protocols/protocol_trace.h"
 #include "../helpers/protopirate_storage.h"
+#include "../helpers/protopirate_raw_reader.h"
 #include <dialogs/dialogs.h>
-#include <ctype.h>
 #include <math.h>
 
 #define TAG "ProtoPirateSubDecode"
 
 #define SUBGHZ_APP_FOLDER     EXT_PATH("subghz")
-#define SAMPLES_PER_TICK      256
-#define MAX_RAW_SAMPLES       8192
+#define RAW_CHUNK_SAMPLES     256
+#define DECODE_WORKER_STACK   (3 * 1024)
+#define DECODE_QUEUE_SIZE     8
 #define SUCCESS_DISPLAY_TICKS 18
 #define FAILURE_DISPLAY_TICKS 18
 
@@ -19,7 +21,6 @@ typedef enum {
     DecodeStateIdle,
     DecodeStateOpenFile,
     DecodeStateReadHeader,
-    DecodeStateLoadRawSamples,
     DecodeStateDecodingRaw,
     DecodeStateDecodingProtocol,
     DecodeStateShowSuccess,
@@ -27,8 +28,32 @@ typedef enum {
     DecodeStateDone,
 } DecodeState;
 
-// Context for the whole decode operation
+typedef struct SubDecodeContext SubDecodeContext;
+
+// Messages posted by the decode worker to the scene
+typedef enum {
+    DecodeWorkerEventProgress,
+    DecodeWorkerEventDone,
+} DecodeWorkerEventType;
+
 typedef struct {
+    DecodeWorkerEventType type;
+    uint8_t progress;
+    const char* match_name;
+} DecodeWorkerEvent;
+
+// One registry decoder fed in the single RAW pass
+typedef struct {
+    SubDecodeContext* ctx;
+    const SubGhzProtocol* protocol;
+    void* decoder;
+    uint32_t match_count;
+    FuriString* decoded_string;
+    FlipperFormat* save_data;
+} SubDecodeSlot;
+
+// Context for the whole decode operation
+struct SubDecodeContext {
     DecodeState state;
     uint16_t animation_frame;
     uint8_t result_display_counter;
@@ -44,23 +69,28 @@ typedef struct {
     Storage* storage;
     FlipperFormat* ff;
 
-    // RAW decode state
-    int32_t* raw_samples;
+    // RAW decode state, owned by the worker thread while it runs
+    ProtoPirateRawReader raw_reader;
+    int32_t raw_chunk[RAW_CHUNK_SAMPLES];
     size_t total_samples;
-    size_t current_sample;
-    size_t current_protocol_idx;
-    void* current_decoder;
-    const SubGhzProtocol* current_protocol;
+    SubDecodeSlot* slots;
+    size_t slot_count;
+    ProtoPirateDispatch* dispatch;
+    size_t matched_protocols;
+    const char* last_match_name;
     bool decode_success;
 
-    // Callback context
-    bool callback_fired;
-    FuriString* decoded_string;
+    // Decode worker and the progress snapshot the draw callback reads
+    FuriThread* worker;
+    FuriMessageQueue* worker_queue;
+    volatile bool worker_cancel;
+    uint8_t raw_progress;
+    const char* progress_match_name;
 
     // For saving - keep a copy of the flipper format data
     FlipperFormat* save_data;
     bool can_save;
-} SubDecodeContext;
+};
 
 static SubDecodeContext* g_decode_ctx = NULL;
 
@@ -72,98 +102,48 @@ static void protopirate_scene_sub_decode_widget_callback(
 
 // Callback when decoder successfully decodes
 static void protopirate_decode_callback(SubGhzProtocolDecoderBase* decoder_base, void* context) {
-    SubDecodeContext* ctx = context;
-    ctx->callback_fired = true;
-
-    if(ctx->current_protocol && ctx->current_protocol->decoder &&
-       ctx->current_protocol->decoder->get_string) {
-        ctx->current_protocol->decoder->get_string(decoder_base, ctx->decoded_string);
-    }
-
-    FURI_LOG_I(TAG, "Decode callback fired for %s!", ctx->current_protocol->name);
-}
+    SubDecodeSlot* slot = context;
+    SubDecodeContext* ctx = slot->ctx;
+    const SubGhzProtocolDecoder* decoder = slot->protocol->decoder;
 
-// Case-insensitive string search
-static bool str_contains_ci(const char* haystack, const char* needle) {
-    if(!haystack || !needle) return false;
+    slot->match_count++;
+    ctx->last_match_name = slot->protocol->name;
 
-    size_t haystack_len = strlen(haystack);
-    size_t needle_len = strlen(needle);
+    // Repeats of the same protocol only bump the counter, the first frame is what we show
+    if(slot->match_count > 1) return;
 
-    if(needle_len > haystack_len) return false;
+    ctx->matched_protocols++;
+    protopirate_trace(ProtoPirateTraceMatch, slot->protocol->name, slot->match_count, 0);
 
-    for(size_t i = 0; i <= haystack_len - needle_len; i++) {
-        bool match = true;
-        for(size_t j = 0; j < needle_len; j++) {
-            if(tolower((unsigned char)haystack[i + j]) != tolower((unsigned char)needle[j])) {
-                match = false;
-                break;
-            }
-        }
-        if(match) return true;
-    }
-    return false;
-}
-
-// Check if protocol names match
-static bool protocol_names_match(const char* file_proto, const char* registry_proto) {
-    if(!file_proto || !registry_proto) return false;
-
-    if(strcasecmp(file_proto, registry_proto) == 0) return true;
-    if(str_contains_ci(file_proto, registry_proto)) return true;
-
-    const char* file_version = NULL;
-    const char* reg_version = NULL;
-
-    for(const char* p = file_proto; *p; p++) {
-        if((*p == 'V' || *p == 'v') && isdigit((unsigned char)*(p + 1))) {
-            file_version = p;
-            break;
-        }
-    }
-
-    for(const char* p = registry_proto; *p; p++) {
-        if((*p == 'V' || *p == 'v') && isdigit((unsigned char)*(p + 1))) {
-            reg_version = p;
-            break;
-        }
+    slot->decoded_string = furi_string_alloc();
+    if(decoder->get_string) {
+        decoder->get_string(decoder_base, slot->decoded_string);
     }
 
-    if(file_version && reg_version) {
-        size_t file_ver_len = 0;
-        size_t reg_ver_len = 0;
-
-        for(const char* p = file_version; *p && (isalnum((unsigned char)*p) || *p == '/'); p++) {
-            file_ver_len++;
-        }
-        for(const char* p = reg_version; *p && (isalnum((unsigned char)*p) || *p == '/'); p++) {
-            reg_ver_len++;
+    // Serialize now, the decoder state is overwritten by the next frame
+    if(decoder->serialize) {
+        SubGhzRadioPreset temp_preset;
+        temp_preset.frequency = ctx->frequency;
+        temp_preset.name = furi_string_alloc_set("AM650");
+        temp_preset.data = NULL;
+        temp_preset.data_size = 0;
+
+        slot->save_data = flipper_format_string_alloc();
+        SubGhzProtocolStatus status =
+            decoder->serialize(decoder_base, slot->save_data, &temp_preset);
+
+        if(status != SubGhzProtocolStatusOk) {
+            FURI_LOG_W(TAG, "RAW serialize failed: %d", status);
+            flipper_format_free(slot->save_data);
+            slot->save_data = NULL;
+        } else {
+            protopirate_trace(ProtoPirateTraceSerialized, slot->protocol->name, 0, 0);
         }
 
-        if(file_ver_len == reg_ver_len &&
-           strncasecmp(file_version, reg_version, file_ver_len) == 0) {
-            if((str_contains_ci(file_proto, "KIA") || str_contains_ci(file_proto, "HYU")) &&
-               str_contains_ci(registry_proto, "Kia")) {
-                return true;
-            }
-            if(str_contains_ci(file_proto, "Ford") && str_contains_ci(registry_proto, "Ford")) {
-                return true;
-            }
-            if(str_contains_ci(file_proto, "Subaru") &&
-               str_contains_ci(registry_proto, "Subaru")) {
-                return true;
-            }
-            if(str_contains_ci(file_proto, "Suzuki") &&
-               str_contains_ci(registry_proto, "Suzuki")) {
-                return true;
-            }
-            if(str_contains_ci(file_proto, "VW") && str_contains_ci(registry_proto, "VW")) {
-                return true;
-            }
-        }
+        furi_string_free(temp_preset.name);
+    } else {
+        FURI_LOG_W(TAG, "Protocol %s has no serialize function", slot->protocol->name);
     }
-
-    return false;
 }
 
 // Get human readable error string from status
@@ -362,12 +342,8 @@ static void protopirate_decode_draw_callback(Canvas* canvas, void* context) {
 
     // Calculate progress
     int progress = 0;
-    if(ctx->state == DecodeStateLoadRawSamples && ctx->total_samples > 0) {
-        progress = 10 + (ctx->total_samples * 20) / MAX_RAW_SAMPLES;
-    } else if(ctx->state == DecodeStateDecodingRaw && ctx->total_samples > 0) {
-        int sample_pct = (ctx->current_sample * 100) / ctx->total_samples;
-        int proto_pct = (ctx->current_protocol_idx * 100) / protopirate_protocol_registry.size;
-        progress = 30 + (sample_pct * 35 + proto_pct * 35) / 100;
+    if(ctx->state == DecodeStateDecodingRaw) {
+        progress = 10 + (ctx->raw_progress * 90) / 100;
     } else if(ctx->state == DecodeStateOpenFile || ctx->state == DecodeStateReadHeader) {
         progress = 5 + (frame % 10);
     } else if(ctx->state == DecodeStateDecodingProtocol) {
@@ -396,11 +372,8 @@ static void protopirate_decode_draw_callback(Canvas* canvas, void* context) {
     case DecodeStateReadHeader:
         status_text = "Reading header...";
         break;
-    case DecodeStateLoadRawSamples:
-        status_text = "Loading samples...";
-        break;
     case DecodeStateDecodingRaw:
-        status_text = ctx->current_protocol ? ctx->current_protocol->name : "Analyzing...";
+        status_text = ctx->progress_match_name ? ctx->progress_match_name : "Analyzing...";
         break;
     case DecodeStateDecodingProtocol:
         status_text = "Parsing protocol...";
@@ -437,10 +410,8 @@ static bool protopirate_decode_input_callback(InputEvent* event, void* context)
     if(event->type == InputTypeShort && event->key == InputKeyBack) {
         if(g_decode_ctx && g_decode_ctx->state != DecodeStateIdle &&
            g_decode_ctx->state != DecodeStateDone) {
-            furi_string_set(g_decode_ctx->error_info, "Cancelled");
-            g_decode_ctx->state = DecodeStateShowFailure;
-            g_decode_ctx->result_display_counter = 0;
-            furi_string_set(g_decode_ctx->result, "Cancelled by user");
+            // The worker may still be writing the result, the tick handler shows the cancel
+            g_decode_ctx->worker_cancel = true;
         }
         return true;
     }
@@ -448,115 +419,185 @@ static bool protopirate_decode_input_callback(InputEvent* event, void* context)
     return false;
 }
 
-// Process one chunk of RAW samples
-static bool protopirate_process_raw_chunk(ProtoPirateApp* app, SubDecodeContext* ctx) {
-    if(!ctx->current_decoder) {
-        while(ctx->current_protocol_idx < protopirate_protocol_registry.size) {
-            const SubGhzProtocol* protocol =
-                protopirate_protocol_registry.items[ctx->current_protocol_idx];
-
-            if(protocol->decoder && protocol->decoder->alloc) {
-                ctx->current_decoder = protocol->decoder->alloc(app->txrx->environment);
-                ctx->current_protocol = protocol;
-                ctx->current_sample = 0;
-                ctx->callback_fired = false;
-                furi_string_reset(ctx->decoded_string);
-
-                if(ctx->current_decoder) {
-                    SubGhzProtocolDecoderBase* decoder_base = ctx->current_decoder;
-                    decoder_base->callback = protopirate_decode_callback;
-                    decoder_base->context = ctx;
-
-                    if(protocol->decoder->reset) {
-                        protocol->decoder->reset(ctx->current_decoder);
-                    }
+// Allocate every registry decoder once for the single RAW pass
+static bool protopirate_alloc_decoders(ProtoPirateApp* app, SubDecodeContext* ctx) {
+    ctx->slots = malloc(sizeof(SubDecodeSlot) * protopirate_protocol_registry.size);
+    memset(ctx->slots, 0, sizeof(SubDecodeSlot) * protopirate_protocol_registry.size);
+    ctx->slot_count = 0;
+    ctx->dispatch = protopirate_dispatch_alloc();
 
-                    FURI_LOG_D(TAG, "Trying protocol: %s", protocol->name);
-                    break;
-                }
-            }
-            ctx->current_protocol_idx++;
-        }
+    for(size_t i = 0; i < protopirate_protocol_registry.size; i++) {
+        const SubGhzProtocol* protocol = protopirate_protocol_registry.items[i];
+        if(!protocol->decoder || !protocol->decoder->alloc || !protocol->decoder->feed) continue;
 
-        if(!ctx->current_decoder) {
-            return true;
+        void* decoder = protocol->decoder->alloc(app->txrx->environment);
+        if(!decoder) continue;
+
+        SubDecodeSlot* slot = &ctx->slots[ctx->slot_count++];
+        slot->ctx = ctx;
+        slot->protocol = protocol;
+        slot->decoder = decoder;
+
+        SubGhzProtocolDecoderBase* decoder_base = decoder;
+        decoder_base->callback = protopirate_decode_callback;
+        decoder_base->context = slot;
+
+        if(protocol->decoder->reset) {
+            protocol->decoder->reset(decoder);
         }
+        protopirate_dispatch_add(ctx->dispatch, protocol, decoder);
+    }
+
+    FURI_LOG_D(TAG, "Allocated %zu decoders", ctx->slot_count);
+    return ctx->slot_count > 0;
+}
+
+static void protopirate_free_decoders(SubDecodeContext* ctx) {
+    if(!ctx->slots) return;
+
+    for(size_t i = 0; i < ctx->slot_count; i++) {
+        SubDecodeSlot* slot = &ctx->slots[i];
+        slot->protocol->decoder->free(slot->decoder);
+        if(slot->decoded_string) furi_string_free(slot->decoded_string);
+        if(slot->save_data) flipper_format_free(slot->save_data);
     }
 
-    size_t end_sample = ctx->current_sample + SAMPLES_PER_TICK;
-    if(end_sample > ctx->total_samples) {
-        end_sample = ctx->total_samples;
+    free(ctx->slots);
+    ctx->slots = NULL;
+    ctx->slot_count = 0;
+    protopirate_dispatch_free(ctx->dispatch);
+    ctx->dispatch = NULL;
+}
+
+// Build the result text from every protocol that matched
+static void protopirate_build_raw_result(SubDecodeContext* ctx) {
+    furi_string_printf(
+        ctx->result,
+        "RAW Decoded!\nFreq: %lu.%02lu MHz\nMatches: %zu\n",
+        ctx->frequency / 1000000,
+        (ctx->frequency % 1000000) / 10000,
+        ctx->matched_protocols);
+
+    for(size_t i = 0; i < ctx->slot_count; i++) {
+        SubDecodeSlot* slot = &ctx->slots[i];
+        if(!slot->match_count) continue;
+
+        furi_string_cat_printf(
+            ctx->result, "\n%s x%lu\n", slot->protocol->name, slot->match_count);
+        furi_string_cat(ctx->result, slot->decoded_string);
+
+        // The first protocol with a serialized frame is the one offered for saving
+        if(!ctx->save_data && slot->save_data) {
+            ctx->save_data = slot->save_data;
+            slot->save_data = NULL;
+        }
     }
 
-    for(size_t i = ctx->current_sample; i < end_sample && !ctx->callback_fired; i++) {
-        int32_t duration = ctx->raw_samples[i];
+    ctx->can_save = (ctx->save_data != NULL);
+}
+
+// Stream one chunk of RAW samples from the file to all decoders
+static bool protopirate_process_raw_chunk(SubDecodeContext* ctx) {
+    size_t count =
+        protopirate_raw_reader_read(&ctx->raw_reader, ctx->raw_chunk, RAW_CHUNK_SAMPLES);
+
+    for(size_t i = 0; i < count; i++) {
+        int32_t duration = ctx->raw_chunk[i];
         bool level = (duration >= 0);
         if(duration < 0) duration = -duration;
 
-        ctx->current_protocol->decoder->feed(ctx->current_decoder, level, (uint32_t)duration);
+        protopirate_dispatch_feed(ctx->dispatch, level, (uint32_t)duration);
+    }
+
+    ctx->total_samples += count;
+
+    if(count > 0) {
+        return false;
     }
 
-    ctx->current_sample = end_sample;
+    FURI_LOG_I(TAG, "Streamed %zu RAW samples", ctx->total_samples);
 
-    if(ctx->callback_fired && furi_string_size(ctx->decoded_string) > 0) {
-        furi_string_printf(
-            ctx->result,
-            "RAW Decoded!\nFreq: %lu.%02lu MHz\n\n%s",
-            ctx->frequency / 1000000,
-            (ctx->frequency % 1000000) / 10000,
-            furi_string_get_cstr(ctx->decoded_string));
+    if(ctx->matched_protocols > 0) {
+        protopirate_build_raw_result(ctx);
         ctx->decode_success = true;
-        ctx->can_save = true;
-
-        // Serialize the decoded data BEFORE freeing the decoder
-        ctx->save_data = flipper_format_string_alloc();
-        if(ctx->current_protocol->decoder->serialize) {
-            // Create a temporary preset for serialization
-            SubGhzRadioPreset temp_preset;
-            temp_preset.frequency = ctx->frequency;
-            temp_preset.name = furi_string_alloc_set("AM650");
-            temp_preset.data = NULL;
-            temp_preset.data_size = 0;
-
-            SubGhzProtocolStatus status = ctx->current_protocol->decoder->serialize(
-                ctx->current_decoder, ctx->save_data, &temp_preset);
-
-            if(status != SubGhzProtocolStatusOk) {
-                FURI_LOG_W(TAG, "RAW serialize failed: %d", status);
-                flipper_format_free(ctx->save_data);
-                ctx->save_data = NULL;
-                ctx->can_save = false;
-            } else {
-                FURI_LOG_I(TAG, "RAW serialize success for %s", ctx->current_protocol->name);
-            }
+    }
 
-            furi_string_free(temp_preset.name);
-        } else {
-            FURI_LOG_W(TAG, "Protocol %s has no serialize function", ctx->current_protocol->name);
-            flipper_format_free(ctx->save_data);
-            ctx->save_data = NULL;
-            ctx->can_save = false;
+    protopirate_free_decoders(ctx);
+    return true;
+}
+
+// Decode the whole RAW file as fast as possible, posting progress snapshots to the scene
+static int32_t protopirate_decode_worker(void* context) {
+    SubDecodeContext* ctx = context;
+    uint8_t last_progress = 0xFF;
+    const char* last_match_name = NULL;
+
+    while(!ctx->worker_cancel) {
+        if(protopirate_process_raw_chunk(ctx)) break;
+
+        DecodeWorkerEvent event = {
+            .type = DecodeWorkerEventProgress,
+            .progress = protopirate_raw_reader_get_progress(&ctx->raw_reader),
+            .match_name = ctx->last_match_name,
+        };
+        if(event.progress != last_progress || event.match_name != last_match_name) {
+            // Dropped when the scene is behind, the next snapshot supersedes it
+            if(furi_message_queue_put(ctx->worker_queue, &event, 0) == FuriStatusOk) {
+                last_progress = event.progress;
+                last_match_name = event.match_name;
+            }
         }
+    }
 
-        ctx->current_protocol->decoder->free(ctx->current_decoder);
-        ctx->current_decoder = NULL;
-        return true;
+    DecodeWorkerEvent done = {
+        .type = DecodeWorkerEventDone,
+        .progress = 100,
+        .match_name = ctx->last_match_name,
+    };
+    while(furi_message_queue_put(ctx->worker_queue, &done, 10) != FuriStatusOk &&
+          !ctx->worker_cancel) {
     }
 
-    if(ctx->current_sample >= ctx->total_samples) {
-        if(ctx->current_decoder) {
-            ctx->current_protocol->decoder->free(ctx->current_decoder);
-            ctx->current_decoder = NULL;
-        }
-        ctx->current_protocol_idx++;
-        ctx->current_sample = 0;
+    return 0;
+}
 
-        if(ctx->current_protocol_idx >= protopirate_protocol_registry.size) {
-            return true;
+static void protopirate_decode_worker_start(SubDecodeContext* ctx) {
+    ctx->worker_queue = furi_message_queue_alloc(DECODE_QUEUE_SIZE, sizeof(DecodeWorkerEvent));
+    ctx->worker = furi_thread_alloc_ex(
+        "ProtoPirateDecode", DECODE_WORKER_STACK, protopirate_decode_worker, ctx);
+    furi_thread_start(ctx->worker);
+}
+
+static void protopirate_decode_worker_stop(SubDecodeContext* ctx) {
+    if(ctx->worker) {
+        ctx->worker_cancel = true;
+        furi_thread_join(ctx->worker);
+        furi_thread_free(ctx->worker);
+        ctx->worker = NULL;
+    }
+    if(ctx->worker_queue) {
+        furi_message_queue_free(ctx->worker_queue);
+        ctx->worker_queue = NULL;
+    }
+}
+
+// Drain worker messages, returns true once the worker has finished
+static bool protopirate_decode_worker_poll(SubDecodeContext* ctx) {
+    DecodeWorkerEvent event;
+    bool done = false;
+
+    while(furi_message_queue_get(ctx->worker_queue, &event, 0) == FuriStatusOk) {
+        ctx->raw_progress = event.progress;
+        ctx->progress_match_name = event.match_name;
+        if(event.type == DecodeWorkerEventDone) {
+            done = true;
         }
     }
 
-    return false;
+    if(done) {
+        protopirate_decode_worker_stop(ctx);
+    }
+    return done;
 }
 
 static void close_file_handles(SubDecodeContext* ctx) {
@@ -570,6 +611,17 @@ static void close_file_handles(SubDecodeContext* ctx) {
     }
 }
 
+// Back was pressed while decoding, the worker is joined before its result is overwritten
+static void protopirate_decode_cancel(SubDecodeContext* ctx) {
+    protopirate_decode_worker_stop(ctx);
+    close_file_handles(ctx);
+
+    furi_string_set(ctx->error_info, "Cancelled");
+    furi_string_set(ctx->result, "Cancelled by user");
+    ctx->state = DecodeStateShowFailure;
+    ctx->result_display_counter = 0;
+}
+
 // Widget callback for save button
 static void protopirate_scene_sub_decode_widget_callback(
     GuiButtonType result,
@@ -593,8 +645,8 @@ void protopirate_scene_sub_decode_on_enter(void* context) {
     g_decode_ctx->protocol_name = furi_string_alloc();
     g_decode_ctx->result = furi_string_alloc();
     g_decode_ctx->error_info = furi_string_alloc();
-    g_decode_ctx->decoded_string = furi_string_alloc();
     g_decode_ctx->state = DecodeStateIdle;
+    g_decode_ctx->worker_cancel = false;
     g_decode_ctx->can_save = false;
     g_decode_ctx->save_data = NULL;
 
@@ -642,10 +694,6 @@ bool protopirate_scene_sub_decode_on_event(void* context, SceneManagerEvent even
                     FURI_LOG_W(TAG, "Could not read Protocol from save_data");
                 }
 
-                // Clean protocol name for filename
-                furi_string_replace_all(protocol, "/", "_");
-                furi_string_replace_all(protocol, " ", "_");
-
                 FURI_LOG_I(TAG, "Saving as protocol: %s", furi_string_get_cstr(protocol));
 
                 FuriString* saved_path = furi_string_alloc();
@@ -673,6 +721,11 @@ bool protopirate_scene_sub_decode_on_event(void* context, SceneManagerEvent even
         consumed = true;
         ctx->animation_frame++;
 
+        if(ctx->worker_cancel && ctx->state >= DecodeStateOpenFile &&
+           ctx->state <= DecodeStateDecodingProtocol) {
+            protopirate_decode_cancel(ctx);
+        }
+
         switch(ctx->state) {
         case DecodeStateOpenFile: {
             ctx->storage = furi_record_open(RECORD_STORAGE);
@@ -739,8 +792,7 @@ bool protopirate_scene_sub_decode_on_event(void* context, SceneManagerEvent even
                 ctx->result_display_counter = 0;
                 notification_message(app->notifications, &sequence_error);
             } else if(furi_string_cmp_str(ctx->protocol_name, "RAW") == 0) {
-                ctx->raw_samples = malloc(sizeof(int32_t) * MAX_RAW_SAMPLES);
-                if(!ctx->raw_samples) {
+                if(!protopirate_alloc_decoders(app, ctx)) {
                     furi_string_set(ctx->result, "Memory error");
                     furi_string_set(ctx->error_info, "Out of memory");
                     close_file_handles(ctx);
@@ -749,8 +801,11 @@ bool protopirate_scene_sub_decode_on_event(void* context, SceneManagerEvent even
                     notification_message(app->notifications, &sequence_error);
                 } else {
                     ctx->total_samples = 0;
-                    flipper_format_rewind(ctx->ff);
-                    ctx->state = DecodeStateLoadRawSamples;
+                    ctx->raw_progress = 0;
+                    protopirate_raw_reader_init(
+                        &ctx->raw_reader, flipper_format_get_raw_stream(ctx->ff));
+                    ctx->state = DecodeStateDecodingRaw;
+                    protopirate_decode_worker_start(ctx);
                 }
             } else {
                 ctx->state = DecodeStateDecodingProtocol;
@@ -758,61 +813,28 @@ bool protopirate_scene_sub_decode_on_event(void* context, SceneManagerEvent even
             break;
         }
 
-        case DecodeStateLoadRawSamples: {
-            size_t samples_this_tick = 0;
-
-            while(ctx->total_samples < MAX_RAW_SAMPLES && samples_this_tick < 512) {
-                uint32_t count = 0;
-                if(!flipper_format_get_value_count(ctx->ff, "RAW_Data", &count) || count == 0) {
-                    break;
-                }
-
-                size_t to_read = count;
-                if(ctx->total_samples + to_read > MAX_RAW_SAMPLES) {
-                    to_read = MAX_RAW_SAMPLES - ctx->total_samples;
-                }
-
-                if(!flipper_format_read_int32(
-                       ctx->ff, "RAW_Data", &ctx->raw_samples[ctx->total_samples], to_read)) {
-                    break;
-                }
-
-                ctx->total_samples += to_read;
-                samples_this_tick += to_read;
-            }
-
-            uint32_t count = 0;
-            bool more_data = flipper_format_get_value_count(ctx->ff, "RAW_Data", &count) &&
-                             count > 0;
+        case DecodeStateDecodingRaw: {
+            bool done = protopirate_decode_worker_poll(ctx);
 
-            if(!more_data || ctx->total_samples >= MAX_RAW_SAMPLES) {
+            if(done) {
                 close_file_handles(ctx);
 
-                FURI_LOG_I(TAG, "Loaded %zu RAW samples", ctx->total_samples);
-
-                if(ctx->total_samples < 10) {
-                    furi_string_set(ctx->result, "Not enough samples");
-                    furi_string_set(ctx->error_info, "Too few samples");
+                if(protopirate_raw_reader_has_error(&ctx->raw_reader)) {
+                    furi_string_set(ctx->result, "RAW_Data value out of range");
+                    furi_string_set(ctx->error_info, "Parse error");
                     ctx->state = DecodeStateShowFailure;
                     ctx->result_display_counter = 0;
                     notification_message(app->notifications, &sequence_error);
-                } else {
-                    ctx->current_protocol_idx = 0;
-                    ctx->current_sample = 0;
-                    ctx->state = DecodeStateDecodingRaw;
-                }
-            }
-            break;
-        }
-
-        case DecodeStateDecodingRaw: {
-            bool done = protopirate_process_raw_chunk(app, ctx);
-
-            if(done) {
-                if(ctx->decode_success) {
+                } else if(ctx->decode_success) {
                     ctx->state = DecodeStateShowSuccess;
                     ctx->result_display_counter = 0;
                     notification_message(app->notifications, &sequence_success);
+                } else if(ctx->total_samples < 10) {
+                    furi_string_set(ctx->result, "Not enough samples");
+                    furi_string_set(ctx->error_info, "Too few samples");
+                    ctx->state = DecodeStateShowFailure;
+                    ctx->result_display_counter = 0;
+                    notification_message(app->notifications, &sequence_error);
                 } else {
                     furi_string_printf(
                         ctx->result,
@@ -841,12 +863,10 @@ bool protopirate_scene_sub_decode_on_event(void* context, SceneManagerEvent even
 
             // Find matching protocol
             const SubGhzProtocol* custom_protocol = NULL;
-            for(size_t i = 0; i < protopirate_protocol_registry.size; i++) {
-                if(protocol_names_match(proto_name, protopirate_protocol_registry.items[i]->name)) {
-                    custom_protocol = protopirate_protocol_registry.items[i];
-                    FURI_LOG_I(TAG, "Matched to: %s", custom_protocol->name);
-                    break;
-                }
+            const ProtoPirateProtocolInfo* info = protopirate_protocol_find_info(proto_name);
+            if(info) {
+                custom_protocol = info->protocol;
+                FURI_LOG_I(TAG, "Matched to: %s", custom_protocol->name);
             }
 
             if(custom_protocol && custom_protocol->decoder && custom_protocol->decoder->alloc) {
@@ -1104,14 +1124,11 @@ void protopirate_scene_sub_decode_on_exit(void* context) {
     ProtoPirateApp* app = context;
 
     if(g_decode_ctx) {
+        // The worker reads the file and owns the decoders, stop it first
+        protopirate_decode_worker_stop(g_decode_ctx);
         close_file_handles(g_decode_ctx);
 
-        if(g_decode_ctx->current_decoder && g_decode_ctx->current_protocol) {
-            g_decode_ctx->current_protocol->decoder->free(g_decode_ctx->current_decoder);
-        }
-        if(g_decode_ctx->raw_samples) {
-            free(g_decode_ctx->raw_samples);
-        }
+        protopirate_free_decoders(g_decode_ctx);
         if(g_decode_ctx->save_data) {
             flipper_format_free(g_decode_ctx->save_data);
         }
@@ -1119,7 +1136,6 @@ void protopirate_scene_sub_decode_on_exit(void* context) {
         furi_string_free(g_decode_ctx->protocol_name);
         furi_string_free(g_decode_ctx->result);
         furi_string_free(g_decode_ctx->error_info);
-        furi_string_free(g_decode_ctx->decoded_string);
         free(g_decode_ctx);
         g_decode_ctx = NULL;
     }
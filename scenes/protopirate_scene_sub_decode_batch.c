@@ -0,0 +1,216 @@
+// scenes/protopirate_scene_sub_decode_batch.c
+#include "../protopirate_app_i.h"
+#include "../helpers/protopirate_batch_decode.h"
+#include "../helpers/protopirate_storage.h"
+#include <dialogs/dialogs.h>
+
+#define TAG "ProtoPirateBatchDecode"
+
+#define SUBGHZ_APP_FOLDER  EXT_PATH("subghz")
+#define BATCH_WORKER_STACK (4 * 1024)
+#define BATCH_EVENT_EXIT   0
+
+typedef struct {
+    ProtoPirateBatchDecode* batch;
+    FuriString* folder;
+    FuriString* csv_path;
+
+    // The worker walks the folder, the scene only polls done and draws the totals
+    FuriThread* worker;
+    volatile bool cancel;
+    volatile bool done;
+    bool started;
+    bool saved;
+} SubDecodeBatchContext;
+
+static SubDecodeBatchContext* g_batch_ctx = NULL;
+
+static const char* sub_decode_batch_name(const FuriString* path) {
+    const char* cstr = furi_string_get_cstr(path);
+    const char* name = strrchr(cstr, '/');
+    return name ? name + 1 : cstr;
+}
+
+static void sub_decode_batch_draw_callback(Canvas* canvas, void* context) {
+    UNUSED(context);
+    SubDecodeBatchContext* ctx = g_batch_ctx;
+    if(!ctx) return;
+
+    ProtoPirateBatchDecodeStats stats;
+    protopirate_batch_decode_get_stats(ctx->batch, &stats);
+    bool running = ctx->worker && !ctx->done;
+    char line_str[32];
+
+    canvas_clear(canvas);
+    canvas_set_color(canvas, ColorBlack);
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(canvas, 64, 2, AlignCenter, AlignTop, "DECODE FOLDER");
+
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str_aligned(
+        canvas, 64, 14, AlignCenter, AlignTop, sub_decode_batch_name(ctx->folder));
+
+    if(running) {
+        snprintf(
+            line_str,
+            sizeof(line_str),
+            "File %lu: %u%%",
+            stats.files,
+            protopirate_batch_decode_get_progress(ctx->batch));
+    } else if(!ctx->started) {
+        snprintf(line_str, sizeof(line_str), "Can't write CSV");
+    } else {
+        snprintf(
+            line_str,
+            sizeof(line_str),
+            "%lu files in %lu.%lus",
+            stats.files,
+            stats.time_ms / 1000,
+            (stats.time_ms % 1000) / 100);
+    }
+    canvas_draw_str_aligned(canvas, 64, 25, AlignCenter, AlignTop, line_str);
+
+    snprintf(
+        line_str,
+        sizeof(line_str),
+        "Decoded: %lu  Skipped: %lu",
+        stats.decoded,
+        stats.skipped);
+    canvas_draw_str_aligned(canvas, 64, 36, AlignCenter, AlignTop, line_str);
+
+    if(running || !ctx->started) {
+        snprintf(line_str, sizeof(line_str), "Frames: %lu", stats.rows);
+    } else {
+        snprintf(
+            line_str,
+            sizeof(line_str),
+            "%s %s",
+            ctx->saved ? "Saved" : "Failed",
+            sub_decode_batch_name(ctx->csv_path));
+    }
+    canvas_draw_str_aligned(canvas, 64, 47, AlignCenter, AlignTop, line_str);
+
+    canvas_draw_str_aligned(
+        canvas, 64, 62, AlignCenter, AlignBottom, running ? "Back:Stop" : "Back:Exit");
+}
+
+static int32_t sub_decode_batch_worker(void* context) {
+    SubDecodeBatchContext* ctx = context;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+
+    ctx->started = protopirate_batch_decode_start(
+        ctx->batch, storage, furi_string_get_cstr(ctx->folder), ctx->csv_path);
+    if(ctx->started) {
+        while(!ctx->cancel && protopirate_batch_decode_step(ctx->batch)) {
+        }
+        ctx->saved = protopirate_batch_decode_finish(ctx->batch);
+    }
+
+    furi_record_close(RECORD_STORAGE);
+    ctx->done = true;
+    return 0;
+}
+
+static void sub_decode_batch_stop(SubDecodeBatchContext* ctx) {
+    if(ctx->worker) {
+        ctx->cancel = true;
+        furi_thread_join(ctx->worker);
+        furi_thread_free(ctx->worker);
+        ctx->worker = NULL;
+    }
+}
+
+static bool sub_decode_batch_input_callback(InputEvent* event, void* context) {
+    ProtoPirateApp* app = context;
+    if(event->type != InputTypeShort || event->key != InputKeyBack) return false;
+
+    // The first Back stops a running batch and keeps its totals on screen
+    if(g_batch_ctx && g_batch_ctx->worker && !g_batch_ctx->done) {
+        g_batch_ctx->cancel = true;
+    } else {
+        view_dispatcher_send_custom_event(app->view_dispatcher, BATCH_EVENT_EXIT);
+    }
+    return true;
+}
+
+void protopirate_scene_sub_decode_batch_on_enter(void* context) {
+    ProtoPirateApp* app = context;
+
+    g_batch_ctx = malloc(sizeof(SubDecodeBatchContext));
+    memset(g_batch_ctx, 0, sizeof(SubDecodeBatchContext));
+    g_batch_ctx->folder = furi_string_alloc_set(SUBGHZ_APP_FOLDER);
+    g_batch_ctx->csv_path = furi_string_alloc();
+
+    // The browser picks files, so any .sub stands for its folder and everything below it
+    DialogsFileBrowserOptions browser_options;
+    dialog_file_browser_set_basic_options(&browser_options, PROTOPIRATE_APP_EXTENSION, NULL);
+    browser_options.base_path = SUBGHZ_APP_FOLDER;
+    browser_options.hide_ext = false;
+
+    DialogsApp* dialogs = furi_record_open(RECORD_DIALOGS);
+    bool selected = dialog_file_browser_show(
+        dialogs, g_batch_ctx->folder, g_batch_ctx->folder, &browser_options);
+    furi_record_close(RECORD_DIALOGS);
+
+    if(!selected) {
+        scene_manager_previous_scene(app->scene_manager);
+        return;
+    }
+
+    const char* path = furi_string_get_cstr(g_batch_ctx->folder);
+    const char* name = sub_decode_batch_name(g_batch_ctx->folder);
+    furi_string_left(g_batch_ctx->folder, name > path ? (size_t)(name - path - 1) : 0);
+    FURI_LOG_I(TAG, "Batch folder: %s", furi_string_get_cstr(g_batch_ctx->folder));
+
+    g_batch_ctx->batch = protopirate_batch_decode_alloc(app->txrx->environment);
+    g_batch_ctx->worker = furi_thread_alloc_ex(
+        "ProtoPirateBatch", BATCH_WORKER_STACK, sub_decode_batch_worker, g_batch_ctx);
+    furi_thread_start(g_batch_ctx->worker);
+
+    view_set_draw_callback(app->view_about, sub_decode_batch_draw_callback);
+    view_set_input_callback(app->view_about, sub_decode_batch_input_callback);
+    view_set_context(app->view_about, app);
+    view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewAbout);
+}
+
+bool protopirate_scene_sub_decode_batch_on_event(void* context, SceneManagerEvent event) {
+    ProtoPirateApp* app = context;
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeCustom) {
+        if(event.event == BATCH_EVENT_EXIT) {
+            scene_manager_previous_scene(app->scene_manager);
+            consumed = true;
+        }
+    } else if(event.type == SceneManagerEventTypeTick) {
+        if(g_batch_ctx && g_batch_ctx->worker && g_batch_ctx->done) {
+            sub_decode_batch_stop(g_batch_ctx);
+            notification_message(
+                app->notifications,
+                g_batch_ctx->started && g_batch_ctx->saved ? &sequence_success :
+                                                             &sequence_error);
+        }
+        view_commit_model(app->view_about, false);
+        consumed = true;
+    }
+
+    return consumed;
+}
+
+void protopirate_scene_sub_decode_batch_on_exit(void* context) {
+    ProtoPirateApp* app = context;
+
+    view_set_draw_callback(app->view_about, NULL);
+    view_set_input_callback(app->view_about, NULL);
+
+    if(g_batch_ctx) {
+        sub_decode_batch_stop(g_batch_ctx);
+        if(g_batch_ctx->batch) {
+            protopirate_batch_decode_free(g_batch_ctx->batch);
+        }
+        furi_string_free(g_batch_ctx->folder);
+        furi_string_free(g_batch_ctx->csv_path);
+        free(g_batch_ctx);
+        g_batch_ctx = NULL;
+    }
+}
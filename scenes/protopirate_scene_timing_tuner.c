@@ -1,24 +1,38 @@
 // scenes/protopirate_scene_timing_tuner.c
 #include "../protopirate_app_i.h"
 #include "../protocols/protocol_items.h"
+#include "../helpers/protopirate_timing_cluster.h"
+#include "../helpers/protopirate_timing_fit.h"
+#include "../helpers/protopirate_timing_file.h"
+#include "../helpers/protopirate_storage.h"
+#include <dialogs/dialogs.h>
 #include <math.h>
 
 #define TAG "ProtoPirateTimingTuner"
 
-#define MAX_TIMING_SAMPLES 512
-#define VISIBLE_LINES      6
-#define LINE_HEIGHT        9
+#define VISIBLE_LINES       6
+#define LINE_HEIGHT         9
+#define SUBGHZ_APP_FOLDER   EXT_PATH("subghz")
+#define FILE_CHUNK_SAMPLES  256
+#define FILE_WORKER_STACK   (3 * 1024)
+#define FILE_NAME_MAX       128
 
 typedef struct {
-    // Ring buffer for timing capture
-    int32_t samples[MAX_TIMING_SAMPLES];
-    size_t write_idx; // Next write position
-    size_t sample_count; // Total samples captured (may exceed MAX)
-    bool buffer_wrapped; // True if we've wrapped around
+    // Streaming timing clusters, the decode thread adds pulses under the mutex and
+    // the stats below are calculated from it under the mutex too
+    ProtoPirateTimingEstimator estimator;
+    FuriMutex* mutex;
+
+    // Live fit of every registry protocol's timing, ranked on ticks while shown
+    ProtoPirateTimingFit* fit;
+    ProtoPirateTimingFitResult* rank;
+    size_t rank_count;
+    bool show_rank;
 
     // Timing statistics
     size_t short_count;
     size_t long_count;
+    uint8_t cluster_count;
 
     // Calculated stats
     int32_t avg_short;
@@ -27,10 +41,13 @@ typedef struct {
     int32_t max_short;
     int32_t min_long;
     int32_t max_long;
+    int32_t spread_short;
+    int32_t spread_long;
+    int32_t avg_gap; // 0 when there is no gap cluster
 
     // Protocol match info
     const char* matched_protocol;
-    const ProtoPirateProtocolTiming* timing_info;
+    const SubGhzBlockConst* timing_info;
 
     // State
     bool is_receiving;
@@ -40,123 +57,124 @@ typedef struct {
     uint8_t scroll_offset;
     uint8_t total_lines;
 
+    // File mode: a worker streams .sub RAW files through the same estimator and fit
+    // instead of the radio, and writes a report for each
+    ProtoPirateTimingTunerMode mode;
+    FuriString* file_path; // Chosen file, a folder run takes every .sub next to it
+    FuriThread* file_worker;
+    ProtoPirateTimingFile file; // Owned by the worker while it runs
+    int32_t file_chunk[FILE_CHUNK_SAMPLES];
+    volatile bool file_cancel;
+    volatile bool file_done;
+    volatile uint8_t file_progress;
+    volatile uint32_t files_read;
+    volatile uint32_t files_skipped;
+    volatile uint32_t reports_saved;
+    bool file_folder;
+
     // App reference for callback
     ProtoPirateApp* app;
 } TimingTunerContext;
 
 static TimingTunerContext* g_timing_ctx = NULL;
 
-static void calculate_timing_stats(TimingTunerContext* ctx) {
-    size_t num_samples = ctx->buffer_wrapped ? MAX_TIMING_SAMPLES : ctx->write_idx;
-
-    if(num_samples < 10) {
-        FURI_LOG_W(TAG, "Not enough samples: %zu", num_samples);
+// Copies a cluster into one row of stats, zeroes it when the cluster is missing
+static void timing_tuner_apply_cluster(
+    const ProtoPirateTimingClusters* clusters,
+    int8_t index,
+    int32_t* avg,
+    int32_t* min,
+    int32_t* max,
+    int32_t* spread,
+    size_t* count) {
+    if(index < 0) {
+        *avg = 0;
+        *min = 0;
+        *max = 0;
+        *spread = 0;
+        *count = 0;
         return;
     }
 
-    FURI_LOG_I(
-        TAG,
-        "Analyzing %zu samples (total captured: %zu, wrapped: %d)",
-        num_samples,
-        ctx->sample_count,
-        ctx->buffer_wrapped);
-
-    ctx->short_count = 0;
-    ctx->long_count = 0;
-    ctx->min_short = INT32_MAX;
-    ctx->max_short = 0;
-    ctx->min_long = INT32_MAX;
-    ctx->max_long = 0;
-
-    int64_t short_sum = 0;
-    int64_t long_sum = 0;
-
-    int32_t threshold;
-    int32_t min_valid;
-    int32_t max_valid;
-
-    if(ctx->timing_info) {
-        int32_t te_short = (int32_t)ctx->timing_info->te_short;
-        int32_t te_long = (int32_t)ctx->timing_info->te_long;
-        int32_t te_delta = (int32_t)ctx->timing_info->te_delta;
-
-        // Threshold halfway between expected short and long
-        threshold = (te_short + te_long) / 2;
-
-        // Valid pulse range - use 2x delta as bounds
-        min_valid = te_short - (te_delta * 2);
-        if(min_valid < 100) min_valid = 100;
-        max_valid = te_long + (te_delta * 2);
-
-        FURI_LOG_I(
-            TAG, "Protocol timing: threshold=%ld valid=%ld-%ld", threshold, min_valid, max_valid);
-
-    } else {
-        // No protocol info - use reasonable defaults
-        threshold = 400;
-        min_valid = 100;
-        max_valid = 1200;
+    const ProtoPirateTimingCluster* cluster = &clusters->clusters[index];
+    *avg = (int32_t)cluster->mean;
+    *min = (int32_t)cluster->min;
+    *max = (int32_t)cluster->max;
+    *spread = (int32_t)cluster->spread;
+    *count = cluster->count;
+}
 
-        FURI_LOG_I(
-            TAG,
-            "No protocol ref, using defaults: threshold=%ld valid=%ld-%ld",
-            threshold,
-            min_valid,
-            max_valid);
+// Caller holds ctx->mutex. With a protocol reference short and long are the clusters
+// closest to its te_short and te_long, without one the estimator's own guess.
+static bool calculate_timing_stats(TimingTunerContext* ctx) {
+    ProtoPirateTimingClusters clusters;
+    if(!protopirate_timing_estimator_find(&ctx->estimator, &clusters)) {
+        ctx->cluster_count = 0;
+        return false;
     }
 
-    // Analyze all samples in the ring buffer
-    for(size_t i = 0; i < num_samples; i++) {
-        int32_t dur = ctx->samples[i];
-        if(dur < 0) dur = -dur;
-
-        // Filter out noise and gaps
-        if(dur < min_valid || dur > max_valid) continue;
-
-        if(dur < threshold) {
-            short_sum += dur;
-            ctx->short_count++;
-            if(dur < ctx->min_short) ctx->min_short = dur;
-            if(dur > ctx->max_short) ctx->max_short = dur;
-        } else {
-            long_sum += dur;
-            ctx->long_count++;
-            if(dur < ctx->min_long) ctx->min_long = dur;
-            if(dur > ctx->max_long) ctx->max_long = dur;
+    int8_t short_index = clusters.short_index;
+    int8_t long_index = clusters.long_index;
+    if(ctx->timing_info) {
+        short_index = protopirate_timing_clusters_nearest(&clusters, ctx->timing_info->te_short);
+        long_index = protopirate_timing_clusters_nearest(&clusters, ctx->timing_info->te_long);
+        if(long_index == short_index) {
+            // A single cluster is short or long, whichever it is closer to
+            int32_t mean = (int32_t)clusters.clusters[short_index].mean;
+            int32_t te_short = (int32_t)ctx->timing_info->te_short;
+            int32_t te_long = (int32_t)ctx->timing_info->te_long;
+            if(abs(mean - te_short) <= abs(mean - te_long)) {
+                long_index = -1;
+            } else {
+                short_index = -1;
+            }
         }
     }
 
-    // Calculate averages
-    if(ctx->short_count > 0) {
-        ctx->avg_short = (int32_t)(short_sum / (int64_t)ctx->short_count);
-    } else {
-        ctx->avg_short = 0;
-        ctx->min_short = 0;
-        ctx->max_short = 0;
-    }
-
-    if(ctx->long_count > 0) {
-        ctx->avg_long = (int32_t)(long_sum / (int64_t)ctx->long_count);
-    } else {
-        ctx->avg_long = 0;
-        ctx->min_long = 0;
-        ctx->max_long = 0;
-    }
+    ctx->cluster_count = clusters.count;
+    timing_tuner_apply_cluster(
+        &clusters,
+        short_index,
+        &ctx->avg_short,
+        &ctx->min_short,
+        &ctx->max_short,
+        &ctx->spread_short,
+        &ctx->short_count);
+    timing_tuner_apply_cluster(
+        &clusters,
+        long_index,
+        &ctx->avg_long,
+        &ctx->min_long,
+        &ctx->max_long,
+        &ctx->spread_long,
+        &ctx->long_count);
+    ctx->avg_gap = clusters.gap_index >= 0 ? (int32_t)clusters.clusters[clusters.gap_index].mean :
+                                             0;
+    return true;
+}
 
-    // Log results
+static void log_timing_stats(TimingTunerContext* ctx) {
+    FURI_LOG_I(
+        TAG,
+        "Analyzed %lu pulses, %u clusters, gap=%ld",
+        ctx->estimator.pulses,
+        ctx->cluster_count,
+        ctx->avg_gap);
     FURI_LOG_I(
         TAG,
-        "MEASURED SHORT: avg=%ld min=%ld max=%ld n=%zu",
+        "MEASURED SHORT: avg=%ld min=%ld max=%ld spread=%ld n=%zu",
         ctx->avg_short,
         ctx->min_short,
         ctx->max_short,
+        ctx->spread_short,
         ctx->short_count);
     FURI_LOG_I(
         TAG,
-        "MEASURED LONG: avg=%ld min=%ld max=%ld n=%zu",
+        "MEASURED LONG: avg=%ld min=%ld max=%ld spread=%ld n=%zu",
         ctx->avg_long,
         ctx->min_long,
         ctx->max_long,
+        ctx->spread_long,
         ctx->long_count);
 
     if(ctx->timing_info && ctx->short_count > 0 && ctx->long_count > 0) {
@@ -164,19 +182,66 @@ static void calculate_timing_stats(TimingTunerContext* ctx) {
         int32_t long_diff = ctx->avg_long - (int32_t)ctx->timing_info->te_long;
         FURI_LOG_I(
             TAG,
-            "DIFFERENCE: short=%+ld long=%+ld (tolerance +/-%lu)",
+            "DIFFERENCE: short=%+ld long=%+ld (tolerance +/-%u)",
             short_diff,
             long_diff,
             ctx->timing_info->te_delta);
     }
 }
 
+// Switches to the results, false when they are already shown or nothing was clustered
+static bool timing_tuner_show_results(
+    TimingTunerContext* ctx,
+    const char* protocol_name,
+    const SubGhzBlockConst* timing_info) {
+    bool shown = false;
+
+    furi_mutex_acquire(ctx->mutex, FuriWaitForever);
+    if(!ctx->has_match) {
+        ctx->matched_protocol = protocol_name;
+        ctx->timing_info = timing_info;
+        if(calculate_timing_stats(ctx)) {
+            log_timing_stats(ctx);
+            ctx->has_match = true;
+            ctx->scroll_offset = 0;
+            shown = true;
+        } else {
+            FURI_LOG_W(TAG, "No timing clusters yet: %lu pulses", ctx->estimator.pulses);
+        }
+    }
+    furi_mutex_release(ctx->mutex);
+
+    return shown;
+}
+
+static void timing_tuner_format_figure(char* buf, size_t buf_size, char role, int32_t value) {
+    if(value > 0) {
+        snprintf(buf, buf_size, "%c:%ld", role, value);
+    } else {
+        snprintf(buf, buf_size, "%c:-", role);
+    }
+}
+
 static void timing_tuner_draw_listening(Canvas* canvas, TimingTunerContext* ctx) {
     canvas_set_font(canvas, FontPrimary);
     canvas_draw_str_aligned(canvas, 64, 2, AlignCenter, AlignTop, "TIMING TUNER");
 
     canvas_set_font(canvas, FontSecondary);
-    canvas_draw_str_aligned(canvas, 64, 18, AlignCenter, AlignTop, "Listening for signals...");
+    if(ctx->cluster_count > 0) {
+        // Live clusters, good enough to characterise a fob no protocol matches
+        char short_str[10];
+        char long_str[10];
+        char gap_str[10];
+        char figures_str[32];
+        timing_tuner_format_figure(short_str, sizeof(short_str), 'S', ctx->avg_short);
+        timing_tuner_format_figure(long_str, sizeof(long_str), 'L', ctx->avg_long);
+        timing_tuner_format_figure(gap_str, sizeof(gap_str), 'G', ctx->avg_gap);
+        snprintf(figures_str, sizeof(figures_str), "%s %s %s", short_str, long_str, gap_str);
+        canvas_draw_str_aligned(canvas, 64, 18, AlignCenter, AlignTop, figures_str);
+    } else {
+        canvas_draw_str_aligned(
+            canvas, 64, 18, AlignCenter, AlignTop, "Listening for signals...");
+    }
 
     int wave_y = 38;
     ctx->animation_frame++;
@@ -187,11 +252,76 @@ static void timing_tuner_draw_listening(Canvas* canvas, TimingTunerContext* ctx)
     }
 
     canvas_set_font(canvas, FontSecondary);
-    char rssi_str[24];
-    snprintf(rssi_str, sizeof(rssi_str), "RSSI: %.0f  <:Cfg", (double)ctx->rssi);
+    char rssi_str[32];
+    snprintf(
+        rssi_str,
+        sizeof(rssi_str),
+        ctx->cluster_count > 0 ? "RSSI: %.0f OK >:Fit <:Cfg" : "RSSI: %.0f  >:Fit  <:Cfg",
+        (double)ctx->rssi);
     canvas_draw_str_aligned(canvas, 64, 62, AlignCenter, AlignBottom, rssi_str);
 }
 
+static const char* timing_tuner_file_name(TimingTunerContext* ctx) {
+    const char* path = furi_string_get_cstr(ctx->file_path);
+    const char* name = strrchr(path, '/');
+    return name ? name + 1 : path;
+}
+
+static void timing_tuner_draw_file(Canvas* canvas, TimingTunerContext* ctx) {
+    char line_str[32];
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(canvas, 64, 2, AlignCenter, AlignTop, "TIMING FROM FILE");
+
+    canvas_set_font(canvas, FontSecondary);
+    if(ctx->file_folder) {
+        snprintf(
+            line_str,
+            sizeof(line_str),
+            "File %lu: %u%%",
+            ctx->files_read + ctx->files_skipped + (ctx->file_worker ? 1 : 0),
+            ctx->file_progress);
+    } else {
+        snprintf(line_str, sizeof(line_str), "%s", timing_tuner_file_name(ctx));
+    }
+    canvas_draw_str_aligned(canvas, 64, 16, AlignCenter, AlignTop, line_str);
+
+    if(ctx->file_worker && !ctx->file_folder) {
+        snprintf(line_str, sizeof(line_str), "Reading: %u%%", ctx->file_progress);
+    } else if(ctx->file_folder) {
+        snprintf(
+            line_str,
+            sizeof(line_str),
+            "Reports: %lu  Skipped: %lu",
+            ctx->reports_saved,
+            ctx->files_skipped);
+    } else if(ctx->files_skipped > 0) {
+        snprintf(line_str, sizeof(line_str), "Not a RAW recording");
+    } else {
+        snprintf(line_str, sizeof(line_str), "No timing found");
+    }
+    canvas_draw_str_aligned(canvas, 64, 27, AlignCenter, AlignTop, line_str);
+
+    if(ctx->cluster_count > 0) {
+        char short_str[10];
+        char long_str[10];
+        char gap_str[10];
+        timing_tuner_format_figure(short_str, sizeof(short_str), 'S', ctx->avg_short);
+        timing_tuner_format_figure(long_str, sizeof(long_str), 'L', ctx->avg_long);
+        timing_tuner_format_figure(gap_str, sizeof(gap_str), 'G', ctx->avg_gap);
+        snprintf(line_str, sizeof(line_str), "%s %s %s", short_str, long_str, gap_str);
+        canvas_draw_str_aligned(canvas, 64, 38, AlignCenter, AlignTop, line_str);
+    }
+
+    canvas_draw_str_aligned(
+        canvas,
+        64,
+        62,
+        AlignCenter,
+        AlignBottom,
+        ctx->file_worker ? "Back:Stop" : ">:Fit  Back:Exit");
+}
+
 // Get a specific line of content
 static bool
     get_result_line(TimingTunerContext* ctx, uint8_t line_idx, char* buf, size_t buf_size) {
@@ -222,13 +352,13 @@ static bool
             snprintf(buf, buf_size, "PROTOCOL DEFINITION:");
             return true;
         case 1:
-            snprintf(buf, buf_size, "  Short: %lu us", ctx->timing_info->te_short);
+            snprintf(buf, buf_size, "  Short: %u us", ctx->timing_info->te_short);
             return true;
         case 2:
-            snprintf(buf, buf_size, "  Long: %lu us", ctx->timing_info->te_long);
+            snprintf(buf, buf_size, "  Long: %u us", ctx->timing_info->te_long);
             return true;
         case 3:
-            snprintf(buf, buf_size, "  Tolerance: +/-%lu us", ctx->timing_info->te_delta);
+            snprintf(buf, buf_size, "  Tolerance: +/-%u us", ctx->timing_info->te_delta);
             return true;
         case 4:
             buf[0] = '\0';
@@ -279,12 +409,18 @@ static bool
             snprintf(buf, buf_size, "  Long Jitter: %ld us", long_jitter);
             return true;
         case 20:
-            buf[0] = '\0';
+            snprintf(buf, buf_size, "  Short Spread: +/-%ld us", ctx->spread_short);
             return true;
         case 21:
-            snprintf(buf, buf_size, "CONCLUSION:");
+            snprintf(buf, buf_size, "  Long Spread: +/-%ld us", ctx->spread_long);
             return true;
         case 22:
+            buf[0] = '\0';
+            return true;
+        case 23:
+            snprintf(buf, buf_size, "CONCLUSION:");
+            return true;
+        case 24:
             if(short_exact) {
                 snprintf(buf, buf_size, "  Short: EXCELLENT");
             } else if(short_ok) {
@@ -295,7 +431,7 @@ static bool
                 snprintf(buf, buf_size, "  Short: LOW by %ld", -short_diff);
             }
             return true;
-        case 23:
+        case 25:
             if(long_exact) {
                 snprintf(buf, buf_size, "  Long: EXCELLENT");
             } else if(long_ok) {
@@ -306,10 +442,10 @@ static bool
                 snprintf(buf, buf_size, "  Long: LOW by %ld", -long_diff);
             }
             return true;
-        case 24:
+        case 26:
             buf[0] = '\0';
             return true;
-        case 25:
+        case 27:
             if(short_exact && long_exact) {
                 snprintf(buf, buf_size, "Timing matches fob!");
             } else if(short_ok && long_ok) {
@@ -318,7 +454,7 @@ static bool
                 snprintf(buf, buf_size, "NEEDS ADJUSTMENT:");
             }
             return true;
-        case 26:
+        case 28:
             if(short_exact && long_exact) {
                 snprintf(buf, buf_size, "No changes needed.");
             } else if(short_ok && long_ok) {
@@ -331,24 +467,24 @@ static bool
                 snprintf(buf, buf_size, "Set te_long=%ld", ctx->avg_long);
             }
             return true;
-        case 27:
+        case 29:
             if(!short_ok && !long_ok) {
                 snprintf(buf, buf_size, "te_long=%ld", ctx->avg_long);
             } else {
                 buf[0] = '\0';
             }
             return true;
-        case 28:
+        case 30:
             buf[0] = '\0';
             return true;
-        case 29:
+        case 31:
             snprintf(buf, buf_size, "OK:Retry  <:Config");
             return true;
         default:
             return false;
         }
     } else {
-        // No timing reference
+        // No timing reference, the estimator picked short, long and gap itself
         switch(line_idx) {
         case 0:
             snprintf(buf, buf_size, "NO PROTOCOL REFERENCE");
@@ -369,40 +505,60 @@ static bool
             snprintf(buf, buf_size, "  Short Max: %ld us", ctx->max_short);
             return true;
         case 6:
-            snprintf(buf, buf_size, "  Short Samples: %zu", ctx->short_count);
+            snprintf(buf, buf_size, "  Short Spread: +/-%ld us", ctx->spread_short);
             return true;
         case 7:
-            snprintf(buf, buf_size, "  Long Avg: %ld us", ctx->avg_long);
+            snprintf(buf, buf_size, "  Short Samples: %zu", ctx->short_count);
             return true;
         case 8:
-            snprintf(buf, buf_size, "  Long Min: %ld us", ctx->min_long);
+            snprintf(buf, buf_size, "  Long Avg: %ld us", ctx->avg_long);
             return true;
         case 9:
-            snprintf(buf, buf_size, "  Long Max: %ld us", ctx->max_long);
+            snprintf(buf, buf_size, "  Long Min: %ld us", ctx->min_long);
             return true;
         case 10:
-            snprintf(buf, buf_size, "  Long Samples: %zu", ctx->long_count);
+            snprintf(buf, buf_size, "  Long Max: %ld us", ctx->max_long);
             return true;
         case 11:
-            buf[0] = '\0';
+            snprintf(buf, buf_size, "  Long Spread: +/-%ld us", ctx->spread_long);
             return true;
         case 12:
-            snprintf(buf, buf_size, "Short Jitter: %ld us", short_jitter);
+            snprintf(buf, buf_size, "  Long Samples: %zu", ctx->long_count);
             return true;
         case 13:
-            snprintf(buf, buf_size, "Long Jitter: %ld us", long_jitter);
+            if(ctx->avg_gap > 0) {
+                snprintf(buf, buf_size, "  Gap: %ld us", ctx->avg_gap);
+            } else {
+                snprintf(buf, buf_size, "  Gap: none");
+            }
             return true;
         case 14:
-            buf[0] = '\0';
+            snprintf(buf, buf_size, "  Clusters: %u", ctx->cluster_count);
             return true;
         case 15:
-            snprintf(buf, buf_size, "Add to protocol_items.c");
+            buf[0] = '\0';
             return true;
         case 16:
-            buf[0] = '\0';
+            snprintf(buf, buf_size, "Short Jitter: %ld us", short_jitter);
             return true;
         case 17:
-            snprintf(buf, buf_size, "OK:Retry  <:Config");
+            snprintf(buf, buf_size, "Long Jitter: %ld us", long_jitter);
+            return true;
+        case 18:
+            buf[0] = '\0';
+            return true;
+        case 19:
+            snprintf(buf, buf_size, "Edit te_ in the decoder's");
+            return true;
+        case 20:
+            snprintf(buf, buf_size, "SubGhzBlockConst");
+            return true;
+        case 21:
+            if(ctx->mode == ProtoPirateTimingTunerModeFile) {
+                snprintf(buf, buf_size, "OK:Whole folder");
+            } else {
+                snprintf(buf, buf_size, "OK:Retry  <:Config");
+            }
             return true;
         default:
             return false;
@@ -412,9 +568,9 @@ static bool
 
 static uint8_t count_result_lines(TimingTunerContext* ctx) {
     if(ctx->timing_info) {
-        return 30; // Lines 0-29
+        return 32; // Lines 0-31
     } else {
-        return 18; // Lines 0-17
+        return 22; // Lines 0-21
     }
 }
 
@@ -458,6 +614,56 @@ static void timing_tuner_draw_results(Canvas* canvas, TimingTunerContext* ctx) {
     }
 }
 
+// Every registry protocol, best timing fit first
+static void timing_tuner_draw_rank(Canvas* canvas, TimingTunerContext* ctx) {
+    char line_buf[32];
+
+    ctx->total_lines = ctx->rank_count;
+    uint8_t max_scroll = 0;
+    if(ctx->rank_count > VISIBLE_LINES) {
+        max_scroll = ctx->rank_count - VISIBLE_LINES;
+    }
+    if(ctx->scroll_offset > max_scroll) {
+        ctx->scroll_offset = max_scroll;
+    }
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(canvas, 64, 0, AlignCenter, AlignTop, "TIMING FIT");
+
+    canvas_set_font(canvas, FontSecondary);
+    uint8_t y = 10;
+    for(uint8_t i = 0; i < VISIBLE_LINES; i++) {
+        uint8_t rank_idx = ctx->scroll_offset + i;
+        if(rank_idx >= ctx->rank_count) break;
+        const ProtoPirateTimingFitResult* result = &ctx->rank[rank_idx];
+
+        snprintf(
+            line_buf, sizeof(line_buf), "%u.%s", rank_idx + 1, result->info->protocol->name);
+        canvas_draw_str(canvas, 1, y + LINE_HEIGHT, line_buf);
+        if(result->score > 0) {
+            // Score, then how far off te the pulses are on average
+            snprintf(
+                line_buf,
+                sizeof(line_buf),
+                "%u%% e%u.%u%%",
+                result->score,
+                result->error / 10,
+                result->error % 10);
+        } else {
+            snprintf(line_buf, sizeof(line_buf), "-");
+        }
+        canvas_draw_str_aligned(canvas, 120, y + LINE_HEIGHT, AlignRight, AlignBottom, line_buf);
+        y += LINE_HEIGHT;
+    }
+
+    if(ctx->scroll_offset > 0) {
+        canvas_draw_str_aligned(canvas, 126, 14, AlignRight, AlignTop, "^");
+    }
+    if(ctx->scroll_offset < max_scroll) {
+        canvas_draw_str_aligned(canvas, 126, 62, AlignRight, AlignBottom, "v");
+    }
+}
+
 static void timing_tuner_draw_callback(Canvas* canvas, void* context) {
     UNUSED(context);
     TimingTunerContext* ctx = g_timing_ctx;
@@ -466,13 +672,133 @@ static void timing_tuner_draw_callback(Canvas* canvas, void* context) {
     canvas_clear(canvas);
     canvas_set_color(canvas, ColorBlack);
 
-    if(!ctx->has_match) {
+    if(ctx->show_rank) {
+        timing_tuner_draw_rank(canvas, ctx);
+    } else if(!ctx->has_match && ctx->mode == ProtoPirateTimingTunerModeFile) {
+        timing_tuner_draw_file(canvas, ctx);
+    } else if(!ctx->has_match) {
         timing_tuner_draw_listening(canvas, ctx);
     } else {
         timing_tuner_draw_results(canvas, ctx);
     }
 }
 
+// Worker: streams one file into the estimator and fit, then writes its report
+static void timing_tuner_file_read(TimingTunerContext* ctx, Storage* storage, const char* path) {
+    if(!protopirate_timing_file_open(&ctx->file, storage, path)) {
+        ctx->files_skipped++;
+        return;
+    }
+
+    furi_mutex_acquire(ctx->mutex, FuriWaitForever);
+    protopirate_timing_estimator_reset(&ctx->estimator);
+    protopirate_timing_fit_reset(ctx->fit);
+    furi_mutex_release(ctx->mutex);
+
+    while(!ctx->file_cancel) {
+        size_t count =
+            protopirate_timing_file_read(&ctx->file, ctx->file_chunk, FILE_CHUNK_SAMPLES);
+        if(count == 0) break;
+
+        furi_mutex_acquire(ctx->mutex, FuriWaitForever);
+        for(size_t i = 0; i < count; i++) {
+            int32_t duration = ctx->file_chunk[i];
+            uint32_t magnitude = (uint32_t)(duration < 0 ? -duration : duration);
+            protopirate_timing_estimator_add(&ctx->estimator, magnitude);
+            protopirate_timing_fit_add(ctx->fit, magnitude);
+        }
+        furi_mutex_release(ctx->mutex);
+        ctx->file_progress = protopirate_timing_file_get_progress(&ctx->file);
+    }
+
+    if(protopirate_raw_reader_has_error(&ctx->file.raw_reader)) {
+        FURI_LOG_W(TAG, "Parse error, no report for %s", path);
+        ctx->files_skipped++;
+    } else if(!ctx->file_cancel) {
+        FURI_LOG_I(TAG, "Read %lu samples from %s", ctx->file.samples, path);
+        furi_mutex_acquire(ctx->mutex, FuriWaitForever);
+        bool saved = protopirate_timing_file_save_report(
+            storage, &ctx->file, path, &ctx->estimator, ctx->fit, NULL);
+        furi_mutex_release(ctx->mutex);
+        if(saved) ctx->reports_saved++;
+        ctx->files_read++;
+    }
+    protopirate_timing_file_close(&ctx->file);
+}
+
+static int32_t timing_tuner_file_worker(void* context) {
+    TimingTunerContext* ctx = context;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+
+    if(!ctx->file_folder) {
+        timing_tuner_file_read(ctx, storage, furi_string_get_cstr(ctx->file_path));
+    } else {
+        // Every .sub in the chosen file's folder, the folder itself is not recursed
+        const char* path = furi_string_get_cstr(ctx->file_path);
+        const char* name = timing_tuner_file_name(ctx);
+        FuriString* folder = furi_string_alloc_set(ctx->file_path);
+        FuriString* file_path = furi_string_alloc();
+        furi_string_left(folder, name > path ? (size_t)(name - path - 1) : 0);
+
+        File* dir = storage_file_alloc(storage);
+        if(storage_dir_open(dir, furi_string_get_cstr(folder))) {
+            FileInfo file_info;
+            char file_name[FILE_NAME_MAX];
+            while(!ctx->file_cancel &&
+                  storage_dir_read(dir, &file_info, file_name, sizeof(file_name))) {
+                size_t name_len = strlen(file_name);
+                size_t extension_len = strlen(PROTOPIRATE_APP_EXTENSION);
+                if(file_info_is_dir(&file_info) || name_len <= extension_len ||
+                   strcmp(file_name + name_len - extension_len, PROTOPIRATE_APP_EXTENSION) != 0) {
+                    continue;
+                }
+                furi_string_printf(
+                    file_path, "%s/%s", furi_string_get_cstr(folder), file_name);
+                ctx->file_progress = 0;
+                timing_tuner_file_read(ctx, storage, furi_string_get_cstr(file_path));
+            }
+        }
+        storage_dir_close(dir);
+        storage_file_free(dir);
+
+        furi_string_free(file_path);
+        furi_string_free(folder);
+    }
+
+    furi_record_close(RECORD_STORAGE);
+    ctx->file_done = true;
+    return 0;
+}
+
+static void timing_tuner_file_start(TimingTunerContext* ctx, bool folder) {
+    furi_mutex_acquire(ctx->mutex, FuriWaitForever);
+    ctx->has_match = false;
+    ctx->show_rank = false;
+    ctx->scroll_offset = 0;
+    ctx->cluster_count = 0;
+    furi_mutex_release(ctx->mutex);
+
+    ctx->file_folder = folder;
+    ctx->file_cancel = false;
+    ctx->file_done = false;
+    ctx->file_progress = 0;
+    ctx->files_read = 0;
+    ctx->files_skipped = 0;
+    ctx->reports_saved = 0;
+    ctx->file_worker = furi_thread_alloc_ex(
+        "ProtoPirateTiming", FILE_WORKER_STACK, timing_tuner_file_worker, ctx);
+    furi_thread_start(ctx->file_worker);
+}
+
+static void timing_tuner_file_stop(TimingTunerContext* ctx) {
+    if(ctx->file_worker) {
+        ctx->file_cancel = true;
+        furi_thread_join(ctx->file_worker);
+        furi_thread_free(ctx->file_worker);
+        ctx->file_worker = NULL;
+    }
+}
+
 static bool timing_tuner_input_callback(InputEvent* event, void* context) {
     ProtoPirateApp* app = context;
     bool consumed = false;
@@ -486,30 +812,60 @@ static bool timing_tuner_input_callback(InputEvent* event, void* context) {
             }
             break;
         case InputKeyOk:
-            if(event->type == InputTypeShort && g_timing_ctx && g_timing_ctx->has_match) {
+            if(event->type == InputTypeShort && g_timing_ctx &&
+               g_timing_ctx->mode == ProtoPirateTimingTunerModeFile) {
+                // A file's results lead on to every .sub in its folder
+                if(g_timing_ctx->has_match && !g_timing_ctx->show_rank &&
+                   !g_timing_ctx->file_worker) {
+                    timing_tuner_file_start(g_timing_ctx, true);
+                }
+                consumed = true;
+            } else if(event->type == InputTypeShort && g_timing_ctx && g_timing_ctx->show_rank) {
+                furi_mutex_acquire(g_timing_ctx->mutex, FuriWaitForever);
+                protopirate_timing_fit_reset(g_timing_ctx->fit);
+                furi_mutex_release(g_timing_ctx->mutex);
+                consumed = true;
+            } else if(event->type == InputTypeShort && g_timing_ctx && g_timing_ctx->has_match) {
+                furi_mutex_acquire(g_timing_ctx->mutex, FuriWaitForever);
+                protopirate_timing_estimator_reset(&g_timing_ctx->estimator);
                 g_timing_ctx->has_match = false;
-                g_timing_ctx->write_idx = 0;
-                g_timing_ctx->sample_count = 0;
-                g_timing_ctx->buffer_wrapped = false;
+                g_timing_ctx->cluster_count = 0;
                 g_timing_ctx->timing_info = NULL;
                 g_timing_ctx->scroll_offset = 0;
+                furi_mutex_release(g_timing_ctx->mutex);
+                consumed = true;
+            } else if(event->type == InputTypeShort && g_timing_ctx) {
+                // Results from the clusters alone, for a fob no protocol decodes
+                if(timing_tuner_show_results(g_timing_ctx, "Unknown", NULL)) {
+                    notification_message(app->notifications, &sequence_success);
+                }
                 consumed = true;
             }
             break;
         case InputKeyLeft:
-            if(event->type == InputTypeShort) {
+            if(event->type == InputTypeShort && g_timing_ctx &&
+               g_timing_ctx->mode == ProtoPirateTimingTunerModeRadio) {
                 view_dispatcher_send_custom_event(app->view_dispatcher, 1);
                 consumed = true;
             }
             break;
+        case InputKeyRight:
+            if(event->type == InputTypeShort && g_timing_ctx) {
+                // Ranks every protocol against what was heard so far, one press for a guess
+                g_timing_ctx->show_rank = !g_timing_ctx->show_rank;
+                g_timing_ctx->scroll_offset = 0;
+                consumed = true;
+            }
+            break;
         case InputKeyUp:
-            if(g_timing_ctx && g_timing_ctx->has_match && g_timing_ctx->scroll_offset > 0) {
+            if(g_timing_ctx && (g_timing_ctx->has_match || g_timing_ctx->show_rank) &&
+               g_timing_ctx->scroll_offset > 0) {
                 g_timing_ctx->scroll_offset--;
                 consumed = true;
             }
             break;
         case InputKeyDown:
-            if(g_timing_ctx && g_timing_ctx->has_match) {
+            if(g_timing_ctx && (g_timing_ctx->has_match || g_timing_ctx->show_rank)) {
                 uint8_t max_scroll = 0;
                 if(g_timing_ctx->total_lines > VISIBLE_LINES) {
                     max_scroll = g_timing_ctx->total_lines - VISIBLE_LINES;
@@ -539,50 +895,45 @@ static void timing_tuner_rx_callback(
     if(!ctx || ctx->has_match) return;
 
     const char* protocol_name = decoder_base->protocol->name;
-    ctx->matched_protocol = protocol_name;
 
     FURI_LOG_I(TAG, "Matched protocol: %s", protocol_name);
 
-    ctx->timing_info = protopirate_get_protocol_timing(protocol_name);
+    const ProtoPirateProtocolInfo* info = protopirate_protocol_find_info(protocol_name);
+    const SubGhzBlockConst* timing_info = info ? info->timing : NULL;
 
-    if(ctx->timing_info) {
+    if(timing_info) {
         FURI_LOG_I(
             TAG,
-            "Found timing for %s: short=%lu, long=%lu, delta=%lu",
-            ctx->timing_info->name,
-            ctx->timing_info->te_short,
-            ctx->timing_info->te_long,
-            ctx->timing_info->te_delta);
+            "Found timing for %s: short=%u, long=%u, delta=%u",
+            protocol_name,
+            timing_info->te_short,
+            timing_info->te_long,
+            timing_info->te_delta);
     } else {
         FURI_LOG_W(TAG, "No timing info found for protocol: %s", protocol_name);
     }
 
-    calculate_timing_stats(ctx);
-
-    ctx->has_match = true;
-    ctx->scroll_offset = 0;
-
-    notification_message(app->notifications, &sequence_success);
+    if(timing_tuner_show_results(ctx, protocol_name, timing_info)) {
+        notification_message(app->notifications, &sequence_success);
+    }
 }
 
 static void timing_tuner_pair_callback(void* context, bool level, uint32_t duration) {
     UNUSED(context);
     TimingTunerContext* ctx = g_timing_ctx;
 
-    if(ctx && !ctx->has_match) {
-        // Ring buffer - always write, wrap around if needed
-        ctx->samples[ctx->write_idx] = level ? (int32_t)duration : -(int32_t)duration;
-        ctx->write_idx++;
-        ctx->sample_count++;
-
-        if(ctx->write_idx >= MAX_TIMING_SAMPLES) {
-            ctx->write_idx = 0;
-            ctx->buffer_wrapped = true;
+    if(ctx) {
+        // O(1) per pulse, the clusters are only looked for on ticks and matches
+        furi_mutex_acquire(ctx->mutex, FuriWaitForever);
+        if(!ctx->has_match) {
+            protopirate_timing_estimator_add(&ctx->estimator, duration);
         }
+        protopirate_timing_fit_add(ctx->fit, duration);
+        furi_mutex_release(ctx->mutex);
     }
 
-    if(ctx && ctx->app && ctx->app->txrx && ctx->app->txrx->receiver) {
-        subghz_receiver_decode(ctx->app->txrx->receiver, level, duration);
+    if(ctx && ctx->app && ctx->app->txrx && ctx->app->txrx->dispatch) {
+        protopirate_dispatch_feed(ctx->app->txrx->dispatch, level, duration);
     }
 }
 
@@ -599,19 +950,47 @@ void protopirate_scene_timing_tuner_on_enter(void* context) {
     g_timing_ctx->timing_info = NULL;
     g_timing_ctx->scroll_offset = 0;
     g_timing_ctx->total_lines = 0;
-    g_timing_ctx->write_idx = 0;
-    g_timing_ctx->sample_count = 0;
-    g_timing_ctx->buffer_wrapped = false;
+    g_timing_ctx->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    protopirate_timing_estimator_reset(&g_timing_ctx->estimator);
+    g_timing_ctx->fit = protopirate_timing_fit_alloc();
+    g_timing_ctx->rank = malloc(protopirate_protocol_count() * sizeof(ProtoPirateTimingFitResult));
+    g_timing_ctx->rank_count = 0;
+    g_timing_ctx->show_rank = false;
+    g_timing_ctx->mode =
+        scene_manager_get_scene_state(app->scene_manager, ProtoPirateSceneTimingTuner);
+    g_timing_ctx->file_path = furi_string_alloc_set(SUBGHZ_APP_FOLDER);
     g_timing_ctx->app = app;
 
     view_set_draw_callback(app->view_about, timing_tuner_draw_callback);
     view_set_input_callback(app->view_about, timing_tuner_input_callback);
     view_set_context(app->view_about, app);
 
+    if(g_timing_ctx->mode == ProtoPirateTimingTunerModeFile) {
+        DialogsFileBrowserOptions browser_options;
+        dialog_file_browser_set_basic_options(
+            &browser_options, PROTOPIRATE_APP_EXTENSION, NULL);
+        browser_options.base_path = SUBGHZ_APP_FOLDER;
+        browser_options.hide_ext = false;
+
+        DialogsApp* dialogs = furi_record_open(RECORD_DIALOGS);
+        bool selected = dialog_file_browser_show(
+            dialogs, g_timing_ctx->file_path, g_timing_ctx->file_path, &browser_options);
+        furi_record_close(RECORD_DIALOGS);
+
+        if(selected) {
+            FURI_LOG_I(TAG, "Timing file: %s", furi_string_get_cstr(g_timing_ctx->file_path));
+            timing_tuner_file_start(g_timing_ctx, false);
+            view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewAbout);
+        } else {
+            scene_manager_previous_scene(app->scene_manager);
+        }
+        return;
+    }
+
     subghz_receiver_set_rx_callback(app->txrx->receiver, timing_tuner_rx_callback, app);
 
-    subghz_worker_set_pair_callback(
-        app->txrx->worker, (SubGhzWorkerPairCallback)timing_tuner_pair_callback);
+    protopirate_pulse_ring_set_pair_callback(
+        app->txrx->pulse_ring, (SubGhzWorkerPairCallback)timing_tuner_pair_callback);
 
     protopirate_begin(app, app->txrx->preset->data);
     protopirate_rx(app, app->txrx->preset->frequency);
@@ -640,6 +1019,38 @@ bool protopirate_scene_timing_tuner_on_event(void* context, SceneManagerEvent ev
         if(g_timing_ctx && g_timing_ctx->is_receiving && !g_timing_ctx->has_match) {
             g_timing_ctx->rssi = subghz_devices_get_rssi(app->txrx->radio_device);
         }
+        if(g_timing_ctx && g_timing_ctx->file_worker && g_timing_ctx->file_done) {
+            bool folder = g_timing_ctx->file_folder;
+            timing_tuner_file_stop(g_timing_ctx);
+            if(folder) {
+                FURI_LOG_I(
+                    TAG,
+                    "Folder done: %lu read, %lu skipped, %lu reports",
+                    g_timing_ctx->files_read,
+                    g_timing_ctx->files_skipped,
+                    g_timing_ctx->reports_saved);
+                notification_message(app->notifications, &sequence_success);
+            } else if(
+                g_timing_ctx->files_read > 0 &&
+                timing_tuner_show_results(
+                    g_timing_ctx, timing_tuner_file_name(g_timing_ctx), NULL)) {
+                notification_message(app->notifications, &sequence_success);
+            } else {
+                notification_message(app->notifications, &sequence_error);
+            }
+        }
+        if(g_timing_ctx) {
+            // Live figures while listening
+            furi_mutex_acquire(g_timing_ctx->mutex, FuriWaitForever);
+            if(!g_timing_ctx->has_match) {
+                calculate_timing_stats(g_timing_ctx);
+            }
+            if(g_timing_ctx->show_rank) {
+                g_timing_ctx->rank_count = protopirate_timing_fit_rank(
+                    g_timing_ctx->fit, g_timing_ctx->rank, protopirate_protocol_count());
+            }
+            furi_mutex_release(g_timing_ctx->mutex);
+        }
         view_commit_model(app->view_about, false);
         consumed = true;
     }
@@ -655,14 +1066,21 @@ void protopirate_scene_timing_tuner_on_exit(void* context) {
     if(g_timing_ctx && g_timing_ctx->is_receiving) {
         protopirate_rx_end(app);
     }
+    if(g_timing_ctx) {
+        timing_tuner_file_stop(g_timing_ctx);
+    }
 
-    subghz_worker_set_pair_callback(
-        app->txrx->worker, (SubGhzWorkerPairCallback)subghz_receiver_decode);
+    protopirate_pulse_ring_set_pair_callback(
+        app->txrx->pulse_ring, (SubGhzWorkerPairCallback)protopirate_dispatch_feed);
 
     view_set_draw_callback(app->view_about, NULL);
     view_set_input_callback(app->view_about, NULL);
 
     if(g_timing_ctx) {
+        protopirate_timing_fit_free(g_timing_ctx->fit);
+        free(g_timing_ctx->rank);
+        furi_string_free(g_timing_ctx->file_path);
+        furi_mutex_free(g_timing_ctx->mutex);
         free(g_timing_ctx);
         g_timing_ctx = NULL;
     }
@@ -0,0 +1,1266 @@
+// tools/bench/bench_main.c
+// Replays RAW .sub captures through every decoder in protopirate_protocol_registry
+// and reports per-decoder cost: ns per fed pulse, decode count and allocations.
+#include "bench_stubs.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "../../protocols/protocol_items.h"
+#include "../../protocols/protocol_dispatch.h"
+#include "../../protocols/protocol_checksum.h"
+#include "../../protocols/protocol_trace.h"
+#include "../../protopirate_history.h"
+#include "../../helpers/protopirate_timing_cluster.h"
+#include "../../helpers/protopirate_timing_fit.h"
+#include <lib/subghz/blocks/decoder.h>
+#include <lib/subghz/blocks/encoder.h>
+#include <lib/subghz/blocks/generic.h>
+
+#define BENCH_DEFAULT_REPEATS 20
+#define BENCH_MAX_FILES       256
+#define BENCH_CHECKSUM_FRAMES 1000000
+#define BENCH_ROUND_TRIP_KEYS 16
+#define BENCH_ROUND_TRIP_MAX  8192
+#define BENCH_GLITCH_EVERY    32 // One corpus pulse in this many gets a glitch cut in
+#define BENCH_GLITCH_MAX      640 // us, past every decoder's te_short - te_delta
+
+typedef struct {
+    char* path;
+    int32_t* samples;
+    size_t count;
+} BenchCapture;
+
+typedef struct {
+    const SubGhzProtocol* protocol;
+    void* decoder;
+    uint64_t alloc_allocs;
+    uint64_t alloc_bytes;
+    uint64_t pulses;
+    uint64_t feed_ns;
+    uint64_t feed_allocs;
+    uint64_t decodes;
+    // Callback bookkeeping, excluded from the feed figures
+    uint64_t callback_ns;
+    uint64_t callback_allocs;
+    uint32_t file_decodes;
+    bool verbose;
+    FuriString* last_decode;
+} BenchDecoder;
+
+static BenchCapture bench_captures[BENCH_MAX_FILES];
+static size_t bench_capture_count = 0;
+
+static void bench_decode_callback(SubGhzProtocolDecoderBase* base, void* context) {
+    BenchDecoder* entry = context;
+    uint64_t start = bench_time_ns();
+    uint64_t allocs = bench_alloc_stats.allocs;
+
+    entry->file_decodes++;
+    if(entry->verbose && entry->protocol->decoder->get_string) {
+        furi_string_reset(entry->last_decode);
+        entry->protocol->decoder->get_string(base, entry->last_decode);
+    }
+
+    entry->callback_allocs += bench_alloc_stats.allocs - allocs;
+    entry->callback_ns += bench_time_ns() - start;
+}
+
+static bool bench_load_capture(const char* path) {
+    if(bench_capture_count >= BENCH_MAX_FILES) return false;
+
+    FILE* file = fopen(path, "r");
+    if(!file) {
+        fprintf(stderr, "bench: cannot open %s\n", path);
+        return false;
+    }
+
+    size_t capacity = 4096;
+    BenchCapture capture = {
+        .path = strdup(path),
+        .samples = bench_malloc(capacity * sizeof(int32_t)),
+        .count = 0,
+    };
+
+    char* line = NULL;
+    size_t line_size = 0;
+    while(getline(&line, &line_size, file) >= 0) {
+        if(strncmp(line, "RAW_Data:", 9) != 0) continue;
+
+        const char* cursor = line + 9;
+        char* end;
+        for(;;) {
+            long value = strtol(cursor, &end, 10);
+            if(end == cursor) break;
+            cursor = end;
+            if(value == 0) continue;
+            if(capture.count == capacity) {
+                capacity *= 2;
+                capture.samples = bench_realloc(capture.samples, capacity * sizeof(int32_t));
+            }
+            capture.samples[capture.count++] = (int32_t)value;
+        }
+    }
+    free(line);
+    fclose(file);
+
+    if(capture.count == 0) {
+        free(capture.path);
+        bench_free(capture.samples);
+        return false;
+    }
+
+    bench_captures[bench_capture_count++] = capture;
+    return true;
+}
+
+static bool bench_has_suffix(const char* name, const char* suffix) {
+    size_t name_len = strlen(name);
+    size_t suffix_len = strlen(suffix);
+    return name_len >= suffix_len && strcmp(name + name_len - suffix_len, suffix) == 0;
+}
+
+static int bench_compare_names(const void* a, const void* b) {
+    return strcmp(*(const char* const*)a, *(const char* const*)b);
+}
+
+static void bench_load_path(const char* path) {
+    struct stat st;
+    if(stat(path, &st) != 0) {
+        fprintf(stderr, "bench: cannot stat %s\n", path);
+        return;
+    }
+
+    if(!S_ISDIR(st.st_mode)) {
+        bench_load_capture(path);
+        return;
+    }
+
+    DIR* dir = opendir(path);
+    if(!dir) return;
+
+    char* names[BENCH_MAX_FILES];
+    size_t name_count = 0;
+    struct dirent* entry;
+    while((entry = readdir(dir)) && name_count < BENCH_MAX_FILES) {
+        if(bench_has_suffix(entry->d_name, ".sub")) {
+            names[name_count++] = strdup(entry->d_name);
+        }
+    }
+    closedir(dir);
+
+    // Sorted so runs are comparable between machines
+    qsort(names, name_count, sizeof(char*), bench_compare_names);
+    for(size_t i = 0; i < name_count; i++) {
+        char full[1024];
+        snprintf(full, sizeof(full), "%s/%s", path, names[i]);
+        bench_load_capture(full);
+        free(names[i]);
+    }
+}
+
+static void bench_feed_capture(BenchDecoder* entry, const BenchCapture* capture) {
+    const SubGhzProtocolDecoder* decoder = entry->protocol->decoder;
+    for(size_t i = 0; i < capture->count; i++) {
+        int32_t duration = capture->samples[i];
+        bool level = (duration >= 0);
+        if(duration < 0) duration = -duration;
+        decoder->feed(entry->decoder, level, (uint32_t)duration);
+    }
+}
+
+typedef struct {
+    const SubGhzProtocol* protocol;
+    void* decoder;
+    uint32_t decodes;
+} BenchPipelineSlot;
+
+static void bench_pipeline_callback(SubGhzProtocolDecoderBase* base, void* context) {
+    UNUSED(base);
+    BenchPipelineSlot* slot = context;
+    slot->decodes++;
+}
+
+// Whole receive pipeline: every pulse of the captures to every decoder, either directly or
+// through protopirate_dispatch. Returns ns per pulse and checks both see the same decodes.
+static bool bench_pipeline(
+    const BenchCapture* captures,
+    size_t capture_count,
+    uint32_t repeats,
+    bool use_dispatch,
+    uint32_t* decodes,
+    double* ns) {
+    const SubGhzProtocolRegistry* registry = &protopirate_protocol_registry;
+    BenchPipelineSlot* slots = bench_malloc(registry->size * sizeof(BenchPipelineSlot));
+    ProtoPirateDispatch* dispatch = protopirate_dispatch_alloc();
+
+    for(size_t p = 0; p < registry->size; p++) {
+        slots[p].protocol = registry->items[p];
+        slots[p].decoder = slots[p].protocol->decoder->alloc(NULL);
+        SubGhzProtocolDecoderBase* base = slots[p].decoder;
+        base->callback = bench_pipeline_callback;
+        base->context = &slots[p];
+        protopirate_dispatch_add(dispatch, slots[p].protocol, slots[p].decoder);
+    }
+
+    uint64_t elapsed = 0;
+    uint64_t pulses = 0;
+    for(size_t f = 0; f < capture_count; f++) {
+        const BenchCapture* capture = &captures[f];
+        uint64_t start = bench_time_ns();
+        for(uint32_t r = 0; r < repeats; r++) {
+            protopirate_dispatch_reset(dispatch);
+            for(size_t i = 0; i < capture->count; i++) {
+                int32_t duration = capture->samples[i];
+                bool level = (duration >= 0);
+                if(duration < 0) duration = -duration;
+                if(use_dispatch) {
+                    protopirate_dispatch_feed(dispatch, level, (uint32_t)duration);
+                } else {
+                    for(size_t p = 0; p < registry->size; p++) {
+                        slots[p].protocol->decoder->feed(
+                            slots[p].decoder, level, (uint32_t)duration);
+                    }
+                }
+            }
+        }
+        elapsed += bench_time_ns() - start;
+        pulses += (uint64_t)capture->count * repeats;
+    }
+
+    for(size_t p = 0; p < registry->size; p++) {
+        decodes[p] = slots[p].decodes / repeats;
+        (slots[p].protocol->decoder->free)(slots[p].decoder);
+    }
+    protopirate_dispatch_free(dispatch);
+    bench_free(slots);
+
+    *ns = pulses ? (double)elapsed / pulses : 0;
+    return true;
+}
+
+typedef struct {
+    const SubGhzProtocol* protocol;
+    void* decoder;
+    ProtoPirateHistory* history;
+    SubGhzRadioPreset* preset;
+    FuriString* expected;
+    FuriString* actual;
+    uint32_t checked;
+    uint32_t repeats;
+    uint32_t mismatched;
+    bool verbose;
+} BenchHistorySlot;
+
+// Layout every registry decoder starts with, lets the ring test set a key directly
+typedef struct {
+    SubGhzProtocolDecoderBase base;
+    SubGhzBlockDecoder decoder;
+    SubGhzBlockGeneric generic;
+} BenchDecoderHead;
+
+static void bench_history_report(BenchHistorySlot* slot, const char* what) {
+    slot->mismatched++;
+    if(slot->verbose) {
+        printf(
+            "MISMATCH %s %s\n--- expected\n%s\n--- history\n%s\n",
+            slot->protocol->name,
+            what,
+            furi_string_get_cstr(slot->expected),
+            furi_string_get_cstr(slot->actual));
+    }
+}
+
+static void bench_history_callback(SubGhzProtocolDecoderBase* base, void* context) {
+    BenchHistorySlot* slot = context;
+    if(!protopirate_history_add_to_history(slot->history, base, slot->preset, -60.0f)) {
+        slot->repeats++;
+        return;
+    }
+    uint16_t idx = protopirate_history_get_item(slot->history) - 1;
+    slot->checked++;
+
+    // Saved form: the record rebuilt must match what the decoder serialized
+    FlipperFormat* original = flipper_format_string_alloc();
+    FlipperFormat* rebuilt = flipper_format_string_alloc();
+    slot->protocol->decoder->serialize(base, original, slot->preset);
+    protopirate_history_get_raw_data(slot->history, idx, rebuilt);
+    furi_string_set(slot->expected, flipper_format_get_raw_stream_string(original));
+    furi_string_set(slot->actual, flipper_format_get_raw_stream_string(rebuilt));
+    bool raw_ok = furi_string_equal(slot->expected, slot->actual);
+    flipper_format_free(original);
+    flipper_format_free(rebuilt);
+    if(!raw_ok) {
+        bench_history_report(slot, "saved form");
+        return;
+    }
+
+    // Display text: rebuilt through a fresh decoder
+    furi_string_reset(slot->expected);
+    slot->protocol->decoder->get_string(base, slot->expected);
+    protopirate_history_get_text_item(slot->history, slot->actual, idx);
+    if(!furi_string_equal(slot->expected, slot->actual)) {
+        bench_history_report(slot, "text");
+    }
+}
+
+// Wraps the ring several times with distinct keys: every key still held must be found
+// as a repeat, and nothing evicted may be, which exercises removal from the key index
+static bool bench_history_ring(void) {
+    const SubGhzProtocol* protocol = protopirate_protocol_registry.items[0];
+    ProtoPirateHistory* history = protopirate_history_alloc(NULL);
+    SubGhzRadioPreset preset = {
+        .name = furi_string_alloc_set_str("AM650"),
+        .frequency = 433920000,
+    };
+    BenchDecoderHead* head = protocol->decoder->alloc(NULL);
+    const uint32_t total = KIA_HISTORY_MAX * 4 + 7;
+    uint32_t errors = 0;
+
+    head->generic.data_count_bit = 61;
+    for(uint32_t i = 0; i < total; i++) {
+        // Multiplied so keys land all over the table rather than in one probe run
+        head->generic.data = (uint64_t)i * 0x9E3779B1u;
+        if(!protopirate_history_add_to_history(history, head, &preset, -60.0f)) errors++;
+    }
+    for(uint32_t i = total - KIA_HISTORY_MAX; i < total; i++) {
+        head->generic.data = (uint64_t)i * 0x9E3779B1u;
+        if(protopirate_history_add_to_history(history, head, &preset, -60.0f)) errors++;
+    }
+    for(uint32_t i = 0; i < KIA_HISTORY_MAX / 2; i++) {
+        head->generic.data = (uint64_t)i * 0x9E3779B1u;
+        if(!protopirate_history_add_to_history(history, head, &preset, -60.0f)) errors++;
+    }
+    if(protopirate_history_get_item(history) != KIA_HISTORY_MAX) errors++;
+
+    printf(
+        "%-12s %6lu keys    %6lu errors\n", "Ring", (unsigned long)total, (unsigned long)errors);
+
+    (protocol->decoder->free)(head);
+    furi_string_free(preset.name);
+    protopirate_history_free(history);
+    return errors == 0;
+}
+
+// One more preset than history shares: the extra one is kept inline, and every record
+// must keep the preset it came with. Wrapping the ring with a shared preset then reuses
+// the inline record's slot, which must read the shared name.
+static bool bench_history_presets(void) {
+    const SubGhzProtocol* protocol = protopirate_protocol_registry.items[0];
+    ProtoPirateHistory* history = protopirate_history_alloc(NULL);
+    SubGhzRadioPreset preset = {.name = furi_string_alloc(), .frequency = 433920000};
+    BenchDecoderHead* head = protocol->decoder->alloc(NULL);
+    const uint32_t presets = 9;
+    uint32_t stored = 0;
+    uint32_t errors = 0;
+    char name[PROTOPIRATE_CAPTURE_PRESET_SIZE];
+
+    head->generic.data_count_bit = 61;
+    for(uint32_t i = 0; i < presets; i++) {
+        snprintf(name, sizeof(name), "Preset%lu", (unsigned long)i);
+        furi_string_set_str(preset.name, name);
+        head->generic.data = (uint64_t)(i + 1) * 0x9E3779B1u;
+        if(protopirate_history_add_to_history(history, head, &preset, -60.0f)) stored++;
+    }
+    if(stored != presets) errors++;
+
+    for(uint16_t idx = 0; idx < protopirate_history_get_item(history); idx++) {
+        ProtoPirateCapture capture;
+        snprintf(name, sizeof(name), "Preset%u", idx);
+        if(!protopirate_history_get_capture(history, idx, &capture) ||
+           strcmp(capture.preset, name) != 0) {
+            errors++;
+        }
+    }
+
+    furi_string_set_str(preset.name, "Preset0");
+    for(uint32_t i = 0; i < KIA_HISTORY_MAX; i++) {
+        head->generic.data = (uint64_t)(presets + i + 1) * 0x9E3779B1u;
+        if(!protopirate_history_add_to_history(history, head, &preset, -60.0f)) errors++;
+    }
+    for(uint16_t idx = 0; idx < protopirate_history_get_item(history); idx++) {
+        ProtoPirateCapture capture;
+        if(!protopirate_history_get_capture(history, idx, &capture) ||
+           strcmp(capture.preset, "Preset0") != 0) {
+            errors++;
+        }
+    }
+
+    printf(
+        "%-12s %6lu stored  %6lu errors\n",
+        "Presets",
+        (unsigned long)stored,
+        (unsigned long)errors);
+
+    (protocol->decoder->free)(head);
+    furi_string_free(preset.name);
+    protopirate_history_free(history);
+    return errors == 0;
+}
+
+// Every decode goes into protopirate_history and is read back, which must reproduce
+// the decoder's own serialize and get_string output. Returns false on any mismatch.
+static bool bench_history(bool verbose) {
+    const SubGhzProtocolRegistry* registry = &protopirate_protocol_registry;
+    ProtoPirateHistory* history = protopirate_history_alloc(NULL);
+    SubGhzRadioPreset preset = {
+        .name = furi_string_alloc_set_str("AM650"),
+        .frequency = 433920000,
+    };
+    bool result = true;
+
+    printf("\nHistory round trip\n");
+    for(size_t p = 0; p < registry->size; p++) {
+        BenchHistorySlot slot = {
+            .protocol = registry->items[p],
+            .history = history,
+            .preset = &preset,
+            .expected = furi_string_alloc(),
+            .actual = furi_string_alloc(),
+            .verbose = verbose,
+        };
+        slot.decoder = slot.protocol->decoder->alloc(NULL);
+        SubGhzProtocolDecoderBase* base = slot.decoder;
+        base->callback = bench_history_callback;
+        base->context = &slot;
+
+        // The second pass only repeats what history already holds
+        uint32_t stored = 0;
+        for(size_t pass = 0; pass < 2; pass++) {
+            for(size_t f = 0; f < bench_capture_count; f++) {
+                BenchDecoder entry = {.protocol = slot.protocol, .decoder = slot.decoder};
+                slot.protocol->decoder->reset(slot.decoder);
+                bench_feed_capture(&entry, &bench_captures[f]);
+            }
+            if(pass == 0) stored = slot.checked;
+        }
+        if(slot.checked != stored) {
+            bench_history_report(&slot, "repeat stored again");
+        }
+
+        if(slot.checked) {
+            printf(
+                "%-12s %6lu checked %6lu repeats %6lu mismatched\n",
+                slot.protocol->name,
+                (unsigned long)slot.checked,
+                (unsigned long)slot.repeats,
+                (unsigned long)slot.mismatched);
+        }
+        if(slot.mismatched) result = false;
+
+        (slot.protocol->decoder->free)(slot.decoder);
+        furi_string_free(slot.expected);
+        furi_string_free(slot.actual);
+    }
+
+    furi_string_free(preset.name);
+    protopirate_history_free(history);
+    bool ring_match = bench_history_ring();
+    return bench_history_presets() && ring_match && result;
+}
+
+// Dispatch run with a near-miss capture attached, drained after every pulse. Each
+// snippet has to be cut from the stream and each protocol's misses bounded by its locks.
+static bool bench_near_miss(bool verbose) {
+    const SubGhzProtocolRegistry* registry = &protopirate_protocol_registry;
+    BenchPipelineSlot* slots = bench_malloc(registry->size * sizeof(BenchPipelineSlot));
+    uint32_t* misses = bench_malloc(registry->size * sizeof(uint32_t));
+    ProtoPirateDispatch* dispatch = protopirate_dispatch_alloc();
+    ProtoPirateNearMiss* near_miss = protopirate_near_miss_alloc();
+    bool result = true;
+
+    protopirate_protocol_stats_reset();
+    protopirate_dispatch_set_near_miss(dispatch, near_miss);
+    for(size_t p = 0; p < registry->size; p++) {
+        slots[p].protocol = registry->items[p];
+        slots[p].decoder = slots[p].protocol->decoder->alloc(NULL);
+        slots[p].decodes = 0;
+        misses[p] = 0;
+        SubGhzProtocolDecoderBase* base = slots[p].decoder;
+        base->callback = bench_pipeline_callback;
+        base->context = &slots[p];
+        protopirate_dispatch_add(dispatch, slots[p].protocol, slots[p].decoder);
+    }
+
+    for(size_t f = 0; f < bench_capture_count; f++) {
+        const BenchCapture* capture = &bench_captures[f];
+        protopirate_dispatch_reset(dispatch);
+        for(size_t i = 0; i < capture->count; i++) {
+            int32_t duration = capture->samples[i];
+            bool level = (duration >= 0);
+            if(duration < 0) duration = -duration;
+            protopirate_dispatch_feed(dispatch, level, (uint32_t)duration);
+
+            const ProtoPirateNearMissSnippet* snippet;
+            while((snippet = protopirate_near_miss_take(near_miss)) != NULL) {
+                int32_t index = protopirate_protocol_index(
+                    protopirate_protocol_find_info(snippet->protocol)->protocol);
+                misses[index]++;
+
+                // The snippet ends with the pulse just fed
+                if(snippet->count == 0 || snippet->count > i + 1 ||
+                   snippet->pulses[snippet->count - 1] != capture->samples[i]) {
+                    result = false;
+                    printf("MISMATCH %s: near miss not cut from the stream\n", snippet->protocol);
+                }
+                if(verbose) {
+                    printf(
+                        "  %s: %s, step %u, %u pulses\n",
+                        snippet->protocol,
+                        snippet->reason,
+                        snippet->step,
+                        snippet->count);
+                }
+                protopirate_near_miss_release(near_miss, snippet);
+            }
+        }
+    }
+
+    uint32_t captured, dropped;
+    protopirate_near_miss_get_counts(near_miss, &captured, &dropped);
+    printf("\n%-12s %8s %8s\n", "Near misses", "locks", "misses");
+    for(size_t p = 0; p < registry->size; p++) {
+        const ProtoPirateProtocolStats* stats = protopirate_protocol_stats_get(registry->items[p]);
+        printf(
+            "%-12s %8lu %8lu\n",
+            registry->items[p]->name,
+            (unsigned long)stats->preamble_locks,
+            (unsigned long)misses[p]);
+        if(misses[p] > stats->preamble_locks) {
+            result = false;
+            printf("MISMATCH %s: more near misses than locks\n", registry->items[p]->name);
+        }
+        (slots[p].protocol->decoder->free)(slots[p].decoder);
+    }
+    if(dropped) {
+        result = false;
+        printf("MISMATCH %lu near misses dropped while drained\n", (unsigned long)dropped);
+    }
+
+    protopirate_near_miss_free(near_miss);
+    protopirate_dispatch_free(dispatch);
+    bench_free(misses);
+    bench_free(slots);
+    return result;
+}
+
+static void bench_cluster_format(
+    const ProtoPirateTimingClusters* clusters,
+    int8_t index,
+    char* buf,
+    size_t size) {
+    if(index < 0) {
+        snprintf(buf, size, "-");
+    } else {
+        snprintf(
+            buf,
+            size,
+            "%lu+-%lu",
+            (unsigned long)clusters->clusters[index].mean,
+            (unsigned long)clusters->clusters[index].spread);
+    }
+}
+
+// Streams every capture through the timing estimator and shows the clusters it finds.
+// The clusters have to come out in order of duration, each inside its own range.
+static bool bench_timing_clusters(void) {
+    ProtoPirateTimingEstimator* estimator = bench_malloc(sizeof(ProtoPirateTimingEstimator));
+    ProtoPirateTimingClusters clusters;
+    bool result = true;
+    uint64_t elapsed = 0;
+    uint64_t pulses = 0;
+
+    printf("\n%-28s %12s %12s %14s\n", "Timing clusters", "short", "long", "gap");
+    for(size_t f = 0; f < bench_capture_count; f++) {
+        const BenchCapture* capture = &bench_captures[f];
+        protopirate_timing_estimator_reset(estimator);
+
+        uint64_t start = bench_time_ns();
+        for(size_t i = 0; i < capture->count; i++) {
+            int32_t duration = capture->samples[i];
+            protopirate_timing_estimator_add(
+                estimator, (uint32_t)(duration < 0 ? -duration : duration));
+        }
+        elapsed += bench_time_ns() - start;
+        pulses += capture->count;
+
+        protopirate_timing_estimator_find(estimator, &clusters);
+        for(uint8_t c = 0; c < clusters.count; c++) {
+            const ProtoPirateTimingCluster* cluster = &clusters.clusters[c];
+            if(cluster->mean < cluster->min || cluster->mean > cluster->max ||
+               (c > 0 && cluster->mean < clusters.clusters[c - 1].mean)) {
+                result = false;
+                printf("MISMATCH %s: cluster %u out of order\n", capture->path, c);
+            }
+        }
+
+        char short_str[16], long_str[16], gap_str[16];
+        bench_cluster_format(&clusters, clusters.short_index, short_str, sizeof(short_str));
+        bench_cluster_format(&clusters, clusters.long_index, long_str, sizeof(long_str));
+        bench_cluster_format(&clusters, clusters.gap_index, gap_str, sizeof(gap_str));
+        const char* name = strrchr(capture->path, '/');
+        printf(
+            "%-28.28s %12s %12s %14s\n",
+            name ? name + 1 : capture->path,
+            short_str,
+            long_str,
+            gap_str);
+    }
+    printf("%-28s %12.2f ns/pulse\n", "add", pulses ? (double)elapsed / pulses : 0);
+
+    bench_free(estimator);
+    return result;
+}
+
+// Streams every capture through the timing fit and shows the best ranked protocols.
+// The ranking has to come out sorted, with every registry protocol in it.
+static bool bench_timing_fit(void) {
+    ProtoPirateTimingFit* fit = protopirate_timing_fit_alloc();
+    size_t protocol_count = protopirate_protocol_count();
+    ProtoPirateTimingFitResult* results =
+        bench_malloc(protocol_count * sizeof(ProtoPirateTimingFitResult));
+    bool result = true;
+    uint64_t elapsed = 0;
+    uint64_t pulses = 0;
+
+    printf("\n%-28s %16s %16s %16s\n", "Timing fit", "first", "second", "third");
+    for(size_t f = 0; f < bench_capture_count; f++) {
+        const BenchCapture* capture = &bench_captures[f];
+        protopirate_timing_fit_reset(fit);
+
+        uint64_t start = bench_time_ns();
+        for(size_t i = 0; i < capture->count; i++) {
+            int32_t duration = capture->samples[i];
+            protopirate_timing_fit_add(fit, (uint32_t)(duration < 0 ? -duration : duration));
+        }
+        elapsed += bench_time_ns() - start;
+        pulses += capture->count;
+
+        size_t ranked = protopirate_timing_fit_rank(fit, results, protocol_count);
+        if(ranked != protocol_count) {
+            result = false;
+            printf(
+                "MISMATCH %s: %zu of %zu protocols ranked\n",
+                capture->path,
+                ranked,
+                protocol_count);
+        }
+        for(size_t r = 1; r < ranked; r++) {
+            if(results[r].score > results[r - 1].score) {
+                result = false;
+                printf("MISMATCH %s: rank %zu out of order\n", capture->path, r);
+            }
+        }
+
+        char top[3][24];
+        for(size_t r = 0; r < 3; r++) {
+            if(r < ranked) {
+                snprintf(
+                    top[r],
+                    sizeof(top[r]),
+                    "%s %u%%",
+                    results[r].info->protocol->name,
+                    results[r].score);
+            } else {
+                snprintf(top[r], sizeof(top[r]), "-");
+            }
+        }
+        const char* name = strrchr(capture->path, '/');
+        printf(
+            "%-28.28s %16s %16s %16s\n", name ? name + 1 : capture->path, top[0], top[1], top[2]);
+    }
+    printf("%-28s %12.2f ns/pulse\n", "add", pulses ? (double)elapsed / pulses : 0);
+
+    bench_free(results);
+    protopirate_timing_fit_free(fit);
+    return result;
+}
+
+// The bitwise routines protocol_checksum replaced, kept as the reference its tables and
+// kernels have to match
+static uint8_t bench_reference_kia_crc8(uint64_t data) {
+    uint8_t crc = 0;
+    for(int i = 6; i >= 1; i--) {
+        crc ^= (data >> (i * 8)) & 0xFF;
+        for(int j = 0; j < 8; j++) {
+            if(crc & 0x80) {
+                crc = (uint8_t)((crc << 1) ^ 0x7F);
+            } else {
+                crc <<= 1;
+            }
+        }
+    }
+    return crc;
+}
+
+static uint8_t bench_reference_parity8(uint8_t value) {
+    uint8_t parity = 0;
+    while(value) {
+        parity ^= (value & 1);
+        value >>= 1;
+    }
+    return parity;
+}
+
+// Keeps the timed loops from being optimised away
+static volatile uint8_t bench_checksum_sink;
+
+static uint64_t bench_checksum_frame(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Every byte value through the tables, then random frames timed against the reference
+static bool bench_checksums(void) {
+    bool result = true;
+    for(uint32_t byte = 0; byte < 256; byte++) {
+        if(protopirate_crc8(protopirate_crc8_kia, 0, byte, 1) !=
+           bench_reference_kia_crc8((uint64_t)byte << 8)) {
+            result = false;
+            printf("MISMATCH Kia CRC-8 table entry 0x%02lX\n", (unsigned long)byte);
+        }
+        if(protopirate_parity8(byte) != bench_reference_parity8(byte)) {
+            result = false;
+            printf("MISMATCH parity of 0x%02lX\n", (unsigned long)byte);
+        }
+    }
+
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    uint32_t mismatched = 0;
+    uint8_t sink = 0;
+    uint64_t start = bench_time_ns();
+    for(uint32_t i = 0; i < BENCH_CHECKSUM_FRAMES; i++) {
+        sink ^= bench_reference_kia_crc8(bench_checksum_frame(&state));
+    }
+    uint64_t reference_ns = bench_time_ns() - start;
+
+    state = 0x9E3779B97F4A7C15ULL;
+    start = bench_time_ns();
+    for(uint32_t i = 0; i < BENCH_CHECKSUM_FRAMES; i++) {
+        sink ^= protopirate_crc8(protopirate_crc8_kia, 0, bench_checksum_frame(&state) >> 8, 6);
+    }
+    uint64_t table_ns = bench_time_ns() - start;
+
+    state = 0x9E3779B97F4A7C15ULL;
+    for(uint32_t i = 0; i < BENCH_CHECKSUM_FRAMES; i++) {
+        uint64_t frame = bench_checksum_frame(&state);
+        if(protopirate_crc8(protopirate_crc8_kia, 0, frame >> 8, 6) !=
+           bench_reference_kia_crc8(frame)) {
+            mismatched++;
+        }
+    }
+    if(mismatched) {
+        result = false;
+        printf("MISMATCH Kia CRC-8: %lu frames\n", (unsigned long)mismatched);
+    }
+
+    printf(
+        "\n%-12s %10s %10s %10s\n"
+        "Kia CRC-8    %10.2f %10.2f %10lu\n",
+        "Checksums",
+        "ns/frame",
+        "reference",
+        "mismatched",
+        (double)table_ns / BENCH_CHECKSUM_FRAMES,
+        (double)reference_ns / BENCH_CHECKSUM_FRAMES,
+        (unsigned long)mismatched);
+
+    bench_checksum_sink = sink;
+    return result;
+}
+
+// Layout every registry encoder starts with, lets the round trip read the key it sends
+typedef struct {
+    SubGhzProtocolEncoderBase base;
+    SubGhzProtocolBlockEncoder encoder;
+    SubGhzBlockGeneric generic;
+} BenchEncoderHead;
+
+typedef struct {
+    const char* name;
+    uint64_t (*key)(uint64_t random); // A key the decoder accepts, made from random bits
+    uint32_t type; // Written as Type, for protocols that read one
+    uint32_t lead_pairs; // Short HIGH/LOW pairs sent ahead of the encoder's frame
+} BenchRoundTrip;
+
+typedef struct {
+    uint64_t sent;
+    uint32_t decodes;
+    uint32_t mismatched;
+} BenchRoundTripSlot;
+
+// 61 bits: a 0, the sync pulse as a 1, then 59 sent bits ending in the CRC
+static uint64_t bench_round_trip_kia_v0(uint64_t random) {
+    uint64_t key = (random & 0x07FFFFFFFFFFFF00ULL) | (1ULL << 59);
+    return key | bench_reference_kia_crc8(key);
+}
+
+// The manufacturer nibble is checked
+static uint64_t bench_round_trip_suzuki(uint64_t random) {
+    return random | 0xF000000000000000ULL;
+}
+
+static uint64_t bench_round_trip_any(uint64_t random) {
+    return random;
+}
+
+static const BenchRoundTrip bench_round_trips[] = {
+    {KIA_PROTOCOL_V0_NAME, bench_round_trip_kia_v0, 0, 0},
+    // The encoder sends 130 preamble pairs and the decoder wants 257 short LOWs, so the
+    // encoder's frame alone never decodes. The lead pairs keep the decoder covered.
+    {SUZUKI_PROTOCOL_NAME, bench_round_trip_suzuki, 0, 130},
+    // The decoder needs the type's top bit set, see VwDecoderStepFoundStart3
+    {VW_PROTOCOL_NAME, bench_round_trip_any, 0x80, 0},
+};
+
+static void bench_round_trip_callback(SubGhzProtocolDecoderBase* base, void* context) {
+    BenchRoundTripSlot* slot = context;
+    BenchDecoderHead* head = (BenchDecoderHead*)base;
+    slot->decodes++;
+    if(head->generic.data != slot->sent) slot->mismatched++;
+}
+
+// Runs the protocol's encoder on key until it stops, into capture, after the round trip's
+// lead pairs. Returns false if the encoder turned the key down. The key it sends is left
+// in sent.
+static bool bench_encode(
+    const SubGhzProtocol* protocol,
+    const BenchRoundTrip* round_trip,
+    uint64_t key,
+    BenchCapture* capture,
+    uint64_t* sent) {
+    uint32_t type = round_trip->type;
+    const SubGhzBlockConst* timing = protopirate_protocol_find_info(protocol->name)->timing;
+    FlipperFormat* flipper_format = flipper_format_string_alloc();
+    uint32_t bits = timing->min_count_bit_for_found;
+    uint32_t zero = 0;
+    uint8_t key_data[8];
+    for(size_t i = 0; i < sizeof(key_data); i++) {
+        key_data[i] = (uint8_t)(key >> (56 - i * 8));
+    }
+    flipper_format_write_string_cstr(flipper_format, "Protocol", protocol->name);
+    flipper_format_write_uint32(flipper_format, "Bit", &bits, 1);
+    flipper_format_write_hex(flipper_format, "Key", key_data, sizeof(key_data));
+    flipper_format_write_uint32(flipper_format, "Type", &type, 1);
+    flipper_format_write_uint32(flipper_format, "Check", &zero, 1);
+    flipper_format_rewind(flipper_format);
+
+    BenchEncoderHead* encoder = protocol->encoder->alloc(NULL);
+    bool result = protocol->encoder->deserialize(encoder, flipper_format) ==
+                  SubGhzProtocolStatusOk;
+    *sent = encoder->generic.data;
+
+    capture->count = 0;
+    for(uint32_t i = 0; i < round_trip->lead_pairs; i++) {
+        capture->samples[capture->count++] = (int32_t)timing->te_short;
+        capture->samples[capture->count++] = -(int32_t)timing->te_short;
+    }
+    while(result && capture->count < BENCH_ROUND_TRIP_MAX - 1) {
+        LevelDuration pulse = protocol->encoder->yield(encoder);
+        if(level_duration_is_reset(pulse)) break;
+        if(level_duration_is_wait(pulse) || pulse.duration == 0) continue;
+
+        // Pulses of one level in a row arrive as one
+        int32_t duration = level_duration_get_level(pulse) ? (int32_t)pulse.duration :
+                                                             -(int32_t)pulse.duration;
+        int32_t* last = capture->count ? &capture->samples[capture->count - 1] : NULL;
+        if(last && (*last >= 0) == (duration >= 0)) {
+            *last += duration;
+        } else {
+            capture->samples[capture->count++] = duration;
+        }
+    }
+    // Silence after the transmission
+    if(result) capture->samples[capture->count++] = -100000;
+
+    (protocol->encoder->free)(encoder);
+    flipper_format_free(flipper_format);
+    return result;
+}
+
+// Random keys through each protocol's encoder and back through its decoder, for
+// protocols the RAW captures hold no frames of. Every key must decode as sent. The
+// streams are almost all frame, so ns/pulse here is the decoding cost the mostly idle
+// captures hide.
+static bool bench_round_trip(uint32_t repeats) {
+    BenchCapture capture = {.samples = bench_malloc(BENCH_ROUND_TRIP_MAX * sizeof(int32_t))};
+    uint64_t random = 0x2545F4914F6CDD1DULL;
+    bool result = true;
+
+    printf("\n%-12s %10s %8s %8s %8s\n", "Round trip", "ns/pulse", "keys", "decodes", "wrong");
+    for(size_t t = 0; t < COUNT_OF(bench_round_trips); t++) {
+        const SubGhzProtocol* protocol =
+            protopirate_protocol_find_info(bench_round_trips[t].name)->protocol;
+        BenchRoundTripSlot slot = {0};
+        void* decoder = protocol->decoder->alloc(NULL);
+        SubGhzProtocolDecoderBase* base = decoder;
+        base->callback = bench_round_trip_callback;
+        base->context = &slot;
+        uint32_t missed = 0;
+        uint64_t elapsed = 0;
+        uint64_t pulses = 0;
+
+        for(uint32_t k = 0; k < BENCH_ROUND_TRIP_KEYS; k++) {
+            uint64_t key = bench_round_trips[t].key(bench_checksum_frame(&random));
+            if(!bench_encode(protocol, &bench_round_trips[t], key, &capture, &slot.sent)) {
+                missed++;
+                continue;
+            }
+            uint32_t decodes = slot.decodes;
+            BenchDecoder entry = {.protocol = protocol, .decoder = decoder};
+            uint64_t start = bench_time_ns();
+            for(uint32_t r = 0; r < repeats; r++) {
+                protocol->decoder->reset(decoder);
+                bench_feed_capture(&entry, &capture);
+            }
+            elapsed += bench_time_ns() - start;
+            pulses += (uint64_t)capture.count * repeats;
+            if(slot.decodes < decodes + repeats) missed++;
+        }
+
+        printf(
+            "%-12s %10.2f %8u %8lu %8lu\n",
+            protocol->name,
+            pulses ? (double)elapsed / pulses : 0,
+            BENCH_ROUND_TRIP_KEYS,
+            (unsigned long)(slot.decodes / repeats),
+            (unsigned long)slot.mismatched);
+        if(missed || slot.mismatched) {
+            result = false;
+            printf(
+                "MISMATCH %s: %lu keys not decoded, %lu decoded wrong\n",
+                protocol->name,
+                (unsigned long)missed,
+                (unsigned long)slot.mismatched);
+        }
+        (protocol->decoder->free)(decoder);
+    }
+
+    bench_free(capture.samples);
+    return result;
+}
+
+// Copies capture into glitched with about one pulse in every glitched: cut in two by a pulse
+// of the other level, or cut short, to 1 to BENCH_GLITCH_MAX us either way
+static void bench_glitch_capture(
+    const BenchCapture* capture,
+    BenchCapture* glitched,
+    uint32_t every,
+    uint64_t* random) {
+    glitched->path = capture->path;
+    glitched->samples = bench_malloc(capture->count * 3 * sizeof(int32_t));
+    glitched->count = 0;
+
+    for(size_t i = 0; i < capture->count; i++) {
+        int32_t duration = capture->samples[i];
+        uint64_t r = bench_checksum_frame(random);
+        if((r % every) || duration == 1 || duration == -1) {
+            glitched->samples[glitched->count++] = duration;
+            continue;
+        }
+
+        int32_t glitch = 1 + (int32_t)((r >> 32) % BENCH_GLITCH_MAX);
+        if(r & (1ULL << 31)) {
+            glitched->samples[glitched->count++] = (duration >= 0) ? glitch : -glitch;
+            continue;
+        }
+        glitched->samples[glitched->count++] = duration / 2;
+        glitched->samples[glitched->count++] = (duration >= 0) ? -glitch : glitch;
+        glitched->samples[glitched->count++] = duration - duration / 2;
+    }
+}
+
+// The corpus and one glitch in each round trip frame, fed directly and through dispatch.
+// Dispatch resets a decoder on pulses below its te_short - te_delta unfed, so both only
+// decode alike while it filters just the decoders whose feed resets on those too.
+static bool bench_glitch(void) {
+    size_t total = bench_capture_count + COUNT_OF(bench_round_trips) * BENCH_ROUND_TRIP_KEYS;
+    BenchCapture* glitched = bench_malloc(total * sizeof(BenchCapture));
+    BenchCapture clean = {.samples = bench_malloc(BENCH_ROUND_TRIP_MAX * sizeof(int32_t))};
+    uint64_t random = 0x9E3779B97F4A7C15ULL;
+    size_t count = 0;
+
+    for(size_t f = 0; f < bench_capture_count; f++) {
+        bench_glitch_capture(&bench_captures[f], &glitched[count++], BENCH_GLITCH_EVERY, &random);
+    }
+    for(size_t t = 0; t < COUNT_OF(bench_round_trips); t++) {
+        const SubGhzProtocol* protocol =
+            protopirate_protocol_find_info(bench_round_trips[t].name)->protocol;
+        for(uint32_t k = 0; k < BENCH_ROUND_TRIP_KEYS; k++) {
+            uint64_t key = bench_round_trips[t].key(bench_checksum_frame(&random));
+            uint64_t sent;
+            if(!bench_encode(protocol, &bench_round_trips[t], key, &clean, &sent)) continue;
+            bench_glitch_capture(&clean, &glitched[count++], clean.count, &random);
+        }
+    }
+
+    const SubGhzProtocolRegistry* registry = &protopirate_protocol_registry;
+    uint32_t direct[PROTOPIRATE_DISPATCH_MAX];
+    uint32_t dispatch[PROTOPIRATE_DISPATCH_MAX];
+    double ns;
+    bench_pipeline(glitched, count, 1, false, direct, &ns);
+    bench_pipeline(glitched, count, 1, true, dispatch, &ns);
+
+    bool result = true;
+    printf("\n%-12s %10s %10s\n", "Glitched", "direct", "dispatch");
+    for(size_t p = 0; p < registry->size; p++) {
+        printf(
+            "%-12s %10lu %10lu\n",
+            registry->items[p]->name,
+            (unsigned long)direct[p],
+            (unsigned long)dispatch[p]);
+        if(direct[p] != dispatch[p]) {
+            result = false;
+            printf(
+                "MISMATCH %s: glitched direct %lu, dispatch %lu\n",
+                registry->items[p]->name,
+                (unsigned long)direct[p],
+                (unsigned long)dispatch[p]);
+        }
+    }
+
+    for(size_t i = 0; i < count; i++) {
+        bench_free(glitched[i].samples);
+    }
+    bench_free(glitched);
+    bench_free(clean.samples);
+    return result;
+}
+
+static void bench_usage(const char* name) {
+    fprintf(
+        stderr,
+        "Usage: %s [-r repeats] [-v] [-t] [file.sub|dir ...]\n"
+        "  -r N  replay every capture N times per decoder (default %d)\n"
+        "  -v    print per-file decode counts and the last decoded frame\n"
+        "  -t    print the trace ring at the end, the last %d records of the run\n"
+        "With no paths, dist/ next to the app sources is used.\n",
+        name,
+        BENCH_DEFAULT_REPEATS,
+        PROTOPIRATE_TRACE_DEPTH);
+}
+
+int main(int argc, char** argv) {
+    uint32_t repeats = BENCH_DEFAULT_REPEATS;
+    bool verbose = false;
+    bool trace = false;
+    int first_path = argc;
+
+    protopirate_protocol_init();
+
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            repeats = (uint32_t)strtoul(argv[++i], NULL, 10);
+            if(repeats == 0) repeats = 1;
+        } else if(strcmp(argv[i], "-v") == 0) {
+            verbose = true;
+        } else if(strcmp(argv[i], "-t") == 0) {
+            trace = true;
+        } else if(argv[i][0] == '-') {
+            bench_usage(argv[0]);
+            return 1;
+        } else {
+            first_path = i;
+            break;
+        }
+    }
+
+    if(first_path < argc) {
+        for(int i = first_path; i < argc; i++) {
+            bench_load_path(argv[i]);
+        }
+    } else {
+        bench_load_path(BENCH_DEFAULT_DIST);
+    }
+
+    if(bench_capture_count == 0) {
+        fprintf(stderr, "bench: no RAW captures found\n");
+        return 1;
+    }
+
+    size_t total_samples = 0;
+    for(size_t i = 0; i < bench_capture_count; i++) {
+        total_samples += bench_captures[i].count;
+    }
+    printf(
+        "%zu RAW captures, %zu pulses, %lu repeats\n\n",
+        bench_capture_count,
+        total_samples,
+        (unsigned long)repeats);
+
+    const SubGhzProtocolRegistry* registry = &protopirate_protocol_registry;
+    size_t decoder_count = registry->size;
+    BenchDecoder* decoders = bench_malloc(decoder_count * sizeof(BenchDecoder));
+
+    for(size_t p = 0; p < decoder_count; p++) {
+        BenchDecoder* entry = &decoders[p];
+        entry->protocol = registry->items[p];
+        entry->verbose = verbose;
+        entry->last_decode = furi_string_alloc();
+
+        BenchAllocStats before = bench_alloc_stats;
+        entry->decoder = entry->protocol->decoder->alloc(NULL);
+        entry->alloc_allocs = bench_alloc_stats.allocs - before.allocs;
+        entry->alloc_bytes = bench_alloc_stats.bytes - before.bytes;
+
+        SubGhzProtocolDecoderBase* base = entry->decoder;
+        base->callback = bench_decode_callback;
+        base->context = entry;
+    }
+
+    for(size_t f = 0; f < bench_capture_count; f++) {
+        const BenchCapture* capture = &bench_captures[f];
+        if(verbose) {
+            const char* name = strrchr(capture->path, '/');
+            printf("%s (%zu pulses)\n", name ? name + 1 : capture->path, capture->count);
+        }
+
+        for(size_t p = 0; p < decoder_count; p++) {
+            BenchDecoder* entry = &decoders[p];
+            entry->file_decodes = 0;
+            entry->callback_ns = 0;
+            entry->callback_allocs = 0;
+
+            uint64_t allocs = bench_alloc_stats.allocs;
+            uint64_t start = bench_time_ns();
+            for(uint32_t r = 0; r < repeats; r++) {
+                entry->protocol->decoder->reset(entry->decoder);
+                bench_feed_capture(entry, capture);
+            }
+            uint64_t elapsed = bench_time_ns() - start;
+
+            entry->feed_ns += elapsed - entry->callback_ns;
+            entry->feed_allocs += bench_alloc_stats.allocs - allocs - entry->callback_allocs;
+            entry->pulses += (uint64_t)capture->count * repeats;
+            entry->decodes += entry->file_decodes / repeats;
+
+            if(verbose && entry->file_decodes) {
+                printf(
+                    "  %-12s %4lu decodes\n",
+                    entry->protocol->name,
+                    (unsigned long)(entry->file_decodes / repeats));
+                const char* text = furi_string_get_cstr(entry->last_decode);
+                while(*text) {
+                    size_t len = strcspn(text, "\r\n");
+                    printf("      %.*s\n", (int)len, text);
+                    text += len;
+                    while(*text == '\r' || *text == '\n')
+                        text++;
+                }
+            }
+        }
+    }
+
+    if(verbose) printf("\n");
+    printf(
+        "%-12s %10s %8s %8s %8s %10s\n",
+        "Protocol",
+        "ns/pulse",
+        "decodes",
+        "allocs",
+        "feed_al",
+        "inst_bytes");
+
+    double total_ns = 0;
+    for(size_t p = 0; p < decoder_count; p++) {
+        BenchDecoder* entry = &decoders[p];
+        double ns_per_pulse = entry->pulses ? (double)entry->feed_ns / entry->pulses : 0;
+        total_ns += ns_per_pulse;
+        printf(
+            "%-12s %10.2f %8lu %8lu %8lu %10lu\n",
+            entry->protocol->name,
+            ns_per_pulse,
+            (unsigned long)entry->decodes,
+            (unsigned long)entry->alloc_allocs,
+            (unsigned long)entry->feed_allocs,
+            (unsigned long)entry->alloc_bytes);
+    }
+    printf("%-12s %10.2f\n", "all", total_ns);
+
+    uint32_t direct_decodes[PROTOPIRATE_DISPATCH_MAX];
+    uint32_t dispatch_decodes[PROTOPIRATE_DISPATCH_MAX];
+    double direct_ns, dispatch_ns;
+    bench_pipeline(
+        bench_captures, bench_capture_count, repeats, false, direct_decodes, &direct_ns);
+    protopirate_protocol_stats_reset();
+    bench_pipeline(
+        bench_captures, bench_capture_count, repeats, true, dispatch_decodes, &dispatch_ns);
+
+    bool pipeline_match = true;
+    for(size_t p = 0; p < decoder_count; p++) {
+        if(direct_decodes[p] != dispatch_decodes[p]) {
+            pipeline_match = false;
+            printf(
+                "MISMATCH %s: direct %lu, dispatch %lu\n",
+                registry->items[p]->name,
+                (unsigned long)direct_decodes[p],
+                (unsigned long)dispatch_decodes[p]);
+        }
+    }
+    printf(
+        "\nPipeline     %10s %10s\n"
+        "direct       %10.2f\n"
+        "dispatch     %10.2f %9.1fx\n",
+        "ns/pulse",
+        "speedup",
+        direct_ns,
+        dispatch_ns,
+        dispatch_ns > 0 ? direct_ns / dispatch_ns : 0);
+
+    // Counters from the dispatch run, their decodes have to agree with the callbacks
+    printf(
+        "\n%-12s %8s %8s %8s %8s\n",
+        "Stats/repeat",
+        "locks",
+        "resets",
+        "failed",
+        "decodes");
+    for(size_t p = 0; p < decoder_count; p++) {
+        const ProtoPirateProtocolStats* stats =
+            protopirate_protocol_stats_get(registry->items[p]);
+        printf(
+            "%-12s %8lu %8lu %8lu %8lu\n",
+            registry->items[p]->name,
+            (unsigned long)(stats->preamble_locks / repeats),
+            (unsigned long)(stats->resets / repeats),
+            (unsigned long)(stats->check_failures / repeats),
+            (unsigned long)(stats->decodes / repeats));
+        if(stats->decodes != dispatch_decodes[p] * repeats) {
+            pipeline_match = false;
+            printf(
+                "MISMATCH %s: stats count other decodes than callbacks\n",
+                registry->items[p]->name);
+        }
+    }
+
+    bool near_miss_match = bench_near_miss(verbose);
+    bool round_trip_match = bench_round_trip(repeats);
+    bool glitch_match = bench_glitch();
+    bool cluster_match = bench_timing_clusters();
+    bool fit_match = bench_timing_fit();
+    bool history_match = bench_history(verbose);
+    bool checksum_match = bench_checksums();
+
+    if(trace) {
+        FuriString* text = furi_string_alloc();
+        protopirate_trace_format(text);
+        printf("\nTrace\n%s", furi_string_get_cstr(text));
+        furi_string_free(text);
+    }
+
+    for(size_t p = 0; p < decoder_count; p++) {
+        // Parenthesised so the free() accounting macro does not expand here
+        (decoders[p].protocol->decoder->free)(decoders[p].decoder);
+        furi_string_free(decoders[p].last_decode);
+    }
+    bench_free(decoders);
+    for(size_t i = 0; i < bench_capture_count; i++) {
+        free(bench_captures[i].path);
+        bench_free(bench_captures[i].samples);
+    }
+
+    return (pipeline_match && near_miss_match && round_trip_match && glitch_match &&
+            cluster_match && fit_match && history_match && checksum_match) ? 0 : 2;
+}
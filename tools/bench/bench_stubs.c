@@ -0,0 +1,478 @@
+// tools/bench/bench_stubs.c
+// Host implementations of the furi/subghz helpers that protocols/*.c link against
+#include "bench_stubs.h"
+
+#include <stdarg.h>
+#include <time.h>
+
+#include <lib/subghz/blocks/decoder.h>
+#include <lib/subghz/blocks/generic.h>
+#include <lib/subghz/blocks/math.h>
+#include <lib/subghz/protocols/base.h>
+#include <toolbox/stream/stream.h>
+#include <furi_hal_rtc.h>
+#include <furi_hal_cortex.h>
+
+#undef malloc
+#undef realloc
+#undef free
+
+BenchAllocStats bench_alloc_stats = {0};
+
+void* bench_malloc(size_t size) {
+    bench_alloc_stats.allocs++;
+    bench_alloc_stats.bytes += size;
+    // Firmware malloc never returns NULL and hands out zeroed memory
+    void* ptr = calloc(1, size ? size : 1);
+    furi_check(ptr);
+    return ptr;
+}
+
+void* bench_realloc(void* ptr, size_t size) {
+    bench_alloc_stats.allocs++;
+    bench_alloc_stats.bytes += size;
+    ptr = realloc(ptr, size ? size : 1);
+    furi_check(ptr);
+    return ptr;
+}
+
+void bench_free(void* ptr) {
+    if(ptr) bench_alloc_stats.frees++;
+    free(ptr);
+}
+
+uint64_t bench_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+uint32_t furi_get_tick(void) {
+    return (uint32_t)(bench_time_ns() / 1000000ULL);
+}
+
+// ============ FuriString ============
+
+struct FuriString {
+    char* data;
+    size_t size;
+    size_t capacity;
+};
+
+static void furi_string_reserve(FuriString* string, size_t size) {
+    if(size + 1 <= string->capacity) return;
+    size_t capacity = string->capacity ? string->capacity : 16;
+    while(capacity < size + 1)
+        capacity *= 2;
+    string->data = bench_realloc(string->data, capacity);
+    string->capacity = capacity;
+}
+
+FuriString* furi_string_alloc(void) {
+    FuriString* string = bench_malloc(sizeof(FuriString));
+    furi_string_reserve(string, 0);
+    string->data[0] = '\0';
+    return string;
+}
+
+FuriString* furi_string_alloc_set(const FuriString* source) {
+    return furi_string_alloc_set_str(furi_string_get_cstr(source));
+}
+
+FuriString* furi_string_alloc_set_str(const char* source) {
+    FuriString* string = furi_string_alloc();
+    furi_string_set_str(string, source);
+    return string;
+}
+
+void furi_string_free(FuriString* string) {
+    bench_free(string->data);
+    bench_free(string);
+}
+
+void furi_string_reset(FuriString* string) {
+    string->size = 0;
+    string->data[0] = '\0';
+}
+
+void furi_string_set_string(FuriString* string, FuriString* source) {
+    furi_string_set_str(string, furi_string_get_cstr(source));
+}
+
+void furi_string_set_str(FuriString* string, const char* source) {
+    furi_string_reset(string);
+    furi_string_cat_str(string, source);
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    return string->data;
+}
+
+size_t furi_string_size(const FuriString* string) {
+    return string->size;
+}
+
+bool furi_string_equal_string(const FuriString* a, const FuriString* b) {
+    return strcmp(a->data, b->data) == 0;
+}
+
+bool furi_string_equal_str(const FuriString* a, const char* b) {
+    return strcmp(a->data, b) == 0;
+}
+
+static int furi_string_cat_vprintf(FuriString* string, const char* format, va_list args) {
+    va_list copy;
+    va_copy(copy, args);
+    int len = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+    if(len < 0) return len;
+    furi_string_reserve(string, string->size + (size_t)len);
+    vsnprintf(string->data + string->size, (size_t)len + 1, format, args);
+    string->size += (size_t)len;
+    return len;
+}
+
+int furi_string_printf(FuriString* string, const char* format, ...) {
+    furi_string_reset(string);
+    va_list args;
+    va_start(args, format);
+    int ret = furi_string_cat_vprintf(string, format, args);
+    va_end(args);
+    return ret;
+}
+
+int furi_string_cat_printf(FuriString* string, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int ret = furi_string_cat_vprintf(string, format, args);
+    va_end(args);
+    return ret;
+}
+
+void furi_string_cat_str(FuriString* string, const char* source) {
+    size_t len = strlen(source);
+    furi_string_reserve(string, string->size + len);
+    memcpy(string->data + string->size, source, len + 1);
+    string->size += len;
+}
+
+// ============ FlipperFormat ============
+
+struct Stream {
+    FuriString* string;
+    size_t position;
+};
+
+struct FlipperFormat {
+    FuriString* stream;
+    Stream raw;
+};
+
+FlipperFormat* flipper_format_string_alloc(void) {
+    FlipperFormat* flipper_format = bench_malloc(sizeof(FlipperFormat));
+    flipper_format->stream = furi_string_alloc();
+    flipper_format->raw.string = flipper_format->stream;
+    flipper_format->raw.position = 0;
+    return flipper_format;
+}
+
+Stream* flipper_format_get_raw_stream(FlipperFormat* flipper_format) {
+    return &flipper_format->raw;
+}
+
+bool stream_rewind(Stream* stream) {
+    stream->position = 0;
+    return true;
+}
+
+bool stream_read_line(Stream* stream, FuriString* str_result) {
+    const char* data = furi_string_get_cstr(stream->string);
+    size_t size = furi_string_size(stream->string);
+    furi_string_reset(str_result);
+    if(stream->position >= size) return false;
+
+    const char* start = data + stream->position;
+    const char* newline = memchr(start, '\n', size - stream->position);
+    size_t len = newline ? (size_t)(newline - start) + 1 : size - stream->position;
+    furi_string_reserve(str_result, len);
+    memcpy(str_result->data, start, len);
+    str_result->data[len] = '\0';
+    str_result->size = len;
+    stream->position += len;
+    return true;
+}
+
+void stream_clean(Stream* stream) {
+    furi_string_reset(stream->string);
+    stream->position = 0;
+}
+
+void flipper_format_free(FlipperFormat* flipper_format) {
+    furi_string_free(flipper_format->stream);
+    bench_free(flipper_format);
+}
+
+FuriString* flipper_format_get_raw_stream_string(FlipperFormat* flipper_format) {
+    return flipper_format->stream;
+}
+
+bool flipper_format_rewind(FlipperFormat* flipper_format) {
+    UNUSED(flipper_format);
+    return true;
+}
+
+static const char* flipper_format_find_value(FlipperFormat* flipper_format, const char* key) {
+    size_t key_len = strlen(key);
+    const char* line = furi_string_get_cstr(flipper_format->stream);
+    while(*line) {
+        if(strncmp(line, key, key_len) == 0 && line[key_len] == ':') {
+            const char* value = line + key_len + 1;
+            while(*value == ' ')
+                value++;
+            return value;
+        }
+        line = strchr(line, '\n');
+        if(!line) break;
+        line++;
+    }
+    return NULL;
+}
+
+bool flipper_format_read_string(FlipperFormat* flipper_format, const char* key, FuriString* data) {
+    const char* value = flipper_format_find_value(flipper_format, key);
+    if(!value) return false;
+    furi_string_reset(data);
+    size_t len = strcspn(value, "\n");
+    furi_string_reserve(data, len);
+    memcpy(data->data, value, len);
+    data->data[len] = '\0';
+    data->size = len;
+    return true;
+}
+
+bool flipper_format_write_string(FlipperFormat* flipper_format, const char* key, FuriString* data) {
+    return flipper_format_write_string_cstr(flipper_format, key, furi_string_get_cstr(data));
+}
+
+bool flipper_format_write_string_cstr(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const char* data) {
+    furi_string_cat_printf(flipper_format->stream, "%s: %s\n", key, data);
+    return true;
+}
+
+bool flipper_format_read_uint32(
+    FlipperFormat* flipper_format,
+    const char* key,
+    uint32_t* data,
+    const uint16_t data_size) {
+    const char* value = flipper_format_find_value(flipper_format, key);
+    if(!value) return false;
+    for(uint16_t i = 0; i < data_size; i++) {
+        char* end;
+        data[i] = (uint32_t)strtoul(value, &end, 10);
+        if(end == value) return false;
+        value = end;
+    }
+    return true;
+}
+
+bool flipper_format_write_uint32(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const uint32_t* data,
+    const uint16_t data_size) {
+    furi_string_cat_printf(flipper_format->stream, "%s:", key);
+    for(uint16_t i = 0; i < data_size; i++) {
+        furi_string_cat_printf(flipper_format->stream, " %u", (unsigned)data[i]);
+    }
+    furi_string_cat_str(flipper_format->stream, "\n");
+    return true;
+}
+
+bool flipper_format_read_hex(
+    FlipperFormat* flipper_format,
+    const char* key,
+    uint8_t* data,
+    const uint16_t data_size) {
+    const char* value = flipper_format_find_value(flipper_format, key);
+    if(!value) return false;
+    for(uint16_t i = 0; i < data_size; i++) {
+        unsigned byte;
+        int consumed;
+        if(sscanf(value, "%2x%n", &byte, &consumed) != 1) return false;
+        data[i] = (uint8_t)byte;
+        value += consumed;
+        while(*value == ' ')
+            value++;
+    }
+    return true;
+}
+
+bool flipper_format_write_hex(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const uint8_t* data,
+    const uint16_t data_size) {
+    furi_string_cat_printf(flipper_format->stream, "%s:", key);
+    for(uint16_t i = 0; i < data_size; i++) {
+        furi_string_cat_printf(flipper_format->stream, " %02X", data[i]);
+    }
+    furi_string_cat_str(flipper_format->stream, "\n");
+    return true;
+}
+
+bool flipper_format_insert_or_update_uint32(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const uint32_t* data,
+    const uint16_t data_size) {
+    return flipper_format_write_uint32(flipper_format, key, data, data_size);
+}
+
+// ============ furi ============
+
+struct FuriMutex {
+    FuriMutexType type;
+};
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type) {
+    FuriMutex* instance = bench_malloc(sizeof(FuriMutex));
+    instance->type = type;
+    return instance;
+}
+
+void furi_mutex_free(FuriMutex* instance) {
+    bench_free(instance);
+}
+
+int furi_mutex_acquire(FuriMutex* instance, uint32_t timeout) {
+    UNUSED(instance);
+    UNUSED(timeout);
+    return 0;
+}
+
+int furi_mutex_release(FuriMutex* instance) {
+    UNUSED(instance);
+    return 0;
+}
+
+uint32_t furi_hal_rtc_get_timestamp(void) {
+    return (uint32_t)time(NULL);
+}
+
+// ============ furi_hal_cortex ============
+
+// The dispatch reads the cycle counter once per decoder per pulse. On the device that is
+// one load from DWT, host clocks cost 15-30 ns a read and would swamp the pipeline
+// timing, so this stands in for the read's cost only: it advances by one per call.
+static uint32_t bench_cycle_counter = 0;
+
+FuriHalCortexTimer furi_hal_cortex_timer_get(uint32_t timeout_us) {
+    FuriHalCortexTimer timer = {
+        .start = bench_cycle_counter++,
+        .value = timeout_us * 64,
+    };
+    return timer;
+}
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void) {
+    return 64;
+}
+
+// ============ lib/subghz/protocols/base ============
+
+uint8_t subghz_protocol_decoder_base_get_hash_data(SubGhzProtocolDecoderBase* decoder_base) {
+    return decoder_base->protocol->decoder->get_hash_data(decoder_base);
+}
+
+void subghz_protocol_decoder_base_get_string(
+    SubGhzProtocolDecoderBase* decoder_base,
+    FuriString* output) {
+    decoder_base->protocol->decoder->get_string(decoder_base, output);
+}
+
+SubGhzProtocolStatus subghz_protocol_decoder_base_serialize(
+    SubGhzProtocolDecoderBase* decoder_base,
+    FlipperFormat* flipper_format,
+    SubGhzRadioPreset* preset) {
+    return decoder_base->protocol->decoder->serialize(decoder_base, flipper_format, preset);
+}
+
+// ============ lib/subghz/blocks ============
+
+void subghz_protocol_blocks_add_bit(SubGhzBlockDecoder* decoder, uint8_t bit) {
+    decoder->decode_data = decoder->decode_data << 1 | bit;
+    decoder->decode_count_bit++;
+}
+
+uint8_t subghz_protocol_blocks_get_hash_data(SubGhzBlockDecoder* decoder, size_t len) {
+    uint8_t hash = 0;
+    uint8_t* p = (uint8_t*)&decoder->decode_data;
+    for(size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+    }
+    return hash;
+}
+
+uint64_t subghz_protocol_blocks_reverse_key(uint64_t key, uint8_t bit_count) {
+    uint64_t reverse_key = 0;
+    for(uint8_t i = 0; i < bit_count; i++) {
+        reverse_key = reverse_key << 1 | bit_read(key, i);
+    }
+    return reverse_key;
+}
+
+SubGhzProtocolStatus subghz_block_generic_serialize(
+    SubGhzBlockGeneric* instance,
+    FlipperFormat* flipper_format,
+    SubGhzRadioPreset* preset) {
+    furi_string_reset(flipper_format->stream);
+    uint32_t temp = preset ? preset->frequency : 0;
+    flipper_format_write_uint32(flipper_format, "Frequency", &temp, 1);
+    flipper_format_write_string_cstr(
+        flipper_format,
+        "Preset",
+        (preset && preset->name) ? furi_string_get_cstr(preset->name) : "AM650");
+    flipper_format_write_string_cstr(flipper_format, "Protocol", instance->protocol_name);
+    temp = instance->data_count_bit;
+    flipper_format_write_uint32(flipper_format, "Bit", &temp, 1);
+
+    uint8_t key_data[sizeof(uint64_t)];
+    for(size_t i = 0; i < sizeof(uint64_t); i++) {
+        key_data[sizeof(uint64_t) - i - 1] = (instance->data >> (i * 8)) & 0xFF;
+    }
+    flipper_format_write_hex(flipper_format, "Key", key_data, sizeof(uint64_t));
+    return SubGhzProtocolStatusOk;
+}
+
+SubGhzProtocolStatus
+    subghz_block_generic_deserialize(SubGhzBlockGeneric* instance, FlipperFormat* flipper_format) {
+    uint32_t temp = 0;
+    if(!flipper_format_read_uint32(flipper_format, "Bit", &temp, 1)) {
+        return SubGhzProtocolStatusErrorParserBitCount;
+    }
+    instance->data_count_bit = (uint16_t)temp;
+
+    uint8_t key_data[sizeof(uint64_t)] = {0};
+    if(!flipper_format_read_hex(flipper_format, "Key", key_data, sizeof(uint64_t))) {
+        return SubGhzProtocolStatusErrorParserKey;
+    }
+    instance->data = 0;
+    for(size_t i = 0; i < sizeof(uint64_t); i++) {
+        instance->data = instance->data << 8 | key_data[i];
+    }
+    return SubGhzProtocolStatusOk;
+}
+
+SubGhzProtocolStatus subghz_block_generic_deserialize_check_count_bit(
+    SubGhzBlockGeneric* instance,
+    FlipperFormat* flipper_format,
+    uint16_t count_bit) {
+    SubGhzProtocolStatus ret = subghz_block_generic_deserialize(instance, flipper_format);
+    if(ret == SubGhzProtocolStatusOk && instance->data_count_bit != count_bit) {
+        ret = SubGhzProtocolStatusErrorValueBitCount;
+    }
+    return ret;
+}
@@ -0,0 +1,14 @@
+// tools/bench/bench_stubs.h
+#pragma once
+
+#include <furi.h>
+
+typedef struct {
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t bytes;
+} BenchAllocStats;
+
+extern BenchAllocStats bench_alloc_stats;
+
+uint64_t bench_time_ns(void);
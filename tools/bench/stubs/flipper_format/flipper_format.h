@@ -0,0 +1,46 @@
+// tools/bench/stubs/flipper_format/flipper_format.h
+// Minimal in-memory FlipperFormat: writes append "Key: value" lines, reads scan them back
+#pragma once
+
+#include <furi.h>
+
+typedef struct FlipperFormat FlipperFormat;
+typedef struct Stream Stream;
+
+FlipperFormat* flipper_format_string_alloc(void);
+void flipper_format_free(FlipperFormat* flipper_format);
+FuriString* flipper_format_get_raw_stream_string(FlipperFormat* flipper_format);
+Stream* flipper_format_get_raw_stream(FlipperFormat* flipper_format);
+bool flipper_format_rewind(FlipperFormat* flipper_format);
+
+bool flipper_format_read_string(FlipperFormat* flipper_format, const char* key, FuriString* data);
+bool flipper_format_write_string(FlipperFormat* flipper_format, const char* key, FuriString* data);
+bool flipper_format_write_string_cstr(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const char* data);
+bool flipper_format_read_uint32(
+    FlipperFormat* flipper_format,
+    const char* key,
+    uint32_t* data,
+    const uint16_t data_size);
+bool flipper_format_write_uint32(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const uint32_t* data,
+    const uint16_t data_size);
+bool flipper_format_read_hex(
+    FlipperFormat* flipper_format,
+    const char* key,
+    uint8_t* data,
+    const uint16_t data_size);
+bool flipper_format_write_hex(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const uint8_t* data,
+    const uint16_t data_size);
+bool flipper_format_insert_or_update_uint32(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const uint32_t* data,
+    const uint16_t data_size);
@@ -0,0 +1,110 @@
+// tools/bench/stubs/furi.h
+// Host stand-in for the parts of furi.h used by protocols/*.c
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#ifndef UNUSED
+#define UNUSED(x) (void)(x)
+#endif
+
+#ifndef COUNT_OF
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+#endif
+
+#ifndef FURI_ALWAYS_INLINE
+#define FURI_ALWAYS_INLINE __attribute__((always_inline)) inline
+#endif
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#ifndef CLAMP
+#define CLAMP(x, upper, lower) (MIN(upper, MAX(x, lower)))
+#endif
+
+#define furi_assert(x) assert(x)
+#define furi_check(x)  assert(x)
+
+// Allocation accounting, see bench_stubs.c
+void* bench_malloc(size_t size);
+void* bench_realloc(void* ptr, size_t size);
+void bench_free(void* ptr);
+
+#define malloc(size)       bench_malloc(size)
+#define realloc(ptr, size) bench_realloc(ptr, size)
+#define free(ptr)          bench_free(ptr)
+
+// Logging is swallowed, but arguments are still evaluated as on the device
+static inline void bench_log(const char* tag, const char* format, ...) {
+    UNUSED(tag);
+    UNUSED(format);
+}
+
+#define FURI_LOG_E(tag, format, ...) bench_log(tag, format, ##__VA_ARGS__)
+#define FURI_LOG_W(tag, format, ...) bench_log(tag, format, ##__VA_ARGS__)
+#define FURI_LOG_I(tag, format, ...) bench_log(tag, format, ##__VA_ARGS__)
+#define FURI_LOG_D(tag, format, ...) bench_log(tag, format, ##__VA_ARGS__)
+#define FURI_LOG_T(tag, format, ...) bench_log(tag, format, ##__VA_ARGS__)
+
+typedef struct FuriString FuriString;
+
+FuriString* furi_string_alloc(void);
+FuriString* furi_string_alloc_set(const FuriString* source);
+FuriString* furi_string_alloc_set_str(const char* source);
+void furi_string_free(FuriString* string);
+void furi_string_reset(FuriString* string);
+void furi_string_set_string(FuriString* string, FuriString* source);
+void furi_string_set_str(FuriString* string, const char* source);
+const char* furi_string_get_cstr(const FuriString* string);
+size_t furi_string_size(const FuriString* string);
+bool furi_string_equal_str(const FuriString* a, const char* b);
+bool furi_string_equal_string(const FuriString* a, const FuriString* b);
+int furi_string_printf(FuriString* string, const char* format, ...);
+int furi_string_cat_printf(FuriString* string, const char* format, ...);
+void furi_string_cat_str(FuriString* string, const char* source);
+
+// Same overloads the firmware provides through _Generic
+#define furi_string_set(a, b)                  \
+    _Generic(                                  \
+        (b),                                   \
+        char*: furi_string_set_str,            \
+        const char*: furi_string_set_str,      \
+        FuriString*: furi_string_set_string,   \
+        const FuriString*: furi_string_set_string)(a, b)
+
+#define furi_string_equal(a, b)                       \
+    _Generic(                                         \
+        (b),                                          \
+        char*: furi_string_equal_str,                 \
+        const char*: furi_string_equal_str,           \
+        FuriString*: furi_string_equal_string,        \
+        const FuriString*: furi_string_equal_string)(a, b)
+
+uint32_t furi_get_tick(void);
+
+// Single threaded host: mutexes only need to exist
+typedef struct FuriMutex FuriMutex;
+
+typedef enum {
+    FuriMutexTypeNormal,
+    FuriMutexTypeRecursive,
+} FuriMutexType;
+
+#define FuriWaitForever 0xFFFFFFFFU
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type);
+void furi_mutex_free(FuriMutex* instance);
+int furi_mutex_acquire(FuriMutex* instance, uint32_t timeout);
+int furi_mutex_release(FuriMutex* instance);
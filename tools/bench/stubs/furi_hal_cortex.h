@@ -0,0 +1,13 @@
+// tools/bench/stubs/furi_hal_cortex.h
+#pragma once
+
+#include <furi.h>
+
+// The DWT cycle counter, emulated from the host's monotonic clock at 64 MHz
+typedef struct {
+    uint32_t start;
+    uint32_t value;
+} FuriHalCortexTimer;
+
+FuriHalCortexTimer furi_hal_cortex_timer_get(uint32_t timeout_us);
+uint32_t furi_hal_cortex_instructions_per_microsecond(void);
@@ -0,0 +1,6 @@
+// tools/bench/stubs/furi_hal_rtc.h
+#pragma once
+
+#include <furi.h>
+
+uint32_t furi_hal_rtc_get_timestamp(void);
@@ -0,0 +1,15 @@
+// tools/bench/stubs/lib/subghz/blocks/encoder.h
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <lib/toolbox/level_duration.h>
+
+typedef struct {
+    bool is_running;
+    size_t repeat;
+    size_t front;
+    size_t size_upload;
+    LevelDuration* upload;
+} SubGhzProtocolBlockEncoder;
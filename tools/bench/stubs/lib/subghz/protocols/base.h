@@ -0,0 +1,29 @@
+// tools/bench/stubs/lib/subghz/protocols/base.h
+#pragma once
+
+#include "../types.h"
+
+typedef struct SubGhzProtocolDecoderBase SubGhzProtocolDecoderBase;
+
+typedef void (*SubGhzProtocolDecoderBaseRxCallback)(
+    SubGhzProtocolDecoderBase* instance,
+    void* context);
+
+struct SubGhzProtocolDecoderBase {
+    const SubGhzProtocol* protocol;
+    SubGhzProtocolDecoderBaseRxCallback callback;
+    void* context;
+};
+
+typedef struct {
+    const SubGhzProtocol* protocol;
+} SubGhzProtocolEncoderBase;
+
+uint8_t subghz_protocol_decoder_base_get_hash_data(SubGhzProtocolDecoderBase* decoder_base);
+void subghz_protocol_decoder_base_get_string(
+    SubGhzProtocolDecoderBase* decoder_base,
+    FuriString* output);
+SubGhzProtocolStatus subghz_protocol_decoder_base_serialize(
+    SubGhzProtocolDecoderBase* decoder_base,
+    FlipperFormat* flipper_format,
+    SubGhzRadioPreset* preset);
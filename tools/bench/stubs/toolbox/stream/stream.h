@@ -0,0 +1,11 @@
+// tools/bench/stubs/toolbox/stream/stream.h
+// Host stand-in for the read side of toolbox/stream/stream.h over an in-memory FlipperFormat
+#pragma once
+
+#include <furi.h>
+
+typedef struct Stream Stream;
+
+bool stream_rewind(Stream* stream);
+bool stream_read_line(Stream* stream, FuriString* str_result);
+void stream_clean(Stream* stream);
@@ -11,13 +11,6 @@
 #define MENU_ITEMS   4u
 #define UNLOCK_CNT   3
 
-typedef struct {
-    FuriString* item_str;
-    uint8_t type;
-} ProtoPirateReceiverMenuItem;
-
-ARRAY_DEF(ProtoPirateReceiverMenuItemArray, ProtoPirateReceiverMenuItem, M_POD_OPLIST)
-
 struct ProtoPirateReceiver {
     View* view;
     ProtoPirateReceiverCallback callback;
@@ -25,9 +18,12 @@ struct ProtoPirateReceiver {
 };
 
 typedef struct {
-    ProtoPirateReceiverMenuItemArray_t history_item_arr;
-    uint8_t list_offset;
-    uint8_t history_item;
+    // Item text is not kept here, the visible rows are asked for on every draw
+    uint16_t item_count;
+    uint16_t list_offset;
+    uint16_t history_item;
+    ProtoPirateReceiverItemCallback item_callback;
+    void* item_context;
     float rssi;
     FuriString* frequency_str;
     FuriString* preset_str;
@@ -67,7 +63,7 @@ static void protopirate_view_receiver_update_offset(ProtoPirateReceiver* receive
         {
             size_t history_item = model->history_item;
             size_t list_offset = model->list_offset;
-            size_t item_count = ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
+            size_t item_count = model->item_count;
 
             if(history_item < list_offset) {
                 model->list_offset = history_item;
@@ -84,19 +80,31 @@ static void protopirate_view_receiver_update_offset(ProtoPirateReceiver* receive
         true);
 }
 
-void protopirate_view_receiver_add_item_to_menu(
+void protopirate_view_receiver_set_item_callback(
     ProtoPirateReceiver* receiver,
-    const char* name,
-    uint8_t type) {
+    ProtoPirateReceiverItemCallback callback,
+    void* context) {
     furi_assert(receiver);
     with_view_model(
         receiver->view,
         ProtoPirateReceiverModel * model,
         {
-            ProtoPirateReceiverMenuItem* item_menu =
-                ProtoPirateReceiverMenuItemArray_push_raw(model->history_item_arr);
-            item_menu->item_str = furi_string_alloc_set(name);
-            item_menu->type = type;
+            model->item_callback = callback;
+            model->item_context = context;
+        },
+        false);
+}
+
+void protopirate_view_receiver_set_item_count(ProtoPirateReceiver* receiver, uint16_t count) {
+    furi_assert(receiver);
+    with_view_model(
+        receiver->view,
+        ProtoPirateReceiverModel * model,
+        {
+            model->item_count = count;
+            if(model->history_item >= count) {
+                model->history_item = count > 0 ? count - 1 : 0;
+            }
         },
         true);
     protopirate_view_receiver_update_offset(receiver);
@@ -143,7 +151,7 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
     // Increment animation frame
     model->animation_frame = (model->animation_frame + 1) % 96;
 
-    size_t item_count = ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
+    size_t item_count = model->item_count;
     bool scrollbar = item_count > MENU_ITEMS;
 
     // Draw EXT/INT indicator in upper right corner
@@ -163,10 +171,11 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
 
         for(size_t i = 0; i < MIN(item_count, MENU_ITEMS); i++) {
             size_t idx = shift_position + i;
-            ProtoPirateReceiverMenuItem* item =
-                ProtoPirateReceiverMenuItemArray_get(model->history_item_arr, idx);
 
-            furi_string_set(str_buff, item->item_str);
+            furi_string_reset(str_buff);
+            if(model->item_callback) {
+                model->item_callback(model->item_context, idx, str_buff);
+            }
             elements_string_fit_width(canvas, str_buff, scrollbar ? MAX_LEN_PX - 6 : MAX_LEN_PX);
 
             if(model->history_item == idx) {
@@ -389,9 +398,7 @@ bool protopirate_view_receiver_input(InputEvent* event, void* context) {
                 receiver->view,
                 ProtoPirateReceiverModel * model,
                 {
-                    size_t item_count =
-                        ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
-                    if(item_count > 0 && model->history_item < item_count - 1) {
+                    if(model->item_count > 0 && model->history_item < model->item_count - 1) {
                         model->history_item++;
                     }
                 },
@@ -413,9 +420,7 @@ bool protopirate_view_receiver_input(InputEvent* event, void* context) {
                 receiver->view,
                 ProtoPirateReceiverModel * model,
                 {
-                    size_t item_count =
-                        ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
-                    if(item_count > 0) {
+                    if(model->item_count > 0) {
                         if(receiver->callback) {
                             receiver->callback(
                                 ProtoPirateCustomEventViewReceiverOK, receiver->context);
@@ -431,14 +436,7 @@ bool protopirate_view_receiver_input(InputEvent* event, void* context) {
                     receiver->view,
                     ProtoPirateReceiverModel * model,
                     {
-                        for(size_t i = 0;
-                            i < ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
-                            i++) {
-                            ProtoPirateReceiverMenuItem* item =
-                                ProtoPirateReceiverMenuItemArray_get(model->history_item_arr, i);
-                            furi_string_free(item->item_str);
-                        }
-                        ProtoPirateReceiverMenuItemArray_reset(model->history_item_arr);
+                        model->item_count = 0;
                         model->history_item = 0;
                         model->list_offset = 0;
                     },
@@ -480,7 +478,9 @@ ProtoPirateReceiver* protopirate_view_receiver_alloc() {
         receiver->view,
         ProtoPirateReceiverModel * model,
         {
-            ProtoPirateReceiverMenuItemArray_init(model->history_item_arr);
+            model->item_count = 0;
+            model->item_callback = NULL;
+            model->item_context = NULL;
             model->frequency_str = furi_string_alloc();
             model->preset_str = furi_string_alloc();
             model->history_stat_str = furi_string_alloc();
@@ -504,13 +504,6 @@ void protopirate_view_receiver_free(ProtoPirateReceiver* receiver) {
         receiver->view,
         ProtoPirateReceiverModel * model,
         {
-            for(size_t i = 0; i < ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
-                i++) {
-                ProtoPirateReceiverMenuItem* item =
-                    ProtoPirateReceiverMenuItemArray_get(model->history_item_arr, i);
-                furi_string_free(item->item_str);
-            }
-            ProtoPirateReceiverMenuItemArray_clear(model->history_item_arr);
             furi_string_free(model->frequency_str);
             furi_string_free(model->preset_str);
             furi_string_free(model->history_stat_str);
@@ -541,9 +534,8 @@ void protopirate_view_receiver_set_idx_menu(ProtoPirateReceiver* receiver, uint1
         ProtoPirateReceiverModel * model,
         {
             model->history_item = idx;
-            size_t item_count = ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
-            if(model->history_item >= item_count) {
-                model->history_item = item_count > 0 ? item_count - 1 : 0;
+            if(model->history_item >= model->item_count) {
+                model->history_item = model->item_count > 0 ? model->item_count - 1 : 0;
             }
         },
         true);
@@ -8,6 +8,9 @@ typedef struct ProtoPirateReceiver ProtoPirateReceiver;
 
 typedef void (*ProtoPirateReceiverCallback)(ProtoPirateCustomEvent event, void* context);
 
+// Fills out with the menu text of item idx, called for the visible rows only
+typedef void (*ProtoPirateReceiverItemCallback)(void* context, uint16_t idx, FuriString* out);
+
 void protopirate_view_receiver_set_callback(
     ProtoPirateReceiver* receiver,
     ProtoPirateReceiverCallback callback,
@@ -17,10 +20,12 @@ ProtoPirateReceiver* protopirate_view_receiver_alloc(void);
 void protopirate_view_receiver_free(ProtoPirateReceiver* receiver);
 View* protopirate_view_receiver_get_view(ProtoPirateReceiver* receiver);
 
-void protopirate_view_receiver_add_item_to_menu(
+void protopirate_view_receiver_set_item_callback(
     ProtoPirateReceiver* receiver,
-    const char* name,
-    uint8_t type);
+    ProtoPirateReceiverItemCallback callback,
+    void* context);
+
+void protopirate_view_receiver_set_item_count(ProtoPirateReceiver* receiver, uint16_t count);
 
 void protopirate_view_receiver_add_data_statusbar(
     ProtoPirateReceiver* receiver,